@@ -4,6 +4,7 @@ add_executable(
   run_unit_tests
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/run_unit_tests.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_buffer.c
+  ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_bus.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_can.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_codb.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_dbc.c
@@ -13,8 +14,10 @@ add_executable(
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_pdo.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_scripts.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_sdo.c
+  ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_sim.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_table.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_test_report.c
+  ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_vcan.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/tests/test_wrapper.c
   ${CMAKE_CURRENT_SOURCE_DIR}/src/codb2json/codb2json.c
 )
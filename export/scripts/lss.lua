@@ -377,6 +377,20 @@ local function action_inquire_identity()
     print(string.rep("─", 50))
 end
 
+local function action_assign_node_ids()
+    print("\nAssign Node-IDs to all non-configured slaves (Fastscan)")
+    local inp = core.select_variable("First Node-ID (hex, 1-7F):")
+    if inp == nil then return end
+    local node_id = tonumber(inp, 16)
+    if not node_id or node_id < 1 or node_id > 0x7F then
+        print("Invalid Node-ID. Must be 0x01..0x7F.")
+        return
+    end
+
+    -- Runs natively: one Fastscan per slave, stored on the device.
+    lss_assign_node_ids(node_id, true, true)
+end
+
 -- ============================================================
 --  Main menu
 -- ============================================================
@@ -397,6 +411,7 @@ while true do
     print("  6. Identify Slaves")
     print("  7. Identify Non-Configured Slaves")
     print("  8. Inquire Identity / Node-ID")
+    print("  9. Assign Node-IDs (Fastscan)")
     print("  0. Exit")
 
     local choice = core.select_number("Select action:")
@@ -419,6 +434,8 @@ while true do
         action_identify_non_configured()
     elseif choice == 8 then
         action_inquire_identity()
+    elseif choice == 9 then
+        action_assign_node_ids()
     else
         print("Invalid choice.")
     end
@@ -14,6 +14,8 @@
 #include "lauxlib.h"
 #include "lua.h"
 #include "os.h"
+#include "sim.h"
+#include "vcan.h"
 
 int lua_can_write(lua_State* L)
 {
@@ -159,6 +161,31 @@ int lua_dict_lookup_raw(lua_State* L)
     return 1;
 }
 
+int lua_vcan_open(lua_State* L)
+{
+    const char* options = luaL_optstring(L, 1, NULL);
+
+    if (ALL_OK == vcan_init_from_string(options))
+    {
+        lua_pushboolean(L, 1);
+    }
+    else
+    {
+        lua_pushboolean(L, 0);
+    }
+
+    return 1;
+}
+
+int lua_vcan_close(lua_State* L)
+{
+    (void)L;
+
+    sim_stop();
+    vcan_deinit();
+    return 0;
+}
+
 void lua_register_can_commands(core_t* core)
 {
     lua_pushcfunction(core->L, lua_can_write);
@@ -171,4 +198,10 @@ void lua_register_can_commands(core_t* core)
     lua_setglobal(core->L, "can_set_baud_rate");
     lua_pushcfunction(core->L, lua_dict_lookup_raw);
     lua_setglobal(core->L, "dict_lookup_raw");
+
+    lua_pushcfunction(core->L, lua_vcan_open);
+    lua_setglobal(core->L, "vcan_open");
+
+    lua_pushcfunction(core->L, lua_vcan_close);
+    lua_setglobal(core->L, "vcan_close");
 }
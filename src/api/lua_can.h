@@ -18,6 +18,8 @@ int lua_can_read(lua_State* L);
 int lua_can_flush(lua_State* L);
 int lua_can_set_baud_rate(lua_State* L);
 int lua_dict_lookup_raw(lua_State* L);
+int lua_vcan_open(lua_State* L);
+int lua_vcan_close(lua_State* L);
 void lua_register_can_commands(core_t* core);
 
 #endif /* LUA_CAN_H */
@@ -26,6 +26,91 @@ int lua_dbc_decode(lua_State* L)
     return 1;
 }
 
+int lua_dbc_decode_values(lua_State* L)
+{
+    signal_value_t values[DBC_VALUES_MAX];
+    int can_id = luaL_checkinteger(L, 1);
+    uint64 data = lua_tointeger(L, 2);
+    const char* filter = luaL_optstring(L, 3, NULL);
+    int count = 0;
+    int i;
+
+    if (ALL_OK != dbc_decode_values(can_id, data, filter, values, DBC_VALUES_MAX, &count))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_createtable(L, 0, count);
+    lua_createtable(L, 0, count);
+    lua_newtable(L);
+
+    for (i = 0; i < count; i += 1)
+    {
+        lua_pushnumber(L, values[i].value);
+        lua_setfield(L, -4, values[i].signal->name);
+        lua_pushinteger(L, (lua_Integer)values[i].raw);
+        lua_setfield(L, -3, values[i].signal->name);
+
+        if (NULL != values[i].description)
+        {
+            lua_pushstring(L, values[i].description);
+            lua_setfield(L, -2, values[i].signal->name);
+        }
+    }
+
+    return 3;
+}
+
+int lua_dbc_encode(lua_State* L)
+{
+    signal_value_t values[DBC_VALUES_MAX];
+    const message_t* msg;
+    int can_id = luaL_checkinteger(L, 1);
+    uint64 data = 0;
+    uint8 length = 0;
+    int count = 0;
+    int i;
+
+    luaL_checktype(L, 2, LUA_TTABLE);
+
+    msg = dbc_get_message(can_id);
+    if (NULL == msg)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    /* One lookup per signal of the message, not per table entry. */
+    for (i = 0; (i < msg->signal_count) && (count < DBC_VALUES_MAX); i += 1)
+    {
+        if (LUA_TNIL != lua_getfield(L, 2, msg->signals[i].name))
+        {
+            values[count].signal = &msg->signals[i];
+            values[count].value = lua_tonumber(L, -1);
+            count += 1;
+        }
+        lua_pop(L, 1);
+    }
+
+    if (ALL_OK != dbc_encode(can_id, values, count, &data, &length))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    /* Right-aligned, byte 0 first: as pdo_add() and pdo_update() expect. */
+    if (0 != length)
+    {
+        data = os_swap_64(data) >> (8u * (8u - length));
+    }
+
+    lua_pushinteger(L, (lua_Integer)data);
+    lua_pushinteger(L, length);
+
+    return 2;
+}
+
 int lua_dbc_find_id_by_name(lua_State* L)
 {
     const char* search = luaL_checkstring(L, 1);
@@ -45,6 +130,42 @@ int lua_dbc_find_id_by_name(lua_State* L)
     return 1;
 }
 
+int lua_dbc_find_names(lua_State* L)
+{
+    name_match_t matches[DBC_MATCHES_MAX];
+    const char* search = luaL_checkstring(L, 1);
+    bool is_prefix = lua_toboolean(L, 2);
+    int count = 0;
+    int i;
+
+    if (ALL_OK != dbc_find_names(search, is_prefix, matches, DBC_MATCHES_MAX, &count))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_createtable(L, count, 0);
+
+    for (i = 0; i < count; i += 1)
+    {
+        lua_createtable(L, 0, 3);
+        lua_pushinteger(L, matches[i].message->id);
+        lua_setfield(L, -2, "id");
+        lua_pushstring(L, matches[i].message->name);
+        lua_setfield(L, -2, "message");
+
+        if (NULL != matches[i].signal)
+        {
+            lua_pushstring(L, matches[i].signal->name);
+            lua_setfield(L, -2, "signal");
+        }
+
+        lua_rawseti(L, -2, (lua_Integer)i + 1);
+    }
+
+    return 1;
+}
+
 int lua_dbc_load(lua_State* L)
 {
     char* filename = (char*)luaL_checkstring(L, 1);
@@ -68,8 +189,14 @@ void lua_register_dbc_commands(core_t* core)
 {
     lua_pushcfunction(core->L, lua_dbc_decode);
     lua_setglobal(core->L, "dbc_decode");
+    lua_pushcfunction(core->L, lua_dbc_decode_values);
+    lua_setglobal(core->L, "dbc_decode_values");
+    lua_pushcfunction(core->L, lua_dbc_encode);
+    lua_setglobal(core->L, "dbc_encode");
     lua_pushcfunction(core->L, lua_dbc_find_id_by_name);
     lua_setglobal(core->L, "dbc_find_id_by_name");
+    lua_pushcfunction(core->L, lua_dbc_find_names);
+    lua_setglobal(core->L, "dbc_find_names");
     lua_pushcfunction(core->L, lua_dbc_load);
     lua_setglobal(core->L, "dbc_load");
 }
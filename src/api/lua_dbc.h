@@ -14,7 +14,10 @@
 #include "lua.h"
 
 int lua_dbc_decode(lua_State* L);
+int lua_dbc_decode_values(lua_State* L);
+int lua_dbc_encode(lua_State* L);
 int lua_dbc_find_id_by_name(lua_State* L);
+int lua_dbc_find_names(lua_State* L);
 int lua_dbc_load(lua_State* L);
 void lua_register_dbc_commands(core_t* core);
 
@@ -0,0 +1,144 @@
+/** @file lua_emcy.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "lua_emcy.h"
+#include "core.h"
+#include "dict.h"
+#include "emcy.h"
+#include "lauxlib.h"
+#include "lua.h"
+#include "os.h"
+
+static void push_entry(lua_State* L, const emcy_record_t* entry);
+
+int lua_emcy_get_node(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    emcy_node_t node;
+
+    if ((node_id < 0) || (ALL_OK != emcy_get_node((uint8)node_id, &node)))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_createtable(L, 0, 8);
+    lua_pushinteger(L, node.count);
+    lua_setfield(L, -2, "count");
+    lua_pushinteger(L, node.last_code);
+    lua_setfield(L, -2, "code");
+    lua_pushstring(L, emcy_lookup(node.last_code));
+    lua_setfield(L, -2, "description");
+    lua_pushinteger(L, node.error_register);
+    lua_setfield(L, -2, "error_register");
+    lua_pushinteger(L, (lua_Integer)node.first_us);
+    lua_setfield(L, -2, "first_us");
+    lua_pushinteger(L, (lua_Integer)node.last_us);
+    lua_setfield(L, -2, "last_us");
+    lua_pushnumber(L, emcy_get_rate(&node));
+    lua_setfield(L, -2, "rate");
+    lua_pushinteger(L, node.peak_per_s);
+    lua_setfield(L, -2, "peak_per_s");
+
+    return 1;
+}
+
+int lua_emcy_get_history(lua_State* L)
+{
+    emcy_record_t entries[EMCY_HISTORY_MAX];
+    int node_id = luaL_checkinteger(L, 1);
+    uint32 count = 0;
+    uint32 i;
+
+    if (node_id > 0)
+    {
+        count = emcy_get_history((uint8)node_id, entries, EMCY_HISTORY_MAX);
+    }
+
+    lua_createtable(L, (int)count, 0);
+
+    for (i = 0; i < count; i += 1)
+    {
+        push_entry(L, &entries[i]);
+        lua_rawseti(L, -2, (lua_Integer)i + 1);
+    }
+
+    return 1;
+}
+
+int lua_emcy_wait(lua_State* L)
+{
+    emcy_record_t entry;
+    int node_id = luaL_checkinteger(L, 1);
+    int code = luaL_checkinteger(L, 2);
+    int timeout_ms = luaL_checkinteger(L, 3);
+    int mask = luaL_optinteger(L, 4, 0xffff);
+
+    if ((node_id < 0) || (timeout_ms < 0) || (ALL_OK != emcy_wait((uint8)node_id, (uint16)code, (uint16)mask, (uint32)timeout_ms, &entry)))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    push_entry(L, &entry);
+    return 1;
+}
+
+int lua_emcy_clear(lua_State* L)
+{
+    int node_id = luaL_optinteger(L, 1, 0);
+
+    if (node_id >= 0)
+    {
+        emcy_clear((uint8)node_id);
+    }
+
+    return 0;
+}
+
+void lua_register_emcy_commands(core_t* core)
+{
+    lua_pushcfunction(core->L, lua_emcy_get_node);
+    lua_setglobal(core->L, "emcy_get_node");
+
+    lua_pushcfunction(core->L, lua_emcy_get_history);
+    lua_setglobal(core->L, "emcy_get_history");
+
+    lua_pushcfunction(core->L, lua_emcy_wait);
+    lua_setglobal(core->L, "emcy_wait");
+
+    lua_pushcfunction(core->L, lua_emcy_clear);
+    lua_setglobal(core->L, "emcy_clear");
+}
+
+static void push_entry(lua_State* L, const emcy_record_t* entry)
+{
+    uint64 data = 0;
+    int i;
+
+    /* Same byte order as the data of can_write(). */
+    for (i = 0; i < 5; i += 1)
+    {
+        data = (data << 8) | entry->data[i];
+    }
+
+    lua_createtable(L, 0, 6);
+    lua_pushinteger(L, entry->node_id);
+    lua_setfield(L, -2, "node_id");
+    lua_pushinteger(L, entry->code);
+    lua_setfield(L, -2, "code");
+    lua_pushstring(L, emcy_lookup(entry->code));
+    lua_setfield(L, -2, "description");
+    lua_pushinteger(L, entry->error_register);
+    lua_setfield(L, -2, "error_register");
+    lua_pushinteger(L, (lua_Integer)data);
+    lua_setfield(L, -2, "data");
+    lua_pushinteger(L, (lua_Integer)entry->timestamp_us);
+    lua_setfield(L, -2, "timestamp_us");
+}
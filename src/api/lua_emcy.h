@@ -0,0 +1,22 @@
+/** @file lua_emcy.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef LUA_EMCY_H
+#define LUA_EMCY_H
+
+#include "core.h"
+#include "lua.h"
+
+int lua_emcy_get_node(lua_State* L);
+int lua_emcy_get_history(lua_State* L);
+int lua_emcy_wait(lua_State* L);
+int lua_emcy_clear(lua_State* L);
+void lua_register_emcy_commands(core_t* core);
+
+#endif /* LUA_EMCY_H */
@@ -0,0 +1,85 @@
+/** @file lua_lss.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "lua_lss.h"
+#include "core.h"
+#include "lauxlib.h"
+#include "lss.h"
+#include "lua.h"
+#include "os.h"
+
+static void push_identity(lua_State* L, const lss_identity_t* identity);
+
+int lua_lss_fastscan(lua_State* L)
+{
+    lss_identity_t identity;
+    int timeout_us = luaL_optinteger(L, 1, LSS_FASTSCAN_TIMEOUT_US);
+
+    if ((timeout_us < 0) || (ALL_OK != lss_fastscan(&identity, (uint32)timeout_us)))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    push_identity(L, &identity);
+    return 1;
+}
+
+int lua_lss_assign_node_ids(lua_State* L)
+{
+    lss_assignment_t assignments[LSS_NODE_MAX];
+    disp_mode_t disp_mode = SILENT;
+    int first_node_id = luaL_checkinteger(L, 1);
+    bool store = lua_toboolean(L, 2);
+    bool show_output = lua_toboolean(L, 3);
+    uint32 count = 0;
+    uint32 i;
+
+    if (true == show_output)
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    if ((first_node_id > 0) && (first_node_id <= LSS_NODE_MAX))
+    {
+        count = lss_assign_node_ids((uint8)first_node_id, store, assignments, LSS_NODE_MAX, disp_mode);
+    }
+
+    lua_createtable(L, 0, (int)count);
+
+    for (i = 0; i < count; i += 1)
+    {
+        push_identity(L, &assignments[i].identity);
+        lua_rawseti(L, -2, assignments[i].node_id);
+    }
+
+    return 1;
+}
+
+void lua_register_lss_commands(core_t* core)
+{
+    lua_pushcfunction(core->L, lua_lss_fastscan);
+    lua_setglobal(core->L, "lss_fastscan");
+
+    lua_pushcfunction(core->L, lua_lss_assign_node_ids);
+    lua_setglobal(core->L, "lss_assign_node_ids");
+}
+
+static void push_identity(lua_State* L, const lss_identity_t* identity)
+{
+    lua_createtable(L, 0, 4);
+    lua_pushinteger(L, identity->vendor_id);
+    lua_setfield(L, -2, "vendor_id");
+    lua_pushinteger(L, identity->product_code);
+    lua_setfield(L, -2, "product_code");
+    lua_pushinteger(L, identity->revision);
+    lua_setfield(L, -2, "revision");
+    lua_pushinteger(L, identity->serial);
+    lua_setfield(L, -2, "serial");
+}
@@ -0,0 +1,20 @@
+/** @file lua_lss.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef LUA_LSS_H
+#define LUA_LSS_H
+
+#include "core.h"
+#include "lua.h"
+
+int lua_lss_fastscan(lua_State* L);
+int lua_lss_assign_node_ids(lua_State* L);
+void lua_register_lss_commands(core_t* core);
+
+#endif /* LUA_LSS_H */
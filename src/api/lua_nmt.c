@@ -10,10 +10,12 @@
 #include "lua_nmt.h"
 #include "can.h"
 #include "core.h"
+#include "heartbeat.h"
 #include "lauxlib.h"
 #include "lua.h"
 #include "nmt.h"
 #include "os.h"
+#include "scan.h"
 
 extern void nmt_print_error(const char* reason, nmt_command_t command, disp_mode_t disp_mode);
 
@@ -60,8 +62,223 @@ int lua_nmt_send_command(lua_State* L)
     return 1;
 }
 
+int lua_nmt_send_command_confirmed(lua_State* L)
+{
+    nmt_transition_t transitions[NMT_NODE_MAX + 1];
+    status_t status;
+    disp_mode_t disp_mode = SILENT;
+    int node_id = luaL_checkinteger(L, 1);
+    int command = luaL_checkinteger(L, 2);
+    int timeout_ms = luaL_checkinteger(L, 3);
+    bool show_output = lua_toboolean(L, 4);
+    const char* comment = lua_tostring(L, 5);
+    uint8 id;
+
+    limit_node_id((uint8*)&node_id);
+
+    if (true == show_output)
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    if (timeout_ms < 0)
+    {
+        timeout_ms = 0;
+    }
+
+    status = nmt_send_command_confirmed(node_id, command, (uint32)timeout_ms, transitions, disp_mode, comment);
+    if ((ALL_OK != status) && (NMT_NOT_CONFIRMED != status))
+    {
+        lua_pushboolean(L, 0);
+        lua_pushnil(L);
+        return 2;
+    }
+
+    lua_pushboolean(L, (ALL_OK == status));
+    lua_newtable(L);
+
+    for (id = 1; id <= NMT_NODE_MAX; id += 1)
+    {
+        if (false == transitions[id].is_expected)
+        {
+            continue;
+        }
+
+        if (true == transitions[id].is_confirmed)
+        {
+            lua_pushinteger(L, transitions[id].latency_us);
+        }
+        else
+        {
+            lua_pushboolean(L, 0);
+        }
+        lua_rawseti(L, -2, id);
+    }
+
+    return 2;
+}
+
+int lua_heartbeat_get_node(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    heartbeat_node_t node;
+
+    if ((node_id < 0) || (ALL_OK != heartbeat_get_node((uint8)node_id, &node)))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_newtable(L);
+    lua_pushinteger(L, node.state);
+    lua_setfield(L, -2, "state");
+    lua_pushstring(L, heartbeat_get_state_name(node.state));
+    lua_setfield(L, -2, "state_name");
+    lua_pushinteger(L, (lua_Integer)node.last_seen_us);
+    lua_setfield(L, -2, "last_seen_us");
+    lua_pushinteger(L, node.period_us);
+    lua_setfield(L, -2, "period_us");
+    lua_pushinteger(L, node.frames);
+    lua_setfield(L, -2, "frames");
+    lua_pushinteger(L, node.timeouts);
+    lua_setfield(L, -2, "timeouts");
+    lua_pushinteger(L, node.toggle_errors);
+    lua_setfield(L, -2, "toggle_errors");
+    lua_pushboolean(L, node.is_timed_out);
+    lua_setfield(L, -2, "is_timed_out");
+
+    return 1;
+}
+
+int lua_heartbeat_get_events(lua_State* L)
+{
+    heartbeat_entry_t entries[HEARTBEAT_EVENT_MAX];
+    uint32 count = heartbeat_get_events(entries, HEARTBEAT_EVENT_MAX);
+    uint32 i;
+
+    lua_createtable(L, (int)count, 0);
+
+    for (i = 0; i < count; i += 1)
+    {
+        lua_createtable(L, 0, 4);
+        lua_pushinteger(L, entries[i].node_id);
+        lua_setfield(L, -2, "node_id");
+        lua_pushstring(L, heartbeat_get_event_name(entries[i].event));
+        lua_setfield(L, -2, "event");
+        lua_pushinteger(L, entries[i].state);
+        lua_setfield(L, -2, "state");
+        lua_pushinteger(L, (lua_Integer)entries[i].timestamp_us);
+        lua_setfield(L, -2, "timestamp_us");
+        lua_rawseti(L, -2, (lua_Integer)i + 1);
+    }
+
+    return 1;
+}
+
+int lua_heartbeat_set_timeout(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    int timeout_ms = luaL_checkinteger(L, 2);
+
+    if ((node_id < 0) || (timeout_ms < 0))
+    {
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    lua_pushboolean(L, (ALL_OK == heartbeat_set_timeout((uint8)node_id, (uint32)timeout_ms)));
+    return 1;
+}
+
+int lua_heartbeat_set_guarding(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    int guard_time_ms = luaL_checkinteger(L, 2);
+    int life_time_factor = luaL_optinteger(L, 3, 3);
+
+    if ((node_id < 0) || (guard_time_ms < 0) || (life_time_factor < 0) || (life_time_factor > 0xff))
+    {
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    lua_pushboolean(L, (ALL_OK == heartbeat_set_guarding((uint8)node_id, (uint32)guard_time_ms, (uint8)life_time_factor)));
+    return 1;
+}
+
+int lua_scan_network(lua_State* L)
+{
+    static const char* names[SCAN_OBJECT_COUNT] = {"device_type", "vendor_id", "product_code", "revision", "serial"};
+    scan_node_t nodes[SCAN_NODE_MAX + 1];
+    disp_mode_t disp_mode = SILENT;
+    bool show_output = lua_toboolean(L, 1);
+    uint8 node_id;
+
+    if (true == show_output)
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    scan_network(nodes, disp_mode);
+
+    lua_newtable(L);
+
+    for (node_id = 1; node_id <= SCAN_NODE_MAX; node_id += 1)
+    {
+        const scan_node_t* node = &nodes[node_id];
+        int i;
+
+        if (false == node->is_present)
+        {
+            continue;
+        }
+
+        lua_newtable(L);
+
+        for (i = 0; i < SCAN_OBJECT_COUNT; i += 1)
+        {
+            if (true == scan_has_value(node, (scan_object_t)i))
+            {
+                lua_pushinteger(L, node->values[i]);
+                lua_setfield(L, -2, names[i]);
+            }
+        }
+
+        if (0xff != node->state)
+        {
+            lua_pushinteger(L, node->state);
+            lua_setfield(L, -2, "state");
+        }
+
+        lua_pushboolean(L, node->is_booted);
+        lua_setfield(L, -2, "is_booted");
+
+        lua_rawseti(L, -2, node_id);
+    }
+
+    return 1;
+}
+
 void lua_register_nmt_command(core_t* core)
 {
     lua_pushcfunction(core->L, lua_nmt_send_command);
     lua_setglobal(core->L, "nmt_send_command");
+
+    lua_pushcfunction(core->L, lua_nmt_send_command_confirmed);
+    lua_setglobal(core->L, "nmt_send_command_confirmed");
+
+    lua_pushcfunction(core->L, lua_heartbeat_get_node);
+    lua_setglobal(core->L, "heartbeat_get_node");
+
+    lua_pushcfunction(core->L, lua_heartbeat_get_events);
+    lua_setglobal(core->L, "heartbeat_get_events");
+
+    lua_pushcfunction(core->L, lua_heartbeat_set_timeout);
+    lua_setglobal(core->L, "heartbeat_set_timeout");
+
+    lua_pushcfunction(core->L, lua_heartbeat_set_guarding);
+    lua_setglobal(core->L, "heartbeat_set_guarding");
+
+    lua_pushcfunction(core->L, lua_scan_network);
+    lua_setglobal(core->L, "scan_network");
 }
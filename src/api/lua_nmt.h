@@ -14,6 +14,12 @@
 #include "lua.h"
 
 int lua_nmt_send_command(lua_State* L);
+int lua_nmt_send_command_confirmed(lua_State* L);
+int lua_heartbeat_get_node(lua_State* L);
+int lua_heartbeat_get_events(lua_State* L);
+int lua_heartbeat_set_timeout(lua_State* L);
+int lua_heartbeat_set_guarding(lua_State* L);
+int lua_scan_network(lua_State* L);
 void lua_register_nmt_command(core_t* core);
 
 #endif /* LUA_NMT_H */
@@ -13,6 +13,9 @@
 #include "lua.h"
 #include "os.h"
 #include "pdo.h"
+#include "pdo_map.h"
+
+static void push_value(lua_State* L, const pdo_map_field_t* field);
 
 extern void pdo_print_result(uint16 can_id, uint32 event_time_ms, uint64 data, bool was_successful, const char* comment);
 
@@ -44,6 +47,15 @@ int lua_pdo_add(lua_State* L)
     return 1;
 }
 
+int lua_pdo_update(lua_State* L)
+{
+    int can_id = luaL_checkinteger(L, 1);
+    uint64 data = lua_tointeger(L, 2);
+
+    lua_pushboolean(L, pdo_update(can_id, data, SILENT));
+    return 1;
+}
+
 int lua_pdo_del(lua_State* L)
 {
     int can_id = luaL_checkinteger(L, 1);
@@ -60,11 +72,144 @@ int lua_pdo_del(lua_State* L)
     return 1;
 }
 
+int lua_pdo_get_stats(lua_State* L)
+{
+    int can_id = luaL_optinteger(L, 1, 0);
+    pdo_stats_t stats;
+
+    if (ALL_OK != pdo_get_stats((uint16)can_id, &stats))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_newtable(L);
+    lua_pushinteger(L, stats.sent);
+    lua_setfield(L, -2, "sent");
+    lua_pushinteger(L, stats.missed);
+    lua_setfield(L, -2, "missed");
+    lua_pushinteger(L, (lua_Integer)(stats.jitter_min_ns / 1000u));
+    lua_setfield(L, -2, "jitter_min_us");
+    lua_pushinteger(L, (lua_Integer)((0 != stats.sent) ? (stats.jitter_sum_ns / stats.sent / 1000u) : 0));
+    lua_setfield(L, -2, "jitter_avg_us");
+    lua_pushinteger(L, (lua_Integer)(stats.jitter_max_ns / 1000u));
+    lua_setfield(L, -2, "jitter_max_us");
+
+    return 1;
+}
+
+int lua_pdo_map_discover(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    bool show_output = lua_toboolean(L, 2);
+    disp_mode_t disp_mode = SILENT;
+
+    if (true == show_output)
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    lua_pushinteger(L, pdo_map_discover((uint8)node_id, disp_mode));
+    return 1;
+}
+
+int lua_pdo_map_get_value(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    int index = luaL_checkinteger(L, 2);
+    int sub_index = luaL_checkinteger(L, 3);
+    pdo_map_field_t field;
+
+    if ((ALL_OK != pdo_map_get_field((uint8)node_id, (uint16)index, (uint8)sub_index, &field)) || (false == field.is_valid))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    push_value(L, &field);
+    return 1;
+}
+
+int lua_pdo_map_get_values(lua_State* L)
+{
+    int can_id = luaL_checkinteger(L, 1);
+    pdo_map_field_t fields[PDO_MAP_FIELD_MAX];
+    uint32 count;
+    uint32 i;
+
+    count = pdo_map_get_fields((uint16)can_id, fields, PDO_MAP_FIELD_MAX);
+    if (0 == count)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_newtable(L);
+    for (i = 0; i < count; i += 1)
+    {
+        lua_newtable(L);
+        lua_pushinteger(L, fields[i].index);
+        lua_setfield(L, -2, "index");
+        lua_pushinteger(L, fields[i].sub_index);
+        lua_setfield(L, -2, "sub_index");
+        lua_pushstring(L, fields[i].name);
+        lua_setfield(L, -2, "name");
+
+        if (true == fields[i].is_valid)
+        {
+            push_value(L, &fields[i]);
+            lua_setfield(L, -2, "value");
+        }
+
+        lua_rawseti(L, -2, (lua_Integer)(i + 1));
+    }
+
+    return 1;
+}
+
+int lua_pdo_reset_stats(lua_State* L)
+{
+    (void)L;
+
+    pdo_reset_stats();
+    return 0;
+}
+
 void lua_register_pdo_commands(core_t* core)
 {
     lua_pushcfunction(core->L, lua_pdo_add);
     lua_setglobal(core->L, "pdo_add");
 
+    lua_pushcfunction(core->L, lua_pdo_update);
+    lua_setglobal(core->L, "pdo_update");
+
     lua_pushcfunction(core->L, lua_pdo_del);
     lua_setglobal(core->L, "pdo_del");
+
+    lua_pushcfunction(core->L, lua_pdo_get_stats);
+    lua_setglobal(core->L, "pdo_get_stats");
+
+    lua_pushcfunction(core->L, lua_pdo_reset_stats);
+    lua_setglobal(core->L, "pdo_reset_stats");
+
+    lua_pushcfunction(core->L, lua_pdo_map_discover);
+    lua_setglobal(core->L, "pdo_map_discover");
+
+    lua_pushcfunction(core->L, lua_pdo_map_get_value);
+    lua_setglobal(core->L, "pdo_map_get_value");
+
+    lua_pushcfunction(core->L, lua_pdo_map_get_values);
+    lua_setglobal(core->L, "pdo_map_get_values");
+}
+
+static void push_value(lua_State* L, const pdo_map_field_t* field)
+{
+    if ((REAL32 == field->data_type) || (REAL64 == field->data_type) || (FLOAT_T == field->data_type))
+    {
+        lua_pushnumber(L, pdo_map_to_number(field));
+    }
+    else
+    {
+        lua_pushinteger(L, (lua_Integer)field->value);
+    }
 }
@@ -14,7 +14,13 @@
 #include "lua.h"
 
 int lua_pdo_add(lua_State* L);
+int lua_pdo_update(lua_State* L);
 int lua_pdo_del(lua_State* L);
+int lua_pdo_get_stats(lua_State* L);
+int lua_pdo_reset_stats(lua_State* L);
+int lua_pdo_map_discover(lua_State* L);
+int lua_pdo_map_get_value(lua_State* L);
+int lua_pdo_map_get_values(lua_State* L);
 void lua_register_pdo_commands(core_t* core);
 
 #endif /* LUA_PDO_H */
@@ -14,6 +14,8 @@
 #include "lua.h"
 #include "os.h"
 #include "sdo.h"
+#include "sdo_cache.h"
+#include "sdo_stats.h"
 
 extern bool is_printable_string(const char* str, size_t length);
 
@@ -36,6 +38,7 @@ int lua_sdo_read(lua_State* L)
     int sub_index = luaL_checkinteger(L, 3);
     bool show_output = lua_toboolean(L, 4);
     const char* comment = lua_tostring(L, 5);
+    bool bypass_cache = lua_toboolean(L, 6);
     char str_buffer[5] = {0};
     uint32 result;
 
@@ -46,17 +49,31 @@ int lua_sdo_read(lua_State* L)
         disp_mode = SCRIPT_MODE;
     }
 
-    sdo_state = sdo_read(
-        &sdo_response,
-        disp_mode,
-        (uint8)node_id,
-        (uint16)index,
-        (uint16)sub_index,
-        comment);
+    if (true == bypass_cache)
+    {
+        sdo_state = sdo_read_uncached(
+            &sdo_response,
+            disp_mode,
+            (uint8)node_id,
+            (uint16)index,
+            (uint16)sub_index,
+            comment);
+    }
+    else
+    {
+        sdo_state = sdo_read(
+            &sdo_response,
+            disp_mode,
+            (uint8)node_id,
+            (uint16)index,
+            (uint16)sub_index,
+            comment);
+    }
 
     switch (sdo_state)
     {
         case IS_READ_SEGMENTED:
+        case IS_READ_BLOCK:
             lua_pushstring(L, (const char*)sdo_response.data);
             lua_pushstring(L, (const char*)sdo_response.data);
             break;
@@ -216,6 +233,341 @@ int lua_sdo_write_string(lua_State* L)
     return 1;
 }
 
+int lua_sdo_transfer_read(lua_State* L)
+{
+    can_message_t sdo_response = {0};
+    disp_mode_t disp_mode = SILENT;
+    sdo_state_t sdo_state;
+    int node_id = luaL_checkinteger(L, 1);
+    int index = luaL_checkinteger(L, 2);
+    int sub_index = luaL_checkinteger(L, 3);
+    bool show_output = lua_toboolean(L, 4);
+    const char* comment = lua_tostring(L, 5);
+    char str_buffer[5] = {0};
+    uint32 result;
+
+    limit_node_id((uint8*)&node_id);
+
+    if (true == show_output)
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    sdo_state = sdo_transfer_read(
+        &sdo_response,
+        disp_mode,
+        (uint8)node_id,
+        (uint16)index,
+        (uint8)sub_index,
+        comment);
+
+    switch (sdo_state)
+    {
+        case IS_READ_SEGMENTED:
+        case IS_READ_BLOCK:
+            lua_pushstring(L, (const char*)sdo_response.data);
+            lua_pushstring(L, (const char*)sdo_response.data);
+            break;
+        case IS_READ_EXPEDITED:
+            os_memcpy(&result, &sdo_response.data, sizeof(uint32));
+            os_memcpy(&str_buffer, &sdo_response.data, sizeof(uint32));
+            lua_pushinteger(L, result);
+
+            if (is_printable_string(str_buffer, sizeof(uint32)))
+            {
+                lua_pushstring(L, (const char*)str_buffer);
+            }
+            else
+            {
+                lua_pushnil(L);
+            }
+            break;
+        default:
+        case ABORT_TRANSFER:
+            lua_pushnil(L);
+            lua_pushnil(L);
+            break;
+    }
+
+    return 2;
+}
+
+int lua_sdo_transfer_write(lua_State* L)
+{
+    can_message_t sdo_response = {0};
+    disp_mode_t disp_mode = SILENT;
+    sdo_state_t sdo_state;
+    int node_id = luaL_checkinteger(L, 1);
+    int index = luaL_checkinteger(L, 2);
+    int sub_index = luaL_checkinteger(L, 3);
+    bool show_output = lua_toboolean(L, 5);
+    const char* comment = lua_tostring(L, 6);
+    uint8 buffer[sizeof(uint64)] = {0};
+    void* data = (void*)buffer;
+    uint32 length = 0;
+
+    if (LUA_TSTRING == lua_type(L, 4))
+    {
+        data = (void*)lua_tostring(L, 4);
+        length = os_strlen((const char*)data);
+
+        if (0 == length)
+        {
+            lua_pushboolean(L, 0);
+            return 1;
+        }
+    }
+    else
+    {
+        uint64 value = (uint64)luaL_checkinteger(L, 4);
+        int i;
+
+        /* Length is derived from the object's data type. */
+        for (i = 0; i < sizeof(uint64); i += 1)
+        {
+            buffer[i] = (uint8)(value >> (i * 8));
+        }
+    }
+
+    limit_node_id((uint8*)&node_id);
+
+    if (true == show_output)
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    sdo_state = sdo_transfer_write(
+        &sdo_response,
+        disp_mode,
+        (uint8)node_id,
+        (uint16)index,
+        (uint8)sub_index,
+        length,
+        data,
+        comment);
+
+    switch (sdo_state)
+    {
+        case ABORT_TRANSFER:
+            lua_pushboolean(L, 0);
+            break;
+        default:
+            lua_pushboolean(L, 1);
+            break;
+    }
+
+    return 1;
+}
+
+int lua_sdo_discover_channels(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+
+    limit_node_id((uint8*)&node_id);
+
+    lua_pushinteger(L, sdo_discover_channels((uint8)node_id));
+    return 1;
+}
+
+int lua_sdo_set_channel(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    int channel = luaL_checkinteger(L, 2);
+    uint32 request_id = (uint32)luaL_checkinteger(L, 3);
+    uint32 response_id = (uint32)luaL_checkinteger(L, 4);
+
+    limit_node_id((uint8*)&node_id);
+
+    if (ALL_OK == sdo_set_channel((uint8)node_id, (uint8)channel, request_id, response_id))
+    {
+        lua_pushboolean(L, 1);
+    }
+    else
+    {
+        lua_pushboolean(L, 0);
+    }
+
+    return 1;
+}
+
+int lua_sdo_set_usdo(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    int enable = lua_toboolean(L, 2);
+
+    limit_node_id((uint8*)&node_id);
+
+    sdo_set_usdo((uint8)node_id, enable ? true : false);
+    return 0;
+}
+
+int lua_sdo_enable_cache(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    int enable = lua_toboolean(L, 2);
+
+    limit_node_id((uint8*)&node_id);
+
+    sdo_cache_enable((uint8)node_id, enable ? true : false);
+    return 0;
+}
+
+int lua_sdo_invalidate_cache(lua_State* L)
+{
+    int node_id = (int)luaL_optinteger(L, 1, 0);
+
+    limit_node_id((uint8*)&node_id);
+
+    sdo_cache_invalidate((uint8)node_id);
+    return 0;
+}
+
+int lua_sdo_get_stats(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    sdo_state_t sdo_state;
+
+    limit_node_id((uint8*)&node_id);
+
+    lua_newtable(L);
+
+    for (sdo_state = IS_READ_EXPEDITED; sdo_state < SDO_STATS_TYPE_COUNT; sdo_state += 1)
+    {
+        sdo_stats_t stats;
+        uint32 i;
+
+        sdo_stats_get((uint8)node_id, sdo_state, &stats);
+        if (true == sdo_stats_is_empty(&stats))
+        {
+            continue;
+        }
+
+        lua_newtable(L);
+        lua_pushinteger(L, stats.transfers);
+        lua_setfield(L, -2, "transfers");
+        lua_pushinteger(L, stats.timeouts);
+        lua_setfield(L, -2, "timeouts");
+        lua_pushinteger(L, stats.aborts);
+        lua_setfield(L, -2, "aborts");
+        lua_pushinteger(L, stats.retries);
+        lua_setfield(L, -2, "retries");
+        lua_pushinteger(L, (lua_Integer)stats.bytes);
+        lua_setfield(L, -2, "bytes");
+        lua_pushinteger(L, (lua_Integer)sdo_stats_get_throughput(&stats));
+        lua_setfield(L, -2, "bytes_per_second");
+        lua_pushinteger(L, (lua_Integer)(stats.min_ns / 1000u));
+        lua_setfield(L, -2, "latency_min_us");
+        lua_pushinteger(L, (lua_Integer)(sdo_stats_get_percentile(&stats, 50.f) / 1000u));
+        lua_setfield(L, -2, "latency_p50_us");
+        lua_pushinteger(L, (lua_Integer)(sdo_stats_get_percentile(&stats, 90.f) / 1000u));
+        lua_setfield(L, -2, "latency_p90_us");
+        lua_pushinteger(L, (lua_Integer)(sdo_stats_get_percentile(&stats, 99.f) / 1000u));
+        lua_setfield(L, -2, "latency_p99_us");
+        lua_pushinteger(L, (lua_Integer)(stats.max_ns / 1000u));
+        lua_setfield(L, -2, "latency_max_us");
+
+        lua_newtable(L);
+        for (i = 0; (i < SDO_STATS_ABORT_MAX) && (0 != stats.abort_codes[i].count); i += 1)
+        {
+            lua_pushinteger(L, stats.abort_codes[i].count);
+            lua_rawseti(L, -2, (lua_Integer)stats.abort_codes[i].abort_code);
+        }
+        lua_setfield(L, -2, "abort_codes");
+
+        lua_setfield(L, -2, sdo_stats_get_type_name(sdo_state));
+    }
+
+    return 1;
+}
+
+int lua_sdo_reset_stats(lua_State* L)
+{
+    (void)L;
+
+    sdo_stats_reset();
+    return 0;
+}
+
+int lua_sdo_export_stats(lua_State* L)
+{
+    sdo_stats_export(lua_tostring(L, 1));
+    return 0;
+}
+
+int lua_sdo_read_parallel(lua_State* L)
+{
+    disp_mode_t disp_mode = SILENT;
+    sdo_request_t* requests;
+    int node_id = luaL_checkinteger(L, 1);
+    bool show_output = lua_toboolean(L, 3);
+    uint32 count;
+    uint32 i;
+
+    luaL_checktype(L, 2, LUA_TTABLE);
+    count = (uint32)lua_rawlen(L, 2);
+
+    if (0 == count)
+    {
+        lua_newtable(L);
+        return 1;
+    }
+
+    requests = (sdo_request_t*)os_calloc(count, sizeof(sdo_request_t));
+    if (NULL == requests)
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    for (i = 0; i < count; i += 1)
+    {
+        if (LUA_TTABLE != lua_rawgeti(L, 2, i + 1))
+        {
+            os_free(requests);
+            return luaL_error(L, "expected a list of {index, sub_index} pairs");
+        }
+
+        lua_rawgeti(L, -1, 1);
+        lua_rawgeti(L, -2, 2);
+        requests[i].index = (uint16)lua_tointeger(L, -2);
+        requests[i].sub_index = (uint8)lua_tointeger(L, -1);
+        lua_pop(L, 3);
+    }
+
+    limit_node_id((uint8*)&node_id);
+
+    if (true == show_output)
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    sdo_read_parallel(disp_mode, (uint8)node_id, requests, count);
+
+    lua_createtable(L, count, 0);
+    for (i = 0; i < count; i += 1)
+    {
+        uint32 result = 0;
+
+        switch (requests[i].sdo_state)
+        {
+            case IS_READ_EXPEDITED:
+                os_memcpy(&result, &requests[i].response.data, sizeof(uint32));
+                lua_pushinteger(L, result);
+                break;
+            case IS_READ_SEGMENTED:
+                lua_pushstring(L, (const char*)requests[i].response.data);
+                break;
+            default:
+                lua_pushboolean(L, 0);
+                break;
+        }
+        lua_rawseti(L, -2, i + 1);
+    }
+
+    os_free(requests);
+    return 1;
+}
+
 int lua_dict_lookup(lua_State* L)
 {
     int index = luaL_checkinteger(L, 1);
@@ -251,6 +603,39 @@ void lua_register_sdo_commands(core_t* core)
     lua_pushcfunction(core->L, lua_sdo_write_string);
     lua_setglobal(core->L, "sdo_write_string");
 
+    lua_pushcfunction(core->L, lua_sdo_transfer_read);
+    lua_setglobal(core->L, "sdo_transfer_read");
+
+    lua_pushcfunction(core->L, lua_sdo_transfer_write);
+    lua_setglobal(core->L, "sdo_transfer_write");
+
+    lua_pushcfunction(core->L, lua_sdo_discover_channels);
+    lua_setglobal(core->L, "sdo_discover_channels");
+
+    lua_pushcfunction(core->L, lua_sdo_set_channel);
+    lua_setglobal(core->L, "sdo_set_channel");
+
+    lua_pushcfunction(core->L, lua_sdo_set_usdo);
+    lua_setglobal(core->L, "sdo_set_usdo");
+
+    lua_pushcfunction(core->L, lua_sdo_enable_cache);
+    lua_setglobal(core->L, "sdo_enable_cache");
+
+    lua_pushcfunction(core->L, lua_sdo_invalidate_cache);
+    lua_setglobal(core->L, "sdo_invalidate_cache");
+
+    lua_pushcfunction(core->L, lua_sdo_get_stats);
+    lua_setglobal(core->L, "sdo_get_stats");
+
+    lua_pushcfunction(core->L, lua_sdo_reset_stats);
+    lua_setglobal(core->L, "sdo_reset_stats");
+
+    lua_pushcfunction(core->L, lua_sdo_export_stats);
+    lua_setglobal(core->L, "sdo_export_stats");
+
+    lua_pushcfunction(core->L, lua_sdo_read_parallel);
+    lua_setglobal(core->L, "sdo_read_parallel");
+
     lua_pushcfunction(core->L, lua_dict_lookup);
     lua_setglobal(core->L, "dict_lookup");
 }
@@ -18,6 +18,17 @@ int lua_sdo_read(lua_State* L);
 int lua_sdo_write(lua_State* L);
 int lua_sdo_write_file(lua_State* L);
 int lua_sdo_write_string(lua_State* L);
+int lua_sdo_transfer_read(lua_State* L);
+int lua_sdo_transfer_write(lua_State* L);
+int lua_sdo_discover_channels(lua_State* L);
+int lua_sdo_set_channel(lua_State* L);
+int lua_sdo_set_usdo(lua_State* L);
+int lua_sdo_enable_cache(lua_State* L);
+int lua_sdo_invalidate_cache(lua_State* L);
+int lua_sdo_get_stats(lua_State* L);
+int lua_sdo_reset_stats(lua_State* L);
+int lua_sdo_export_stats(lua_State* L);
+int lua_sdo_read_parallel(lua_State* L);
 int lua_dict_lookup(lua_State* L);
 void lua_register_sdo_commands(core_t* core);
 
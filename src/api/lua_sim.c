@@ -0,0 +1,56 @@
+/** @file lua_sim.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "lua_sim.h"
+#include "core.h"
+#include "lauxlib.h"
+#include "lua.h"
+#include "os.h"
+#include "sim.h"
+
+int lua_sim_add_nodes(lua_State* L)
+{
+    int node_id = luaL_checkinteger(L, 1);
+    int count = (int)luaL_optinteger(L, 2, 1);
+    const char* file_name = luaL_optstring(L, 3, NULL);
+
+    if ((node_id < 0x01) || (node_id > 0x7f) || (count < 1) || (count > 0x7f))
+    {
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    if (ALL_OK == sim_add_nodes((uint8)node_id, (uint8)count, file_name))
+    {
+        lua_pushboolean(L, 1);
+    }
+    else
+    {
+        lua_pushboolean(L, 0);
+    }
+
+    return 1;
+}
+
+int lua_sim_stop(lua_State* L)
+{
+    (void)L;
+
+    sim_stop();
+    return 0;
+}
+
+void lua_register_sim_commands(core_t* core)
+{
+    lua_pushcfunction(core->L, lua_sim_add_nodes);
+    lua_setglobal(core->L, "sim_add_nodes");
+
+    lua_pushcfunction(core->L, lua_sim_stop);
+    lua_setglobal(core->L, "sim_stop");
+}
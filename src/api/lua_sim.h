@@ -0,0 +1,20 @@
+/** @file lua_sim.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef LUA_SIM_H
+#define LUA_SIM_H
+
+#include "core.h"
+#include "lua.h"
+
+int lua_sim_add_nodes(lua_State* L);
+int lua_sim_stop(lua_State* L);
+void lua_register_sim_commands(core_t* core);
+
+#endif /* LUA_SIM_H */
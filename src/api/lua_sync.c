@@ -0,0 +1,112 @@
+/** @file lua_sync.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "lua_sync.h"
+#include "core.h"
+#include "lauxlib.h"
+#include "lua.h"
+#include "os.h"
+#include "sync.h"
+
+int lua_sync_start(lua_State* L)
+{
+    int period_us = luaL_checkinteger(L, 1);
+    int counter_overflow = luaL_optinteger(L, 2, 0);
+    int cob_id = luaL_optinteger(L, 3, SYNC_DEFAULT_COB_ID);
+
+    if ((period_us < 0) || (counter_overflow < 0) || (counter_overflow > 0xff) || (cob_id < 0))
+    {
+        lua_pushboolean(L, 0);
+        return 1;
+    }
+
+    lua_pushboolean(L, (ALL_OK == sync_start((uint32)period_us, (uint8)counter_overflow, (uint16)cob_id)));
+    return 1;
+}
+
+int lua_sync_stop(lua_State* L)
+{
+    (void)L;
+
+    sync_stop();
+    return 0;
+}
+
+int lua_sync_add_rpdo(lua_State* L)
+{
+    int can_id = luaL_checkinteger(L, 1);
+    int length = luaL_checkinteger(L, 2);
+    uint64 data = lua_tointeger(L, 3);
+
+    lua_pushboolean(L, (ALL_OK == sync_add_rpdo((uint16)can_id, (uint8)length, data)));
+    return 1;
+}
+
+int lua_sync_del_rpdo(lua_State* L)
+{
+    int can_id = luaL_checkinteger(L, 1);
+
+    lua_pushboolean(L, (ALL_OK == sync_del_rpdo((uint16)can_id)));
+    return 1;
+}
+
+int lua_sync_get_stats(lua_State* L)
+{
+    int node_id = luaL_optinteger(L, 1, 0);
+    sync_stats_t stats;
+
+    if (ALL_OK != sync_get_stats((uint8)node_id, &stats))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+
+    lua_newtable(L);
+    lua_pushinteger(L, stats.count);
+    lua_setfield(L, -2, "count");
+    lua_pushinteger(L, stats.missed);
+    lua_setfield(L, -2, "missed");
+    lua_pushinteger(L, (lua_Integer)(stats.jitter_min_ns / 1000u));
+    lua_setfield(L, -2, "jitter_min_us");
+    lua_pushinteger(L, (lua_Integer)((0 != stats.count) ? (stats.jitter_sum_ns / stats.count / 1000u) : 0));
+    lua_setfield(L, -2, "jitter_avg_us");
+    lua_pushinteger(L, (lua_Integer)(stats.jitter_max_ns / 1000u));
+    lua_setfield(L, -2, "jitter_max_us");
+
+    return 1;
+}
+
+int lua_sync_reset_stats(lua_State* L)
+{
+    (void)L;
+
+    sync_reset_stats();
+    return 0;
+}
+
+void lua_register_sync_commands(core_t* core)
+{
+    lua_pushcfunction(core->L, lua_sync_start);
+    lua_setglobal(core->L, "sync_start");
+
+    lua_pushcfunction(core->L, lua_sync_stop);
+    lua_setglobal(core->L, "sync_stop");
+
+    lua_pushcfunction(core->L, lua_sync_add_rpdo);
+    lua_setglobal(core->L, "sync_add_rpdo");
+
+    lua_pushcfunction(core->L, lua_sync_del_rpdo);
+    lua_setglobal(core->L, "sync_del_rpdo");
+
+    lua_pushcfunction(core->L, lua_sync_get_stats);
+    lua_setglobal(core->L, "sync_get_stats");
+
+    lua_pushcfunction(core->L, lua_sync_reset_stats);
+    lua_setglobal(core->L, "sync_reset_stats");
+}
@@ -0,0 +1,24 @@
+/** @file lua_sync.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef LUA_SYNC_H
+#define LUA_SYNC_H
+
+#include "core.h"
+#include "lua.h"
+
+int lua_sync_start(lua_State* L);
+int lua_sync_stop(lua_State* L);
+int lua_sync_add_rpdo(lua_State* L);
+int lua_sync_del_rpdo(lua_State* L);
+int lua_sync_get_stats(lua_State* L);
+int lua_sync_reset_stats(lua_State* L);
+void lua_register_sync_commands(core_t* core);
+
+#endif /* LUA_SYNC_H */
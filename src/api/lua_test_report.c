@@ -26,6 +26,7 @@ int lua_test_add_result(lua_State* L)
     result.error_type = lua_tostring(L, 6);
     result.error_message = lua_tostring(L, 7);
     result.call_stack = lua_tostring(L, 8);
+    result.system_out = NULL;
 
     test_add_result(&result);
 
@@ -11,6 +11,8 @@
 #include "core.h"
 #include "dict.h"
 #include "os.h"
+#include "sim.h"
+#include "vcan.h"
 #include <pocketpy.h>
 
 typedef bool (*py_CFunction)(int argc, py_Ref argv);
@@ -20,6 +22,8 @@ bool py_can_write(int argc, py_Ref argv);
 bool py_can_read(int argc, py_Ref argv);
 bool py_can_flush(int argc, py_Ref argv);
 bool py_can_set_baud_rate(int argc, py_Ref argv);
+bool py_vcan_open(int argc, py_Ref argv);
+bool py_vcan_close(int argc, py_Ref argv);
 
 void python_can_init(void)
 {
@@ -31,6 +35,8 @@ void python_can_init(void)
     py_bindfunc(mod, "can_read", py_can_read);
     py_bindfunc(mod, "can_flush", py_can_flush);
     py_bindfunc(mod, "can_set_baud_rate", py_can_set_baud_rate);
+    py_bind(mod, "vcan_open(options=None)", py_vcan_open);
+    py_bind(mod, "vcan_close()", py_vcan_close);
 }
 
 bool py_dict_lookup_raw(int argc, py_Ref argv)
@@ -210,3 +216,29 @@ bool py_can_set_baud_rate(int argc, py_Ref argv)
     can_set_baud_rate((uint8)(baud_rate_index - 1), core);
     return true;
 }
+
+bool py_vcan_open(int argc, py_Ref argv)
+{
+    const char* options = NULL;
+
+    PY_CHECK_ARGC(1);
+
+    if (false == py_isnone(py_arg(0)))
+    {
+        PY_CHECK_ARG_TYPE(0, tp_str);
+        options = py_tostr(py_arg(0));
+    }
+
+    py_newbool(py_retval(), ALL_OK == vcan_init_from_string(options));
+    return true;
+}
+
+bool py_vcan_close(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(0);
+
+    sim_stop();
+    vcan_deinit();
+    py_newnone(py_retval());
+    return true;
+}
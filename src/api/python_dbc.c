@@ -15,7 +15,10 @@
 typedef bool (*py_CFunction)(int argc, py_Ref argv);
 
 bool py_dbc_decode(int argc, py_Ref argv);
+bool py_dbc_decode_values(int argc, py_Ref argv);
+bool py_dbc_encode(int argc, py_Ref argv);
 bool py_dbc_find_id_by_name(int argc, py_Ref argv);
+bool py_dbc_find_names(int argc, py_Ref argv);
 bool py_dbc_load(int argc, py_Ref argv);
 
 void python_dbc_init(void)
@@ -23,8 +26,11 @@ void python_dbc_init(void)
     py_GlobalRef mod = py_getmodule("__main__");
 
     py_bind(mod, "dbc_decode(can_id, data=0)", py_dbc_decode);
+    py_bind(mod, "dbc_decode_values(can_id, data=0, filter=None)", py_dbc_decode_values);
+    py_bind(mod, "dbc_encode(can_id, values)", py_dbc_encode);
 
     py_bindfunc(mod, "dbc_find_id_by_name", py_dbc_find_id_by_name);
+    py_bind(mod, "dbc_find_names(search, prefix=False)", py_dbc_find_names);
     py_bindfunc(mod, "dbc_load", py_dbc_load);
 }
 
@@ -49,6 +55,130 @@ bool py_dbc_decode(int argc, py_Ref argv)
     return true;
 }
 
+bool py_dbc_decode_values(int argc, py_Ref argv)
+{
+    signal_value_t values[DBC_VALUES_MAX];
+    int can_id;
+    uint64 data;
+    const char* filter = NULL;
+    int count = 0;
+    int i;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+
+    can_id = py_toint(py_arg(0));
+    data = py_toint(py_arg(1));
+
+    if (false == py_isnone(py_arg(2)))
+    {
+        PY_CHECK_ARG_TYPE(2, tp_str);
+        filter = py_tostr(py_arg(2));
+    }
+
+    if (ALL_OK != dbc_decode_values(can_id, data, filter, values, DBC_VALUES_MAX, &count))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    /* (physical values, raw values, descriptions), keyed by signal name. */
+    py_newdict(py_r0());
+    py_newdict(py_r1());
+    py_newdict(py_r2());
+
+    for (i = 0; i < count; i += 1)
+    {
+        py_newfloat(py_r3(), values[i].value);
+        py_dict_setitem_by_str(py_r0(), values[i].signal->name, py_r3());
+        py_newint(py_r3(), (py_i64)values[i].raw);
+        py_dict_setitem_by_str(py_r1(), values[i].signal->name, py_r3());
+
+        if (NULL != values[i].description)
+        {
+            py_newstr(py_r3(), values[i].description);
+            py_dict_setitem_by_str(py_r2(), values[i].signal->name, py_r3());
+        }
+    }
+
+    py_newtuple(py_retval(), 3);
+    py_tuple_setitem(py_retval(), 0, py_r0());
+    py_tuple_setitem(py_retval(), 1, py_r1());
+    py_tuple_setitem(py_retval(), 2, py_r2());
+
+    return true;
+}
+
+bool py_dbc_encode(int argc, py_Ref argv)
+{
+    signal_value_t values[DBC_VALUES_MAX];
+    const message_t* msg;
+    int can_id;
+    uint64 data = 0;
+    uint8 length = 0;
+    int count = 0;
+    int i;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_dict);
+
+    can_id = py_toint(py_arg(0));
+    msg = dbc_get_message(can_id);
+    if (NULL == msg)
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    /* One lookup per signal of the message, not per dict entry. */
+    for (i = 0; (i < msg->signal_count) && (count < DBC_VALUES_MAX); i += 1)
+    {
+        int found = py_dict_getitem_by_str(py_arg(1), msg->signals[i].name);
+        py_f64 value;
+
+        if (found < 0)
+        {
+            return false;
+        }
+        else if (0 == found)
+        {
+            continue;
+        }
+
+        if (false == py_castfloat(py_retval(), &value))
+        {
+            return false;
+        }
+
+        values[count].signal = &msg->signals[i];
+        values[count].value = value;
+        count += 1;
+    }
+
+    if (ALL_OK != dbc_encode(can_id, values, count, &data, &length))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    /* Right-aligned, byte 0 first: as pdo_add() and pdo_update() expect. */
+    if (0 != length)
+    {
+        data = os_swap_64(data) >> (8u * (8u - length));
+    }
+
+    py_newint(py_r0(), (py_i64)data);
+    py_newint(py_r1(), length);
+
+    py_newtuple(py_retval(), 2);
+    py_tuple_setitem(py_retval(), 0, py_r0());
+    py_tuple_setitem(py_retval(), 1, py_r1());
+
+    return true;
+}
+
 bool py_dbc_find_id_by_name(int argc, py_Ref argv)
 {
     const char* search;
@@ -73,6 +203,52 @@ bool py_dbc_find_id_by_name(int argc, py_Ref argv)
     return true;
 }
 
+bool py_dbc_find_names(int argc, py_Ref argv)
+{
+    name_match_t matches[DBC_MATCHES_MAX];
+    const char* search;
+    bool is_prefix;
+    int count = 0;
+    int i;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+
+    search = py_tostr(py_arg(0));
+    is_prefix = py_tobool(py_arg(1));
+
+    if (ALL_OK != dbc_find_names(search, is_prefix, matches, DBC_MATCHES_MAX, &count))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    py_newlist(py_retval());
+
+    for (i = 0; i < count; i += 1)
+    {
+        py_newdict(py_r0());
+        py_newint(py_r1(), matches[i].message->id);
+        py_dict_setitem_by_str(py_r0(), "id", py_r1());
+        py_newstr(py_r1(), matches[i].message->name);
+        py_dict_setitem_by_str(py_r0(), "message", py_r1());
+
+        if (NULL != matches[i].signal)
+        {
+            py_newstr(py_r1(), matches[i].signal->name);
+        }
+        else
+        {
+            py_newnone(py_r1());
+        }
+        py_dict_setitem_by_str(py_r0(), "signal", py_r1());
+
+        py_list_append(py_retval(), py_r0());
+    }
+
+    return true;
+}
+
 bool py_dbc_load(int argc, py_Ref argv)
 {
     char* filename;
@@ -0,0 +1,171 @@
+/** @file python_emcy.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "core.h"
+#include "dict.h"
+#include "emcy.h"
+#include "os.h"
+#include <pocketpy.h>
+
+typedef bool (*py_CFunction)(int argc, py_Ref argv);
+
+bool py_emcy_get_node(int argc, py_Ref argv);
+bool py_emcy_get_history(int argc, py_Ref argv);
+bool py_emcy_wait(int argc, py_Ref argv);
+bool py_emcy_clear(int argc, py_Ref argv);
+
+static void new_entry(py_Ref out, const emcy_record_t* entry);
+
+void python_emcy_init(void)
+{
+    py_GlobalRef mod = py_getmodule("__main__");
+
+    py_bind(mod, "emcy_get_node(node_id)", py_emcy_get_node);
+    py_bind(mod, "emcy_get_history(node_id)", py_emcy_get_history);
+    py_bind(mod, "emcy_wait(node_id, code, timeout_ms, mask=0xffff)", py_emcy_wait);
+    py_bind(mod, "emcy_clear(node_id=0)", py_emcy_clear);
+}
+
+bool py_emcy_get_node(int argc, py_Ref argv)
+{
+    int node_id;
+    emcy_node_t node;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    node_id = py_toint(py_arg(0));
+
+    if ((node_id < 0) || (ALL_OK != emcy_get_node((uint8)node_id, &node)))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    py_newdict(py_retval());
+    py_newint(py_r0(), node.count);
+    py_dict_setitem_by_str(py_retval(), "count", py_r0());
+    py_newint(py_r0(), node.last_code);
+    py_dict_setitem_by_str(py_retval(), "code", py_r0());
+    py_newstr(py_r0(), emcy_lookup(node.last_code));
+    py_dict_setitem_by_str(py_retval(), "description", py_r0());
+    py_newint(py_r0(), node.error_register);
+    py_dict_setitem_by_str(py_retval(), "error_register", py_r0());
+    py_newint(py_r0(), (py_i64)node.first_us);
+    py_dict_setitem_by_str(py_retval(), "first_us", py_r0());
+    py_newint(py_r0(), (py_i64)node.last_us);
+    py_dict_setitem_by_str(py_retval(), "last_us", py_r0());
+    py_newfloat(py_r0(), emcy_get_rate(&node));
+    py_dict_setitem_by_str(py_retval(), "rate", py_r0());
+    py_newint(py_r0(), node.peak_per_s);
+    py_dict_setitem_by_str(py_retval(), "peak_per_s", py_r0());
+
+    return true;
+}
+
+bool py_emcy_get_history(int argc, py_Ref argv)
+{
+    emcy_record_t entries[EMCY_HISTORY_MAX];
+    int node_id;
+    uint32 count = 0;
+    uint32 i;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    node_id = py_toint(py_arg(0));
+
+    if (node_id > 0)
+    {
+        count = emcy_get_history((uint8)node_id, entries, EMCY_HISTORY_MAX);
+    }
+
+    py_newlist(py_retval());
+
+    for (i = 0; i < count; i += 1)
+    {
+        new_entry(py_r0(), &entries[i]);
+        py_list_append(py_retval(), py_r0());
+    }
+
+    return true;
+}
+
+bool py_emcy_wait(int argc, py_Ref argv)
+{
+    emcy_record_t entry;
+    int node_id;
+    int code;
+    int timeout_ms;
+    int mask;
+
+    PY_CHECK_ARGC(4);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_int);
+
+    node_id = py_toint(py_arg(0));
+    code = py_toint(py_arg(1));
+    timeout_ms = py_toint(py_arg(2));
+    mask = py_toint(py_arg(3));
+
+    if ((node_id < 0) || (timeout_ms < 0) || (ALL_OK != emcy_wait((uint8)node_id, (uint16)code, (uint16)mask, (uint32)timeout_ms, &entry)))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    new_entry(py_retval(), &entry);
+    return true;
+}
+
+bool py_emcy_clear(int argc, py_Ref argv)
+{
+    int node_id;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    node_id = py_toint(py_arg(0));
+
+    if (node_id >= 0)
+    {
+        emcy_clear((uint8)node_id);
+    }
+
+    py_newnone(py_retval());
+    return true;
+}
+
+static void new_entry(py_Ref out, const emcy_record_t* entry)
+{
+    uint64 data = 0;
+    int i;
+
+    /* Same byte order as the data of can_write(). */
+    for (i = 0; i < 5; i += 1)
+    {
+        data = (data << 8) | entry->data[i];
+    }
+
+    py_newdict(out);
+    py_newint(py_r1(), entry->node_id);
+    py_dict_setitem_by_str(out, "node_id", py_r1());
+    py_newint(py_r1(), entry->code);
+    py_dict_setitem_by_str(out, "code", py_r1());
+    py_newstr(py_r1(), emcy_lookup(entry->code));
+    py_dict_setitem_by_str(out, "description", py_r1());
+    py_newint(py_r1(), entry->error_register);
+    py_dict_setitem_by_str(out, "error_register", py_r1());
+    py_newint(py_r1(), (py_i64)data);
+    py_dict_setitem_by_str(out, "data", py_r1());
+    py_newint(py_r1(), (py_i64)entry->timestamp_us);
+    py_dict_setitem_by_str(out, "timestamp_us", py_r1());
+}
@@ -0,0 +1,15 @@
+/** @file python_emcy.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef PYTHON_EMCY_H
+#define PYTHON_EMCY_H
+
+void python_emcy_init(void);
+
+#endif /* PYTHON_EMCY_H */
@@ -0,0 +1,98 @@
+/** @file python_lss.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "core.h"
+#include "lss.h"
+#include "os.h"
+#include <pocketpy.h>
+
+typedef bool (*py_CFunction)(int argc, py_Ref argv);
+
+bool py_lss_fastscan(int argc, py_Ref argv);
+bool py_lss_assign_node_ids(int argc, py_Ref argv);
+
+static void new_identity(py_Ref out, const lss_identity_t* identity);
+
+void python_lss_init(void)
+{
+    py_GlobalRef mod = py_getmodule("__main__");
+
+    py_bind(mod, "lss_fastscan(timeout_us=1000)", py_lss_fastscan);
+    py_bind(mod, "lss_assign_node_ids(first_node_id, store=False, show_output=False)", py_lss_assign_node_ids);
+}
+
+bool py_lss_fastscan(int argc, py_Ref argv)
+{
+    lss_identity_t identity;
+    int timeout_us;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    timeout_us = py_toint(py_arg(0));
+
+    if ((timeout_us < 0) || (ALL_OK != lss_fastscan(&identity, (uint32)timeout_us)))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    new_identity(py_retval(), &identity);
+    return true;
+}
+
+bool py_lss_assign_node_ids(int argc, py_Ref argv)
+{
+    lss_assignment_t assignments[LSS_NODE_MAX];
+    disp_mode_t disp_mode = SILENT;
+    int first_node_id;
+    uint32 count = 0;
+    uint32 i;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_bool);
+    PY_CHECK_ARG_TYPE(2, tp_bool);
+
+    first_node_id = py_toint(py_arg(0));
+
+    if (true == py_tobool(py_arg(2)))
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    if ((first_node_id > 0) && (first_node_id <= LSS_NODE_MAX))
+    {
+        count = lss_assign_node_ids((uint8)first_node_id, py_tobool(py_arg(1)), assignments, LSS_NODE_MAX, disp_mode);
+    }
+
+    py_newdict(py_retval());
+
+    for (i = 0; i < count; i += 1)
+    {
+        py_newint(py_r0(), assignments[i].node_id);
+        new_identity(py_r1(), &assignments[i].identity);
+        py_dict_setitem(py_retval(), py_r0(), py_r1());
+    }
+
+    return true;
+}
+
+static void new_identity(py_Ref out, const lss_identity_t* identity)
+{
+    py_newdict(out);
+    py_newint(py_r2(), identity->vendor_id);
+    py_dict_setitem_by_str(out, "vendor_id", py_r2());
+    py_newint(py_r2(), identity->product_code);
+    py_dict_setitem_by_str(out, "product_code", py_r2());
+    py_newint(py_r2(), identity->revision);
+    py_dict_setitem_by_str(out, "revision", py_r2());
+    py_newint(py_r2(), identity->serial);
+    py_dict_setitem_by_str(out, "serial", py_r2());
+}
@@ -0,0 +1,15 @@
+/** @file python_lss.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef PYTHON_LSS_H
+#define PYTHON_LSS_H
+
+void python_lss_init(void);
+
+#endif /* PYTHON_LSS_H */
@@ -9,8 +9,10 @@
 
 #include "can.h"
 #include "core.h"
+#include "heartbeat.h"
 #include "nmt.h"
 #include "os.h"
+#include "scan.h"
 #include <pocketpy.h>
 
 typedef bool (*py_CFunction)(int argc, py_Ref argv);
@@ -18,12 +20,25 @@ typedef bool (*py_CFunction)(int argc, py_Ref argv);
 extern void nmt_print_error(const char* reason, nmt_command_t command, disp_mode_t disp_mode);
 
 bool py_nmt_send_command(int argc, py_Ref argv);
+bool py_nmt_send_command_confirmed(int argc, py_Ref argv);
+bool py_heartbeat_get_node(int argc, py_Ref argv);
+bool py_heartbeat_get_events(int argc, py_Ref argv);
+bool py_heartbeat_set_timeout(int argc, py_Ref argv);
+bool py_heartbeat_set_guarding(int argc, py_Ref argv);
+bool py_scan_network(int argc, py_Ref argv);
 
 void python_nmt_init(void)
 {
     py_GlobalRef mod = py_getmodule("__main__");
 
     py_bind(mod, "nmt_send_command(node_id, command, show_output=False, comment=\"\")", py_nmt_send_command);
+    py_bind(mod, "nmt_send_command_confirmed(node_id, command, timeout_ms, show_output=False, comment=\"\")", py_nmt_send_command_confirmed);
+    py_bind(mod, "heartbeat_get_node(node_id)", py_heartbeat_get_node);
+    py_bind(mod, "heartbeat_set_timeout(node_id, timeout_ms)", py_heartbeat_set_timeout);
+    py_bind(mod, "heartbeat_set_guarding(node_id, guard_time_ms, life_time_factor=3)", py_heartbeat_set_guarding);
+    py_bind(mod, "scan_network(show_output=False)", py_scan_network);
+
+    py_bindfunc(mod, "heartbeat_get_events", py_heartbeat_get_events);
 }
 
 bool py_nmt_send_command(int argc, py_Ref argv)
@@ -78,3 +93,243 @@ bool py_nmt_send_command(int argc, py_Ref argv)
 
     return true;
 }
+
+bool py_nmt_send_command_confirmed(int argc, py_Ref argv)
+{
+    nmt_transition_t transitions[NMT_NODE_MAX + 1];
+    status_t status;
+    disp_mode_t disp_mode = SILENT;
+    int node_id;
+    int command;
+    int timeout_ms;
+    uint8 id;
+
+    PY_CHECK_ARGC(5);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_bool);
+    PY_CHECK_ARG_TYPE(4, tp_str);
+
+    node_id = py_toint(py_arg(0));
+    command = py_toint(py_arg(1));
+    timeout_ms = py_toint(py_arg(2));
+
+    limit_node_id((uint8*)&node_id);
+
+    if (true == py_tobool(py_arg(3)))
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    if (timeout_ms < 0)
+    {
+        timeout_ms = 0;
+    }
+
+    status = nmt_send_command_confirmed(node_id, command, (uint32)timeout_ms, transitions, disp_mode, py_tostr(py_arg(4)));
+
+    py_newtuple(py_retval(), 2);
+    py_newbool(py_r0(), (ALL_OK == status));
+    py_tuple_setitem(py_retval(), 0, py_r0());
+
+    if ((ALL_OK != status) && (NMT_NOT_CONFIRMED != status))
+    {
+        py_newnone(py_r0());
+        py_tuple_setitem(py_retval(), 1, py_r0());
+        return true;
+    }
+
+    py_newdict(py_r0());
+
+    for (id = 1; id <= NMT_NODE_MAX; id += 1)
+    {
+        if (false == transitions[id].is_expected)
+        {
+            continue;
+        }
+
+        py_newint(py_r1(), id);
+        if (true == transitions[id].is_confirmed)
+        {
+            py_newint(py_r2(), transitions[id].latency_us);
+        }
+        else
+        {
+            py_newnone(py_r2());
+        }
+        py_dict_setitem(py_r0(), py_r1(), py_r2());
+    }
+
+    py_tuple_setitem(py_retval(), 1, py_r0());
+    return true;
+}
+
+bool py_heartbeat_get_node(int argc, py_Ref argv)
+{
+    int node_id;
+    heartbeat_node_t node;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    node_id = py_toint(py_arg(0));
+
+    if ((node_id < 0) || (ALL_OK != heartbeat_get_node((uint8)node_id, &node)))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    py_newdict(py_retval());
+    py_newint(py_r0(), node.state);
+    py_dict_setitem_by_str(py_retval(), "state", py_r0());
+    py_newstr(py_r0(), heartbeat_get_state_name(node.state));
+    py_dict_setitem_by_str(py_retval(), "state_name", py_r0());
+    py_newint(py_r0(), (py_i64)node.last_seen_us);
+    py_dict_setitem_by_str(py_retval(), "last_seen_us", py_r0());
+    py_newint(py_r0(), node.period_us);
+    py_dict_setitem_by_str(py_retval(), "period_us", py_r0());
+    py_newint(py_r0(), node.frames);
+    py_dict_setitem_by_str(py_retval(), "frames", py_r0());
+    py_newint(py_r0(), node.timeouts);
+    py_dict_setitem_by_str(py_retval(), "timeouts", py_r0());
+    py_newint(py_r0(), node.toggle_errors);
+    py_dict_setitem_by_str(py_retval(), "toggle_errors", py_r0());
+    py_newbool(py_r0(), node.is_timed_out);
+    py_dict_setitem_by_str(py_retval(), "is_timed_out", py_r0());
+
+    return true;
+}
+
+bool py_heartbeat_get_events(int argc, py_Ref argv)
+{
+    heartbeat_entry_t entries[HEARTBEAT_EVENT_MAX];
+    uint32 count;
+    uint32 i;
+
+    PY_CHECK_ARGC(0);
+
+    count = heartbeat_get_events(entries, HEARTBEAT_EVENT_MAX);
+
+    py_newlist(py_retval());
+
+    for (i = 0; i < count; i += 1)
+    {
+        py_newdict(py_r0());
+        py_newint(py_r1(), entries[i].node_id);
+        py_dict_setitem_by_str(py_r0(), "node_id", py_r1());
+        py_newstr(py_r1(), heartbeat_get_event_name(entries[i].event));
+        py_dict_setitem_by_str(py_r0(), "event", py_r1());
+        py_newint(py_r1(), entries[i].state);
+        py_dict_setitem_by_str(py_r0(), "state", py_r1());
+        py_newint(py_r1(), (py_i64)entries[i].timestamp_us);
+        py_dict_setitem_by_str(py_r0(), "timestamp_us", py_r1());
+        py_list_append(py_retval(), py_r0());
+    }
+
+    return true;
+}
+
+bool py_heartbeat_set_timeout(int argc, py_Ref argv)
+{
+    int node_id;
+    int timeout_ms;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+
+    node_id = py_toint(py_arg(0));
+    timeout_ms = py_toint(py_arg(1));
+
+    if ((node_id < 0) || (timeout_ms < 0))
+    {
+        py_newbool(py_retval(), false);
+        return true;
+    }
+
+    py_newbool(py_retval(), (ALL_OK == heartbeat_set_timeout((uint8)node_id, (uint32)timeout_ms)));
+    return true;
+}
+
+bool py_heartbeat_set_guarding(int argc, py_Ref argv)
+{
+    int node_id;
+    int guard_time_ms;
+    int life_time_factor;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+
+    node_id = py_toint(py_arg(0));
+    guard_time_ms = py_toint(py_arg(1));
+    life_time_factor = py_toint(py_arg(2));
+
+    if ((node_id < 0) || (guard_time_ms < 0) || (life_time_factor < 0) || (life_time_factor > 0xff))
+    {
+        py_newbool(py_retval(), false);
+        return true;
+    }
+
+    py_newbool(py_retval(), (ALL_OK == heartbeat_set_guarding((uint8)node_id, (uint32)guard_time_ms, (uint8)life_time_factor)));
+    return true;
+}
+
+bool py_scan_network(int argc, py_Ref argv)
+{
+    static const char* names[SCAN_OBJECT_COUNT] = {"device_type", "vendor_id", "product_code", "revision", "serial"};
+    scan_node_t nodes[SCAN_NODE_MAX + 1];
+    disp_mode_t disp_mode = SILENT;
+    uint8 node_id;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_bool);
+
+    if (true == py_tobool(py_arg(0)))
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    scan_network(nodes, disp_mode);
+
+    py_newdict(py_retval());
+
+    for (node_id = 1; node_id <= SCAN_NODE_MAX; node_id += 1)
+    {
+        const scan_node_t* node = &nodes[node_id];
+        int i;
+
+        if (false == node->is_present)
+        {
+            continue;
+        }
+
+        py_newdict(py_r0());
+
+        for (i = 0; i < SCAN_OBJECT_COUNT; i += 1)
+        {
+            if (true == scan_has_value(node, (scan_object_t)i))
+            {
+                py_newint(py_r1(), node->values[i]);
+                py_dict_setitem_by_str(py_r0(), names[i], py_r1());
+            }
+        }
+
+        if (0xff != node->state)
+        {
+            py_newint(py_r1(), node->state);
+            py_dict_setitem_by_str(py_r0(), "state", py_r1());
+        }
+
+        py_newbool(py_r1(), node->is_booted);
+        py_dict_setitem_by_str(py_r0(), "is_booted", py_r1());
+
+        py_newint(py_r1(), node_id);
+        py_dict_setitem(py_retval(), py_r1(), py_r0());
+    }
+
+    return true;
+}
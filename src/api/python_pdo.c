@@ -10,6 +10,7 @@
 #include "core.h"
 #include "os.h"
 #include "pdo.h"
+#include "pdo_map.h"
 #include <pocketpy.h>
 
 typedef bool (*py_CFunction)(int argc, py_Ref argv);
@@ -17,14 +18,30 @@ typedef bool (*py_CFunction)(int argc, py_Ref argv);
 extern void pdo_print_result(uint16 can_id, uint32 event_time_ms, uint64 data, bool was_successful, const char* comment);
 
 bool py_pdo_add(int argc, py_Ref argv);
+bool py_pdo_update(int argc, py_Ref argv);
 bool py_pdo_del(int argc, py_Ref argv);
+bool py_pdo_get_stats(int argc, py_Ref argv);
+bool py_pdo_reset_stats(int argc, py_Ref argv);
+bool py_pdo_map_discover(int argc, py_Ref argv);
+bool py_pdo_map_get_value(int argc, py_Ref argv);
+bool py_pdo_map_get_values(int argc, py_Ref argv);
+
+static void new_value(py_OutRef out, const pdo_map_field_t* field);
 
 void python_pdo_init(void)
 {
     py_GlobalRef mod = py_getmodule("__main__");
 
     py_bind(mod, "pdo_add(can_id, event_time_ms, length, data=0, show_output=False, comment=\"\")", py_pdo_add);
+    py_bind(mod, "pdo_update(can_id, data=0)", py_pdo_update);
     py_bind(mod, "pdo_del(can_id, show_output=False, comment=\"\")", py_pdo_del);
+    py_bind(mod, "pdo_get_stats(can_id=0)", py_pdo_get_stats);
+
+    py_bind(mod, "pdo_map_discover(node_id, show_output=False)", py_pdo_map_discover);
+    py_bind(mod, "pdo_map_get_value(node_id, index, sub_index)", py_pdo_map_get_value);
+    py_bind(mod, "pdo_map_get_values(can_id)", py_pdo_map_get_values);
+
+    py_bindfunc(mod, "pdo_reset_stats", py_pdo_reset_stats);
 }
 
 bool py_pdo_add(int argc, py_Ref argv)
@@ -70,6 +87,22 @@ bool py_pdo_add(int argc, py_Ref argv)
     return true;
 }
 
+bool py_pdo_update(int argc, py_Ref argv)
+{
+    int can_id;
+    uint64 data;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+
+    can_id = py_toint(py_arg(0));
+    data = py_toint(py_arg(1));
+
+    py_newbool(py_retval(), pdo_update(can_id, data, SILENT));
+    return true;
+}
+
 bool py_pdo_del(int argc, py_Ref argv)
 {
     int can_id;
@@ -94,3 +127,147 @@ bool py_pdo_del(int argc, py_Ref argv)
     py_newbool(py_retval(), pdo_del(can_id, disp_mode));
     return true;
 }
+
+bool py_pdo_get_stats(int argc, py_Ref argv)
+{
+    int can_id;
+    pdo_stats_t stats;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    can_id = py_toint(py_arg(0));
+
+    if (ALL_OK != pdo_get_stats((uint16)can_id, &stats))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    py_newdict(py_retval());
+    py_newint(py_r0(), stats.sent);
+    py_dict_setitem_by_str(py_retval(), "sent", py_r0());
+    py_newint(py_r0(), stats.missed);
+    py_dict_setitem_by_str(py_retval(), "missed", py_r0());
+    py_newint(py_r0(), (py_i64)(stats.jitter_min_ns / 1000u));
+    py_dict_setitem_by_str(py_retval(), "jitter_min_us", py_r0());
+    py_newint(py_r0(), (py_i64)((0 != stats.sent) ? (stats.jitter_sum_ns / stats.sent / 1000u) : 0));
+    py_dict_setitem_by_str(py_retval(), "jitter_avg_us", py_r0());
+    py_newint(py_r0(), (py_i64)(stats.jitter_max_ns / 1000u));
+    py_dict_setitem_by_str(py_retval(), "jitter_max_us", py_r0());
+
+    return true;
+}
+
+bool py_pdo_reset_stats(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(0);
+
+    pdo_reset_stats();
+    py_newnone(py_retval());
+    return true;
+}
+
+bool py_pdo_map_discover(int argc, py_Ref argv)
+{
+    int node_id;
+    disp_mode_t disp_mode = SILENT;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_bool);
+
+    node_id = py_toint(py_arg(0));
+
+    if (true == py_tobool(py_arg(1)))
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    py_newint(py_retval(), pdo_map_discover((uint8)node_id, disp_mode));
+    return true;
+}
+
+bool py_pdo_map_get_value(int argc, py_Ref argv)
+{
+    int node_id;
+    int index;
+    int sub_index;
+    pdo_map_field_t field;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+
+    node_id = py_toint(py_arg(0));
+    index = py_toint(py_arg(1));
+    sub_index = py_toint(py_arg(2));
+
+    if ((ALL_OK != pdo_map_get_field((uint8)node_id, (uint16)index, (uint8)sub_index, &field)) || (false == field.is_valid))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    new_value(py_retval(), &field);
+    return true;
+}
+
+bool py_pdo_map_get_values(int argc, py_Ref argv)
+{
+    int can_id;
+    pdo_map_field_t fields[PDO_MAP_FIELD_MAX];
+    uint32 count;
+    uint32 i;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    can_id = py_toint(py_arg(0));
+
+    count = pdo_map_get_fields((uint16)can_id, fields, PDO_MAP_FIELD_MAX);
+    if (0 == count)
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    py_newlist(py_retval());
+    for (i = 0; i < count; i += 1)
+    {
+        py_newdict(py_r1());
+        py_newint(py_r0(), fields[i].index);
+        py_dict_setitem_by_str(py_r1(), "index", py_r0());
+        py_newint(py_r0(), fields[i].sub_index);
+        py_dict_setitem_by_str(py_r1(), "sub_index", py_r0());
+        py_newstr(py_r0(), fields[i].name);
+        py_dict_setitem_by_str(py_r1(), "name", py_r0());
+
+        if (true == fields[i].is_valid)
+        {
+            new_value(py_r0(), &fields[i]);
+        }
+        else
+        {
+            py_newnone(py_r0());
+        }
+        py_dict_setitem_by_str(py_r1(), "value", py_r0());
+
+        py_list_append(py_retval(), py_r1());
+    }
+
+    return true;
+}
+
+static void new_value(py_OutRef out, const pdo_map_field_t* field)
+{
+    if ((REAL32 == field->data_type) || (REAL64 == field->data_type) || (FLOAT_T == field->data_type))
+    {
+        py_newfloat(out, pdo_map_to_number(field));
+    }
+    else
+    {
+        py_newint(out, (py_i64)field->value);
+    }
+}
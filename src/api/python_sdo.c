@@ -12,6 +12,8 @@
 #include "os.h"
 #include <pocketpy.h>
 #include "sdo.h"
+#include "sdo_cache.h"
+#include "sdo_stats.h"
 
 typedef bool (*py_CFunction)(int argc, py_Ref argv);
 
@@ -22,17 +24,40 @@ bool py_sdo_read(int argc, py_Ref argv);
 bool py_sdo_write(int argc, py_Ref argv);
 bool py_sdo_write_file(int argc, py_Ref argv);
 bool py_sdo_write_string(int argc, py_Ref argv);
+bool py_sdo_transfer_read(int argc, py_Ref argv);
+bool py_sdo_transfer_write(int argc, py_Ref argv);
+bool py_sdo_discover_channels(int argc, py_Ref argv);
+bool py_sdo_set_channel(int argc, py_Ref argv);
+bool py_sdo_set_usdo(int argc, py_Ref argv);
+bool py_sdo_enable_cache(int argc, py_Ref argv);
+bool py_sdo_invalidate_cache(int argc, py_Ref argv);
+bool py_sdo_get_stats(int argc, py_Ref argv);
+bool py_sdo_reset_stats(int argc, py_Ref argv);
+bool py_sdo_export_stats(int argc, py_Ref argv);
+bool py_sdo_read_parallel(int argc, py_Ref argv);
 bool py_dict_lookup(int argc, py_Ref argv);
 
 void python_sdo_init(void)
 {
     py_GlobalRef mod = py_getmodule("__main__");
 
-    py_bind(mod, "sdo_read(node_id, index, sub_index, show_output=False, comment=\"\")", py_sdo_read);
+    py_bind(mod, "sdo_read(node_id, index, sub_index, show_output=False, comment=\"\", bypass_cache=False)", py_sdo_read);
     py_bind(mod, "sdo_write(node_id, index, sub_index, length, data=0, show_output=False, comment=\"\")", py_sdo_write);
     py_bind(mod, "sdo_write_string(node_id, index, sub_index, data=\"\", show_output=False, comment=\"\")", py_sdo_write_string);
+    py_bind(mod, "sdo_transfer_read(node_id, index, sub_index, show_output=False, comment=\"\")", py_sdo_transfer_read);
+    py_bind(mod, "sdo_transfer_write(node_id, index, sub_index, data, show_output=False, comment=\"\")", py_sdo_transfer_write);
+
+    py_bind(mod, "sdo_set_usdo(node_id, enable=True)", py_sdo_set_usdo);
+    py_bind(mod, "sdo_enable_cache(node_id, enable=True)", py_sdo_enable_cache);
+    py_bind(mod, "sdo_invalidate_cache(node_id=0)", py_sdo_invalidate_cache);
+    py_bind(mod, "sdo_export_stats(package=None)", py_sdo_export_stats);
+    py_bind(mod, "sdo_read_parallel(node_id, objects, show_output=False)", py_sdo_read_parallel);
 
     py_bindfunc(mod, "sdo_lookup_abort_code", py_sdo_lookup_abort_code);
+    py_bindfunc(mod, "sdo_discover_channels", py_sdo_discover_channels);
+    py_bindfunc(mod, "sdo_set_channel", py_sdo_set_channel);
+    py_bindfunc(mod, "sdo_get_stats", py_sdo_get_stats);
+    py_bindfunc(mod, "sdo_reset_stats", py_sdo_reset_stats);
     py_bindfunc(mod, "sdo_write_file", py_sdo_write_file);
     py_bindfunc(mod, "dict_lookup", py_dict_lookup);
 }
@@ -63,20 +88,23 @@ bool py_sdo_read(int argc, py_Ref argv)
     int sub_index;
     bool show_output;
     const char* comment;
+    bool bypass_cache;
     uint32 result;
 
-    PY_CHECK_ARGC(5);
+    PY_CHECK_ARGC(6);
     PY_CHECK_ARG_TYPE(0, tp_int);
     PY_CHECK_ARG_TYPE(1, tp_int);
     PY_CHECK_ARG_TYPE(2, tp_int);
     PY_CHECK_ARG_TYPE(3, tp_bool);
     PY_CHECK_ARG_TYPE(4, tp_str);
+    PY_CHECK_ARG_TYPE(5, tp_bool);
 
     node_id = py_toint(py_arg(0));
     index = py_toint(py_arg(1));
     sub_index = py_toint(py_arg(2));
     show_output = py_tobool(py_arg(3));
     comment = py_tostr(py_arg(4));
+    bypass_cache = py_tobool(py_arg(5));
 
     limit_node_id((uint8*)&node_id);
 
@@ -85,17 +113,31 @@ bool py_sdo_read(int argc, py_Ref argv)
         disp_mode = SCRIPT_MODE;
     }
 
-    sdo_state = sdo_read(
-        &sdo_response,
-        disp_mode,
-        (uint8)node_id,
-        (uint16)index,
-        (uint16)sub_index,
-        comment);
+    if (true == bypass_cache)
+    {
+        sdo_state = sdo_read_uncached(
+            &sdo_response,
+            disp_mode,
+            (uint8)node_id,
+            (uint16)index,
+            (uint16)sub_index,
+            comment);
+    }
+    else
+    {
+        sdo_state = sdo_read(
+            &sdo_response,
+            disp_mode,
+            (uint8)node_id,
+            (uint16)index,
+            (uint16)sub_index,
+            comment);
+    }
 
     switch (sdo_state)
     {
         case IS_READ_SEGMENTED:
+        case IS_READ_BLOCK:
             py_newstr(py_retval(), (const char*)sdo_response.data);
             break;
         case IS_READ_EXPEDITED:
@@ -286,6 +328,406 @@ bool py_sdo_write_string(int argc, py_Ref argv)
     return true;
 }
 
+bool py_sdo_transfer_read(int argc, py_Ref argv)
+{
+    can_message_t sdo_response = {0};
+    disp_mode_t disp_mode = SILENT;
+    sdo_state_t sdo_state;
+    int node_id;
+    int index;
+    int sub_index;
+    bool show_output;
+    const char* comment;
+    uint32 result;
+
+    PY_CHECK_ARGC(5);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_bool);
+    PY_CHECK_ARG_TYPE(4, tp_str);
+
+    node_id = py_toint(py_arg(0));
+    index = py_toint(py_arg(1));
+    sub_index = py_toint(py_arg(2));
+    show_output = py_tobool(py_arg(3));
+    comment = py_tostr(py_arg(4));
+
+    limit_node_id((uint8*)&node_id);
+
+    if (true == show_output)
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    sdo_state = sdo_transfer_read(
+        &sdo_response,
+        disp_mode,
+        (uint8)node_id,
+        (uint16)index,
+        (uint8)sub_index,
+        comment);
+
+    switch (sdo_state)
+    {
+        case IS_READ_SEGMENTED:
+        case IS_READ_BLOCK:
+            py_newstr(py_retval(), (const char*)sdo_response.data);
+            break;
+        case IS_READ_EXPEDITED:
+            os_memcpy(&result, &sdo_response.data, sizeof(uint32));
+            py_newint(py_retval(), result);
+            break;
+        default:
+        case ABORT_TRANSFER:
+            py_newnone(py_retval());
+            break;
+    }
+
+    return true;
+}
+
+bool py_sdo_transfer_write(int argc, py_Ref argv)
+{
+    can_message_t sdo_response = {0};
+    disp_mode_t disp_mode = SILENT;
+    sdo_state_t sdo_state;
+    int node_id;
+    int index;
+    int sub_index;
+    bool show_output;
+    const char* comment;
+    uint8 buffer[sizeof(uint64)] = {0};
+    void* data = (void*)buffer;
+    uint32 length = 0;
+
+    PY_CHECK_ARGC(6);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(4, tp_bool);
+    PY_CHECK_ARG_TYPE(5, tp_str);
+
+    node_id = py_toint(py_arg(0));
+    index = py_toint(py_arg(1));
+    sub_index = py_toint(py_arg(2));
+    show_output = py_tobool(py_arg(4));
+    comment = py_tostr(py_arg(5));
+
+    if (py_istype(py_arg(3), tp_str))
+    {
+        data = (void*)py_tostr(py_arg(3));
+        length = os_strlen((const char*)data);
+
+        if (0 == length)
+        {
+            py_newbool(py_retval(), false);
+            return true;
+        }
+    }
+    else
+    {
+        uint64 value;
+        int i;
+
+        PY_CHECK_ARG_TYPE(3, tp_int);
+        value = (uint64)py_toint(py_arg(3));
+
+        /* Length is derived from the object's data type. */
+        for (i = 0; i < sizeof(uint64); i += 1)
+        {
+            buffer[i] = (uint8)(value >> (i * 8));
+        }
+    }
+
+    limit_node_id((uint8*)&node_id);
+
+    if (true == show_output)
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    sdo_state = sdo_transfer_write(
+        &sdo_response,
+        disp_mode,
+        (uint8)node_id,
+        (uint16)index,
+        (uint8)sub_index,
+        length,
+        data,
+        comment);
+
+    switch (sdo_state)
+    {
+        case ABORT_TRANSFER:
+            py_newbool(py_retval(), false);
+            break;
+        default:
+            py_newbool(py_retval(), true);
+            break;
+    }
+
+    return true;
+}
+
+bool py_sdo_discover_channels(int argc, py_Ref argv)
+{
+    int node_id;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    node_id = py_toint(py_arg(0));
+    limit_node_id((uint8*)&node_id);
+
+    py_newint(py_retval(), sdo_discover_channels((uint8)node_id));
+    return true;
+}
+
+bool py_sdo_set_channel(int argc, py_Ref argv)
+{
+    int node_id;
+    int channel;
+    uint32 request_id;
+    uint32 response_id;
+
+    PY_CHECK_ARGC(4);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_int);
+
+    node_id = py_toint(py_arg(0));
+    channel = py_toint(py_arg(1));
+    request_id = (uint32)py_toint(py_arg(2));
+    response_id = (uint32)py_toint(py_arg(3));
+
+    limit_node_id((uint8*)&node_id);
+
+    py_newbool(py_retval(), ALL_OK == sdo_set_channel((uint8)node_id, (uint8)channel, request_id, response_id));
+    return true;
+}
+
+bool py_sdo_set_usdo(int argc, py_Ref argv)
+{
+    int node_id;
+    bool enable;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_bool);
+
+    node_id = py_toint(py_arg(0));
+    enable = py_tobool(py_arg(1));
+
+    limit_node_id((uint8*)&node_id);
+
+    sdo_set_usdo((uint8)node_id, enable);
+    py_newnone(py_retval());
+    return true;
+}
+
+bool py_sdo_enable_cache(int argc, py_Ref argv)
+{
+    int node_id;
+    bool enable;
+
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_bool);
+
+    node_id = py_toint(py_arg(0));
+    enable = py_tobool(py_arg(1));
+
+    limit_node_id((uint8*)&node_id);
+
+    sdo_cache_enable((uint8)node_id, enable);
+    py_newnone(py_retval());
+    return true;
+}
+
+bool py_sdo_invalidate_cache(int argc, py_Ref argv)
+{
+    int node_id;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    node_id = py_toint(py_arg(0));
+
+    limit_node_id((uint8*)&node_id);
+
+    sdo_cache_invalidate((uint8)node_id);
+    py_newnone(py_retval());
+    return true;
+}
+
+bool py_sdo_get_stats(int argc, py_Ref argv)
+{
+    int node_id;
+    sdo_state_t sdo_state;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    node_id = py_toint(py_arg(0));
+    limit_node_id((uint8*)&node_id);
+
+    py_newdict(py_retval());
+
+    for (sdo_state = IS_READ_EXPEDITED; sdo_state < SDO_STATS_TYPE_COUNT; sdo_state += 1)
+    {
+        sdo_stats_t stats;
+        uint32 i;
+
+        sdo_stats_get((uint8)node_id, sdo_state, &stats);
+        if (true == sdo_stats_is_empty(&stats))
+        {
+            continue;
+        }
+
+        py_newdict(py_r0());
+        py_newint(py_r1(), stats.transfers);
+        py_dict_setitem_by_str(py_r0(), "transfers", py_r1());
+        py_newint(py_r1(), stats.timeouts);
+        py_dict_setitem_by_str(py_r0(), "timeouts", py_r1());
+        py_newint(py_r1(), stats.aborts);
+        py_dict_setitem_by_str(py_r0(), "aborts", py_r1());
+        py_newint(py_r1(), stats.retries);
+        py_dict_setitem_by_str(py_r0(), "retries", py_r1());
+        py_newint(py_r1(), (py_i64)stats.bytes);
+        py_dict_setitem_by_str(py_r0(), "bytes", py_r1());
+        py_newint(py_r1(), (py_i64)sdo_stats_get_throughput(&stats));
+        py_dict_setitem_by_str(py_r0(), "bytes_per_second", py_r1());
+        py_newint(py_r1(), (py_i64)(stats.min_ns / 1000u));
+        py_dict_setitem_by_str(py_r0(), "latency_min_us", py_r1());
+        py_newint(py_r1(), (py_i64)(sdo_stats_get_percentile(&stats, 50.f) / 1000u));
+        py_dict_setitem_by_str(py_r0(), "latency_p50_us", py_r1());
+        py_newint(py_r1(), (py_i64)(sdo_stats_get_percentile(&stats, 90.f) / 1000u));
+        py_dict_setitem_by_str(py_r0(), "latency_p90_us", py_r1());
+        py_newint(py_r1(), (py_i64)(sdo_stats_get_percentile(&stats, 99.f) / 1000u));
+        py_dict_setitem_by_str(py_r0(), "latency_p99_us", py_r1());
+        py_newint(py_r1(), (py_i64)(stats.max_ns / 1000u));
+        py_dict_setitem_by_str(py_r0(), "latency_max_us", py_r1());
+
+        py_newdict(py_r1());
+        for (i = 0; (i < SDO_STATS_ABORT_MAX) && (0 != stats.abort_codes[i].count); i += 1)
+        {
+            py_newint(py_r2(), stats.abort_codes[i].abort_code);
+            py_newint(py_r3(), stats.abort_codes[i].count);
+            py_dict_setitem(py_r1(), py_r2(), py_r3());
+        }
+        py_dict_setitem_by_str(py_r0(), "abort_codes", py_r1());
+
+        py_dict_setitem_by_str(py_retval(), sdo_stats_get_type_name(sdo_state), py_r0());
+    }
+
+    return true;
+}
+
+bool py_sdo_reset_stats(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(0);
+
+    sdo_stats_reset();
+    py_newnone(py_retval());
+    return true;
+}
+
+bool py_sdo_export_stats(int argc, py_Ref argv)
+{
+    const char* package = NULL;
+
+    PY_CHECK_ARGC(1);
+
+    if (false == py_isnone(py_arg(0)))
+    {
+        PY_CHECK_ARG_TYPE(0, tp_str);
+        package = py_tostr(py_arg(0));
+    }
+
+    sdo_stats_export(package);
+    py_newnone(py_retval());
+    return true;
+}
+
+bool py_sdo_read_parallel(int argc, py_Ref argv)
+{
+    disp_mode_t disp_mode = SILENT;
+    sdo_request_t* requests;
+    int node_id;
+    int count;
+    int i;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_list);
+    PY_CHECK_ARG_TYPE(2, tp_bool);
+
+    node_id = py_toint(py_arg(0));
+    count = py_list_len(py_arg(1));
+
+    if (true == py_tobool(py_arg(2)))
+    {
+        disp_mode = SCRIPT_MODE;
+    }
+
+    py_newlist(py_retval());
+
+    if (0 == count)
+    {
+        return true;
+    }
+
+    requests = (sdo_request_t*)os_calloc(count, sizeof(sdo_request_t));
+    if (NULL == requests)
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    for (i = 0; i < count; i += 1)
+    {
+        py_Ref item = py_list_getitem(py_arg(1), i);
+
+        if ((false == py_istype(item, tp_tuple)) || (py_tuple_len(item) < 2))
+        {
+            os_free(requests);
+            return TypeError("expected a list of (index, sub_index) tuples");
+        }
+
+        requests[i].index = (uint16)py_toint(py_tuple_getitem(item, 0));
+        requests[i].sub_index = (uint8)py_toint(py_tuple_getitem(item, 1));
+    }
+
+    limit_node_id((uint8*)&node_id);
+
+    sdo_read_parallel(disp_mode, (uint8)node_id, requests, (uint32)count);
+
+    for (i = 0; i < count; i += 1)
+    {
+        uint32 result = 0;
+
+        switch (requests[i].sdo_state)
+        {
+            case IS_READ_EXPEDITED:
+                os_memcpy(&result, &requests[i].response.data, sizeof(uint32));
+                py_newint(py_r0(), result);
+                break;
+            case IS_READ_SEGMENTED:
+                py_newstr(py_r0(), (const char*)requests[i].response.data);
+                break;
+            default:
+                py_newnone(py_r0());
+                break;
+        }
+        py_list_append(py_retval(), py_r0());
+    }
+
+    os_free(requests);
+    return true;
+}
+
 bool py_dict_lookup(int argc, py_Ref argv)
 {
     int index;
@@ -0,0 +1,64 @@
+/** @file python_sim.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "core.h"
+#include "os.h"
+#include "sim.h"
+#include <pocketpy.h>
+
+typedef bool (*py_CFunction)(int argc, py_Ref argv);
+
+bool py_sim_add_nodes(int argc, py_Ref argv);
+bool py_sim_stop(int argc, py_Ref argv);
+
+void python_sim_init(void)
+{
+    py_GlobalRef mod = py_getmodule("__main__");
+
+    py_bind(mod, "sim_add_nodes(node_id, count=1, file=None)", py_sim_add_nodes);
+    py_bind(mod, "sim_stop()", py_sim_stop);
+}
+
+bool py_sim_add_nodes(int argc, py_Ref argv)
+{
+    const char* file_name = NULL;
+    int node_id;
+    int count;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+
+    node_id = py_toint(py_arg(0));
+    count = py_toint(py_arg(1));
+
+    if (false == py_isnone(py_arg(2)))
+    {
+        PY_CHECK_ARG_TYPE(2, tp_str);
+        file_name = py_tostr(py_arg(2));
+    }
+
+    if ((node_id < 0x01) || (node_id > 0x7f) || (count < 1) || (count > 0x7f))
+    {
+        py_newbool(py_retval(), false);
+        return true;
+    }
+
+    py_newbool(py_retval(), ALL_OK == sim_add_nodes((uint8)node_id, (uint8)count, file_name));
+    return true;
+}
+
+bool py_sim_stop(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(0);
+
+    sim_stop();
+    py_newnone(py_retval());
+    return true;
+}
@@ -0,0 +1,15 @@
+/** @file python_sim.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef PYTHON_SIM_H
+#define PYTHON_SIM_H
+
+void python_sim_init(void);
+
+#endif /* PYTHON_SIM_H */
@@ -0,0 +1,141 @@
+/** @file python_sync.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "core.h"
+#include "os.h"
+#include "sync.h"
+#include <pocketpy.h>
+
+typedef bool (*py_CFunction)(int argc, py_Ref argv);
+
+bool py_sync_start(int argc, py_Ref argv);
+bool py_sync_stop(int argc, py_Ref argv);
+bool py_sync_add_rpdo(int argc, py_Ref argv);
+bool py_sync_del_rpdo(int argc, py_Ref argv);
+bool py_sync_get_stats(int argc, py_Ref argv);
+bool py_sync_reset_stats(int argc, py_Ref argv);
+
+void python_sync_init(void)
+{
+    py_GlobalRef mod = py_getmodule("__main__");
+
+    py_bind(mod, "sync_start(period_us, counter_overflow=0, cob_id=0)", py_sync_start);
+    py_bind(mod, "sync_add_rpdo(can_id, length, data=0)", py_sync_add_rpdo);
+    py_bind(mod, "sync_del_rpdo(can_id)", py_sync_del_rpdo);
+    py_bind(mod, "sync_get_stats(node_id=0)", py_sync_get_stats);
+
+    py_bindfunc(mod, "sync_stop", py_sync_stop);
+    py_bindfunc(mod, "sync_reset_stats", py_sync_reset_stats);
+}
+
+bool py_sync_start(int argc, py_Ref argv)
+{
+    int period_us;
+    int counter_overflow;
+    int cob_id;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+
+    period_us = py_toint(py_arg(0));
+    counter_overflow = py_toint(py_arg(1));
+    cob_id = py_toint(py_arg(2));
+
+    if ((period_us < 0) || (counter_overflow < 0) || (counter_overflow > 0xff) || (cob_id < 0))
+    {
+        py_newbool(py_retval(), false);
+        return true;
+    }
+
+    py_newbool(py_retval(), (ALL_OK == sync_start((uint32)period_us, (uint8)counter_overflow, (uint16)cob_id)));
+    return true;
+}
+
+bool py_sync_stop(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(0);
+
+    sync_stop();
+    py_newnone(py_retval());
+    return true;
+}
+
+bool py_sync_add_rpdo(int argc, py_Ref argv)
+{
+    int can_id;
+    int length;
+    uint64 data;
+
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+
+    can_id = py_toint(py_arg(0));
+    length = py_toint(py_arg(1));
+    data = py_toint(py_arg(2));
+
+    py_newbool(py_retval(), (ALL_OK == sync_add_rpdo((uint16)can_id, (uint8)length, data)));
+    return true;
+}
+
+bool py_sync_del_rpdo(int argc, py_Ref argv)
+{
+    int can_id;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    can_id = py_toint(py_arg(0));
+
+    py_newbool(py_retval(), (ALL_OK == sync_del_rpdo((uint16)can_id)));
+    return true;
+}
+
+bool py_sync_get_stats(int argc, py_Ref argv)
+{
+    int node_id;
+    sync_stats_t stats;
+
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+
+    node_id = py_toint(py_arg(0));
+
+    if ((node_id < 0) || (ALL_OK != sync_get_stats((uint8)node_id, &stats)))
+    {
+        py_newnone(py_retval());
+        return true;
+    }
+
+    py_newdict(py_retval());
+    py_newint(py_r0(), stats.count);
+    py_dict_setitem_by_str(py_retval(), "count", py_r0());
+    py_newint(py_r0(), stats.missed);
+    py_dict_setitem_by_str(py_retval(), "missed", py_r0());
+    py_newint(py_r0(), (py_i64)(stats.jitter_min_ns / 1000u));
+    py_dict_setitem_by_str(py_retval(), "jitter_min_us", py_r0());
+    py_newint(py_r0(), (py_i64)((0 != stats.count) ? (stats.jitter_sum_ns / stats.count / 1000u) : 0));
+    py_dict_setitem_by_str(py_retval(), "jitter_avg_us", py_r0());
+    py_newint(py_r0(), (py_i64)(stats.jitter_max_ns / 1000u));
+    py_dict_setitem_by_str(py_retval(), "jitter_max_us", py_r0());
+
+    return true;
+}
+
+bool py_sync_reset_stats(int argc, py_Ref argv)
+{
+    PY_CHECK_ARGC(0);
+
+    sync_reset_stats();
+    py_newnone(py_retval());
+    return true;
+}
@@ -0,0 +1,15 @@
+/** @file python_sync.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef PYTHON_SYNC_H
+#define PYTHON_SYNC_H
+
+void python_sync_init(void);
+
+#endif /* PYTHON_SYNC_H */
@@ -0,0 +1,23 @@
+/** @file bcm.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef BCM_H
+#define BCM_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+#define BCM_JOB_MAX 1024
+
+status_t bcm_tx_setup(const char* interface, const can_message_t* message, uint32 interval_us);
+status_t bcm_tx_delete(uint32 id);
+void bcm_close(void);
+
+#endif /* BCM_H */
@@ -0,0 +1,262 @@
+/** @file bcm_linux.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <linux/can.h>
+#include <linux/can/bcm.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "bcm.h"
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+typedef struct bcm_job
+{
+    uint32 id;
+    uint32 interval_us;
+    uint8 length;
+    uint8 data[CAN_MAX_DLEN];
+
+} bcm_job_t;
+
+typedef struct bcm_msg
+{
+    struct bcm_msg_head head;
+    struct can_frame frame;
+
+} bcm_msg_t;
+
+static int bcm_socket = -1;
+static unsigned int bcm_ifindex;
+static bcm_job_t jobs[BCM_JOB_MAX];
+static uint32 job_count;
+static os_mutex* lock;
+
+static status_t open_socket(const char* interface);
+static status_t send_setup(const bcm_job_t* job, bool set_timer);
+static bcm_job_t* find_job(uint32 id);
+
+status_t bcm_tx_setup(const char* interface, const can_message_t* message, uint32 interval_us)
+{
+    status_t status;
+    bcm_job_t* job;
+    bool set_timer = true;
+    bool is_new = false;
+
+    if ((NULL == interface) || (NULL == message) || (0 == interval_us) || (message->length > CAN_MAX_DLEN))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (NULL == lock)
+    {
+        lock = os_create_mutex();
+        if (NULL == lock)
+        {
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+
+    os_lock_mutex(lock);
+
+    status = open_socket(interface);
+    if (ALL_OK != status)
+    {
+        os_unlock_mutex(lock);
+        return status;
+    }
+
+    job = find_job(message->id);
+    if (NULL != job)
+    {
+        /* Same cycle: only replace the payload, the timer keeps running. */
+        set_timer = (interval_us != job->interval_us);
+    }
+    else if (job_count < BCM_JOB_MAX)
+    {
+        job = &jobs[job_count];
+        job_count += 1;
+        is_new = true;
+    }
+    else
+    {
+        os_unlock_mutex(lock);
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    job->id = message->id;
+    job->interval_us = interval_us;
+    job->length = (uint8)message->length;
+    os_memcpy(job->data, message->data, message->length);
+
+    status = send_setup(job, set_timer);
+    if ((ALL_OK != status) && (true == is_new))
+    {
+        job_count -= 1;
+        os_memcpy(job, &jobs[job_count], sizeof(bcm_job_t));
+    }
+
+    os_unlock_mutex(lock);
+    return status;
+}
+
+status_t bcm_tx_delete(uint32 id)
+{
+    bcm_msg_t msg = {0};
+    bcm_job_t* job;
+
+    if (NULL == lock)
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    os_lock_mutex(lock);
+
+    job = find_job(id);
+    if (NULL == job)
+    {
+        os_unlock_mutex(lock);
+        return ITEM_NOT_FOUND;
+    }
+
+    if (bcm_socket >= 0)
+    {
+        msg.head.opcode = TX_DELETE;
+        msg.head.can_id = (id > CAN_SFF_MASK) ? (id | CAN_EFF_FLAG) : id;
+        msg.head.nframes = 0;
+
+        if (write(bcm_socket, &msg, sizeof(msg.head)) < 0)
+        {
+            /* Nothing to do here. */
+        }
+    }
+
+    job_count -= 1;
+    os_memcpy(job, &jobs[job_count], sizeof(bcm_job_t));
+
+    os_unlock_mutex(lock);
+    return ALL_OK;
+}
+
+void bcm_close(void)
+{
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    /* Closing the socket ends all of its cyclic transmissions. */
+    if (bcm_socket >= 0)
+    {
+        close(bcm_socket);
+        bcm_socket = -1;
+    }
+
+    bcm_ifindex = 0;
+    job_count = 0;
+
+    os_unlock_mutex(lock);
+}
+
+static status_t open_socket(const char* interface)
+{
+    struct sockaddr_can addr = {0};
+    unsigned int ifindex = if_nametoindex(interface);
+    uint32 i;
+
+    if (0 == ifindex)
+    {
+        return CAN_NO_HARDWARE_FOUND;
+    }
+
+    if ((bcm_socket >= 0) && (ifindex == bcm_ifindex))
+    {
+        return ALL_OK;
+    }
+
+    if (bcm_socket >= 0)
+    {
+        close(bcm_socket);
+        bcm_socket = -1;
+    }
+
+    bcm_socket = socket(PF_CAN, SOCK_DGRAM, CAN_BCM);
+    if (bcm_socket < 0)
+    {
+        return CAN_NO_HARDWARE_FOUND;
+    }
+
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = (int)ifindex;
+
+    if (connect(bcm_socket, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        close(bcm_socket);
+        bcm_socket = -1;
+        return CAN_NO_HARDWARE_FOUND;
+    }
+
+    bcm_ifindex = ifindex;
+
+    /* The interface changed: move the running jobs over. */
+    for (i = 0; i < job_count; i += 1)
+    {
+        send_setup(&jobs[i], true);
+    }
+
+    return ALL_OK;
+}
+
+static status_t send_setup(const bcm_job_t* job, bool set_timer)
+{
+    bcm_msg_t msg = {0};
+    canid_t can_id = (job->id > CAN_SFF_MASK) ? (job->id | CAN_EFF_FLAG) : job->id;
+
+    msg.head.opcode = TX_SETUP;
+    msg.head.can_id = can_id;
+    msg.head.nframes = 1;
+
+    if (true == set_timer)
+    {
+        msg.head.flags = SETTIMER | STARTTIMER;
+        msg.head.count = 0;
+        msg.head.ival2.tv_sec = job->interval_us / 1000000u;
+        msg.head.ival2.tv_usec = job->interval_us % 1000000u;
+    }
+
+    msg.frame.can_id = can_id;
+    msg.frame.can_dlc = job->length;
+    os_memcpy(msg.frame.data, job->data, job->length);
+
+    if (write(bcm_socket, &msg, sizeof(msg)) < 0)
+    {
+        return CAN_WRITE_ERROR;
+    }
+
+    return ALL_OK;
+}
+
+static bcm_job_t* find_job(uint32 id)
+{
+    uint32 i;
+
+    for (i = 0; i < job_count; i += 1)
+    {
+        if (id == jobs[i].id)
+        {
+            return &jobs[i];
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,36 @@
+/** @file bcm_windows.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "bcm.h"
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+/* No kernel-side cyclic transmission: callers use their own timers. */
+
+status_t bcm_tx_setup(const char* interface, const can_message_t* message, uint32 interval_us)
+{
+    (void)interface;
+    (void)message;
+    (void)interval_us;
+
+    return CAN_NO_HARDWARE_FOUND;
+}
+
+status_t bcm_tx_delete(uint32 id)
+{
+    (void)id;
+
+    return ITEM_NOT_FOUND;
+}
+
+void bcm_close(void)
+{
+    /* Nothing to do here. */
+}
@@ -9,11 +9,19 @@
 
 #include <CANvenient.h>
 
+#include "bcm.h"
 #include "buffer.h"
 #include "can.h"
 #include "core.h"
+#include "emcy.h"
+#include "heartbeat.h"
 #include "os.h"
+#include "pdo.h"
+#include "pdo_map.h"
+#include "sdo_cache.h"
+#include "sync.h"
 #include "table.h"
+#include "vcan.h"
 
 static const char* baud_rate_desc[] = {
     "1 MBit/s",
@@ -32,6 +40,23 @@ static const char* baud_rate_desc[] = {
     "10 kBit/s",
     "5 kBit/s"};
 
+static const uint32 baud_rate_bps[] = {
+    1000000,
+    1000000,
+    800000,
+    500000,
+    250000,
+    125000,
+    100000,
+    95238,
+    83333,
+    50000,
+    47619,
+    33333,
+    20000,
+    10000,
+    5000};
+
 static uint32 pcan_channel_count;
 
 static int can_monitor(void* core);
@@ -52,7 +77,7 @@ bool is_can_initialised(core_t* core)
         return false;
     }
 
-    return core->is_can_initialised;
+    return (true == core->is_can_initialised) || (true == vcan_is_open());
 }
 
 void can_print_error(uint32 can_id, const char* reason, disp_mode_t disp_mode)
@@ -108,11 +133,24 @@ void can_deinit(core_t* core)
     core->can_status = 0;
     core->is_can_initialised = false;
 
+    /* Also ends the offloaded PDOs, pdo_rearm() restarts them. */
+    bcm_close();
     can_close(core->can_channel);
 }
 
 void can_flush(void)
 {
+    if (true == vcan_is_open())
+    {
+        can_message_t message;
+
+        while (ALL_OK == vcan_read(VCAN_HOST, &message))
+        {
+            /* Drop everything received so far. */
+        }
+        return;
+    }
+
     can_close(core->can_channel);
     can_open(core->can_channel, (enum can_baudrate)(core->baud_rate - 1));
 }
@@ -265,10 +303,16 @@ uint32 can_write(can_message_t* message, disp_mode_t disp_mode, const char* comm
     (void)disp_mode;
     (void)comment;
 
+    if (true == vcan_is_open())
+    {
+        return (ALL_OK == vcan_write(VCAN_HOST, message)) ? ALL_OK : CAN_WRITE_ERROR;
+    }
+
     frame.can_id = message->id;
     frame.can_dlc = message->length;
 
-    for (i = 0; i < 8; i++)
+    /* Up to 64 bytes if the backend supports CAN FD. */
+    for (i = 0; (i < sizeof(frame.data)) && (i < CAN_BUF_SIZE); i++)
     {
         frame.data[i] = message->data[i];
     }
@@ -283,29 +327,74 @@ uint32 can_write(can_message_t* message, disp_mode_t disp_mode, const char* comm
     }
 }
 
+status_t can_write_cyclic(const can_message_t* message, uint32 interval_us)
+{
+    if (NULL == message)
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    /* Only real hardware can hand the cycle to the kernel. */
+    if ((true == vcan_is_open()) || (NULL == core) || (false == core->is_can_initialised))
+    {
+        return CAN_NO_HARDWARE_FOUND;
+    }
+
+    return bcm_tx_setup(core->can_interface, message, interval_us);
+}
+
+status_t can_stop_cyclic(uint32 id)
+{
+    return bcm_tx_delete(id);
+}
+
 uint32 can_read(can_message_t* message)
 {
     uint32 can_status;
     u64 timestamp;
     struct can_frame frame = {0};
 
-    can_status = can_recv(core->can_channel, &frame, &timestamp);
-    if (0 == can_status)
+    if (true == vcan_is_open())
     {
-        int i;
-        message->id = frame.can_id;
-        message->length = frame.can_dlc;
-        message->timestamp_us = timestamp;
+        can_status = vcan_read(VCAN_HOST, message);
+    }
+    else
+    {
+        can_status = can_recv(core->can_channel, &frame, &timestamp);
+        if (0 == can_status)
+        {
+            int i;
+            message->id = frame.can_id;
+            message->length = frame.can_dlc;
+            message->timestamp_us = timestamp;
+
+            for (i = 0; (i < sizeof(frame.data)) && (i < CAN_BUF_SIZE); i++)
+            {
+                message->data[i] = frame.data[i];
+            }
+        }
+    }
 
-        for (i = 0; i < 8; i++)
+    if (0 == can_status)
+    {
+        /* Boot-up: the node's object dictionary is back to its defaults. */
+        if ((0x700 == (message->id & 0x780)) && (0 != (message->id & 0x7f)) && (1 == message->length) && (0 == message->data[0]))
         {
-            message->data[i] = frame.data[i];
+            sdo_cache_invalidate((uint8)(message->id & 0x7f));
         }
 
+        heartbeat_on_read(message);
+        emcy_on_read(message);
+        pdo_map_decode(message);
+        sync_on_receive(message);
+
         return ALL_OK;
     }
     else
     {
+        /* Nothing to read: under virtual time, skip to the next event. */
+        os_idle();
+
         os_memset(message, 0, sizeof(*message));
         return CAN_READ_ERROR;
     }
@@ -313,6 +402,19 @@ uint32 can_read(can_message_t* message)
 
 void can_set_baud_rate(uint8 baud_rate_index, core_t* core)
 {
+    if ((true == vcan_is_open()) && (NULL != core))
+    {
+        if ((0 == baud_rate_index) || (baud_rate_index > 14))
+        {
+            can_print_baud_rate_help(core);
+            return;
+        }
+
+        core->baud_rate = baud_rate_index;
+        vcan_set_bit_rate(baud_rate_bps[baud_rate_index]);
+        return;
+    }
+
 #ifdef _WIN32
 
     if (NULL == core)
@@ -395,10 +497,22 @@ static int can_monitor(void* core_pt)
         return 1;
     }
 
-    find_can_channel(core, CAN_BAUD_1M);
+    if (false == vcan_is_open())
+    {
+        find_can_channel(core, CAN_BAUD_1M);
+    }
 
     while (true == core->is_running)
     {
+        /* The virtual bus needs no hardware. */
+        if (true == vcan_is_open())
+        {
+            heartbeat_update(core);
+            emcy_update(core);
+            os_delay(1);
+            continue;
+        }
+
         while (false == is_can_initialised(core))
         {
             find_can_channel(core, (enum can_baudrate)(core->baud_rate - 1));
@@ -412,6 +526,9 @@ static int can_monitor(void* core_pt)
             os_log(LOG_WARNING, "CAN de-initialised: Hardware removed?");
             os_print_prompt();
         }
+
+        heartbeat_update(core);
+        emcy_update(core);
         os_delay(1);
     }
 
@@ -432,6 +549,7 @@ static void find_can_channel(core_t* core, enum can_baudrate baud)
             char name_buf[256] = {0};
 
             can_get_name(ch, name_buf, sizeof(name_buf));
+            os_strlcpy(core->can_interface, name_buf, sizeof(core->can_interface));
 
             os_print(DEFAULT_COLOR, "\r");
             os_log(LOG_SUCCESS, "CAN successfully initialised on %s with baud rate %s\n", name_buf, baud_rate_desc[(int)baud + 1]);
@@ -439,6 +557,8 @@ static void find_can_channel(core_t* core, enum can_baudrate baud)
 
             core->is_can_initialised = true;
             core->can_channel = ch;
+
+            pdo_rearm();
             break;
         }
         else
@@ -15,6 +15,7 @@
 #include "os.h"
 
 #define CAN_BUF_SIZE 0xff
+#define CAN_REMOTE_FRAME 0x40000000u /* Same bit as CAN_RTR_FLAG in the CAN-ID. */
 
 typedef struct can_message
 {
@@ -31,6 +32,8 @@ void can_flush(void);
 const char* can_get_error_message(uint32 can_status);
 void can_quit(core_t* core);
 uint32 can_write(can_message_t* message, disp_mode_t disp_mode, const char* comment);
+status_t can_write_cyclic(const can_message_t* message, uint32 interval_us);
+status_t can_stop_cyclic(uint32 id);
 uint32 can_read(can_message_t* message);
 status_t can_print_baud_rate_help(core_t* core);
 status_t can_print_channel_help(core_t* core);
@@ -0,0 +1,85 @@
+/** @file can_listener.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "can_listener.h"
+#include "can.h"
+#include "core.h"
+#include "os.h"
+#include "vcan.h"
+
+void can_listener_init(can_listener_t* listener, uint32 id, uint32 mask, vcan_handler_t handler, void* user)
+{
+    os_memset(listener, 0, sizeof(can_listener_t));
+    listener->id = id;
+    listener->mask = mask;
+    listener->handler = handler;
+    listener->user = user;
+    listener->socket = -1;
+    listener->endpoint = -1;
+}
+
+void can_listener_update(can_listener_t* listener, core_t* core)
+{
+    if (true == vcan_is_open())
+    {
+        /* Handlers run on every bus poll, no frame is ever skipped. */
+        if (listener->endpoint < 0)
+        {
+            can_close_filter_socket(listener);
+            listener->endpoint = vcan_attach(listener->handler, listener->user);
+        }
+        listener->is_polled = (listener->endpoint < 0);
+    }
+    else
+    {
+        listener->endpoint = -1;
+        listener->is_polled = false;
+
+        if ((NULL != core) && (true == core->is_can_initialised))
+        {
+            can_message_t message = {0};
+
+            if (ALL_OK == can_open_filter_socket(listener, core->can_interface))
+            {
+                while (true == can_read_filter_socket(listener, &message))
+                {
+                    listener->handler(&message, os_get_ticks(), listener->user);
+                }
+            }
+            else
+            {
+                /* No second socket: fall back to what can_read() sees. */
+                listener->is_polled = true;
+            }
+        }
+    }
+
+    listener->handler(NULL, os_get_ticks(), listener->user);
+}
+
+void can_listener_on_read(can_listener_t* listener, const can_message_t* message)
+{
+    if ((true == listener->is_polled) && (NULL != message) && (listener->id == (message->id & listener->mask)))
+    {
+        listener->handler(message, os_get_ticks(), listener->user);
+    }
+}
+
+void can_listener_close(can_listener_t* listener)
+{
+    if ((listener->endpoint >= 0) && (true == vcan_is_open()))
+    {
+        vcan_detach(listener->endpoint);
+    }
+
+    listener->endpoint = -1;
+    listener->is_polled = false;
+
+    can_close_filter_socket(listener);
+}
@@ -0,0 +1,45 @@
+/** @file can_listener.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef CAN_LISTENER_H
+#define CAN_LISTENER_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+#include "vcan.h"
+
+/* A background consumer of one range of CAN-IDs: a vcan endpoint on the
+ * virtual bus, else a second socket with a kernel filter, else whatever
+ * can_read() sees.
+ */
+typedef struct can_listener
+{
+    uint32 id;
+    uint32 mask;
+    vcan_handler_t handler;  /* Called with NULL on every bus poll. */
+    void* user;
+    int socket;
+    unsigned int ifindex;
+    int endpoint;
+    bool is_polled;
+
+} can_listener_t;
+
+void can_listener_init(can_listener_t* listener, uint32 id, uint32 mask, vcan_handler_t handler, void* user);
+void can_listener_update(can_listener_t* listener, core_t* core);
+void can_listener_on_read(can_listener_t* listener, const can_message_t* message);
+void can_listener_close(can_listener_t* listener);
+
+/* Platform specific: the second socket. */
+status_t can_open_filter_socket(can_listener_t* listener, const char* interface);
+bool can_read_filter_socket(can_listener_t* listener, can_message_t* message);
+void can_close_filter_socket(can_listener_t* listener);
+
+#endif /* CAN_LISTENER_H */
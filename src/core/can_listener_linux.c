@@ -0,0 +1,108 @@
+/** @file can_listener_linux.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <fcntl.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "can.h"
+#include "can_listener.h"
+#include "core.h"
+#include "os.h"
+
+status_t can_open_filter_socket(can_listener_t* listener, const char* interface)
+{
+    struct sockaddr_can addr = {0};
+    struct can_filter kernel_filter = {0};
+    unsigned int ifindex;
+
+    if ((NULL == listener) || (NULL == interface))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    ifindex = if_nametoindex(interface);
+    if (0 == ifindex)
+    {
+        return CAN_NO_HARDWARE_FOUND;
+    }
+
+    if ((listener->socket >= 0) && (ifindex == listener->ifindex))
+    {
+        return ALL_OK;
+    }
+
+    can_close_filter_socket(listener);
+
+    listener->socket = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (listener->socket < 0)
+    {
+        return CAN_NO_HARDWARE_FOUND;
+    }
+
+    /* Standard data frames only; the kernel queues them until the next update. */
+    kernel_filter.can_id = listener->id;
+    kernel_filter.can_mask = CAN_EFF_FLAG | CAN_RTR_FLAG | listener->mask;
+    setsockopt(listener->socket, SOL_CAN_RAW, CAN_RAW_FILTER, &kernel_filter, sizeof(kernel_filter));
+    fcntl(listener->socket, F_SETFL, fcntl(listener->socket, F_GETFL, 0) | O_NONBLOCK);
+
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = (int)ifindex;
+
+    if (bind(listener->socket, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        can_close_filter_socket(listener);
+        return CAN_NO_HARDWARE_FOUND;
+    }
+
+    listener->ifindex = ifindex;
+
+    return ALL_OK;
+}
+
+bool can_read_filter_socket(can_listener_t* listener, can_message_t* message)
+{
+    struct can_frame frame = {0};
+
+    if ((NULL == listener) || (listener->socket < 0) || (NULL == message))
+    {
+        return false;
+    }
+
+    if (read(listener->socket, &frame, sizeof(frame)) != (ssize_t)sizeof(frame))
+    {
+        return false;
+    }
+
+    os_memset(message, 0, sizeof(can_message_t));
+    message->id = frame.can_id & CAN_SFF_MASK;
+    message->length = frame.can_dlc;
+    os_memcpy(message->data, frame.data, frame.can_dlc);
+
+    return true;
+}
+
+void can_close_filter_socket(can_listener_t* listener)
+{
+    if (NULL == listener)
+    {
+        return;
+    }
+
+    if (listener->socket >= 0)
+    {
+        close(listener->socket);
+        listener->socket = -1;
+    }
+
+    listener->ifindex = 0;
+}
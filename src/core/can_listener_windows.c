@@ -0,0 +1,36 @@
+/** @file can_listener_windows.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "can.h"
+#include "can_listener.h"
+#include "core.h"
+#include "os.h"
+
+/* PCAN has a single receive queue: filtered frames are taken from can_read(). */
+
+status_t can_open_filter_socket(can_listener_t* listener, const char* interface)
+{
+    (void)listener;
+    (void)interface;
+
+    return CAN_NO_HARDWARE_FOUND;
+}
+
+bool can_read_filter_socket(can_listener_t* listener, can_message_t* message)
+{
+    (void)listener;
+    (void)message;
+
+    return false;
+}
+
+void can_close_filter_socket(can_listener_t* listener)
+{
+    (void)listener;
+}
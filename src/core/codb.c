@@ -341,7 +341,7 @@ void codb_info_lookup(codb_t* db, uint16 index, uint8 sub_index, object_info_t*
 
                         if (sub_access_type_type != NULL)
                         {
-                            info->access_type = (bool)sub_access_type_type->valueint;
+                            info->access_type = (acc_type_t)sub_access_type_type->valueint;
                         }
                     }
 
@@ -14,11 +14,16 @@
 #include "core.h"
 #include "dict.h"
 #include "eds.h"
+#include "emcy.h"
+#include "heartbeat.h"
+#include "lss.h"
 #include "nmt.h"
 #include "os.h"
 #include "pdo.h"
+#include "scan.h"
 #include "scripts.h"
 #include "sdo.h"
+#include "sdo_stats.h"
 #include "table.h"
 
 static void convert_token_to_uint(char* token, uint32* result);
@@ -113,6 +118,26 @@ void parse_command(char* input, core_t* core)
             (void)dict_lookup_object(file_no, sub_index);
         }
     }
+    else if (0 == os_strncmp(token, "e", 1))
+    {
+        uint32 node_id = 0;
+
+        token = os_strtokr_r(input_savptr, delim, &input_savptr);
+        if (NULL == token)
+        {
+            emcy_print(0);
+            return;
+        }
+        else if (0 == os_strncmp(token, "reset", 5))
+        {
+            emcy_clear(0);
+            os_log(LOG_SUCCESS, "EMCY history cleared");
+            return;
+        }
+
+        convert_token_to_uint(token, &node_id);
+        emcy_print((uint8)node_id);
+    }
     else if (0 == os_strncmp(token, "q", 1))
     {
         core->is_running = false;
@@ -121,6 +146,26 @@ void parse_command(char* input, core_t* core)
     {
         print_usage_information(true);
     }
+    else if (0 == os_strncmp(token, "m", 1))
+    {
+        uint32 node_id = 0;
+
+        token = os_strtokr_r(input_savptr, delim, &input_savptr);
+        if (NULL == token)
+        {
+            sdo_stats_print(0);
+            return;
+        }
+        else if (0 == os_strncmp(token, "reset", 5))
+        {
+            sdo_stats_reset();
+            os_log(LOG_SUCCESS, "SDO statistics cleared");
+            return;
+        }
+
+        convert_token_to_uint(token, &node_id);
+        sdo_stats_print((uint8)node_id);
+    }
     else if (0 == os_strncmp(token, "n", 1))
     {
         uint32 node_id;
@@ -130,7 +175,45 @@ void parse_command(char* input, core_t* core)
         token = os_strtokr_r(input_savptr, delim, &input_savptr);
         if (NULL == token)
         {
-            print_usage_information(false);
+            heartbeat_print();
+            return;
+        }
+        else if (0 == os_strncmp(token, "scan", 4))
+        {
+            scan_node_t nodes[SCAN_NODE_MAX + 1];
+
+            if (false == is_can_initialised(core))
+            {
+                os_log(LOG_WARNING, "Could not scan network: CAN not initialised");
+                return;
+            }
+
+            scan_network(nodes, TERM_MODE);
+            return;
+        }
+        else if (0 == os_strncmp(token, "lss", 3))
+        {
+            uint32 first_node_id = 1;
+
+            if (false == is_can_initialised(core))
+            {
+                os_log(LOG_WARNING, "Could not assign Node-IDs: CAN not initialised");
+                return;
+            }
+
+            token = os_strtokr_r(input_savptr, delim, &input_savptr);
+            if (NULL != token)
+            {
+                convert_token_to_uint(token, &first_node_id);
+            }
+
+            if ((0 == first_node_id) || (first_node_id > LSS_NODE_MAX))
+            {
+                os_log(LOG_WARNING, "Invalid Node-ID 0x%02x", first_node_id);
+                return;
+            }
+
+            lss_assign_node_ids((uint8)first_node_id, true, NULL, 0, TERM_MODE);
             return;
         }
 
@@ -304,7 +387,7 @@ void parse_command(char* input, core_t* core)
             convert_token_to_uint(token, &sub_index);
         }
 
-        sdo_read(&sdo_response, TERM_MODE, node_id, sdo_index, sub_index, NULL);
+        sdo_transfer_read(&sdo_response, TERM_MODE, node_id, sdo_index, sub_index, NULL);
     }
     else if (0 == os_strncmp(token, "w", 1))
     {
@@ -314,7 +397,6 @@ void parse_command(char* input, core_t* core)
         uint32 sub_index;
         uint32 sdo_data_length = 0;
         uint32 sdo_data = 0;
-        sdo_state_t sdo_state = IS_WRITE_EXPEDITED;
 
         token = os_strtokr_r(input_savptr, delim, &input_savptr);
         if (token == NULL)
@@ -363,7 +445,6 @@ void parse_command(char* input, core_t* core)
 
                 os_strlcpy(buffer, token, sizeof(buffer));
                 len = os_strlen(buffer);
-                sdo_state = IS_WRITE_SEGMENTED;
                 token = os_strtokr_r(NULL, delim, &input_savptr);
 
                 while (token != NULL)
@@ -385,14 +466,7 @@ void parse_command(char* input, core_t* core)
 
             if (sdo_data_length > 0)
             {
-                if (IS_WRITE_EXPEDITED == sdo_state)
-                {
-                    sdo_write(&sdo_response, TERM_MODE, node_id, sdo_index, sub_index, sdo_data_length, (void*)buffer, NULL);
-                }
-                else
-                {
-                    sdo_write_segmented(&sdo_response, TERM_MODE, node_id, sdo_index, sub_index, sdo_data_length, (void*)buffer, NULL);
-                }
+                sdo_transfer_write(&sdo_response, TERM_MODE, node_id, sdo_index, sub_index, sdo_data_length, (void*)buffer, NULL);
             }
             else
             {
@@ -469,7 +543,14 @@ status_t print_usage_information(bool show_all)
         table_print_row(" s ", "[identifier](.lua)", "Run script", &table);
     }
 
+    table_print_row(" n ", " ", "NMT state table", &table);
+    table_print_row(" n ", "scan", "Scan network", &table);
+    table_print_row(" n ", "lss (first_node_id)", "Assign Node-IDs (LSS)", &table);
     table_print_row(" n ", "[node_id] [command or alias]", "NMT command", &table);
+    table_print_row(" e ", "(node_id)", "EMCY history", &table);
+    table_print_row(" e ", "reset", "Clear EMCY history", &table);
+    table_print_row(" m ", "(node_id)", "SDO statistics", &table);
+    table_print_row(" m ", "reset", "Clear SDO statistics", &table);
     table_print_row(" r ", "[node_id] [index] (sub_index)", "Read SDO", &table);
     table_print_row(" w ", "[node_id] [index] [sub_index] [length] (data)", "Write SDO", &table);
     table_print_row(" w ", "[node_id] [index] [sub_index] [\"data\"]", "Write SDO", &table);
@@ -554,6 +635,8 @@ static void completion_add(completions_t* cenv, const char* word)
         // Empty line TAB -> suggest commands.
         os_completion_add(cenv, "b", "b", "Set baud rate");
         os_completion_add(cenv, "d", "d", "Load data base");
+        os_completion_add(cenv, "e", "e", "EMCY history");
+        os_completion_add(cenv, "m", "m", "SDO statistics");
         os_completion_add(cenv, "n", "n", "NMT command");
         os_completion_add(cenv, "q", "q", "Quit");
         os_completion_add(cenv, "r", "r", "Read SDO");
@@ -12,26 +12,42 @@
 #include "codb.h"
 #include "command.h"
 #include "dbc.h"
+#include "emcy.h"
+#include "heartbeat.h"
 #include "lua_can.h"
 #include "lua_dbc.h"
+#include "lua_emcy.h"
+#include "lua_lss.h"
 #include "lua_misc.h"
 #include "lua_nmt.h"
 #include "lua_pdo.h"
 #include "lua_sdo.h"
+#include "lua_sim.h"
+#include "lua_sync.h"
 #include "lua_test_report.h"
 #include "lua_widget.h"
 #include "nmt.h"
 #include "os.h"
+#include "pdo.h"
+#include "pdo_map.h"
 #include "python_can.h"
 #include "python_dbc.h"
+#include "python_emcy.h"
+#include "python_lss.h"
 #include "python_misc.h"
 #include "python_nmt.h"
 #include "python_pdo.h"
 #include "python_sdo.h"
+#include "python_sim.h"
+#include "python_sync.h"
 #include "python_test_report.h"
 #include "python_widget.h"
 #include "scripts.h"
+#include "sdo_cache.h"
+#include "sim.h"
+#include "sync.h"
 #include "test_report.h"
+#include "vcan.h"
 #include "version.h"
 
 status_t core_init(core_t** core, bool is_plain_mode)
@@ -76,18 +92,26 @@ status_t core_init(core_t** core, bool is_plain_mode)
     {
         lua_register_can_commands((*core));
         lua_register_dbc_commands((*core));
+        lua_register_emcy_commands((*core));
+        lua_register_lss_commands((*core));
         lua_register_misc_commands((*core));
         lua_register_nmt_command((*core));
         lua_register_pdo_commands((*core));
         lua_register_sdo_commands((*core));
+        lua_register_sim_commands((*core));
+        lua_register_sync_commands((*core));
         lua_register_test_commands((*core));
         lua_register_widget_commands((*core));
         python_can_init();
         python_dbc_init();
+        python_emcy_init();
+        python_lss_init();
         python_misc_init();
         python_nmt_init();
         python_pdo_init();
         python_sdo_init();
+        python_sim_init();
+        python_sync_init();
         python_test_init();
         python_widget_init();
     }
@@ -136,8 +160,16 @@ void core_deinit(core_t* core)
     }
 
     test_clear_results();
+    sync_stop();
+    pdo_del_all();
+    pdo_map_clear(0);
+    heartbeat_close();
+    emcy_close();
+    sim_stop();
+    vcan_deinit();
     can_quit(core);
     codb_deinit();
+    sdo_cache_deinit();
     dbc_unload();
     scripts_deinit(core);
 
@@ -11,306 +11,1468 @@
 #include "core.h"
 #include "os.h"
 
+struct dbc_filter
+{
+    char* pattern;
+    uint8* matches;  /* One bit per signal ID. */
+};
+
+#define DBC_CYCLE_TIME_PREFIX "BA_ \"GenMsgCycleTime\" BO_ "
+#define DBC_FRAME_FORMAT_PREFIX "BA_ \"VFrameFormat\" BO_ "
+#define DBC_PROTOCOL_TYPE_PREFIX "BA_ \"ProtocolType\" "
+#define DBC_FRAME_FORMAT_J1939PG 3
+#define DBC_SUFFIX_BUCKETS 0x10000u
+
 static dbc_t* dbc;
+static os_mutex* filter_lock;  /* Decoders may compile filters from any thread. */
+
+static void count_lines(char* text, size_t length, int* message_max, int* signal_max, int* value_max);
+static void parse_text(char* text, size_t length, int signal_max, int value_max);
+static void build_index(void);
+static void insert_index(uint32* index, uint32 key, uint32 key_mask, uint32 message_index);
+static message_t* find_message(uint32 can_id);
+static message_t* find_definition(uint32 id);
+static signal_t* find_signal(uint32 id, const char* name);
+static message_t* find_index(const uint32* index, uint32 key, uint32 key_mask);
+static uint32 hash_id(uint32 id);
+static const dbc_filter_t* compile_filter(const char* pattern);
+static void compile_decoder(signal_t* signal);
+static status_t build_name_index(void);
+static uint32 suffix_bucket(uint32 offset);
+static int compare_suffixes(const void* a, const void* b);
+static int compare_search(const char* folded, const char* search, size_t length);
+static void find_names(const char* search, bool is_prefix, bool is_signal_included, name_match_t* matches, int max_count, int* count);
+static void insert_match(name_match_t* matches, int max_count, int* count, const name_match_t* candidate);
+static uint64 rank_match(const name_match_t* match);
+static const message_t* find_owner(const signal_t* signal);
+static const char* get_name(uint32 name);
+static status_t build_value_tables(void);
+static int compare_value_descriptions(const void* a, const void* b);
+static long long to_integer(const signal_t* signal, uint64 raw);
+static uint64 extract_raw(const signal_decoder_t* decoder, uint64 data, uint64 swapped);
+static double to_physical(const signal_t* signal, uint64 raw);
+static uint64 to_raw(const signal_t* signal, double value);
+static void parse_message_line(char* line, message_t* message);
+static void parse_signal_line(char* line, signal_t* signal);
+static void parse_value_type_line(char* line);
+static void parse_value_line(char* line, int value_max);
+static void parse_cycle_time_line(char* line);
+static void parse_frame_format_line(char* line);
+static size_t align(size_t size);
+static bool starts_with(const char* str, const char* prefix);
+static char* trim_whitespace(char* str);
+
+const char* dbc_decode(uint32 can_id, uint64 data, const char* filter)
+{
+    static char result[4096] = {0};
+    static signal_value_t values[DBC_VALUES_MAX];
+    const message_t* msg;
+    int count = 0;
+    int pos;
+    int n;
+    int i;
+
+    if ((NULL == dbc) || (ALL_OK != dbc_decode_values(can_id, data, filter, values, DBC_VALUES_MAX, &count)))
+    {
+        return "";
+    }
+
+    msg = find_message(can_id);
+    pos = os_snprintf(result, sizeof(result), "%s (%Xh)\n", msg->name, msg->id);
+
+    for (i = 0; (i < count) && (pos > 0) && (pos < (int)sizeof(result)); ++i)
+    {
+        const signal_t* signal = values[i].signal;
+
+        if (NULL != values[i].description)
+        {
+            n = os_snprintf(result + pos, sizeof(result) - pos, "  %-36s: %f %s (%s)\n", signal->name, values[i].value, signal->unit, values[i].description);
+        }
+        else
+        {
+            n = os_snprintf(result + pos, sizeof(result) - pos, "  %-36s: %f %s\n", signal->name, values[i].value, signal->unit);
+        }
+        if (n < 0)
+        {
+            break;
+        }
+        pos += n;
+    }
+
+    result[sizeof(result) - 1] = '\0';
+    return result;
+}
+
+status_t dbc_decode_values(uint32 can_id, uint64 data, const char* filter, signal_value_t* values, int max_count, int* count)
+{
+    const dbc_filter_t* compiled = NULL;
+    const message_t* msg;
+    uint64 swapped;
+    uint64 mux_value = 0;
+    int i;
+
+    if ((NULL == values) || (NULL == count))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    *count = 0;
+
+    if (NULL == dbc)
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    msg = find_message(can_id);
+    if (NULL == msg)
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    if (NULL != filter)
+    {
+        compiled = compile_filter(filter);
+        if (NULL == compiled)
+        {
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+
+    /* Byte 0 is the most significant byte for Motorola signals. */
+    swapped = os_swap_64(data);
+
+    if (msg->mux_switch >= 0)
+    {
+        const signal_t* mux = &msg->signals[msg->mux_switch];
+
+        mux_value = (uint64)to_integer(mux, extract_raw(&mux->decoder, data, swapped));
+    }
+
+    for (i = 0; (i < msg->signal_count) && (*count < max_count); ++i)
+    {
+        const signal_t* signal = &msg->signals[i];
+        signal_value_t* value = &values[*count];
+
+        if (false == signal->decoder.is_valid)
+        {
+            continue;
+        }
+
+        /* Only the group selected by the switch is in this frame. */
+        if ((MUX_VALUE == signal->mux) && (msg->mux_switch >= 0) && ((uint64)signal->mux_value != mux_value))
+        {
+            continue;
+        }
+
+        if ((NULL != compiled) && (0 == (compiled->matches[signal->id / 8u] & (1u << (signal->id % 8u)))))
+        {
+            continue;
+        }
+
+        value->signal = signal;
+        value->raw = extract_raw(&signal->decoder, data, swapped);
+        value->value = to_physical(signal, value->raw);
+        value->description = dbc_get_value_description(signal, value->raw);
+        *count += 1;
+    }
+
+    return ALL_OK;
+}
+
+status_t dbc_encode(uint32 can_id, const signal_value_t* values, int count, uint64* data, uint8* length)
+{
+    const message_t* msg;
+    uint64 swapped = 0;
+    uint64 mux_value = 0;
+    int i;
+
+    if (((NULL == values) && (count > 0)) || (NULL == data) || (NULL == length))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    *data = 0;
+    *length = 0;
+
+    if (NULL == dbc)
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    msg = find_message(can_id);
+    if (NULL == msg)
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        const signal_t* signal = values[i].signal;
+
+        if ((signal < msg->signals) || (signal >= (msg->signals + msg->signal_count)))
+        {
+            return OS_INVALID_ARGUMENT;
+        }
+
+        if ((msg->mux_switch >= 0) && (signal == &msg->signals[msg->mux_switch]))
+        {
+            mux_value = (uint64)to_integer(signal, to_raw(signal, values[i].value));
+        }
+    }
+
+    /* Signals that are not given stay 0, as does an inactive group. */
+    for (i = 0; i < count; ++i)
+    {
+        const signal_t* signal = values[i].signal;
+        uint64 raw;
+
+        if (false == signal->decoder.is_valid)
+        {
+            continue;
+        }
+
+        if ((MUX_VALUE == signal->mux) && (msg->mux_switch >= 0) && ((uint64)signal->mux_value != mux_value))
+        {
+            continue;
+        }
+
+        raw = (to_raw(signal, values[i].value) & signal->decoder.mask) << signal->decoder.shift;
+
+        if (true == signal->decoder.is_motorola)
+        {
+            swapped |= raw;
+        }
+        else
+        {
+            *data |= raw;
+        }
+    }
+
+    *data |= os_swap_64(swapped);
+    *length = (uint8)((msg->dlc > 8) ? 8 : msg->dlc);
+
+    return ALL_OK;
+}
+
+status_t dbc_find_id_by_name(uint32* id, const char* search)
+{
+    name_match_t match;
+    int count = 0;
+
+    if ((NULL == dbc) || (NULL == search) || (NULL == id))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    find_names(search, false, false, &match, 1, &count);
+    if (0 == count)
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    *id = match.message->id;
+    return ALL_OK;
+}
+
+status_t dbc_find_names(const char* search, bool is_prefix, name_match_t* matches, int max_count, int* count)
+{
+    if ((NULL == search) || (NULL == matches) || (NULL == count))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    *count = 0;
+
+    if (NULL == dbc)
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    find_names(search, is_prefix, true, matches, max_count, count);
+    return ALL_OK;
+}
+
+const message_t* dbc_get_message(uint32 can_id)
+{
+    if (NULL == dbc)
+    {
+        return NULL;
+    }
+
+    return find_message(can_id);
+}
+
+const char* dbc_get_value_description(const signal_t* signal, uint64 raw)
+{
+    long long key;
+    int low;
+    int high;
+
+    if ((NULL == signal) || (0 == signal->value_description_count) || (VALUE_TYPE_INTEGER != signal->value_type))
+    {
+        return NULL;
+    }
+
+    key = to_integer(signal, raw);
+
+    if (0 != signal->value_span)
+    {
+        if ((key < signal->value_min) || ((key - signal->value_min) >= (long long)signal->value_span))
+        {
+            return NULL;
+        }
+
+        return signal->value_table[key - signal->value_min];
+    }
+
+    /* Sparse tables are sorted at load time. */
+    low = 0;
+    high = signal->value_description_count - 1;
+
+    while (low <= high)
+    {
+        int mid = low + ((high - low) / 2);
+        long long value = signal->value_descriptions[mid].value;
+
+        if (value == key)
+        {
+            return signal->value_descriptions[mid].description;
+        }
+        else if (value < key)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+
+    return NULL;
+}
+
+status_t dbc_load(char* filename)
+{
+    FILE_t* file;
+    char* arena;
+    char* temp;
+    long file_size;
+    size_t text_size;
+    size_t arena_size;
+    size_t offset;
+    uint32 table_size = 16;
+    int message_max = 0;
+    int signal_max = 0;
+    int value_max = 0;
+    uint32 i;
+
+    dbc_unload();
+
+    if (NULL == filter_lock)
+    {
+        filter_lock = os_create_mutex();
+        if (NULL == filter_lock)
+        {
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+
+    os_fix_path(filename);
+    file = os_fopen(filename, "rb");
+
+    if (NULL == file)
+    {
+        return OS_FILE_NOT_FOUND;
+    }
+
+    os_fseek(file, 0, SEEK_END);
+    file_size = os_ftell(file);
+    os_fseek(file, 0, SEEK_SET);
+
+    if (file_size < 0)
+    {
+        os_fclose(file);
+        return OS_FILE_READ_ERROR;
+    }
+
+    text_size = align((size_t)file_size + 1u);
+    arena = os_calloc(text_size, sizeof(char));
+    if (NULL == arena)
+    {
+        os_fclose(file);
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    if (os_fread(arena, 1, (size_t)file_size, file) != (size_t)file_size)
+    {
+        os_free(arena);
+        os_fclose(file);
+        return OS_FILE_READ_ERROR;
+    }
+    os_fclose(file);
+
+    /* First pass: split into lines and count what the arena must hold. */
+    count_lines(arena, (size_t)file_size, &message_max, &signal_max, &value_max);
+
+    /* At most half full, so probe sequences stay short. */
+    while (table_size < ((uint32)message_max * 2u))
+    {
+        table_size <<= 1;
+    }
+
+    arena_size = text_size;
+    arena_size += align(sizeof(message_t) * (size_t)message_max);
+    arena_size += align(sizeof(signal_t) * (size_t)signal_max);
+    arena_size += align(sizeof(value_description_t) * (size_t)value_max);
+    arena_size += align(sizeof(uint32) * (DBC_STD_ID_MAX + 1u));
+    arena_size += align(sizeof(uint32) * table_size) * 2u;
+
+    /* Nothing points into the text yet, so it may still move. */
+    temp = os_realloc(arena, arena_size);
+    if (NULL == temp)
+    {
+        os_free(arena);
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+    arena = temp;
+
+    os_memset(arena + text_size, 0, arena_size - text_size);
+
+    dbc = os_calloc(1, sizeof(dbc_t));
+    if (NULL == dbc)
+    {
+        os_free(arena);
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    dbc->arena = arena;
+    dbc->arena_size = arena_size;
+    dbc->ext_mask = table_size - 1u;
+
+    offset = text_size;
+    dbc->messages = (message_t*)(arena + offset);
+    offset += align(sizeof(message_t) * (size_t)message_max);
+    dbc->signals = (signal_t*)(arena + offset);
+    offset += align(sizeof(signal_t) * (size_t)signal_max);
+    dbc->value_descriptions = (value_description_t*)(arena + offset);
+    offset += align(sizeof(value_description_t) * (size_t)value_max);
+    dbc->std_index = (uint32*)(arena + offset);
+    offset += align(sizeof(uint32) * (DBC_STD_ID_MAX + 1u));
+    dbc->ext_index = (uint32*)(arena + offset);
+    offset += align(sizeof(uint32) * table_size);
+    dbc->pgn_index = (uint32*)(arena + offset);
+
+    /* Second pass: parse in place; names and units point into the text. */
+    parse_text(arena, (size_t)file_size, signal_max, value_max);
+
+    /* Value types are declared after the messages. */
+    for (i = 0; i < dbc->signal_count; ++i)
+    {
+        dbc->signals[i].id = i;
+        compile_decoder(&dbc->signals[i]);
+    }
+
+    for (i = 0; i < (uint32)dbc->message_count; ++i)
+    {
+        message_t* message = &dbc->messages[i];
+        int j;
+
+        message->mux_switch = -1;
+        for (j = 0; j < message->signal_count; ++j)
+        {
+            if ((MUX_SWITCH == message->signals[j].mux) && (message->signals[j].decoder.is_valid))
+            {
+                message->mux_switch = j;
+                break;
+            }
+        }
+    }
+
+    if ((ALL_OK != build_value_tables()) || (ALL_OK != build_name_index()))
+    {
+        dbc_unload();
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    return ALL_OK;
+}
+
+void dbc_print(void)
+{
+    int i, j;
+
+    if (NULL == dbc)
+    {
+        return;
+    }
+
+    os_printf("DBC File contains %d messages\n", dbc->message_count);
+    for (i = 0; i < dbc->message_count; ++i)
+    {
+        const message_t* msg = &dbc->messages[i];
+        os_printf("Message %d: ID=%u, Name=%s, DLC=%u, Transmitter=%s, Extended=%d, Cycle=%ums\n",
+                  i + 1, msg->id, msg->name, msg->dlc, msg->transmitter, msg->is_extended, msg->cycle_time_ms);
+        os_printf("  Contains %d signals\n", msg->signal_count);
+        for (j = 0; j < msg->signal_count; ++j)
+        {
+            const signal_t* sig = &msg->signals[j];
+            os_printf("  Signal %d: Name=%s, StartBit=%d, Length=%d, Endianness=%d, Scale=%.6f, Offset=%.2f, Min=%.2f, Max=%.2f, Unit=%s, Receiver=%s, Mux=%d/%u, Values=%d\n",
+                      j + 1, sig->name, sig->start_bit, sig->length, sig->endianness, sig->scale, sig->offset, sig->min_value, sig->max_value, sig->unit, sig->receiver, sig->mux, sig->mux_value, sig->value_description_count);
+        }
+    }
+}
+
+void dbc_unload(void)
+{
+    int i;
+
+    if (NULL == dbc)
+    {
+        return;
+    }
+
+    for (i = 0; i < dbc->filter_count; ++i)
+    {
+        os_free(dbc->filters[i]->pattern);
+        os_free(dbc->filters[i]->matches);
+        os_free(dbc->filters[i]);
+    }
+
+    os_free(dbc->filters);
+    os_free(dbc->value_tables);
+    os_free(dbc->name_offsets);
+    os_free(dbc->arena);
+    os_free(dbc);
+    dbc = NULL;
+}
+
+static void count_lines(char* text, size_t length, int* message_max, int* signal_max, int* value_max)
+{
+    char* line = text;
+    char* end = text + length;
+
+    while (line < end)
+    {
+        char* next = os_strchr(line, '\n');
+        char* trimmed;
+
+        if (NULL == next)
+        {
+            next = end;
+        }
+        *next = '\0';
+
+        /* Leading whitespace only: the second pass still needs whole lines. */
+        trimmed = line;
+        while (os_isspace((unsigned char)*trimmed))
+        {
+            trimmed++;
+        }
+
+        if (starts_with(trimmed, "BO_ "))
+        {
+            *message_max += 1;
+        }
+        else if (starts_with(trimmed, "SG_ "))
+        {
+            *signal_max += 1;
+        }
+        else if (starts_with(trimmed, "VAL_ "))
+        {
+            const char* quote;
+            int quotes = 0;
+
+            for (quote = os_strchr(trimmed, '"'); NULL != quote; quote = os_strchr(quote + 1, '"'))
+            {
+                quotes += 1;
+            }
+
+            /* Two quotes per description. */
+            *value_max += (quotes + 1) / 2;
+        }
+
+        line = next + 1;
+    }
+}
+
+static void parse_text(char* text, size_t length, int signal_max, int value_max)
+{
+    char* line = text;
+    char* end = text + length;
+    message_t* message = NULL;
+    bool is_indexed = false;
+
+    while (line < end)
+    {
+        char* next = line + os_strlen(line) + 1;
+        char* trimmed = trim_whitespace(line);
+
+        if (starts_with(trimmed, "BO_ "))
+        {
+            message = &dbc->messages[dbc->message_count];
+            message->signals = &dbc->signals[dbc->signal_count];
+            dbc->message_count += 1;
+
+            parse_message_line(trimmed, message);
+            is_indexed = false;
+        }
+        else if (starts_with(trimmed, "SG_ "))
+        {
+            if ((NULL != message) && (dbc->signal_count < (uint32)signal_max))
+            {
+                parse_signal_line(trimmed, &dbc->signals[dbc->signal_count]);
+                dbc->signal_count += 1;
+                message->signal_count += 1;
+            }
+        }
+        else if (starts_with(trimmed, "SIG_VALTYPE_ ") || starts_with(trimmed, "VAL_ ") || starts_with(trimmed, DBC_CYCLE_TIME_PREFIX) || starts_with(trimmed, DBC_FRAME_FORMAT_PREFIX))
+        {
+            /* Attributes refer to messages by ID, so they need the index. */
+            if (false == is_indexed)
+            {
+                build_index();
+                is_indexed = true;
+            }
+
+            if ('S' == trimmed[0])
+            {
+                parse_value_type_line(trimmed);
+            }
+            else if ('V' == trimmed[0])
+            {
+                parse_value_line(trimmed, value_max);
+            }
+            else if (starts_with(trimmed, DBC_CYCLE_TIME_PREFIX))
+            {
+                parse_cycle_time_line(trimmed);
+            }
+            else
+            {
+                parse_frame_format_line(trimmed);
+            }
+        }
+        else if (starts_with(trimmed, DBC_PROTOCOL_TYPE_PREFIX))
+        {
+            /* BA_ "ProtocolType" "J1939"; */
+            if (NULL != os_strstr(trimmed + os_strlen(DBC_PROTOCOL_TYPE_PREFIX), "\"J1939\""))
+            {
+                dbc->is_j1939 = true;
+                dbc->has_j1939 = true;
+            }
+        }
+
+        line = next;
+    }
+
+    if (false == is_indexed)
+    {
+        build_index();
+    }
+}
+
+static void build_index(void)
+{
+    int i;
+
+    os_memset(dbc->std_index, 0, sizeof(uint32) * (DBC_STD_ID_MAX + 1u));
+    os_memset(dbc->ext_index, 0, sizeof(uint32) * (dbc->ext_mask + 1u));
+    os_memset(dbc->pgn_index, 0, sizeof(uint32) * (dbc->ext_mask + 1u));
+
+    /* The first definition of an ID wins, as with the linear search. */
+    for (i = 0; i < dbc->message_count; ++i)
+    {
+        uint32 id = dbc->messages[i].id;
+
+        if (id <= DBC_STD_ID_MAX)
+        {
+            if (0 == dbc->std_index[id])
+            {
+                dbc->std_index[id] = (uint32)i + 1u;
+            }
+        }
+        else
+        {
+            insert_index(dbc->ext_index, id, 0xffffffff, (uint32)i);
+            insert_index(dbc->pgn_index, id & ~DBC_J1939_SA_MASK, ~DBC_J1939_SA_MASK, (uint32)i);
+        }
+    }
+}
+
+static void insert_index(uint32* index, uint32 key, uint32 key_mask, uint32 message_index)
+{
+    uint32 slot = hash_id(key) & dbc->ext_mask;
+
+    while (0 != index[slot])
+    {
+        if ((dbc->messages[index[slot] - 1u].id & key_mask) == key)
+        {
+            return;
+        }
+        slot = (slot + 1u) & dbc->ext_mask;
+    }
+
+    index[slot] = message_index + 1u;
+}
+
+static message_t* find_message(uint32 can_id)
+{
+    message_t* msg;
+
+    /* No index without a successful dbc_load(). */
+    if (NULL == dbc->std_index)
+    {
+        return NULL;
+    }
+
+    if (can_id <= DBC_STD_ID_MAX)
+    {
+        return (0 != dbc->std_index[can_id]) ? &dbc->messages[dbc->std_index[can_id] - 1u] : NULL;
+    }
+
+    msg = find_index(dbc->ext_index, can_id, 0xffffffff);
+    if ((NULL == msg) && (true == dbc->has_j1939))
+    {
+        /* J1939: the same PGN from another ECU. Other 29-bit IDs carry
+         * no source address, so they must match exactly.
+         */
+        msg = find_index(dbc->pgn_index, can_id & ~DBC_J1939_SA_MASK, ~DBC_J1939_SA_MASK);
+        if ((NULL != msg) && (false == dbc->is_j1939) && (false == msg->is_j1939))
+        {
+            msg = NULL;
+        }
+    }
+
+    return msg;
+}
+
+static message_t* find_definition(uint32 id)
+{
+    /* Exact match only: attributes name the ID as defined. */
+    if (id <= DBC_STD_ID_MAX)
+    {
+        return (0 != dbc->std_index[id]) ? &dbc->messages[dbc->std_index[id] - 1u] : NULL;
+    }
+
+    return find_index(dbc->ext_index, id, 0xffffffff);
+}
+
+static signal_t* find_signal(uint32 id, const char* name)
+{
+    message_t* message = find_definition(id);
+    int i;
+
+    if (NULL == message)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < message->signal_count; ++i)
+    {
+        if (0 == os_strcmp(message->signals[i].name, name))
+        {
+            return &message->signals[i];
+        }
+    }
+
+    return NULL;
+}
+
+static message_t* find_index(const uint32* index, uint32 key, uint32 key_mask)
+{
+    uint32 slot = hash_id(key) & dbc->ext_mask;
+
+    while (0 != index[slot])
+    {
+        message_t* msg = &dbc->messages[index[slot] - 1u];
+
+        if ((msg->id & key_mask) == key)
+        {
+            return msg;
+        }
+        slot = (slot + 1u) & dbc->ext_mask;
+    }
+
+    return NULL;
+}
+
+static uint32 hash_id(uint32 id)
+{
+    /* Fibonacci hashing; J1939 IDs differ mostly in the middle bytes. */
+    id ^= id >> 16;
+    id *= 0x9e3779b1u;
+    id ^= id >> 15;
+
+    return id;
+}
+
+static const dbc_filter_t* compile_filter(const char* pattern)
+{
+    dbc_filter_t** filters;
+    dbc_filter_t* filter;
+    int i;
+
+    /* The cache array moves when it grows; a compiled filter doesn't,
+     * so the pointer stays valid after the lock until dbc_unload().
+     */
+    os_lock_mutex(filter_lock);
+
+    for (i = 0; i < dbc->filter_count; ++i)
+    {
+        if (0 == os_strcmp(dbc->filters[i]->pattern, pattern))
+        {
+            filter = dbc->filters[i];
+            os_unlock_mutex(filter_lock);
+            return filter;
+        }
+    }
+
+    filters = os_realloc(dbc->filters, sizeof(dbc_filter_t*) * (dbc->filter_count + 1));
+    if (NULL == filters)
+    {
+        os_unlock_mutex(filter_lock);
+        return NULL;
+    }
+    dbc->filters = filters;
+
+    filter = os_calloc(1, sizeof(dbc_filter_t));
+    if (NULL == filter)
+    {
+        os_unlock_mutex(filter_lock);
+        return NULL;
+    }
+
+    filter->pattern = os_strdup(pattern);
+    filter->matches = os_calloc((dbc->signal_count / 8u) + 1u, sizeof(uint8));
+    if ((NULL == filter->pattern) || (NULL == filter->matches))
+    {
+        os_free(filter->pattern);
+        os_free(filter->matches);
+        os_free(filter);
+        os_unlock_mutex(filter_lock);
+        return NULL;
+    }
+
+    /* Same substring match as before, but only once per pattern. */
+    for (i = 0; i < dbc->message_count; ++i)
+    {
+        int j;
+
+        for (j = 0; j < dbc->messages[i].signal_count; ++j)
+        {
+            const signal_t* signal = &dbc->messages[i].signals[j];
+
+            if ((NULL != signal->name) && (NULL != os_strstr(signal->name, pattern)))
+            {
+                filter->matches[signal->id / 8u] |= (uint8)(1u << (signal->id % 8u));
+            }
+        }
+    }
+
+    dbc->filters[dbc->filter_count] = filter;
+    dbc->filter_count += 1;
+
+    os_unlock_mutex(filter_lock);
+    return filter;
+}
+
+static void compile_decoder(signal_t* signal)
+{
+    signal_decoder_t* decoder = &signal->decoder;
+    int first_bit;
+
+    os_memset(decoder, 0, sizeof(signal_decoder_t));
+
+    if ((signal->length < 1) || (signal->length > 64) || (signal->start_bit < 0) || (signal->start_bit > 63))
+    {
+        return;
+    }
+
+    decoder->mask = (64 == signal->length) ? ~0ULL : ((1ULL << signal->length) - 1u);
+
+    if (ENDIANNESS_MOTOROLA == signal->endianness)
+    {
+        /* The start bit is the MSB; count it from the top of the swapped frame. */
+        first_bit = (signal->start_bit & ~7) + (7 - (signal->start_bit & 7));
+        if ((first_bit + signal->length) > 64)
+        {
+            return;
+        }
+
+        decoder->shift = (uint8)(64 - first_bit - signal->length);
+        decoder->is_motorola = true;
+    }
+    else
+    {
+        if ((signal->start_bit + signal->length) > 64)
+        {
+            return;
+        }
+
+        decoder->shift = (uint8)signal->start_bit;
+    }
+
+    if ((true == signal->is_signed) && (VALUE_TYPE_INTEGER == signal->value_type))
+    {
+        decoder->sign_bit = 1ULL << (signal->length - 1);
+    }
+
+    decoder->is_valid = true;
+}
+
+static status_t build_name_index(void)
+{
+    uint32 name_count = (uint32)dbc->message_count + dbc->signal_count;
+    size_t text_size = 0;
+    uint32 offset = 0;
+    uint32* buckets;
+    uint32* block;
+    uint32 i;
+
+    for (i = 0; i < name_count; ++i)
+    {
+        text_size += os_strlen(get_name(i)) + 1u;
+    }
+
+    /* Offsets, marks and suffixes, then the folded text. */
+    block = os_calloc(1, (sizeof(uint32) * ((name_count * 2u) + 1u + text_size)) + text_size);
+    buckets = os_calloc(DBC_SUFFIX_BUCKETS + 1u, sizeof(uint32));
+    if ((NULL == block) || (NULL == buckets))
+    {
+        os_free(block);
+        os_free(buckets);
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    dbc->name_offsets = block;
+    dbc->name_marks = block + name_count + 1u;
+    dbc->suffixes = dbc->name_marks + name_count;
+    dbc->names = (char*)(dbc->suffixes + text_size);
+
+    for (i = 0; i < name_count; ++i)
+    {
+        const char* name = get_name(i);
+
+        dbc->name_offsets[i] = offset;
+        for (; '\0' != *name; ++name)
+        {
+            dbc->names[offset] = (char)os_tolower((unsigned char)*name);
+            offset += 1;
+        }
+        dbc->names[offset] = '\0';
+        offset += 1;
+    }
+    dbc->name_offsets[name_count] = offset;
+
+    /* Bucketed by the first two characters, so qsort() only has to
+     * order the few suffixes that share them.
+     */
+    for (i = 0; i < offset; ++i)
+    {
+        if ('\0' != dbc->names[i])
+        {
+            buckets[suffix_bucket(i) + 1u] += 1;
+        }
+    }
+
+    for (i = 0; i < DBC_SUFFIX_BUCKETS; ++i)
+    {
+        buckets[i + 1u] += buckets[i];
+    }
+    dbc->suffix_count = buckets[DBC_SUFFIX_BUCKETS];
+
+    for (i = 0; i < offset; ++i)
+    {
+        if ('\0' != dbc->names[i])
+        {
+            dbc->suffixes[buckets[suffix_bucket(i)]] = i;
+            buckets[suffix_bucket(i)] += 1;
+        }
+    }
+
+    /* Each bucket now ends where the next one started. */
+    for (i = 0; i < DBC_SUFFIX_BUCKETS; ++i)
+    {
+        uint32 first = (0 == i) ? 0 : buckets[i - 1u];
+
+        if ((buckets[i] - first) > 1u)
+        {
+            os_qsort(&dbc->suffixes[first], buckets[i] - first, sizeof(uint32), compare_suffixes);
+        }
+    }
+
+    os_free(buckets);
+    return ALL_OK;
+}
+
+static uint32 suffix_bucket(uint32 offset)
+{
+    /* The NUL of a one-character suffix is part of the key. */
+    return ((uint32)(unsigned char)dbc->names[offset] << 8) | (unsigned char)dbc->names[offset + 1u];
+}
+
+static int compare_suffixes(const void* a, const void* b)
+{
+    return os_strcmp(dbc->names + *(const uint32*)a, dbc->names + *(const uint32*)b);
+}
+
+static int compare_search(const char* folded, const char* search, size_t length)
+{
+    size_t i;
+
+    /* A suffix shorter than the search ends in NUL and sorts first. */
+    for (i = 0; i < length; ++i)
+    {
+        int a = (unsigned char)folded[i];
+        int b = os_tolower((unsigned char)search[i]);
+
+        if (a != b)
+        {
+            return a - b;
+        }
+    }
+
+    return 0;
+}
+
+static void find_names(const char* search, bool is_prefix, bool is_signal_included, name_match_t* matches, int max_count, int* count)
+{
+    size_t length = os_strlen(search);
+    uint32 first = 0;
+    uint32 last = dbc->suffix_count;
+    uint32 low;
+    uint32 high;
+    uint32 i;
+
+    if ((max_count < 1) || (NULL == dbc->suffixes))
+    {
+        return;
+    }
+
+    /* The suffixes starting with the search form one range. */
+    while (first < last)
+    {
+        uint32 mid = first + ((last - first) / 2u);
+
+        if (compare_search(dbc->names + dbc->suffixes[mid], search, length) < 0)
+        {
+            first = mid + 1u;
+        }
+        else
+        {
+            last = mid;
+        }
+    }
 
-static uint64 extract_raw_signal(uint64 can_frame, uint8 start_bit, uint8 length, endian_t endianness);
-static void parse_message_line(char* line, message_t* message);
-static void parse_signal_line(char* line, signal_t* signal);
-static bool starts_with(const char* str, const char* prefix);
-static char* str_tolower(const char* str);
-static char* trim_whitespace(char* str);
+    last = dbc->suffix_count;
+    low = first;
+    while (low < last)
+    {
+        uint32 mid = low + ((last - low) / 2u);
 
-const char* dbc_decode(uint32 can_id, uint64 data, const char* filter)
-{
-    static char result[4096] = {0};
-    int pos = 0;
-    int i;
+        if (compare_search(dbc->names + dbc->suffixes[mid], search, length) <= 0)
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            last = mid;
+        }
+    }
 
-    if (NULL == dbc)
+    dbc->name_query += 1;
+    if (0 == dbc->name_query)
     {
-        return "";
+        os_memset(dbc->name_marks, 0, sizeof(uint32) * ((uint32)dbc->message_count + dbc->signal_count));
+        dbc->name_query = 1;
     }
 
-    for (i = 0; i < dbc->message_count; ++i)
+    for (i = first; i < last; ++i)
     {
-        if (dbc->messages[i].id == can_id)
+        uint32 offset = dbc->suffixes[i];
+        uint32 name;
+        name_match_t candidate;
+
+        /* The name that holds this suffix. */
+        low = 0;
+        high = (uint32)dbc->message_count + dbc->signal_count;
+        while ((high - low) > 1u)
         {
-            message_t* msg = &dbc->messages[i];
-            int n = os_snprintf(result + pos, sizeof(result) - pos, "%s (%Xh)\n", msg->name, msg->id);
-            int j;
+            uint32 mid = low + ((high - low) / 2u);
 
-            if (n > 0)
+            if (dbc->name_offsets[mid] <= offset)
             {
-                pos += n;
+                low = mid;
             }
-
-            for (j = 0; j < msg->signal_count; ++j)
+            else
             {
-                signal_t* signal = &msg->signals[j];
-                uint64 raw_value = extract_raw_signal(data, signal->start_bit, signal->length, signal->endianness);
-                double value = (raw_value * signal->scale) + signal->offset;
-                int k;
-
-                if (filter != NULL && os_strstr(signal->name, filter) == NULL)
-                {
-                    continue;
-                }
-
-                n = os_snprintf(result + pos, sizeof(result) - pos, "  %s", signal->name);
-                if (n > 0)
-                {
-                    pos += n;
-                }
-
-                for (k = 0; k <= 35 - os_strlen(signal->name); ++k)
-                {
-                    n = os_snprintf(result + pos, sizeof(result) - pos, " ");
-                    if (n > 0)
-                    {
-                        pos += n;
-                    }
-                }
-
-                n = os_snprintf(result + pos, sizeof(result) - pos, ": %f %s\n", value, signal->unit);
-                if (n > 0)
-                {
-                    pos += n;
-                }
+                high = mid;
             }
-            result[sizeof(result) - 1] = '\0';
-            break;
         }
+        name = low;
+
+        if ((dbc->name_query == dbc->name_marks[name]) || ((false == is_signal_included) && (name >= (uint32)dbc->message_count)))
+        {
+            continue;
+        }
+        dbc->name_marks[name] = dbc->name_query;
+
+        if (0 == compare_search(dbc->names + dbc->name_offsets[name], search, length))
+        {
+            bool is_exact = ((dbc->name_offsets[name + 1u] - dbc->name_offsets[name] - 1u) == length);
+
+            candidate.match = (true == is_exact) ? MATCH_EXACT : MATCH_PREFIX;
+        }
+        else if (true == is_prefix)
+        {
+            continue;
+        }
+        else
+        {
+            candidate.match = MATCH_SUBSTRING;
+        }
+
+        if (name < (uint32)dbc->message_count)
+        {
+            candidate.message = &dbc->messages[name];
+            candidate.signal = NULL;
+        }
+        else
+        {
+            candidate.signal = &dbc->signals[name - (uint32)dbc->message_count];
+            candidate.message = find_owner(candidate.signal);
+        }
+
+        insert_match(matches, max_count, count, &candidate);
     }
+}
+
+static void insert_match(name_match_t* matches, int max_count, int* count, const name_match_t* candidate)
+{
+    uint64 rank = rank_match(candidate);
+    int i;
 
-    if (0 == pos)
+    if ((*count == max_count) && (rank >= rank_match(&matches[*count - 1])))
     {
-        return "";
+        return;
     }
 
-    return result;
+    i = (*count < max_count) ? *count : (max_count - 1);
+    if (*count < max_count)
+    {
+        *count += 1;
+    }
+
+    while ((i > 0) && (rank_match(&matches[i - 1]) > rank))
+    {
+        matches[i] = matches[i - 1];
+        i -= 1;
+    }
+
+    matches[i] = *candidate;
 }
 
-status_t dbc_find_id_by_name(uint32* id, const char* search)
+static uint64 rank_match(const name_match_t* match)
 {
-    int i;
+    uint32 name;
+    uint64 length;
 
-    if ((NULL == dbc) || (NULL == search) || (NULL == id))
+    if (NULL == match->signal)
     {
-        return OS_INVALID_ARGUMENT;
+        name = (uint32)(match->message - dbc->messages);
     }
-
-    char* lower_search = str_tolower(search);
-    if (NULL == lower_search)
+    else
     {
-        return OS_MEMORY_ALLOCATION_ERROR;
+        name = (uint32)dbc->message_count + (uint32)(match->signal - dbc->signals);
     }
 
-    for (i = 0; i < dbc->message_count; ++i)
+    length = dbc->name_offsets[name + 1u] - dbc->name_offsets[name];
+
+    /* Kind, messages before signals, length, then the order in the file. */
+    return ((uint64)match->match << 62) | (((NULL != match->signal) ? 1ULL : 0ULL) << 61) | ((length & 0x1fffffffULL) << 32) | name;
+}
+
+static const message_t* find_owner(const signal_t* signal)
+{
+    uint32 index = (uint32)(signal - dbc->signals);
+    int low = 0;
+    int high = dbc->message_count;
+
+    /* Signals are stored message by message. */
+    while ((high - low) > 1)
     {
-        char* lower_name = str_tolower(dbc->messages[i].name);
-        if (NULL == lower_name)
+        int mid = low + ((high - low) / 2);
+
+        if ((uint32)(dbc->messages[mid].signals - dbc->signals) <= index)
         {
-            os_free(lower_search);
-            return OS_MEMORY_ALLOCATION_ERROR;
+            low = mid;
         }
-
-        if (os_strstr(lower_name, lower_search) != NULL)
+        else
         {
-            *id = dbc->messages[i].id;
-            os_free(lower_name);
-            os_free(lower_search);
-            return ALL_OK;
+            high = mid;
         }
-
-        os_free(lower_name);
     }
 
-    os_free(lower_search);
-    return ITEM_NOT_FOUND;
+    return &dbc->messages[low];
 }
 
-status_t dbc_load(char* filename)
+static const char* get_name(uint32 name)
 {
-    FILE_t* file;
-    char line[1024] = {0};
-    message_t* current_message = NULL;
+    const char* str;
 
-    dbc_unload();
+    if (name < (uint32)dbc->message_count)
+    {
+        str = dbc->messages[name].name;
+    }
+    else
+    {
+        str = dbc->signals[name - (uint32)dbc->message_count].name;
+    }
 
-    if (NULL == dbc)
+    return (NULL == str) ? "" : str;
+}
+
+static status_t build_value_tables(void)
+{
+    size_t slots = 0;
+    uint32 i;
+
+    /* Dense where the values are close together, sorted otherwise. */
+    for (i = 0; i < dbc->signal_count; ++i)
     {
-        dbc = os_calloc(1, sizeof(dbc_t));
-        if (NULL == dbc)
+        signal_t* signal = &dbc->signals[i];
+        long long min;
+        long long max;
+        int j;
+
+        if (0 == signal->value_description_count)
         {
-            return OS_MEMORY_ALLOCATION_ERROR;
+            continue;
+        }
+
+        min = signal->value_descriptions[0].value;
+        max = min;
+        for (j = 1; j < signal->value_description_count; ++j)
+        {
+            long long value = signal->value_descriptions[j].value;
+
+            min = (value < min) ? value : min;
+            max = (value > max) ? value : max;
+        }
+
+        if ((max - min) < DBC_VALUE_TABLE_SPAN_MAX)
+        {
+            signal->value_min = min;
+            signal->value_span = (uint32)(max - min + 1);
+            slots += signal->value_span;
+        }
+        else
+        {
+            os_qsort(signal->value_descriptions, (size_t)signal->value_description_count, sizeof(value_description_t), compare_value_descriptions);
         }
     }
 
-    os_fix_path(filename);
-    file = os_fopen(filename, "r");
+    if (0 == slots)
+    {
+        return ALL_OK;
+    }
 
-    if (NULL == file)
+    dbc->value_tables = os_calloc(slots, sizeof(char*));
+    if (NULL == dbc->value_tables)
     {
-        return OS_FILE_NOT_FOUND;
+        return OS_MEMORY_ALLOCATION_ERROR;
     }
 
-    while (os_fgets(line, sizeof(line), file) != NULL)
+    slots = 0;
+    for (i = 0; i < dbc->signal_count; ++i)
     {
-        char* trimmed_line = trim_whitespace(line);
+        signal_t* signal = &dbc->signals[i];
+        int j;
 
-        if (starts_with(trimmed_line, "BO_ "))
+        if (0 == signal->value_span)
         {
-            message_t* temp = os_realloc(dbc->messages, sizeof(message_t) * (dbc->message_count + 1));
-            if (NULL == temp)
-            {
-                os_fclose(file);
-                dbc_unload();
-                return OS_MEMORY_ALLOCATION_ERROR;
-            }
+            continue;
+        }
 
-            dbc->messages = temp;
-            current_message = &dbc->messages[dbc->message_count];
-            os_memset(current_message, 0, sizeof(message_t));
+        signal->value_table = &dbc->value_tables[slots];
+        slots += signal->value_span;
 
-            dbc->message_count += 1;
-            parse_message_line(trimmed_line, current_message);
-        }
-        else if (starts_with(trimmed_line, "SG_ ") && current_message != NULL)
+        for (j = 0; j < signal->value_description_count; ++j)
         {
-            signal_t* temp = os_realloc(current_message->signals, sizeof(signal_t) * (current_message->signal_count + 1));
-            if (NULL == temp)
-            {
-                os_fclose(file);
-                dbc_unload();
-                return OS_MEMORY_ALLOCATION_ERROR;
-            }
+            const value_description_t* description = &signal->value_descriptions[j];
 
-            current_message->signals = temp;
-            signal_t* current_signal = &current_message->signals[current_message->signal_count];
-            os_memset(current_signal, 0, sizeof(signal_t));
-
-            current_message->signal_count += 1;
-            parse_signal_line(trimmed_line, current_signal);
+            signal->value_table[description->value - signal->value_min] = description->description;
         }
     }
 
-    os_fclose(file);
     return ALL_OK;
 }
 
-void dbc_print(void)
+static int compare_value_descriptions(const void* a, const void* b)
 {
-    int i, j;
+    long long value_a = ((const value_description_t*)a)->value;
+    long long value_b = ((const value_description_t*)b)->value;
 
-    if (NULL == dbc)
+    return (value_a > value_b) - (value_a < value_b);
+}
+
+static long long to_integer(const signal_t* signal, uint64 raw)
+{
+    if (0 != (raw & signal->decoder.sign_bit))
     {
-        return;
+        return (long long)(raw | ~signal->decoder.mask);
     }
 
-    os_printf("DBC File contains %d messages\n", dbc->message_count);
-    for (i = 0; i < dbc->message_count; ++i)
+    return (long long)raw;
+}
+
+static uint64 extract_raw(const signal_decoder_t* decoder, uint64 data, uint64 swapped)
+{
+    return (((true == decoder->is_motorola) ? swapped : data) >> decoder->shift) & decoder->mask;
+}
+
+static double to_physical(const signal_t* signal, uint64 raw)
+{
+    double value;
+
+    if (VALUE_TYPE_FLOAT == signal->value_type)
     {
-        const message_t* msg = &dbc->messages[i];
-        os_printf("Message %d: ID=%u, Name=%s, DLC=%u, Transmitter=%s\n",
-                  i + 1, msg->id, msg->name, msg->dlc, msg->transmitter);
-        os_printf("  Contains %d signals\n", msg->signal_count);
-        for (j = 0; j < msg->signal_count; ++j)
-        {
-            const signal_t* sig = &msg->signals[j];
-            os_printf("  Signal %d: Name=%s, StartBit=%d, Length=%d, Endianness=%d, Scale=%.6f, Offset=%.2f, Min=%.2f, Max=%.2f, Unit=%s, Receiver=%s\n",
-                      j + 1, sig->name, sig->start_bit, sig->length, sig->endianness, sig->scale, sig->offset, sig->min_value, sig->max_value, sig->unit, sig->receiver);
-        }
+        uint32 bits = (uint32)raw;
+        float f;
+
+        os_memcpy(&f, &bits, sizeof(f));
+        value = (double)f;
+    }
+    else if (VALUE_TYPE_DOUBLE == signal->value_type)
+    {
+        os_memcpy(&value, &raw, sizeof(value));
+    }
+    else
+    {
+        value = (double)to_integer(signal, raw);
     }
+
+    return (value * signal->scale) + signal->offset;
 }
 
-void dbc_unload(void)
+static uint64 to_raw(const signal_t* signal, double value)
 {
-    int i, j;
+    double limit;
 
-    if (NULL == dbc)
+    /* The physical range first, then what fits into the signal. */
+    if (signal->min_value < signal->max_value)
     {
-        return;
+        value = (value < signal->min_value) ? signal->min_value : value;
+        value = (value > signal->max_value) ? signal->max_value : value;
     }
 
-    for (i = 0; i < dbc->message_count; ++i)
+    if (0.0 != signal->scale)
+    {
+        value = (value - signal->offset) / signal->scale;
+    }
+
+    if (VALUE_TYPE_FLOAT == signal->value_type)
     {
-        message_t* msg = &dbc->messages[i];
+        float f = (float)value;
+        uint32 bits;
 
-        os_free(msg->name);
-        os_free(msg->transmitter);
+        os_memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+    else if (VALUE_TYPE_DOUBLE == signal->value_type)
+    {
+        uint64 bits;
 
-        for (j = 0; j < msg->signal_count; ++j)
+        os_memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    if (0 != signal->decoder.sign_bit)
+    {
+        limit = (double)(signal->decoder.sign_bit - 1u);
+
+        if (value >= limit)
         {
-            signal_t* sig = &msg->signals[j];
-            os_free(sig->name);
-            os_free(sig->unit);
-            os_free(sig->receiver);
+            return signal->decoder.sign_bit - 1u;
+        }
+        else if (value <= (-limit - 1.0))
+        {
+            return signal->decoder.sign_bit;
         }
 
-        os_free(msg->signals);
+        return (uint64)(long long)((value < 0.0) ? (value - 0.5) : (value + 0.5));
     }
 
-    os_free(dbc->messages);
-    os_free(dbc);
-    dbc = NULL;
-}
-
-static uint64 extract_raw_signal(uint64 can_frame, uint8 start_bit, uint8 length, endian_t endianness)
-{
-    uint64 mask = (1ULL << length) - 1;
-    uint64 raw_value;
+    limit = (double)signal->decoder.mask;
 
-    if (ENDIANNESS_MOTOROLA == endianness)
+    if (value >= limit)
     {
-        int bit_pos = 64 - (start_bit + length);
-        raw_value = (can_frame >> bit_pos) & mask;
+        return signal->decoder.mask;
     }
-    else
+    else if (value <= 0.0)
     {
-        raw_value = (can_frame >> start_bit) & mask;
+        return 0;
     }
 
-    return raw_value;
+    return (uint64)(value + 0.5);
 }
 
 static void parse_message_line(char* line, message_t* message)
 {
     char* token;
     char* rest = line;
+    uint32 id;
 
     os_strtokr_r(rest, " ", &rest);
 
+    /* Bit 31 marks an extended ID. */
     token = os_strtokr_r(rest, " ", &rest);
-    message->id = os_strtoul(token, NULL, 10) & 0x7FFFFFFF;
+    id = (NULL != token) ? (uint32)os_strtoul(token, NULL, 10) : 0;
+    message->id = id & 0x7FFFFFFF;
+    message->is_extended = (0 != (id & 0x80000000));
+
     token = os_strtokr_r(rest, ":", &rest);
-    message->name = os_strdup(token);
+    message->name = (NULL != token) ? token : "";
     token = os_strtokr_r(rest, " ", &rest);
-    message->dlc = os_atoi(token);
-    message->transmitter = os_strdup(trim_whitespace(rest));
+    message->dlc = (NULL != token) ? os_atoi(token) : 0;
+    message->transmitter = trim_whitespace(rest);
 }
 
 static void parse_signal_line(char* line, signal_t* signal)
 {
     char* token;
+    char* mux;
     char* rest = line;
 
-    signal->name = NULL;
-    signal->unit = NULL;
-    signal->receiver = NULL;
-    signal->start_bit = 0;
-    signal->length = 0;
+    signal->name = "";
+    signal->unit = "";
+    signal->receiver = "";
     signal->scale = 1.0;
-    signal->offset = 0.0;
-    signal->min_value = 0.0;
-    signal->max_value = 0.0;
-    signal->endianness = 0;
 
     os_strtokr_r(rest, " ", &rest);
 
     token = os_strtokr_r(rest, " ", &rest);
     if (token != NULL)
     {
-        signal->name = os_strdup(token);
+        signal->name = token;
+    }
+
+    /* Multiplexer indicator between name and colon: M, m<n> or m<n>M. */
+    token = os_strchr(rest, ':');
+    if (token != NULL)
+    {
+        *token = '\0';
+        mux = trim_whitespace(rest);
+        rest = token + 1;
+
+        if ('M' == mux[0])
+        {
+            signal->mux = MUX_SWITCH;
+        }
+        else if ('m' == mux[0])
+        {
+            signal->mux = MUX_VALUE;
+            signal->mux_value = (uint32)os_strtoul(mux + 1, NULL, 10);
+        }
     }
 
     token = os_strtokr_r(rest, "|", &rest);
@@ -325,6 +1487,7 @@ static void parse_signal_line(char* line, signal_t* signal)
             {
                 signal->endianness = os_atoi(rest);
                 rest++;
+                signal->is_signed = ('-' == *rest);
             }
         }
     }
@@ -359,81 +1522,174 @@ static void parse_signal_line(char* line, signal_t* signal)
         }
     }
 
-    os_strtokr_r(rest, "\"", &rest);
-    if (rest[0] == '\"')
-    {
-        signal->unit = os_strdup("");
-        rest++;
-    }
-    else
+    /* The unit is quoted and may be empty. */
+    token = os_strchr(rest, '"');
+    if (token != NULL)
     {
-        char* end = os_strtokr_r(rest, "\"", &rest);
+        char* end = os_strchr(token + 1, '"');
+
         if (end != NULL)
         {
-            signal->unit = os_strdup(end);
-        }
-        else
-        {
-            signal->unit = os_strdup("");
+            *end = '\0';
+            signal->unit = token + 1;
+            rest = end + 1;
         }
     }
 
-    while (*rest == ' ')
+    token = os_strtokr_r(rest, " ", &rest);
+    if (token != NULL)
     {
-        rest++;
+        signal->receiver = token;
     }
+}
+
+static void parse_value_type_line(char* line)
+{
+    char* rest = line;
+    char* name;
+    char* token;
+    signal_t* signal;
+    uint32 id;
+    int type;
+
+    /* SIG_VALTYPE_ <message id> <signal name> : <type>; */
+    os_strtokr_r(rest, " ", &rest);
 
     token = os_strtokr_r(rest, " ", &rest);
-    if (token != NULL)
+    if (NULL == token)
     {
-        signal->receiver = os_strdup(token);
+        return;
     }
-    else
+    id = (uint32)os_strtoul(token, NULL, 10) & 0x7FFFFFFF;
+
+    name = os_strtokr_r(rest, " :", &rest);
+    token = os_strtokr_r(rest, " :;", &rest);
+    if ((NULL == name) || (NULL == token))
+    {
+        return;
+    }
+    type = os_atoi(token);
+
+    signal = find_signal(id, name);
+    if (NULL != signal)
     {
-        signal->receiver = os_strdup("");
+        signal->value_type = ((1 == type) || (2 == type)) ? (value_type_t)type : VALUE_TYPE_INTEGER;
     }
 }
 
-static bool starts_with(const char* str, const char* prefix)
+static void parse_value_line(char* line, int value_max)
 {
-    bool status;
-    size_t len_prefix = os_strlen(prefix);
-    size_t len_str = os_strlen(str);
+    char* rest = line;
+    char* name;
+    char* token;
+    signal_t* signal;
+    uint32 id;
 
-    if (len_str < len_prefix)
+    /* VAL_ <message id> <signal name> <value> "<description>" ... ; */
+    os_strtokr_r(rest, " ", &rest);
+
+    token = os_strtokr_r(rest, " ", &rest);
+    name = os_strtokr_r(rest, " ", &rest);
+    if ((NULL == token) || (NULL == name) || (0 == os_isdigit((unsigned char)token[0])))
     {
-        status = false;
+        /* Environment variables have no message ID. */
+        return;
     }
-    else
+    id = (uint32)os_strtoul(token, NULL, 10) & 0x7FFFFFFF;
+
+    signal = find_signal(id, name);
+    if (NULL == signal)
     {
-        status = (bool)(os_strncmp(prefix, str, len_prefix) == 0);
+        return;
     }
 
-    return status;
+    signal->value_descriptions = &dbc->value_descriptions[dbc->value_description_count];
+    signal->value_description_count = 0;
+
+    while (dbc->value_description_count < value_max)
+    {
+        value_description_t* description = &dbc->value_descriptions[dbc->value_description_count];
+        char* quote;
+        char* end;
+
+        quote = os_strchr(rest, '"');
+        if (NULL == quote)
+        {
+            break;
+        }
+
+        end = os_strchr(quote + 1, '"');
+        if (NULL == end)
+        {
+            break;
+        }
+
+        *quote = '\0';
+        *end = '\0';
+
+        description->value = os_strtol(rest, NULL, 10);
+        description->description = quote + 1;
+
+        dbc->value_description_count += 1;
+        signal->value_description_count += 1;
+        rest = end + 1;
+    }
 }
 
-static char* str_tolower(const char* str)
+static void parse_cycle_time_line(char* line)
 {
-    int i;
-    char* lower_str;
+    char* rest = line + os_strlen(DBC_CYCLE_TIME_PREFIX);
+    message_t* message;
+    uint32 id;
 
-    if (NULL == str)
+    /* BA_ "GenMsgCycleTime" BO_ <message id> <value>; */
+    id = (uint32)os_strtoul(rest, &rest, 10) & 0x7FFFFFFF;
+
+    message = find_definition(id);
+    if (NULL != message)
     {
-        return NULL;
+        message->cycle_time_ms = (uint32)os_strtoul(rest, NULL, 10);
     }
+}
+
+static void parse_frame_format_line(char* line)
+{
+    char* rest = line + os_strlen(DBC_FRAME_FORMAT_PREFIX);
+    message_t* message;
+    uint32 id;
+
+    /* BA_ "VFrameFormat" BO_ <message id> <value>; */
+    id = (uint32)os_strtoul(rest, &rest, 10) & 0x7FFFFFFF;
 
-    lower_str = os_strdup(str);
-    if (NULL == lower_str)
+    message = find_definition(id);
+    if ((NULL != message) && (DBC_FRAME_FORMAT_J1939PG == os_strtoul(rest, NULL, 10)))
     {
-        return NULL;
+        message->is_j1939 = true;
+        dbc->has_j1939 = true;
     }
+}
 
-    for (i = 0; lower_str[i]; i++)
+static size_t align(size_t size)
+{
+    return (size + 7u) & ~(size_t)7u;
+}
+
+static bool starts_with(const char* str, const char* prefix)
+{
+    bool status;
+    size_t len_prefix = os_strlen(prefix);
+    size_t len_str = os_strlen(str);
+
+    if (len_str < len_prefix)
+    {
+        status = false;
+    }
+    else
     {
-        lower_str[i] = os_tolower((unsigned char)lower_str[i]);
+        status = (bool)(os_strncmp(prefix, str, len_prefix) == 0);
     }
 
-    return lower_str;
+    return status;
 }
 
 static char* trim_whitespace(char* str)
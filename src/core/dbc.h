@@ -20,18 +20,63 @@ typedef enum
 
 } endian_t;
 
+typedef enum
+{
+    VALUE_TYPE_INTEGER = 0,
+    VALUE_TYPE_FLOAT,  /* SIG_VALTYPE_ 1: IEEE 754 single precision. */
+    VALUE_TYPE_DOUBLE  /* SIG_VALTYPE_ 2: IEEE 754 double precision. */
+
+} value_type_t;
+
+typedef enum
+{
+    MUX_NONE = 0,
+    MUX_SWITCH,  /* M: selects the multiplexed signals. */
+    MUX_VALUE    /* m<n>: present when the switch equals n. */
+
+} mux_t;
+
+typedef struct
+{
+    long value;
+    char* description;
+
+} value_description_t;
+
+/* Precompiled at dbc_load(): one shift and one mask per signal. */
+typedef struct
+{
+    uint64 mask;
+    uint64 sign_bit;  /* 0 for unsigned signals. */
+    uint8 shift;
+    bool is_motorola;  /* Shifted out of the byte-swapped frame. */
+    bool is_valid;
+
+} signal_decoder_t;
+
 typedef struct
 {
+    uint32 id;  /* Position in the whole database. */
     char* name;
     int start_bit;
     int length;
     endian_t endianness;
-    float scale;
-    float offset;
-    float min_value;
-    float max_value;
+    bool is_signed;
+    value_type_t value_type;
+    double scale;
+    double offset;
+    double min_value;
+    double max_value;
     char* unit;
     char* receiver;
+    mux_t mux;
+    uint32 mux_value;
+    int value_description_count;
+    value_description_t* value_descriptions;  /* VAL_ */
+    char** value_table;  /* Dense: description of value_min + i. */
+    long long value_min;
+    uint32 value_span;
+    signal_decoder_t decoder;
 
 } signal_t;
 
@@ -40,21 +85,92 @@ typedef struct
     char* name;
     unsigned int id;
     unsigned int dlc;
+    bool is_extended;
+    uint32 cycle_time_ms;  /* GenMsgCycleTime, 0 if not cyclic. */
+    bool is_j1939;  /* VFrameFormat J1939PG. */
+    int mux_switch;  /* Index of the M signal, -1 if not multiplexed. */
     char* transmitter;
     int signal_count;
     signal_t* signals;
 
 } message_t;
 
+#define DBC_STD_ID_MAX 0x7ff
+#define DBC_J1939_SA_MASK 0x000000ff
+#define DBC_VALUES_MAX 256
+#define DBC_VALUE_TABLE_SPAN_MAX 256
+#define DBC_MATCHES_MAX 256
+
+typedef struct dbc_filter dbc_filter_t;
+
+typedef enum
+{
+    MATCH_EXACT = 0,
+    MATCH_PREFIX,
+    MATCH_SUBSTRING
+
+} match_t;
+
+/* Ranked: exact before prefix before substring matches, messages before
+ * signals, shorter names first.
+ */
 typedef struct
 {
+    const message_t* message;
+    const signal_t* signal;  /* NULL if the message name matched. */
+    match_t match;
+
+} name_match_t;
+
+/* dbc_encode() only reads signal and value. */
+typedef struct
+{
+    const signal_t* signal;
+    uint64 raw;
+    double value;  /* Scaled and offset. */
+    const char* description;  /* From VAL_, NULL if there is none. */
+
+} signal_value_t;
+
+/* Everything a DBC holds lives in one arena: the file text, which the
+ * names and units point into, then the messages, signals, value
+ * descriptions and lookup tables.
+ */
+typedef struct
+{
+    char* arena;
+    size_t arena_size;
     int message_count;
     message_t* messages;
+    signal_t* signals;
+    int value_description_count;
+    value_description_t* value_descriptions;
+    char** value_tables;  /* Dense lookup, one block for all signals. */
+    uint32* std_index;  /* 11-bit IDs, direct: message index + 1. */
+    uint32* ext_index;  /* 29-bit IDs, open addressing. */
+    uint32* pgn_index;  /* 29-bit IDs without the J1939 source address. */
+    bool is_j1939;      /* ProtocolType "J1939": every 29-bit ID is a PGN. */
+    bool has_j1939;     /* is_j1939 or any J1939PG message. */
+    uint32 ext_mask;    /* Hash table size - 1. */
+    uint32 signal_count;
+    uint32* name_offsets;  /* Messages, then signals; one block with the rest. */
+    uint32* name_marks;    /* Query stamps, so each name is reported once. */
+    uint32 name_query;
+    uint32* suffixes;      /* Every suffix of every name, sorted. */
+    uint32 suffix_count;
+    char* names;           /* Case-folded, NUL-separated. */
+    dbc_filter_t** filters;  /* Compiled once per filter string. */
+    int filter_count;
 
 } dbc_t;
 
 const char* dbc_decode(uint32 can_id, uint64 data, const char* filter);
+status_t dbc_decode_values(uint32 can_id, uint64 data, const char* filter, signal_value_t* values, int max_count, int* count);
+status_t dbc_encode(uint32 can_id, const signal_value_t* values, int count, uint64* data, uint8* length);
 status_t dbc_find_id_by_name(uint32* id, const char* search);
+status_t dbc_find_names(const char* search, bool is_prefix, name_match_t* matches, int max_count, int* count);
+const message_t* dbc_get_message(uint32 can_id);
+const char* dbc_get_value_description(const signal_t* signal, uint64 raw);
 status_t dbc_load(char* filename);
 void dbc_print(void);
 void dbc_unload(void);
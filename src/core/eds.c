@@ -19,6 +19,7 @@
 static eds_t eds;
 
 static int parse_eds(void* user, const char* section, const char* name, const char* value);
+static bool parse_section(const char* section, uint16* index, uint8* sub_index, bool* is_sub_section);
 
 void list_eds(void)
 {
@@ -31,8 +32,8 @@ status_t run_conformance_test(const char* eds_path, const char* package, uint32
     char unavailable_subs[256] = {0};
     char base_name[64] = {0};
     int err_count = 0;
-    int error;
     int i;
+    int n;
     int last_sub_index = -1;
     int range_start = -1;
     uint16 current_index = 0xFFFF;
@@ -70,16 +71,26 @@ status_t run_conformance_test(const char* eds_path, const char* package, uint32
     }
 
     /* Parse EDS file. */
-    error = ini_parse(eds_path, parse_eds, &eds_path);
-    if (error < 0)
+    status = eds_load(eds_path, &eds);
+    if (ALL_OK != status)
     {
         if (disp_mode != SCRIPT_MODE)
         {
-            os_log(LOG_ERROR, "Can't load '%s' (%d).", eds_path, error);
+            os_log(LOG_ERROR, "Can't load '%s'.", eds_path);
         }
-        status = EDS_PARSE_ERROR;
     }
 
+    /* Only the [XXXXsubY] sections are tested. */
+    for (i = 0, n = 0; i < eds.num_entries; i++)
+    {
+        if (true == eds.entries[i].IsSubSection)
+        {
+            eds.entries[n] = eds.entries[i];
+            n++;
+        }
+    }
+    eds.num_entries = (uint16)n;
+
     if (disp_mode != SCRIPT_MODE)
     {
         os_log(LOG_INFO, "Number of objects: %u", eds.num_entries);
@@ -163,6 +174,7 @@ status_t run_conformance_test(const char* eds_path, const char* package, uint32
                     result.error_type = "SDORead";
                     result.error_message = "Object not available.";
                     result.call_stack = NULL;
+                    result.system_out = NULL;
 
                     test_add_result(&result);
                 }
@@ -186,6 +198,7 @@ status_t run_conformance_test(const char* eds_path, const char* package, uint32
                     result.error_type = NULL;
                     result.error_message = NULL;
                     result.call_stack = NULL;
+                    result.system_out = NULL;
 
                     test_add_result(&result);
                 }
@@ -211,14 +224,43 @@ status_t run_conformance_test(const char* eds_path, const char* package, uint32
         os_log(LOG_INFO, "%d of %d objects not available.", err_count, eds.num_entries);
     }
 
-    if (eds.entries != NULL)
+    eds_free(&eds);
+
+    return status;
+}
+
+status_t eds_load(const char* eds_path, eds_t* eds_out)
+{
+    if ((NULL == eds_path) || (NULL == eds_out))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    os_memset(eds_out, 0, sizeof(eds_t));
+
+    if (ini_parse(eds_path, parse_eds, eds_out) < 0)
     {
-        os_free(eds.entries);
-        eds.entries = NULL;
-        eds.num_entries = 0;
+        eds_free(eds_out);
+        return EDS_PARSE_ERROR;
     }
 
-    return status;
+    return ALL_OK;
+}
+
+void eds_free(eds_t* eds_out)
+{
+    if (NULL == eds_out)
+    {
+        return;
+    }
+
+    if (eds_out->entries != NULL)
+    {
+        os_free(eds_out->entries);
+    }
+
+    eds_out->entries = NULL;
+    eds_out->num_entries = 0;
 }
 
 status_t validate_eds(uint32 file_no, const char* package, uint32 node_id)
@@ -262,48 +304,41 @@ status_t validate_eds(uint32 file_no, const char* package, uint32 node_id)
 
 static int parse_eds(void* user, const char* section, const char* name, const char* value)
 {
-    size_t len = os_strlen(section);
+    eds_t* eds = (eds_t*)user;
+    eds_entry_t* entry;
+    uint16 index;
+    uint8 sub_index;
+    bool is_sub_section;
 
-    if (len > 7 &&
-        os_isxdigit(section[0]) &&
-        os_isxdigit(section[1]) &&
-        os_isxdigit(section[2]) &&
-        os_isxdigit(section[3]) &&
-        section[4] == 's' &&
-        section[5] == 'u' &&
-        section[6] == 'b' &&
-        os_isxdigit(section[7]) &&
-        (len == 8 || (len == 9 && os_isxdigit(section[8]))))
+    if (false == parse_section(section, &index, &sub_index, &is_sub_section))
     {
-        static char prev_section[50] = "";
-
-        if (0 != os_strcmp(section, prev_section))
-        {
-            char index[5] = {0};
-            char sub_index[3] = {0};
-
-            os_strlcpy(index, section, 5);
-            os_strlcpy(sub_index, section + 7, 3);
-            os_strlcpy(prev_section, section, sizeof(prev_section));
-
-            prev_section[sizeof(prev_section) - 1] = '\0';
+        return 1;
+    }
 
-            eds.entries = os_realloc(eds.entries, (eds.num_entries + 1) * sizeof(eds_entry_t));
-            if (NULL == eds.entries)
-            {
-                os_log(LOG_ERROR, "Memory allocation error.");
-                return 0;
-            }
+    entry = (eds->num_entries > 0) ? &eds->entries[eds->num_entries - 1] : NULL;
 
-            eds.entries[eds.num_entries].Index = (uint16)os_strtoul(index, NULL, 16);
-            eds.entries[eds.num_entries].SubIndex = (uint8)os_strtoul(sub_index, NULL, 16);
-            eds.num_entries++;
+    /* [1018] is directly followed by [1018sub0]: both describe the same entry. */
+    if ((NULL == entry) || (index != entry->Index) || (sub_index != entry->SubIndex))
+    {
+        eds_entry_t* entries = os_realloc(eds->entries, (eds->num_entries + 1) * sizeof(eds_entry_t));
+        if (NULL == entries)
+        {
+            os_log(LOG_ERROR, "Memory allocation error.");
+            return 0;
         }
+
+        eds->entries = entries;
+        entry = &eds->entries[eds->num_entries];
+        os_memset(entry, 0, sizeof(eds_entry_t));
+        entry->Index = index;
+        entry->SubIndex = sub_index;
+        entry->ObjectType = 0x07;
+        eds->num_entries++;
     }
 
-    if (0 == eds.num_entries)
+    if (true == is_sub_section)
     {
-        return 1;
+        entry->IsSubSection = true;
     }
 
     if (0 == os_strcmp(name, "ParameterName"))
@@ -314,55 +349,115 @@ static int parse_eds(void* user, const char* section, const char* name, const ch
             len = 242;
         }
 
-        os_strlcpy(eds.entries[eds.num_entries - 1].ParameterName, value, len);
+        os_strlcpy(entry->ParameterName, value, len);
     }
     else if (0 == os_strcmp(name, "ObjectType"))
     {
-        eds.entries[eds.num_entries - 1].ObjectType = (uint8)os_strtoul(value, NULL, 0);
+        entry->ObjectType = (uint8)os_strtoul(value, NULL, 0);
     }
     else if (0 == os_strcmp(name, "DataType"))
     {
-        eds.entries[eds.num_entries - 1].DataType = (uint16)os_strtoul(value, NULL, 0);
+        entry->DataType = (uint16)os_strtoul(value, NULL, 0);
     }
     else if (0 == os_strcmp(name, "LowLimit"))
     {
-        eds.entries[eds.num_entries - 1].LowLimit = (uint32)os_strtoul(value, NULL, 0);
+        entry->LowLimit = (uint32)os_strtoul(value, NULL, 0);
     }
     else if (0 == os_strcmp(name, "HighLimit"))
     {
-        eds.entries[eds.num_entries - 1].HighLimit = (uint32)os_strtoul(value, NULL, 0);
+        entry->HighLimit = (uint32)os_strtoul(value, NULL, 0);
     }
     else if (0 == os_strcmp(name, "AccessType"))
     {
         if (0 == os_strcmp(value, "ro"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = RO;
+            entry->AccessType = RO;
         }
         else if (0 == os_strcmp(value, "wo"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = WO;
+            entry->AccessType = WO;
         }
         else if (0 == os_strcmp(value, "rw"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = RW;
+            entry->AccessType = RW;
         }
         else if (0 == os_strcmp(value, "rww"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = RWW;
+            entry->AccessType = RWW;
         }
         else if (0 == os_strcmp(value, "const"))
         {
-            eds.entries[eds.num_entries - 1].AccessType = CONST_T;
+            entry->AccessType = CONST_T;
         }
     }
     else if (0 == os_strcmp(name, "DefaultValue"))
     {
-        eds.entries[eds.num_entries - 1].DefaultValue = (uint32)os_strtoul(value, NULL, 0);
+        const char* node_id = os_strstr(value, "$NODEID");
+
+        os_strlcpy(entry->DefaultString, value, sizeof(entry->DefaultString));
+
+        /* $NODEID+0x180 or 0x180+$NODEID */
+        if (NULL != node_id)
+        {
+            const char* offset = (node_id == value) ? os_strchr(value, '+') : value;
+
+            entry->IsNodeIdRelative = true;
+            entry->DefaultValue = (NULL != offset) ? (uint32)os_strtoul((offset == value) ? value : offset + 1, NULL, 0) : 0;
+        }
+        else
+        {
+            entry->DefaultValue = (uint32)os_strtoul(value, NULL, 0);
+        }
     }
     else if (0 == os_strcmp(name, "PDOMapping"))
     {
-        eds.entries[eds.num_entries - 1].DefaultValue = (bool)os_strtoul(value, NULL, 0);
+        entry->PDOMapping = (bool)os_strtoul(value, NULL, 0);
     }
 
     return 1;
 }
+
+static bool parse_section(const char* section, uint16* index, uint8* sub_index, bool* is_sub_section)
+{
+    size_t len = os_strlen(section);
+    char index_str[5] = {0};
+    int i;
+
+    if (len < 4)
+    {
+        return false;
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        if (!os_isxdigit(section[i]))
+        {
+            return false;
+        }
+    }
+
+    os_strlcpy(index_str, section, sizeof(index_str));
+    *index = (uint16)os_strtoul(index_str, NULL, 16);
+    *sub_index = 0;
+    *is_sub_section = false;
+
+    if (4 == len)
+    {
+        return true;
+    }
+
+    if ((len > 7) &&
+        (len <= 9) &&
+        (os_tolower(section[4]) == 's') &&
+        (os_tolower(section[5]) == 'u') &&
+        (os_tolower(section[6]) == 'b') &&
+        os_isxdigit(section[7]) &&
+        (len == 8 || os_isxdigit(section[8])))
+    {
+        *sub_index = (uint8)os_strtoul(section + 7, NULL, 16);
+        *is_sub_section = true;
+        return true;
+    }
+
+    return false;
+}
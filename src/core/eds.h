@@ -13,6 +13,8 @@
 #include "codb.h"
 #include "core.h"
 
+#define EDS_MAX_STRING_LEN 64
+
 void list_eds(void);
 status_t run_conformance_test(const char* eds_path, const char* package, uint32 node_id, disp_mode_t disp_mode);
 status_t validate_eds(uint32 file_no, const char* package, uint32 node_id);
@@ -29,7 +31,10 @@ typedef struct eds_entry
     uint32 HighLimit;
     acc_type_t AccessType;
     uint32 DefaultValue;
+    char DefaultString[EDS_MAX_STRING_LEN];
+    bool IsNodeIdRelative;
     bool PDOMapping;
+    bool IsSubSection; /* Read from a [XXXXsubY] section. */
 
 } eds_entry_t;
 
@@ -40,4 +45,7 @@ typedef struct eds
 
 } eds_t;
 
+status_t eds_load(const char* eds_path, eds_t* eds_out);
+void eds_free(eds_t* eds_out);
+
 #endif /* EDS_H */
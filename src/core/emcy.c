@@ -0,0 +1,417 @@
+/** @file emcy.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "emcy.h"
+#include "can.h"
+#include "can_listener.h"
+#include "core.h"
+#include "dict.h"
+#include "os.h"
+#include "table.h"
+
+static os_mutex* lock;
+static emcy_node_t nodes[EMCY_NODE_MAX + 1];
+static emcy_record_t history[EMCY_NODE_MAX + 1][EMCY_HISTORY_MAX];
+static uint16 trigger_code;
+static uint16 trigger_mask;
+static emcy_callback_t trigger_callback;
+static void* trigger_user;
+static can_listener_t listener;
+
+static bool init(void);
+static void on_frame(const can_message_t* message, uint64 now, void* user);
+static void receive(const can_message_t* message, uint64 now);
+static bool find_since(uint8 node_id, uint16 code, uint16 mask, uint64 since_us, emcy_record_t* entry);
+
+void emcy_update(core_t* core)
+{
+    if (false == init())
+    {
+        return;
+    }
+
+    can_listener_update(&listener, core);
+}
+
+void emcy_on_receive(const can_message_t* message)
+{
+    if (false == init())
+    {
+        return;
+    }
+
+    receive(message, os_get_ticks());
+}
+
+void emcy_on_read(const can_message_t* message)
+{
+    if (NULL != lock)
+    {
+        can_listener_on_read(&listener, message);
+    }
+}
+
+status_t emcy_get_node(uint8 node_id, emcy_node_t* node)
+{
+    status_t status = ALL_OK;
+
+    if ((NULL == node) || (0 == node_id) || (node_id > EMCY_NODE_MAX))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (false == init())
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    os_lock_mutex(lock);
+
+    os_memcpy(node, &nodes[node_id], sizeof(emcy_node_t));
+    if (0 == node->count)
+    {
+        status = ITEM_NOT_FOUND;
+    }
+
+    os_unlock_mutex(lock);
+    return status;
+}
+
+uint32 emcy_get_history(uint8 node_id, emcy_record_t* entries, uint32 max_count)
+{
+    uint32 available;
+    uint32 count = 0;
+
+    if ((NULL == entries) || (0 == node_id) || (node_id > EMCY_NODE_MAX) || (false == init()))
+    {
+        return 0;
+    }
+
+    os_lock_mutex(lock);
+
+    available = (nodes[node_id].count < EMCY_HISTORY_MAX) ? nodes[node_id].count : EMCY_HISTORY_MAX;
+
+    /* Oldest first, the ring itself is left untouched. */
+    while ((count < max_count) && (count < available))
+    {
+        uint32 index = (nodes[node_id].count - available + count) % EMCY_HISTORY_MAX;
+
+        os_memcpy(&entries[count], &history[node_id][index], sizeof(emcy_record_t));
+        count += 1;
+    }
+
+    os_unlock_mutex(lock);
+    return count;
+}
+
+double emcy_get_rate(const emcy_node_t* node)
+{
+    if ((NULL == node) || (node->count < 2) || (node->last_us <= node->first_us))
+    {
+        return 0.0;
+    }
+
+    return (double)(node->count - 1u) * 1000000.0 / (double)(node->last_us - node->first_us);
+}
+
+void emcy_set_trigger(uint16 code, uint16 mask, emcy_callback_t callback, void* user)
+{
+    if (false == init())
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+    trigger_code = code & mask;
+    trigger_mask = mask;
+    trigger_callback = callback;
+    trigger_user = user;
+    os_unlock_mutex(lock);
+}
+
+status_t emcy_wait(uint8 node_id, uint16 code, uint16 mask, uint32 timeout_ms, emcy_record_t* entry)
+{
+    emcy_record_t found;
+    uint64 since_us;
+    uint64 deadline;
+
+    if ((node_id > EMCY_NODE_MAX) || (false == init()))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    since_us = os_get_ticks() / 1000u;
+    deadline = os_get_ticks() + ((uint64)timeout_ms * 1000000u);
+
+    while (false == find_since(node_id, code, mask, since_us, &found))
+    {
+        can_message_t message = {0};
+
+        if (os_get_ticks() >= deadline)
+        {
+            return ITEM_NOT_FOUND;
+        }
+
+        can_read(&message);
+    }
+
+    if (NULL != entry)
+    {
+        os_memcpy(entry, &found, sizeof(emcy_record_t));
+    }
+
+    return ALL_OK;
+}
+
+void emcy_print(uint8 node_id)
+{
+    table_t table = {DARK_CYAN, DEFAULT_COLOR, 4, 6, 48};
+    uint8 first = (0 == node_id) ? 1 : node_id;
+    uint8 last = (0 == node_id) ? EMCY_NODE_MAX : node_id;
+    uint8 id;
+    bool is_empty = true;
+
+    if ((node_id > EMCY_NODE_MAX) || (false == init()))
+    {
+        return;
+    }
+
+    table_init(&table, 4096);
+    table_print_header(&table);
+    table_print_row("ID", "Code", "Description", &table);
+    table_print_divider(&table);
+
+    os_lock_mutex(lock);
+
+    for (id = first; id <= last; id += 1)
+    {
+        const emcy_node_t* node = &nodes[id];
+        char id_str[5] = {0};
+        char code_str[6] = {0};
+        char summary[64] = {0};
+
+        if (0 == node->count)
+        {
+            continue;
+        }
+
+        os_snprintf(id_str, sizeof(id_str), "0x%02x", id);
+
+        /* The overview shows one line per node, a single node its history. */
+        if (0 == node_id)
+        {
+            os_snprintf(code_str, sizeof(code_str), "%04Xh", node->last_code);
+            os_snprintf(summary, sizeof(summary), "%u total, %.1f/s, peak %u/s, ER %02Xh",
+                        node->count,
+                        emcy_get_rate(node),
+                        node->peak_per_s,
+                        node->error_register);
+
+            table_print_row(id_str, code_str, emcy_lookup(node->last_code), &table);
+            table_print_row(" ", " ", summary, &table);
+        }
+        else
+        {
+            uint32 available = (node->count < EMCY_HISTORY_MAX) ? node->count : EMCY_HISTORY_MAX;
+            uint32 i;
+
+            for (i = 0; i < available; i += 1)
+            {
+                const emcy_record_t* entry = &history[id][(node->count - available + i) % EMCY_HISTORY_MAX];
+
+                os_snprintf(code_str, sizeof(code_str), "%04Xh", entry->code);
+                os_snprintf(summary, sizeof(summary), "%s, ER %02Xh, %02X %02X %02X %02X %02X",
+                            emcy_lookup(entry->code),
+                            entry->error_register,
+                            entry->data[0], entry->data[1], entry->data[2], entry->data[3], entry->data[4]);
+
+                table_print_row(id_str, code_str, summary, &table);
+            }
+        }
+
+        is_empty = false;
+    }
+
+    os_unlock_mutex(lock);
+
+    if (true == is_empty)
+    {
+        table_print_row("-", "-", "No EMCY received", &table);
+    }
+
+    table_print_footer(&table);
+    table_flush(&table);
+}
+
+void emcy_clear(uint8 node_id)
+{
+    uint8 id;
+
+    if ((NULL == lock) || (node_id > EMCY_NODE_MAX))
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    for (id = 1; id <= EMCY_NODE_MAX; id += 1)
+    {
+        if ((0 == node_id) || (id == node_id))
+        {
+            os_memset(&nodes[id], 0, sizeof(emcy_node_t));
+        }
+    }
+
+    os_unlock_mutex(lock);
+}
+
+void emcy_close(void)
+{
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    can_listener_close(&listener);
+    emcy_set_trigger(0, 0, NULL, NULL);
+}
+
+static bool init(void)
+{
+    if (NULL == lock)
+    {
+        lock = os_create_mutex();
+        can_listener_init(&listener, 0x080, 0x780, on_frame, NULL);
+    }
+
+    return (NULL != lock);
+}
+
+static void on_frame(const can_message_t* message, uint64 now, void* user)
+{
+    (void)user;
+
+    if (NULL != message)
+    {
+        receive(message, now);
+    }
+}
+
+static void receive(const can_message_t* message, uint64 now)
+{
+    emcy_node_t* node;
+    emcy_record_t* entry;
+    emcy_record_t copy;
+    emcy_callback_t callback = NULL;
+    void* user = NULL;
+    uint64 now_us = now / 1000u;
+    uint8 node_id;
+
+    /* 080h itself is the SYNC. */
+    if ((NULL == message) || (0x080 != (message->id & 0x780)) || (0 == (message->id & 0x7f)))
+    {
+        return;
+    }
+
+    node_id = (uint8)(message->id & 0x7f);
+
+    os_lock_mutex(lock);
+
+    node = &nodes[node_id];
+    entry = &history[node_id][node->count % EMCY_HISTORY_MAX];
+
+    /* Shorter frames are padded with zeros. */
+    os_memset(entry, 0, sizeof(emcy_record_t));
+    entry->node_id = node_id;
+    entry->timestamp_us = now_us;
+    if (message->length >= 2)
+    {
+        entry->code = (uint16)((message->data[1] << 8) | message->data[0]);
+    }
+    if (message->length >= 3)
+    {
+        entry->error_register = message->data[2];
+    }
+    if (message->length > 3)
+    {
+        os_memcpy(entry->data, &message->data[3], ((message->length > 8) ? 8 : message->length) - 3u);
+    }
+
+    /* Fixed one-second windows: a burst shows up as a peak, not as lines. */
+    if ((0 == node->count) || ((now_us - node->window_start_us) >= EMCY_RATE_WINDOW_US))
+    {
+        node->window_start_us = now_us;
+        node->window_count = 0;
+    }
+    node->window_count += 1;
+    if (node->window_count > node->peak_per_s)
+    {
+        node->peak_per_s = node->window_count;
+    }
+
+    if (0 == node->count)
+    {
+        node->first_us = now_us;
+    }
+    node->last_us = now_us;
+    node->last_code = entry->code;
+    node->error_register = entry->error_register;
+    node->count += 1;
+
+    if ((NULL != trigger_callback) && ((entry->code & trigger_mask) == trigger_code))
+    {
+        os_memcpy(&copy, entry, sizeof(emcy_record_t));
+        callback = trigger_callback;
+        user = trigger_user;
+    }
+
+    os_unlock_mutex(lock);
+
+    if (NULL != callback)
+    {
+        callback(&copy, user);
+    }
+}
+
+static bool find_since(uint8 node_id, uint16 code, uint16 mask, uint64 since_us, emcy_record_t* entry)
+{
+    uint8 first = (0 == node_id) ? 1 : node_id;
+    uint8 last = (0 == node_id) ? EMCY_NODE_MAX : node_id;
+    uint8 id;
+    bool is_found = false;
+
+    os_lock_mutex(lock);
+
+    for (id = first; (id <= last) && (false == is_found); id += 1)
+    {
+        const emcy_node_t* node = &nodes[id];
+        uint32 available = (node->count < EMCY_HISTORY_MAX) ? node->count : EMCY_HISTORY_MAX;
+        uint32 i;
+
+        if ((0 == node->count) || (node->last_us < since_us))
+        {
+            continue;
+        }
+
+        for (i = 0; i < available; i += 1)
+        {
+            const emcy_record_t* candidate = &history[id][(node->count - available + i) % EMCY_HISTORY_MAX];
+
+            if ((candidate->timestamp_us >= since_us) && ((candidate->code & mask) == (code & mask)))
+            {
+                os_memcpy(entry, candidate, sizeof(emcy_record_t));
+                is_found = true;
+                break;
+            }
+        }
+    }
+
+    os_unlock_mutex(lock);
+    return is_found;
+}
@@ -0,0 +1,58 @@
+/** @file emcy.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef EMCY_H
+#define EMCY_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+#define EMCY_NODE_MAX 0x7f
+#define EMCY_HISTORY_MAX 32
+#define EMCY_RATE_WINDOW_US 1000000u
+
+typedef struct emcy_record
+{
+    uint8 node_id;
+    uint16 code;
+    uint8 error_register;  /* Copy of 1001h. */
+    uint8 data[5];  /* Manufacturer-specific error code. */
+    uint64 timestamp_us;
+
+} emcy_record_t;
+
+typedef struct emcy_node
+{
+    uint32 count;
+    uint16 last_code;
+    uint8 error_register;
+    uint64 first_us;
+    uint64 last_us;
+    uint32 window_count;  /* EMCYs in the current rate window. */
+    uint64 window_start_us;
+    uint32 peak_per_s;  /* Highest count of a single window. */
+
+} emcy_node_t;
+
+typedef void (*emcy_callback_t)(const emcy_record_t* entry, void* user);
+
+void emcy_update(core_t* core);
+void emcy_on_receive(const can_message_t* message);
+void emcy_on_read(const can_message_t* message);
+status_t emcy_get_node(uint8 node_id, emcy_node_t* node);
+uint32 emcy_get_history(uint8 node_id, emcy_record_t* entries, uint32 max_count);
+double emcy_get_rate(const emcy_node_t* node);
+void emcy_set_trigger(uint16 code, uint16 mask, emcy_callback_t callback, void* user);
+status_t emcy_wait(uint8 node_id, uint16 code, uint16 mask, uint32 timeout_ms, emcy_record_t* entry);
+void emcy_print(uint8 node_id);
+void emcy_clear(uint8 node_id);
+void emcy_close(void);
+
+#endif /* EMCY_H */
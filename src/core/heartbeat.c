@@ -0,0 +1,599 @@
+/** @file heartbeat.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "heartbeat.h"
+#include "can.h"
+#include "can_listener.h"
+#include "core.h"
+#include "os.h"
+#include "table.h"
+
+#define TOGGLE_ANY 0xff
+
+static os_mutex* lock;
+static heartbeat_node_t nodes[HEARTBEAT_NODE_MAX + 1];
+static heartbeat_entry_t events[HEARTBEAT_EVENT_MAX];
+static uint32 event_head;
+static uint32 event_count;
+static heartbeat_callback_t event_callback;
+static void* event_user;
+static can_listener_t listener;
+static uint64 last_check_ns;
+static uint32 guarded_count;
+
+static bool init(void);
+static void on_frame(const can_message_t* message, uint64 now, void* user);
+static void receive(const can_message_t* message, uint64 now);
+static void send_guard_requests(uint64 now);
+static void check_timeouts(uint64 now, bool is_forced);
+static void push_event(uint8 node_id, heartbeat_event_t event, uint8 state, uint64 timestamp_us);
+
+void heartbeat_update(core_t* core)
+{
+    if (false == init())
+    {
+        return;
+    }
+
+    can_listener_update(&listener, core);
+}
+
+void heartbeat_on_receive(const can_message_t* message)
+{
+    if (false == init())
+    {
+        return;
+    }
+
+    receive(message, os_get_ticks());
+}
+
+void heartbeat_on_read(const can_message_t* message)
+{
+    if (NULL != lock)
+    {
+        can_listener_on_read(&listener, message);
+    }
+}
+
+status_t heartbeat_get_node(uint8 node_id, heartbeat_node_t* node)
+{
+    status_t status = ALL_OK;
+
+    if ((NULL == node) || (0 == node_id) || (node_id > HEARTBEAT_NODE_MAX))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (false == init())
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    check_timeouts(os_get_ticks(), false);
+
+    os_lock_mutex(lock);
+
+    os_memcpy(node, &nodes[node_id], sizeof(heartbeat_node_t));
+    if (false == node->is_seen)
+    {
+        status = ITEM_NOT_FOUND;
+    }
+
+    os_unlock_mutex(lock);
+    return status;
+}
+
+status_t heartbeat_set_timeout(uint8 node_id, uint32 timeout_ms)
+{
+    if ((0 == node_id) || (node_id > HEARTBEAT_NODE_MAX))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (false == init())
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    os_lock_mutex(lock);
+    nodes[node_id].timeout_ms = timeout_ms;
+    os_unlock_mutex(lock);
+
+    return ALL_OK;
+}
+
+status_t heartbeat_set_guarding(uint8 node_id, uint32 guard_time_ms, uint8 life_time_factor)
+{
+    heartbeat_node_t* node;
+    uint64 now_us;
+
+    if ((0 == node_id) || (node_id > HEARTBEAT_NODE_MAX) || ((0 != guard_time_ms) && (0 == life_time_factor)))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (false == init())
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    now_us = os_get_ticks() / 1000u;
+
+    os_lock_mutex(lock);
+
+    node = &nodes[node_id];
+
+    if ((0 == node->guard_time_ms) && (0 != guard_time_ms))
+    {
+        guarded_count += 1;
+    }
+    else if ((0 != node->guard_time_ms) && (0 == guard_time_ms))
+    {
+        guarded_count -= 1;
+    }
+
+    node->guard_time_ms = guard_time_ms;
+    node->life_time_factor = life_time_factor;
+    node->toggle = TOGGLE_ANY;
+    node->next_guard_us = now_us;
+
+    /* The life time of a silent node counts from the first request. */
+    if (false == node->is_seen)
+    {
+        node->last_seen_us = now_us;
+    }
+
+    os_unlock_mutex(lock);
+    return ALL_OK;
+}
+
+uint32 heartbeat_get_events(heartbeat_entry_t* entries, uint32 max_count)
+{
+    uint32 count = 0;
+
+    if ((NULL == entries) || (false == init()))
+    {
+        return 0;
+    }
+
+    check_timeouts(os_get_ticks(), true);
+
+    os_lock_mutex(lock);
+
+    while ((count < max_count) && (0 != event_count))
+    {
+        uint32 index = (event_head + HEARTBEAT_EVENT_MAX - event_count) % HEARTBEAT_EVENT_MAX;
+
+        os_memcpy(&entries[count], &events[index], sizeof(heartbeat_entry_t));
+        event_count -= 1;
+        count += 1;
+    }
+
+    os_unlock_mutex(lock);
+    return count;
+}
+
+void heartbeat_set_callback(heartbeat_callback_t callback, void* user)
+{
+    if (false == init())
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+    event_callback = callback;
+    event_user = user;
+    os_unlock_mutex(lock);
+}
+
+const char* heartbeat_get_state_name(uint8 state)
+{
+    switch (state)
+    {
+        case 0x00:
+            return "Boot-up";
+        case 0x04:
+            return "Stopped";
+        case 0x05:
+            return "Operational";
+        case 0x7f:
+            return "Pre-operational";
+        default:
+            return "Unknown";
+    }
+}
+
+const char* heartbeat_get_event_name(heartbeat_event_t event)
+{
+    switch (event)
+    {
+        case HEARTBEAT_BOOT_UP:
+            return "boot_up";
+        case HEARTBEAT_STATE_CHANGED:
+            return "state_changed";
+        case HEARTBEAT_TIMEOUT:
+            return "timeout";
+        case HEARTBEAT_RESUMED:
+            return "resumed";
+        default:
+            return "";
+    }
+}
+
+void heartbeat_print(void)
+{
+    table_t table = {DARK_CYAN, DEFAULT_COLOR, 4, 15, 48};
+    uint64 now_us;
+    uint8 node_id;
+    bool is_empty = true;
+
+    if (false == init())
+    {
+        return;
+    }
+
+    check_timeouts(os_get_ticks(), true);
+    now_us = os_get_ticks() / 1000u;
+
+    table_init(&table, 1024);
+    table_print_header(&table);
+    table_print_row("ID", "State", "Period / Last seen / Timeouts", &table);
+    table_print_divider(&table);
+
+    os_lock_mutex(lock);
+
+    for (node_id = 1; node_id <= HEARTBEAT_NODE_MAX; node_id += 1)
+    {
+        const heartbeat_node_t* node = &nodes[node_id];
+        char id_str[5] = {0};
+        char summary[64] = {0};
+
+        if (false == node->is_seen)
+        {
+            continue;
+        }
+
+        os_snprintf(id_str, sizeof(id_str), "0x%02x", node_id);
+        os_snprintf(summary, sizeof(summary), "%u ms / %u ms ago / %u%s",
+                    node->period_us / 1000u,
+                    (uint32)((now_us - node->last_seen_us) / 1000u),
+                    node->timeouts,
+                    (true == node->is_timed_out) ? " (timed out)" : "");
+
+        table_print_row(id_str, heartbeat_get_state_name(node->state), summary, &table);
+        is_empty = false;
+    }
+
+    os_unlock_mutex(lock);
+
+    if (true == is_empty)
+    {
+        table_print_row("-", "-", "No heartbeats received", &table);
+    }
+
+    table_print_footer(&table);
+    table_flush(&table);
+}
+
+void heartbeat_reset(void)
+{
+    uint8 node_id;
+
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    /* Configured timeouts and guard times are kept. */
+    for (node_id = 1; node_id <= HEARTBEAT_NODE_MAX; node_id += 1)
+    {
+        heartbeat_node_t* node = &nodes[node_id];
+        uint32 timeout_ms = node->timeout_ms;
+        uint32 guard_time_ms = node->guard_time_ms;
+        uint8 life_time_factor = node->life_time_factor;
+
+        os_memset(node, 0, sizeof(heartbeat_node_t));
+        node->timeout_ms = timeout_ms;
+        node->guard_time_ms = guard_time_ms;
+        node->life_time_factor = life_time_factor;
+        node->toggle = TOGGLE_ANY;
+    }
+
+    event_count = 0;
+
+    os_unlock_mutex(lock);
+}
+
+void heartbeat_close(void)
+{
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    can_listener_close(&listener);
+    heartbeat_set_callback(NULL, NULL);
+}
+
+static bool init(void)
+{
+    if (NULL == lock)
+    {
+        lock = os_create_mutex();
+        can_listener_init(&listener, 0x700, 0x780, on_frame, NULL);
+    }
+
+    return (NULL != lock);
+}
+
+static void on_frame(const can_message_t* message, uint64 now, void* user)
+{
+    (void)user;
+
+    if (NULL == message)
+    {
+        send_guard_requests(now);
+        check_timeouts(now, false);
+    }
+    else
+    {
+        receive(message, now);
+    }
+}
+
+static void receive(const can_message_t* message, uint64 now)
+{
+    heartbeat_node_t* node;
+    heartbeat_entry_t entry = {0};
+    heartbeat_callback_t callback;
+    void* user;
+    uint64 now_us = now / 1000u;
+    uint8 node_id;
+    uint8 state;
+    bool has_event = true;
+
+    /* Node guarding requests are remote frames without data. */
+    if ((NULL == message) || (0x700 != (message->id & 0x780)) || (1 != message->length))
+    {
+        return;
+    }
+
+    node_id = (uint8)(message->id & 0x7f);
+    if (0 == node_id)
+    {
+        return;
+    }
+
+    /* Node guarding responses carry a toggle bit on top of the state. */
+    state = message->data[0] & 0x7f;
+
+    os_lock_mutex(lock);
+
+    node = &nodes[node_id];
+
+    /* A wrong toggle bit counts as a missing response; the next one is
+     * expected to follow the node again.
+     */
+    if ((0 != node->guard_time_ms) && (0x00 != state))
+    {
+        uint8 toggle = message->data[0] & 0x80;
+        bool is_valid = ((TOGGLE_ANY == node->toggle) || (toggle == node->toggle));
+
+        node->toggle = toggle ^ 0x80;
+        if (false == is_valid)
+        {
+            node->toggle_errors += 1;
+            os_unlock_mutex(lock);
+            return;
+        }
+    }
+
+    if (0x00 == state)
+    {
+        entry.event = HEARTBEAT_BOOT_UP;
+        node->boot_up_us = now_us;
+        node->toggle = 0x00;
+    }
+    else if (true == node->is_timed_out)
+    {
+        entry.event = HEARTBEAT_RESUMED;
+    }
+    else if ((false == node->is_seen) || (state != node->state))
+    {
+        entry.event = HEARTBEAT_STATE_CHANGED;
+    }
+    else
+    {
+        has_event = false;
+    }
+
+    /* The boot-up message is not part of the heartbeat cycle. */
+    if ((true == node->is_seen) && (0x00 != node->state) && (0x00 != state))
+    {
+        node->period_us = (uint32)(now_us - node->last_seen_us);
+    }
+    else
+    {
+        node->period_us = 0;
+    }
+
+    node->is_seen = true;
+    node->is_timed_out = false;
+    node->state = state;
+    node->last_seen_us = now_us;
+    node->frames += 1;
+
+    callback = event_callback;
+    user = event_user;
+
+    if (true == has_event)
+    {
+        entry.node_id = node_id;
+        entry.state = state;
+        entry.timestamp_us = now_us;
+        push_event(node_id, entry.event, state, now_us);
+    }
+
+    os_unlock_mutex(lock);
+
+    if ((true == has_event) && (NULL != callback))
+    {
+        callback(&entry, user);
+    }
+}
+
+static void check_timeouts(uint64 now, bool is_forced)
+{
+    heartbeat_entry_t expired[HEARTBEAT_NODE_MAX];
+    heartbeat_callback_t callback;
+    void* user;
+    uint64 now_us = now / 1000u;
+    uint32 count = 0;
+    uint32 i;
+    uint8 node_id;
+
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    /* Frames are handled in O(1), the table is scanned once per interval. */
+    if ((false == is_forced) && (now >= last_check_ns) && ((now - last_check_ns) < HEARTBEAT_CHECK_INTERVAL_NS))
+    {
+        os_unlock_mutex(lock);
+        return;
+    }
+    last_check_ns = now;
+
+    for (node_id = 1; node_id <= HEARTBEAT_NODE_MAX; node_id += 1)
+    {
+        heartbeat_node_t* node = &nodes[node_id];
+        uint64 timeout_us = (uint64)node->timeout_ms * 1000u;
+
+        if (((false == node->is_seen) && (0 == node->guard_time_ms)) || (true == node->is_timed_out) || (now_us < node->last_seen_us))
+        {
+            continue;
+        }
+
+        if ((0 == timeout_us) && (0 != node->guard_time_ms))
+        {
+            timeout_us = (uint64)node->guard_time_ms * node->life_time_factor * 1000u;
+        }
+        else if (0 == timeout_us)
+        {
+            timeout_us = (uint64)node->period_us * 2u;
+        }
+
+        if ((0 == timeout_us) || ((now_us - node->last_seen_us) <= timeout_us))
+        {
+            continue;
+        }
+
+        node->is_timed_out = true;
+        node->timeouts += 1;
+
+        expired[count].node_id = node_id;
+        expired[count].event = HEARTBEAT_TIMEOUT;
+        expired[count].state = node->state;
+        expired[count].timestamp_us = now_us;
+        push_event(node_id, HEARTBEAT_TIMEOUT, node->state, now_us);
+        count += 1;
+    }
+
+    callback = event_callback;
+    user = event_user;
+
+    os_unlock_mutex(lock);
+
+    for (i = 0; (NULL != callback) && (i < count); i += 1)
+    {
+        callback(&expired[i], user);
+    }
+}
+
+static void send_guard_requests(uint64 now)
+{
+    uint8 requests[HEARTBEAT_NODE_MAX];
+    uint64 now_us = now / 1000u;
+    uint64 next_us = 0;
+    uint32 count = 0;
+    uint32 i;
+    uint8 node_id;
+
+    os_lock_mutex(lock);
+
+    if (0 == guarded_count)
+    {
+        os_unlock_mutex(lock);
+        return;
+    }
+
+    for (node_id = 1; node_id <= HEARTBEAT_NODE_MAX; node_id += 1)
+    {
+        heartbeat_node_t* node = &nodes[node_id];
+
+        if (0 == node->guard_time_ms)
+        {
+            continue;
+        }
+
+        if (node->next_guard_us <= now_us)
+        {
+            requests[count] = node_id;
+            count += 1;
+
+            node->next_guard_us += (uint64)node->guard_time_ms * 1000u;
+            if (node->next_guard_us <= now_us)
+            {
+                node->next_guard_us = now_us + ((uint64)node->guard_time_ms * 1000u);
+            }
+        }
+
+        if ((0 == next_us) || (node->next_guard_us < next_us))
+        {
+            next_us = node->next_guard_us;
+        }
+    }
+
+    os_unlock_mutex(lock);
+
+    /* Written outside the lock, the response may arrive right away. */
+    for (i = 0; i < count; i += 1)
+    {
+        can_message_t message = {0};
+
+        message.id = (0x700 + requests[i]) | CAN_REMOTE_FRAME;
+        message.length = 0;
+        can_write(&message, SILENT, NULL);
+    }
+
+    os_schedule_wake_up(next_us * 1000u);
+}
+
+static void push_event(uint8 node_id, heartbeat_event_t event, uint8 state, uint64 timestamp_us)
+{
+    heartbeat_entry_t* entry = &events[event_head];
+
+    entry->node_id = node_id;
+    entry->event = event;
+    entry->state = state;
+    entry->timestamp_us = timestamp_us;
+
+    /* A full queue drops the oldest event. */
+    event_head = (event_head + 1u) % HEARTBEAT_EVENT_MAX;
+    if (event_count < HEARTBEAT_EVENT_MAX)
+    {
+        event_count += 1;
+    }
+}
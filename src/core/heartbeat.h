@@ -0,0 +1,74 @@
+/** @file heartbeat.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef HEARTBEAT_H
+#define HEARTBEAT_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+#define HEARTBEAT_NODE_MAX 0x7f
+#define HEARTBEAT_EVENT_MAX 256
+#define HEARTBEAT_CHECK_INTERVAL_NS 1000000u
+
+typedef enum
+{
+    HEARTBEAT_BOOT_UP = 0,
+    HEARTBEAT_STATE_CHANGED,
+    HEARTBEAT_TIMEOUT,
+    HEARTBEAT_RESUMED
+
+} heartbeat_event_t;
+
+typedef struct heartbeat_node
+{
+    bool is_seen;
+    bool is_timed_out;
+    uint8 state;  /* 0x00, 0x04, 0x05 or 0x7f, toggle bit removed. */
+    uint64 last_seen_us;
+    uint64 boot_up_us;  /* Last boot-up message. */
+    uint32 period_us;  /* Interval between the last two heartbeats. */
+    uint32 timeout_ms;  /* 0: node life time if guarded, else twice the measured period. */
+    uint32 guard_time_ms;  /* 0: not guarded. */
+    uint8 life_time_factor;
+    uint8 toggle;  /* Toggle bit of the next guarding response. */
+    uint64 next_guard_us;
+    uint32 frames;
+    uint32 timeouts;
+    uint32 toggle_errors;
+
+} heartbeat_node_t;
+
+typedef struct heartbeat_entry
+{
+    uint8 node_id;
+    heartbeat_event_t event;
+    uint8 state;
+    uint64 timestamp_us;
+
+} heartbeat_entry_t;
+
+typedef void (*heartbeat_callback_t)(const heartbeat_entry_t* entry, void* user);
+
+void heartbeat_update(core_t* core);
+void heartbeat_on_receive(const can_message_t* message);
+void heartbeat_on_read(const can_message_t* message);
+status_t heartbeat_get_node(uint8 node_id, heartbeat_node_t* node);
+status_t heartbeat_set_timeout(uint8 node_id, uint32 timeout_ms);
+status_t heartbeat_set_guarding(uint8 node_id, uint32 guard_time_ms, uint8 life_time_factor);
+uint32 heartbeat_get_events(heartbeat_entry_t* entries, uint32 max_count);
+void heartbeat_set_callback(heartbeat_callback_t callback, void* user);
+const char* heartbeat_get_state_name(uint8 state);
+const char* heartbeat_get_event_name(heartbeat_event_t event);
+void heartbeat_print(void);
+void heartbeat_reset(void);
+void heartbeat_close(void);
+
+#endif /* HEARTBEAT_H */
@@ -0,0 +1,365 @@
+/** @file lss.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "lss.h"
+#include "can.h"
+#include "core.h"
+#include "heartbeat.h"
+#include "os.h"
+#include "sdo.h"
+#include "table.h"
+
+#define LSS_FASTSCAN_RESET 0x80
+
+static status_t send(lss_command_t command, uint32 value, uint8 byte5, uint8 byte6, uint8 byte7);
+static bool wait_response(lss_command_t command, uint64 timeout_ns, can_message_t* response);
+static bool fastscan_step(uint32 id_number, uint8 bit_checked, uint8 sub, uint8 next, uint64 timeout_ns);
+static status_t confirm(lss_command_t command);
+static uint8 next_free_node_id(uint8 node_id);
+static void print_assignments(const lss_assignment_t* assignments, uint32 count, uint64 duration_ns);
+
+status_t lss_switch_mode_global(lss_mode_t mode)
+{
+    return send(LSS_SWITCH_MODE_GLOBAL, (uint32)mode, 0, 0, 0);
+}
+
+status_t lss_switch_mode_selective(const lss_identity_t* identity)
+{
+    can_message_t response = {0};
+
+    if (NULL == identity)
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if ((ALL_OK != send(LSS_SWITCH_MODE_SELECTIVE_VENDOR, identity->vendor_id, 0, 0, 0)) ||
+        (ALL_OK != send(LSS_SWITCH_MODE_SELECTIVE_PRODUCT, identity->product_code, 0, 0, 0)) ||
+        (ALL_OK != send(LSS_SWITCH_MODE_SELECTIVE_REVISION, identity->revision, 0, 0, 0)) ||
+        (ALL_OK != send(LSS_SWITCH_MODE_SELECTIVE_SERIAL, identity->serial, 0, 0, 0)))
+    {
+        return CAN_WRITE_ERROR;
+    }
+
+    if (false == wait_response(LSS_SWITCH_MODE_SELECTIVE_RESPONSE, LSS_TIMEOUT_IN_NS, &response))
+    {
+        return LSS_NO_RESPONSE;
+    }
+
+    return ALL_OK;
+}
+
+status_t lss_configure_node_id(uint8 node_id)
+{
+    status_t status;
+
+    /* 0xff leaves the node unconfigured. */
+    if ((0 == node_id) || ((node_id > LSS_NODE_MAX) && (0xff != node_id)))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    status = send(LSS_CONFIGURE_NODE_ID, node_id, 0, 0, 0);
+    if (ALL_OK != status)
+    {
+        return status;
+    }
+
+    return confirm(LSS_CONFIGURE_NODE_ID);
+}
+
+status_t lss_store_configuration(void)
+{
+    status_t status = send(LSS_STORE_CONFIGURATION, 0, 0, 0, 0);
+
+    if (ALL_OK != status)
+    {
+        return status;
+    }
+
+    return confirm(LSS_STORE_CONFIGURATION);
+}
+
+status_t lss_fastscan(lss_identity_t* identity, uint32 timeout_us)
+{
+    uint32 id_number[4] = {0};
+    uint64 timeout_ns;
+    uint8 sub;
+    int bit;
+
+    if (NULL == identity)
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (0 == timeout_us)
+    {
+        timeout_us = LSS_FASTSCAN_TIMEOUT_US;
+    }
+    timeout_ns = (uint64)timeout_us * 1000u;
+
+    /* Every unconfigured slave answers the reset. */
+    if (false == fastscan_step(0, LSS_FASTSCAN_RESET, 0, 0, timeout_ns))
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    /* Binary search, most significant bit first: a zero that nobody
+     * confirms must be a one.
+     */
+    for (sub = 0; sub < 4; sub += 1)
+    {
+        for (bit = 31; bit >= 0; bit -= 1)
+        {
+            if (false == fastscan_step(id_number[sub], (uint8)bit, sub, sub, timeout_ns))
+            {
+                id_number[sub] |= (1u << bit);
+            }
+        }
+
+        /* The matching slaves move on to the next part of the identity. */
+        if (false == fastscan_step(id_number[sub], 0, sub, (uint8)((sub + 1u) & 0x03), timeout_ns))
+        {
+            return LSS_NO_RESPONSE;
+        }
+    }
+
+    /* The one slave left is in configuration mode now. */
+    identity->vendor_id = id_number[0];
+    identity->product_code = id_number[1];
+    identity->revision = id_number[2];
+    identity->serial = id_number[3];
+
+    return ALL_OK;
+}
+
+uint32 lss_assign_node_ids(uint8 first_node_id, bool store, lss_assignment_t* assignments, uint32 max_count, disp_mode_t disp_mode)
+{
+    lss_assignment_t local[LSS_NODE_MAX];
+    uint64 start_time = os_get_ticks();
+    uint32 count = 0;
+    uint8 node_id;
+
+    if (NULL == assignments)
+    {
+        assignments = local;
+        max_count = LSS_NODE_MAX;
+    }
+
+    if ((0 == first_node_id) || (first_node_id > LSS_NODE_MAX))
+    {
+        return 0;
+    }
+
+    node_id = first_node_id;
+
+    /* Configured slaves stop answering the Fastscan, so each pass finds a new one. */
+    while ((count < max_count) && (0 != node_id))
+    {
+        lss_assignment_t* assignment = &assignments[count];
+        status_t status;
+
+        status = lss_fastscan(&assignment->identity, 0);
+        if (ITEM_NOT_FOUND == status)
+        {
+            break;
+        }
+        else if (ALL_OK != status)
+        {
+            if (SILENT != disp_mode)
+            {
+                os_log(LOG_ERROR, "LSS Fastscan aborted: no confirmation from the slave");
+            }
+            break;
+        }
+
+        /* Only look for a Node-ID once there is a device to take it:
+         * checking a free one costs an SDO timeout.
+         */
+        node_id = next_free_node_id(node_id);
+        if (0 == node_id)
+        {
+            lss_switch_mode_global(LSS_MODE_WAITING);
+            if (SILENT != disp_mode)
+            {
+                os_log(LOG_ERROR, "LSS slave %08Xh left unconfigured: no free Node-ID", assignment->identity.serial);
+            }
+            break;
+        }
+
+        status = lss_configure_node_id(node_id);
+        if ((ALL_OK == status) && (true == store))
+        {
+            status = lss_store_configuration();
+        }
+
+        /* Back to waiting: the slave takes over its new Node-ID. */
+        lss_switch_mode_global(LSS_MODE_WAITING);
+
+        if (ALL_OK != status)
+        {
+            if (SILENT != disp_mode)
+            {
+                os_log(LOG_ERROR, "LSS slave %08Xh rejected Node-ID 0x%02x", assignment->identity.serial, node_id);
+            }
+            break;
+        }
+
+        assignment->node_id = node_id;
+        count += 1;
+
+        node_id = (node_id < LSS_NODE_MAX) ? (node_id + 1u) : 0;
+    }
+
+    if (SILENT != disp_mode)
+    {
+        print_assignments(assignments, count, os_get_ticks() - start_time);
+    }
+
+    return count;
+}
+
+static status_t send(lss_command_t command, uint32 value, uint8 byte5, uint8 byte6, uint8 byte7)
+{
+    can_message_t message = {0};
+
+    message.id = LSS_MASTER_ID;
+    message.length = 8;
+    message.data[0] = (uint8)command;
+    message.data[1] = (uint8)(value & 0xff);
+    message.data[2] = (uint8)((value >> 8) & 0xff);
+    message.data[3] = (uint8)((value >> 16) & 0xff);
+    message.data[4] = (uint8)((value >> 24) & 0xff);
+    message.data[5] = byte5;
+    message.data[6] = byte6;
+    message.data[7] = byte7;
+
+    if (0 != can_write(&message, SILENT, NULL))
+    {
+        return CAN_WRITE_ERROR;
+    }
+
+    return ALL_OK;
+}
+
+static bool wait_response(lss_command_t command, uint64 timeout_ns, can_message_t* response)
+{
+    uint64 deadline = os_get_ticks() + timeout_ns;
+
+    while (os_get_ticks() < deadline)
+    {
+        if ((ALL_OK == can_read(response)) && (LSS_SLAVE_ID == response->id) && ((uint8)command == response->data[0]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool fastscan_step(uint32 id_number, uint8 bit_checked, uint8 sub, uint8 next, uint64 timeout_ns)
+{
+    can_message_t response = {0};
+
+    if (ALL_OK != send(LSS_FASTSCAN, id_number, bit_checked, sub, next))
+    {
+        return false;
+    }
+
+    if (false == wait_response(LSS_IDENTIFY_SLAVE, timeout_ns, &response))
+    {
+        return false;
+    }
+
+    /* Any number of slaves may answer: the others must not be taken
+     * for answers to the next step.
+     */
+    while (true == wait_response(LSS_IDENTIFY_SLAVE, timeout_ns / 4u, &response))
+    {
+        /* Discard. */
+    }
+
+    return true;
+}
+
+static status_t confirm(lss_command_t command)
+{
+    can_message_t response = {0};
+
+    if (false == wait_response(command, LSS_TIMEOUT_IN_NS, &response))
+    {
+        return LSS_NO_RESPONSE;
+    }
+
+    /* Error code 0: protocol successfully completed. */
+    if (0 != response.data[1])
+    {
+        return LSS_REJECTED;
+    }
+
+    return ALL_OK;
+}
+
+static uint8 next_free_node_id(uint8 node_id)
+{
+    for (; node_id <= LSS_NODE_MAX; node_id += 1)
+    {
+        heartbeat_node_t node;
+        can_message_t sdo_response = {0};
+
+        if (ALL_OK == heartbeat_get_node(node_id, &node))
+        {
+            continue;
+        }
+
+        /* A node without heartbeat isn't in the table. Every CANopen
+         * device has a device type, so only a free Node-ID stays silent.
+         */
+        if (ABORT_TRANSFER == sdo_read_uncached(&sdo_response, SILENT, node_id, 0x1000, 0x00, NULL))
+        {
+            return node_id;
+        }
+    }
+
+    return 0;
+}
+
+static void print_assignments(const lss_assignment_t* assignments, uint32 count, uint64 duration_ns)
+{
+    table_t table = {DARK_CYAN, DEFAULT_COLOR, 4, 32, 32};
+    uint32 i;
+
+    table_init(&table, 1024);
+    table_print_header(&table);
+    table_print_row("ID", "Vendor-ID / Product code", "Revision / Serial number", &table);
+    table_print_divider(&table);
+
+    for (i = 0; i < count; i += 1)
+    {
+        const lss_assignment_t* assignment = &assignments[i];
+        char id_str[5] = {0};
+        char product[33] = {0};
+        char revision[33] = {0};
+
+        os_snprintf(id_str, sizeof(id_str), "0x%02x", assignment->node_id);
+        os_snprintf(product, sizeof(product), "%08Xh / %08Xh", assignment->identity.vendor_id, assignment->identity.product_code);
+        os_snprintf(revision, sizeof(revision), "%08Xh / %08Xh", assignment->identity.revision, assignment->identity.serial);
+
+        table_print_row(id_str, product, revision, &table);
+    }
+
+    if (0 == count)
+    {
+        table_print_row("-", "No unconfigured slaves found", "-", &table);
+    }
+
+    table_print_footer(&table);
+    table_flush(&table);
+
+    os_log(LOG_INFO, "%u Node-ID(s) assigned in %u ms", count, (uint32)(duration_ns / 1000000u));
+}
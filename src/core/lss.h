@@ -0,0 +1,68 @@
+/** @file lss.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef LSS_H
+#define LSS_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+#define LSS_MASTER_ID 0x7e5
+#define LSS_SLAVE_ID 0x7e4
+#define LSS_NODE_MAX 0x7f
+#define LSS_TIMEOUT_IN_NS 100000000u
+#define LSS_FASTSCAN_TIMEOUT_US 1000u
+
+typedef enum
+{
+    LSS_SWITCH_MODE_GLOBAL = 0x04,
+    LSS_CONFIGURE_NODE_ID = 0x11,
+    LSS_STORE_CONFIGURATION = 0x17,
+    LSS_SWITCH_MODE_SELECTIVE_VENDOR = 0x40,
+    LSS_SWITCH_MODE_SELECTIVE_PRODUCT = 0x41,
+    LSS_SWITCH_MODE_SELECTIVE_REVISION = 0x42,
+    LSS_SWITCH_MODE_SELECTIVE_SERIAL = 0x43,
+    LSS_SWITCH_MODE_SELECTIVE_RESPONSE = 0x44,
+    LSS_IDENTIFY_SLAVE = 0x4f,
+    LSS_FASTSCAN = 0x51
+
+} lss_command_t;
+
+typedef enum
+{
+    LSS_MODE_WAITING = 0,
+    LSS_MODE_CONFIGURATION = 1
+
+} lss_mode_t;
+
+typedef struct lss_identity
+{
+    uint32 vendor_id;
+    uint32 product_code;
+    uint32 revision;
+    uint32 serial;
+
+} lss_identity_t;
+
+typedef struct lss_assignment
+{
+    uint8 node_id;
+    lss_identity_t identity;
+
+} lss_assignment_t;
+
+status_t lss_switch_mode_global(lss_mode_t mode);
+status_t lss_switch_mode_selective(const lss_identity_t* identity);
+status_t lss_configure_node_id(uint8 node_id);
+status_t lss_store_configuration(void);
+status_t lss_fastscan(lss_identity_t* identity, uint32 timeout_us);
+uint32 lss_assign_node_ids(uint8 first_node_id, bool store, lss_assignment_t* assignments, uint32 max_count, disp_mode_t disp_mode);
+
+#endif /* LSS_H */
@@ -10,9 +10,13 @@
 #include "nmt.h"
 #include "can.h"
 #include "core.h"
+#include "heartbeat.h"
+#include "sdo_cache.h"
 #include "table.h"
 
 void nmt_print_error(const char* reason, nmt_command_t command, disp_mode_t disp_mode);
+static bool is_confirmed(uint8 node_id, nmt_command_t command, uint64 sent_us, uint32* latency_us);
+static void print_transitions(const nmt_transition_t* transitions);
 
 status_t nmt_send_command(uint8 node_id, nmt_command_t command, disp_mode_t disp_mode, const char* comment)
 {
@@ -48,6 +52,11 @@ status_t nmt_send_command(uint8 node_id, nmt_command_t command, disp_mode_t disp
     }
     else
     {
+        if ((NMT_RESET_NODE == command) || (NMT_RESET_COMM == command))
+        {
+            sdo_cache_invalidate(node_id);
+        }
+
         if (SCRIPT_MODE == disp_mode)
         {
             int i;
@@ -94,6 +103,106 @@ status_t nmt_send_command(uint8 node_id, nmt_command_t command, disp_mode_t disp
     return status;
 }
 
+status_t nmt_send_command_confirmed(uint8 node_id, nmt_command_t command, uint32 timeout_ms, nmt_transition_t* transitions, disp_mode_t disp_mode, const char* comment)
+{
+    nmt_transition_t local[NMT_NODE_MAX + 1];
+    status_t status;
+    uint64 deadline;
+    uint64 sent_us;
+    uint8 first;
+    uint8 last;
+    uint8 id;
+    bool is_reset = (NMT_RESET_NODE == command) || (NMT_RESET_COMM == command);
+
+    limit_node_id(&node_id);
+
+    if (NULL == transitions)
+    {
+        transitions = local;
+    }
+
+    os_memset(transitions, 0, (NMT_NODE_MAX + 1) * sizeof(nmt_transition_t));
+
+    first = (0 == node_id) ? 1 : node_id;
+    last = (0 == node_id) ? NMT_NODE_MAX : node_id;
+
+    /* A broadcast waits for every node the heartbeat table knows. */
+    for (id = first; id <= last; id += 1)
+    {
+        heartbeat_node_t node;
+
+        if ((0 != node_id) || (ALL_OK == heartbeat_get_node(id, &node)))
+        {
+            transitions[id].is_expected = true;
+        }
+    }
+
+    sent_us = os_get_ticks() / 1000u;
+    deadline = os_get_ticks() + ((uint64)timeout_ms * 1000000u);
+
+    status = nmt_send_command(node_id, command, disp_mode, comment);
+    if (ALL_OK != status)
+    {
+        return status;
+    }
+
+    while (true)
+    {
+        can_message_t message = {0};
+        bool is_done = true;
+
+        can_read(&message);
+
+        for (id = first; id <= last; id += 1)
+        {
+            nmt_transition_t* transition = &transitions[id];
+
+            if (true == transition->is_confirmed)
+            {
+                continue;
+            }
+
+            /* After a reset, nodes nobody knew about announce themselves too. */
+            if ((false == transition->is_expected) && (false == is_reset))
+            {
+                continue;
+            }
+
+            if (true == is_confirmed(id, command, sent_us, &transition->latency_us))
+            {
+                transition->is_expected = true;
+                transition->is_confirmed = true;
+            }
+            else if (true == transition->is_expected)
+            {
+                is_done = false;
+            }
+        }
+
+        if ((true == is_done) || (os_get_ticks() >= deadline))
+        {
+            break;
+        }
+    }
+
+    status = ALL_OK;
+
+    for (id = first; id <= last; id += 1)
+    {
+        if ((true == transitions[id].is_expected) && (false == transitions[id].is_confirmed))
+        {
+            status = NMT_NOT_CONFIRMED;
+        }
+    }
+
+    if (SILENT != disp_mode)
+    {
+        print_transitions(transitions);
+    }
+
+    return status;
+}
+
 status_t nmt_print_help(disp_mode_t disp_mode)
 {
     status_t status;
@@ -147,3 +256,90 @@ void nmt_print_error(const char* reason, nmt_command_t command, disp_mode_t disp
             break;
     }
 }
+
+static bool is_confirmed(uint8 node_id, nmt_command_t command, uint64 sent_us, uint32* latency_us)
+{
+    heartbeat_node_t node;
+    uint8 expected_state;
+
+    if (ALL_OK != heartbeat_get_node(node_id, &node))
+    {
+        return false;
+    }
+
+    switch (command)
+    {
+        case NMT_OPERATIONAL:
+            expected_state = 0x05;
+            break;
+        case NMT_STOP:
+            expected_state = 0x04;
+            break;
+        case NMT_PRE_OPERATIONAL:
+            expected_state = 0x7f;
+            break;
+        case NMT_RESET_NODE:
+        case NMT_RESET_COMM:
+        default:
+            /* Both resets end with a boot-up message. */
+            if (node.boot_up_us < sent_us)
+            {
+                return false;
+            }
+
+            *latency_us = (uint32)(node.boot_up_us - sent_us);
+            return true;
+    }
+
+    if ((node.last_seen_us < sent_us) || (expected_state != node.state))
+    {
+        return false;
+    }
+
+    *latency_us = (uint32)(node.last_seen_us - sent_us);
+    return true;
+}
+
+static void print_transitions(const nmt_transition_t* transitions)
+{
+    table_t table = {DARK_CYAN, DEFAULT_COLOR, 4, 11, 20};
+    uint8 id;
+    bool is_empty = true;
+
+    table_init(&table, 1024);
+    table_print_header(&table);
+    table_print_row("ID", "Status", "Latency", &table);
+    table_print_divider(&table);
+
+    for (id = 1; id <= NMT_NODE_MAX; id += 1)
+    {
+        char id_str[5] = {0};
+        char latency[21] = {0};
+
+        if (false == transitions[id].is_expected)
+        {
+            continue;
+        }
+
+        os_snprintf(id_str, sizeof(id_str), "0x%02x", id);
+
+        if (true == transitions[id].is_confirmed)
+        {
+            os_snprintf(latency, sizeof(latency), "%u.%03u ms", transitions[id].latency_us / 1000u, transitions[id].latency_us % 1000u);
+            table_print_row(id_str, "Confirmed", latency, &table);
+        }
+        else
+        {
+            table_print_row(id_str, "No response", "-", &table);
+        }
+        is_empty = false;
+    }
+
+    if (true == is_empty)
+    {
+        table_print_row("-", "-", "No nodes known", &table);
+    }
+
+    table_print_footer(&table);
+    table_flush(&table);
+}
@@ -13,6 +13,8 @@
 #include "core.h"
 #include "os.h"
 
+#define NMT_NODE_MAX 0x7f
+
 typedef enum
 {
     NMT_OPERATIONAL = 0x01,
@@ -23,7 +25,16 @@ typedef enum
 
 } nmt_command_t;
 
+typedef struct nmt_transition
+{
+    bool is_expected;
+    bool is_confirmed;
+    uint32 latency_us;  /* From the command to the confirming message. */
+
+} nmt_transition_t;
+
 status_t nmt_send_command(uint8 node_id, nmt_command_t command, disp_mode_t disp_mode, const char* comment);
+status_t nmt_send_command_confirmed(uint8 node_id, nmt_command_t command, uint32 timeout_ms, nmt_transition_t* transitions, disp_mode_t disp_mode, const char* comment);
 status_t nmt_print_help(disp_mode_t disp_mode);
 
 #endif /* NMT_H */
@@ -1,4 +1,4 @@
-/** @file pdo.h
+/** @file pdo.c
  *
  *  A versatile software tool to analyse and configure CANopen devices.
  *
@@ -12,15 +12,53 @@
 #include "os.h"
 #include "table.h"
 
-static pdo_t pdo[PDO_MAX];
+/* Hierarchical timer wheel: 256 slots of one tick, then three levels
+ * of 64 slots, each covering 64 times the range of the level below.
+ */
+#define WHEEL_ROOT_BITS 8
+#define WHEEL_LEVEL_BITS 6
+#define WHEEL_LEVELS 3
+#define WHEEL_ROOT_SIZE (1u << WHEEL_ROOT_BITS)
+#define WHEEL_LEVEL_SIZE (1u << WHEEL_LEVEL_BITS)
+#define WHEEL_RANGE (1ull << (WHEEL_ROOT_BITS + (WHEEL_LEVELS * WHEEL_LEVEL_BITS)))
 
-static uint64 pdo_send_callback(void* pdo_pt, uint32 id, uint64 interval);
+static pdo_t pdo[PDO_MAX];
+static os_atomic_int slot_by_id[PDO_ID_MAX + 1];  /* Slot index + 1, 0: not active. */
+static pdo_t* free_list;
+static uint32 wheel_count;
+static uint32 phase;
+
+static pdo_t* wheel_root[WHEEL_ROOT_SIZE];
+static pdo_t* wheel[WHEEL_LEVELS][WHEEL_LEVEL_SIZE];
+static uint64 wheel_tick;
+static uint32 wheel_generation;
+static os_timer_id wheel_timer;
+static os_mutex* lock;
+
+static bool init(void);
+static pdo_t* find(uint16 can_id);
+static void publish(pdo_t* entry, uint16 can_id);
+static void retire(pdo_t* entry);
+static void start_wheel(uint64 now);
+static void stop_wheel(void);
+static int wheel_thread(void* generation);
+static uint64 wheel_timer_callback(void* param, os_timer_id id, uint64 interval);
+static void run_wheel(uint64 now);
+static void cascade(uint32 level, uint32 index);
+static void insert(pdo_t* entry);
+static void unlink(pdo_t* entry);
+static void send(pdo_t* entry);
+static void set_payload(uint8* buffer, uint8 length, uint64 data);
+static void load_payload(pdo_t* entry);
+static void add_stats(pdo_stats_t* total, const pdo_stats_t* stats);
 static void print_error(const char* reason, disp_mode_t disp_mode, uint16 can_id);
 
 bool pdo_add(uint16 can_id, uint32 event_time_ms, uint8 length, uint64 data, disp_mode_t disp_mode)
 {
-    int i;
-    uint64 event_time_ns = event_time_ms * 1000000ULL;
+    pdo_t* entry;
+    uint64 now;
+    uint64 period_ticks;
+    bool was_scheduled = false;
 
     if (false == pdo_is_id_valid(can_id))
     {
@@ -28,35 +66,183 @@ bool pdo_add(uint16 can_id, uint32 event_time_ms, uint8 length, uint64 data, dis
         return false;
     }
 
+    if (0 == event_time_ms)
+    {
+        print_error("Could not add PDO: Invalid event time", disp_mode, can_id);
+        return false;
+    }
+
     if (length > 8)
     {
         length = 8;
     }
 
-    if (false == pdo_del(can_id, disp_mode))
+    if (false == init())
     {
-        /* Nothing to do here. */
+        print_error("Could not add PDO: Scheduler not available", disp_mode, can_id);
+        return false;
     }
 
-    for (i = 0; i < PDO_MAX; i += 1)
+    os_lock_mutex(lock);
+
+    now = os_get_ticks();
+    entry = find(can_id);
+
+    if (NULL != entry)
     {
-        if (0 == pdo[i].can_id)
+        retire(entry);
+        was_scheduled = (false == entry->is_offloaded);
+        unlink(entry);
+    }
+    else if (NULL != free_list)
+    {
+        entry = free_list;
+        free_list = entry->next;
+        entry->next = NULL;
+    }
+    else
+    {
+        os_unlock_mutex(lock);
+        print_error("Could not add PDO: No empty slot available", disp_mode, can_id);
+        return false;
+    }
+
+    /* The frame is built once, the scheduler only sends it. */
+    os_memset(&entry->message, 0, sizeof(can_message_t));
+    entry->can_id = can_id;
+    entry->message.id = can_id;
+    entry->message.length = length;
+    set_payload(entry->message.data, length, data);
+
+    os_memcpy(entry->payload[0], entry->message.data, sizeof(entry->payload[0]));
+    os_atomic_set(&entry->payload_begin, 0);
+    os_atomic_set(&entry->payload_end, 0);
+
+    os_memset(&entry->stats, 0, sizeof(pdo_stats_t));
+    entry->period_ns = event_time_ms * 1000000ULL;
+
+    /* Let the kernel send the PDO if the interface supports it. Updates
+     * of an offloaded PDO only replace the payload of the running job.
+     */
+    if ((false == os_is_virtual_time()) && (event_time_ms <= (0xffffffffu / 1000u)))
+    {
+        if (ALL_OK == can_write_cyclic(&entry->message, event_time_ms * 1000u))
         {
-            pdo[i].can_id = can_id;
-            pdo[i].length = length;
-            pdo[i].data = data;
-            pdo[i].id = os_add_timer(event_time_ns, pdo_send_callback, &pdo[i]);
+            entry->is_offloaded = true;
+
+            if (true == was_scheduled)
+            {
+                wheel_count -= 1;
+                if (0 == wheel_count)
+                {
+                    stop_wheel();
+                }
+            }
+
+            publish(entry, can_id);
+            os_unlock_mutex(lock);
             return true;
         }
     }
 
-    print_error("Could not add PDO: No empty slot available", disp_mode, can_id);
-    return false;
+    if (true == entry->is_offloaded)
+    {
+        can_stop_cyclic(can_id);
+        entry->is_offloaded = false;
+    }
+
+    if (false == was_scheduled)
+    {
+        if (0 == wheel_count)
+        {
+            start_wheel(now);
+        }
+        wheel_count += 1;
+    }
+
+    /* Stagger the first transmissions so PDOs with the same event time
+     * are spread over the period instead of sharing one tick.
+     */
+    period_ticks = entry->period_ns / PDO_TICK_IN_NS;
+    entry->deadline_ns = now + ((phase % period_ticks) * PDO_TICK_IN_NS);
+    entry->expires = (entry->deadline_ns + PDO_TICK_IN_NS - 1u) / PDO_TICK_IN_NS;
+    phase += 1;
+
+    insert(entry);
+
+    publish(entry, can_id);
+    os_unlock_mutex(lock);
+    return true;
+}
+
+bool pdo_update(uint16 can_id, uint64 data, disp_mode_t disp_mode)
+{
+    pdo_t* entry;
+    uint32 update;
+    int slot;
+    bool status = true;
+
+    if (false == pdo_is_id_valid(can_id))
+    {
+        print_error("Could not update PDO: Invalid TPDO CAN-ID", disp_mode, can_id);
+        return false;
+    }
+
+    /* No lock: the scheduler holds it for a whole transmit pass. Register
+     * as a reader, then check that the slot still belongs to this CAN-ID;
+     * retire() waits for all readers before a slot is reused.
+     */
+    slot = os_atomic_get(&slot_by_id[can_id]);
+    if (0 == slot)
+    {
+        print_error("Could not update PDO: PDO not active", disp_mode, can_id);
+        return false;
+    }
+
+    entry = &pdo[slot - 1];
+    os_atomic_add(&entry->readers, 1);
+
+    if (can_id != os_atomic_get(&entry->owner))
+    {
+        os_atomic_add(&entry->readers, -1);
+        print_error("Could not update PDO: PDO not active", disp_mode, can_id);
+        return false;
+    }
+
+    /* Write into the buffer the scheduler isn't reading, then publish it.
+     * A PDO is updated by one thread at a time, the script that owns it.
+     */
+    update = (uint32)os_atomic_add(&entry->payload_begin, 1) + 1u;
+    os_memset(entry->payload[update & 1u], 0, sizeof(entry->payload[0]));
+    set_payload(entry->payload[update & 1u], (uint8)entry->message.length, data);
+    os_atomic_set(&entry->payload_end, (int)update);
+
+    if (true == entry->is_offloaded)
+    {
+        can_message_t message = {0};
+
+        message.id = can_id;
+        message.length = entry->message.length;
+        os_memcpy(message.data, entry->payload[update & 1u], sizeof(entry->payload[0]));
+
+        if (ALL_OK != can_write_cyclic(&message, (uint32)(entry->period_ns / 1000u)))
+        {
+            status = false;
+        }
+    }
+
+    os_atomic_add(&entry->readers, -1);
+
+    if (false == status)
+    {
+        print_error("Could not update PDO: CAN write error", disp_mode, can_id);
+    }
+    return status;
 }
 
 bool pdo_del(uint16 can_id, disp_mode_t disp_mode)
 {
-    int i;
+    pdo_t* entry;
 
     if (false == pdo_is_id_valid(can_id))
     {
@@ -64,43 +250,170 @@ bool pdo_del(uint16 can_id, disp_mode_t disp_mode)
         return false;
     }
 
-    for (i = 0; i < PDO_MAX; i += 1)
+    if (NULL == lock)
+    {
+        return true;
+    }
+
+    os_lock_mutex(lock);
+
+    entry = find(can_id);
+    if (NULL != entry)
     {
-        if (can_id == pdo[i].can_id)
+        os_atomic_set(&slot_by_id[can_id], 0);
+        retire(entry);
+
+        if (true == entry->is_offloaded)
         {
-            pdo[i].can_id = 0;
-            pdo[i].length = 0;
-            pdo[i].data = 0;
+            can_stop_cyclic(can_id);
+        }
+        else
+        {
+            unlink(entry);
 
-            os_remove_timer(pdo[i].id);
-            break;
+            wheel_count -= 1;
+            if (0 == wheel_count)
+            {
+                stop_wheel();
+            }
         }
+
+        os_memset(entry, 0, sizeof(pdo_t));
+        entry->next = free_list;
+        free_list = entry;
     }
 
+    os_unlock_mutex(lock);
     return true;
 }
 
-static uint64 pdo_send_callback(void* pdo_pt, uint32 id, uint64 interval)
+void pdo_del_all(void)
 {
-    int i;
-    int offset = 0;
-    pdo_t* pdo = pdo_pt;
-    can_message_t message = {0};
+    uint16 can_id;
 
-    (void)id;
+    for (can_id = 0; can_id <= PDO_ID_MAX; can_id += 1)
+    {
+        if (0 != os_atomic_get(&slot_by_id[can_id]))
+        {
+            pdo_del(can_id, SILENT);
+        }
+    }
+}
 
-    message.id = pdo->can_id;
-    message.length = pdo->length;
+void pdo_rearm(void)
+{
+    uint16 can_id;
+    uint64 now;
 
-    for (i = (pdo->length - 1); i >= 0; i -= 1)
+    if (NULL == lock)
     {
-        message.data[i] = ((pdo->data >> offset) & 0xFF);
-        offset += 8;
+        return;
     }
 
-    can_write(&message, SILENT, NULL);
+    os_lock_mutex(lock);
 
-    return interval;
+    now = os_get_ticks();
+
+    /* The kernel dropped the cyclic jobs along with the BCM socket. */
+    for (can_id = 0; can_id <= PDO_ID_MAX; can_id += 1)
+    {
+        pdo_t* entry = find(can_id);
+
+        if ((NULL == entry) || (false == entry->is_offloaded))
+        {
+            continue;
+        }
+
+        load_payload(entry);
+        if (ALL_OK == can_write_cyclic(&entry->message, (uint32)(entry->period_ns / 1000u)))
+        {
+            continue;
+        }
+
+        /* No BCM on the new interface: the wheel takes over. */
+        retire(entry);
+        entry->is_offloaded = false;
+        if (0 == wheel_count)
+        {
+            start_wheel(now);
+        }
+        wheel_count += 1;
+
+        entry->deadline_ns = now;
+        entry->expires = (now + PDO_TICK_IN_NS - 1u) / PDO_TICK_IN_NS;
+        insert(entry);
+        publish(entry, can_id);
+    }
+
+    os_unlock_mutex(lock);
+}
+
+status_t pdo_get_stats(uint16 can_id, pdo_stats_t* stats)
+{
+    status_t status = ALL_OK;
+
+    if ((NULL == stats) || (can_id > PDO_ID_MAX))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    os_memset(stats, 0, sizeof(pdo_stats_t));
+
+    if (NULL == lock)
+    {
+        return (0 == can_id) ? ALL_OK : ITEM_NOT_FOUND;
+    }
+
+    os_lock_mutex(lock);
+
+    /* CAN-ID 0 sums up all PDOs. */
+    if (0 == can_id)
+    {
+        uint16 i;
+
+        for (i = 0; i < PDO_MAX; i += 1)
+        {
+            if (0 != pdo[i].can_id)
+            {
+                add_stats(stats, &pdo[i].stats);
+            }
+        }
+    }
+    else
+    {
+        pdo_t* entry = find(can_id);
+
+        if (NULL != entry)
+        {
+            os_memcpy(stats, &entry->stats, sizeof(pdo_stats_t));
+        }
+        else
+        {
+            status = ITEM_NOT_FOUND;
+        }
+    }
+
+    os_unlock_mutex(lock);
+    return status;
+}
+
+void pdo_reset_stats(void)
+{
+    uint16 i;
+
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    for (i = 0; i < PDO_MAX; i += 1)
+    {
+        os_memset(&pdo[i].stats, 0, sizeof(pdo_stats_t));
+    }
+
+    os_unlock_mutex(lock);
 }
 
 status_t pdo_print_help(void)
@@ -189,6 +502,360 @@ void pdo_print_result(uint16 can_id, uint32 event_time_ms, uint64 data, bool was
     }
 }
 
+static bool init(void)
+{
+    int i;
+
+    if (NULL != lock)
+    {
+        return true;
+    }
+
+    lock = os_create_mutex();
+    if (NULL == lock)
+    {
+        return false;
+    }
+
+    for (i = PDO_MAX - 1; i >= 0; i -= 1)
+    {
+        pdo[i].next = free_list;
+        free_list = &pdo[i];
+    }
+
+    return true;
+}
+
+static pdo_t* find(uint16 can_id)
+{
+    int slot = os_atomic_get(&slot_by_id[can_id]);
+
+    if (0 == slot)
+    {
+        return NULL;
+    }
+    return &pdo[slot - 1];
+}
+
+static void publish(pdo_t* entry, uint16 can_id)
+{
+    os_atomic_set(&entry->owner, can_id);
+    os_atomic_set(&slot_by_id[can_id], (int)(entry - pdo) + 1);
+}
+
+/* Take the slot away from pdo_update() and wait for updates that are
+ * still writing to it. Both sides use sequentially consistent atomics,
+ * so either the reader sees the cleared owner or this sees the reader.
+ */
+static void retire(pdo_t* entry)
+{
+    os_atomic_set(&entry->owner, 0);
+
+    while (0 != os_atomic_get(&entry->readers))
+    {
+        /* An update is a few stores and at most one BCM write. */
+    }
+}
+
+static void start_wheel(uint64 now)
+{
+    wheel_tick = now / PDO_TICK_IN_NS;
+    wheel_generation += 1;
+
+    /* Virtual time only advances through os timers: tick the wheel from one. */
+    if (true == os_is_virtual_time())
+    {
+        wheel_timer = os_add_timer(PDO_TICK_IN_NS, wheel_timer_callback, NULL);
+    }
+    else
+    {
+        os_thread* thread = os_create_thread(wheel_thread, "PDO thread", (void*)(size_t)wheel_generation);
+
+        if (NULL != thread)
+        {
+            os_detach_thread(thread);
+        }
+    }
+}
+
+static void stop_wheel(void)
+{
+    /* The thread ends on its next tick. */
+    wheel_generation += 1;
+
+    if (0 != wheel_timer)
+    {
+        os_remove_timer(wheel_timer);
+        wheel_timer = 0;
+    }
+}
+
+static int wheel_thread(void* generation)
+{
+    while (true)
+    {
+        os_lock_mutex(lock);
+
+        if ((uint32)(size_t)generation != wheel_generation)
+        {
+            os_unlock_mutex(lock);
+            break;
+        }
+
+        run_wheel(os_get_ticks());
+
+        os_unlock_mutex(lock);
+        os_delay(1);
+    }
+
+    return 0;
+}
+
+static uint64 wheel_timer_callback(void* param, os_timer_id id, uint64 interval)
+{
+    (void)param;
+    (void)id;
+
+    os_lock_mutex(lock);
+    run_wheel(os_get_ticks());
+    os_unlock_mutex(lock);
+
+    return interval;
+}
+
+static void run_wheel(uint64 now)
+{
+    uint64 now_tick = now / PDO_TICK_IN_NS;
+
+    while (wheel_tick <= now_tick)
+    {
+        uint32 index = (uint32)(wheel_tick & (WHEEL_ROOT_SIZE - 1u));
+        pdo_t* entry;
+
+        if (0 == index)
+        {
+            uint32 level;
+
+            /* Move the entries of the next slot one level down. */
+            for (level = 0; level < WHEEL_LEVELS; level += 1)
+            {
+                uint32 shift = WHEEL_ROOT_BITS + (level * WHEEL_LEVEL_BITS);
+                uint32 level_index = (uint32)((wheel_tick >> shift) & (WHEEL_LEVEL_SIZE - 1u));
+
+                cascade(level, level_index);
+                if (0 != level_index)
+                {
+                    break;
+                }
+            }
+        }
+
+        entry = wheel_root[index];
+        wheel_root[index] = NULL;
+        wheel_tick += 1;
+
+        while (NULL != entry)
+        {
+            pdo_t* next = entry->next;
+
+            entry->prev = NULL;
+            entry->next = NULL;
+            entry->list = NULL;
+
+            send(entry);
+            insert(entry);
+
+            entry = next;
+        }
+    }
+}
+
+static void cascade(uint32 level, uint32 index)
+{
+    pdo_t* entry = wheel[level][index];
+
+    wheel[level][index] = NULL;
+
+    while (NULL != entry)
+    {
+        pdo_t* next = entry->next;
+
+        entry->prev = NULL;
+        entry->next = NULL;
+        entry->list = NULL;
+        insert(entry);
+
+        entry = next;
+    }
+}
+
+static void insert(pdo_t* entry)
+{
+    pdo_t** list;
+    uint64 expires = entry->expires;
+    uint64 delta;
+
+    if (expires < wheel_tick)
+    {
+        expires = wheel_tick;
+    }
+
+    delta = expires - wheel_tick;
+
+    if (delta < WHEEL_ROOT_SIZE)
+    {
+        list = &wheel_root[expires & (WHEEL_ROOT_SIZE - 1u)];
+    }
+    else
+    {
+        uint32 level;
+        uint32 shift = WHEEL_ROOT_BITS;
+
+        /* Beyond the range of the wheel, park in the last slot and
+         * re-sort when it cascades.
+         */
+        if (delta >= WHEEL_RANGE)
+        {
+            expires = wheel_tick + WHEEL_RANGE - 1u;
+            delta = WHEEL_RANGE - 1u;
+        }
+
+        for (level = 0; level < (WHEEL_LEVELS - 1u); level += 1)
+        {
+            if (delta < (1ull << (shift + WHEEL_LEVEL_BITS)))
+            {
+                break;
+            }
+            shift += WHEEL_LEVEL_BITS;
+        }
+
+        list = &wheel[level][(expires >> shift) & (WHEEL_LEVEL_SIZE - 1u)];
+    }
+
+    entry->prev = NULL;
+    entry->next = *list;
+    entry->list = list;
+
+    if (NULL != *list)
+    {
+        (*list)->prev = entry;
+    }
+    *list = entry;
+}
+
+static void unlink(pdo_t* entry)
+{
+    if (NULL == entry->list)
+    {
+        return;
+    }
+
+    if (NULL != entry->prev)
+    {
+        entry->prev->next = entry->next;
+    }
+    else
+    {
+        *entry->list = entry->next;
+    }
+
+    if (NULL != entry->next)
+    {
+        entry->next->prev = entry->prev;
+    }
+
+    entry->prev = NULL;
+    entry->next = NULL;
+    entry->list = NULL;
+}
+
+static void send(pdo_t* entry)
+{
+    pdo_stats_t* stats = &entry->stats;
+    uint64 now;
+    uint64 jitter;
+
+    load_payload(entry);
+    can_write(&entry->message, SILENT, NULL);
+
+    now = os_get_ticks();
+    jitter = (now > entry->deadline_ns) ? (now - entry->deadline_ns) : 0;
+
+    if ((0 == stats->sent) || (jitter < stats->jitter_min_ns))
+    {
+        stats->jitter_min_ns = jitter;
+    }
+    if (jitter > stats->jitter_max_ns)
+    {
+        stats->jitter_max_ns = jitter;
+    }
+    stats->jitter_sum_ns += jitter;
+    stats->sent += 1;
+
+    /* Step from the previous deadline, not from now, so one late frame
+     * does not delay every frame after it.
+     */
+    entry->deadline_ns += entry->period_ns;
+    if (entry->deadline_ns <= now)
+    {
+        uint64 missed = ((now - entry->deadline_ns) / entry->period_ns) + 1u;
+
+        stats->missed += (uint32)missed;
+        entry->deadline_ns += missed * entry->period_ns;
+    }
+
+    entry->expires = (entry->deadline_ns + PDO_TICK_IN_NS - 1u) / PDO_TICK_IN_NS;
+}
+
+static void set_payload(uint8* buffer, uint8 length, uint64 data)
+{
+    int i;
+    int offset = 0;
+
+    for (i = (length - 1); i >= 0; i -= 1)
+    {
+        buffer[i] = ((data >> offset) & 0xFF);
+        offset += 8;
+    }
+}
+
+static void load_payload(pdo_t* entry)
+{
+    uint32 published;
+
+    /* Copy again if pdo_update() started to overwrite the buffer
+     * while it was being read.
+     */
+    do
+    {
+        published = (uint32)os_atomic_get(&entry->payload_end);
+        os_memcpy(entry->message.data, entry->payload[published & 1u], sizeof(entry->payload[0]));
+    }
+    while (((uint32)os_atomic_get(&entry->payload_begin) - published) > 1u);
+}
+
+static void add_stats(pdo_stats_t* total, const pdo_stats_t* stats)
+{
+    if (0 == stats->sent)
+    {
+        total->missed += stats->missed;
+        return;
+    }
+
+    if ((0 == total->sent) || (stats->jitter_min_ns < total->jitter_min_ns))
+    {
+        total->jitter_min_ns = stats->jitter_min_ns;
+    }
+    if (stats->jitter_max_ns > total->jitter_max_ns)
+    {
+        total->jitter_max_ns = stats->jitter_max_ns;
+    }
+
+    total->jitter_sum_ns += stats->jitter_sum_ns;
+    total->sent += stats->sent;
+    total->missed += stats->missed;
+}
+
 static void print_error(const char* reason, disp_mode_t disp_mode, uint16 can_id)
 {
     if (SCRIPT_MODE != disp_mode)
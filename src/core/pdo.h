@@ -10,22 +10,51 @@
 #ifndef PDO_H
 #define PDO_H
 
+#include "can.h"
 #include "core.h"
 #include "os.h"
 
 #define PDO_MAX 0x1f8 /* TPDO1 - TPDO4 */
+#define PDO_ID_MAX 0x4ff
+#define PDO_TICK_IN_NS 1000000u
+
+typedef struct pdo_stats
+{
+    uint32 sent;
+    uint32 missed;  /* Deadlines skipped because the scheduler fell behind. */
+    uint64 jitter_min_ns;
+    uint64 jitter_max_ns;
+    uint64 jitter_sum_ns;
+
+} pdo_stats_t;
 
 typedef struct pdo
 {
-    os_timer_id id;
     uint16 can_id;
-    uint8 length;
-    uint64 data;
+    can_message_t message;
+    uint64 period_ns;
+    uint64 deadline_ns;
+    uint64 expires;  /* Wheel tick. */
+    struct pdo* prev;
+    struct pdo* next;
+    struct pdo** list;
+    bool is_offloaded;  /* Sent by the kernel, not by the wheel. */
+    uint8 payload[2][8];  /* Double buffer, written by pdo_update(). */
+    os_atomic_int payload_begin;  /* Updates started. */
+    os_atomic_int payload_end;  /* Updates published. */
+    os_atomic_int owner;  /* CAN-ID while in use, 0 once retired. */
+    os_atomic_int readers;  /* pdo_update() calls using the slot. */
+    pdo_stats_t stats;
 
 } pdo_t;
 
 bool pdo_add(uint16 can_id, uint32 event_time_ms, uint8 length, uint64 data, disp_mode_t disp_mode);
+bool pdo_update(uint16 can_id, uint64 data, disp_mode_t disp_mode);
 bool pdo_del(uint16 can_id, disp_mode_t disp_mode);
+void pdo_del_all(void);
+void pdo_rearm(void);
+status_t pdo_get_stats(uint16 can_id, pdo_stats_t* stats);
+void pdo_reset_stats(void);
 status_t pdo_print_help(void);
 bool pdo_is_id_valid(uint16 can_id);
 void pdo_print_result(uint16 can_id, uint32 event_time_ms, uint64 data, bool was_successful, const char* comment);
@@ -0,0 +1,447 @@
+/** @file pdo_map.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "pdo_map.h"
+#include "can.h"
+#include "codb.h"
+#include "core.h"
+#include "dict.h"
+#include "os.h"
+#include "sdo.h"
+
+static pdo_map_t* maps[PDO_MAP_COB_ID_MAX + 1];
+static os_mutex* lock;
+
+static bool init(void);
+static bool read_value(uint8 node_id, uint16 index, uint8 sub_index, uint32* value);
+static pdo_map_t* compile(uint8 node_id, uint16 number, bool is_tpdo, uint16 cob_id);
+static bool is_signed(data_type_t data_type);
+static data_type_t lookup_data_type(uint16 index, uint8 sub_index);
+static void free_map(pdo_map_t* map);
+static void print_map(const pdo_map_t* map);
+
+uint32 pdo_map_discover(uint8 node_id, disp_mode_t disp_mode)
+{
+    uint32 count = 0;
+    int direction;
+
+    limit_node_id(&node_id);
+
+    if (false == init())
+    {
+        return 0;
+    }
+
+    pdo_map_clear(node_id);
+
+    /* RPDOs at 0x1400/0x1600, TPDOs at 0x1800/0x1a00. */
+    for (direction = 0; direction < 2; direction += 1)
+    {
+        bool is_tpdo = (1 == direction);
+        uint16 comm_index = is_tpdo ? 0x1800 : 0x1400;
+        uint16 number;
+
+        for (number = 0; number < PDO_MAP_CHANNEL_MAX; number += 1)
+        {
+            pdo_map_t* map;
+            uint32 cob_id = 0;
+
+            /* The parameters are contiguous: the first missing one ends the scan. */
+            if (false == read_value(node_id, comm_index + number, 0x01, &cob_id))
+            {
+                break;
+            }
+
+            /* Bit 31 set: PDO not valid, bit 29 set: 29-bit CAN-ID. */
+            if ((0 != (cob_id & 0x80000000)) || (0 != (cob_id & 0x20000000)))
+            {
+                continue;
+            }
+
+            map = compile(node_id, number + 1u, is_tpdo, (uint16)(cob_id & PDO_MAP_COB_ID_MAX));
+            if (NULL == map)
+            {
+                continue;
+            }
+
+            os_lock_mutex(lock);
+            free_map(maps[map->cob_id]);
+            maps[map->cob_id] = map;
+            os_unlock_mutex(lock);
+
+            if (SILENT != disp_mode)
+            {
+                print_map(map);
+            }
+
+            count += 1;
+        }
+    }
+
+    if ((SILENT != disp_mode) && (0 == count))
+    {
+        os_log(LOG_WARNING, "No mapped PDOs found on node %u", node_id);
+    }
+
+    return count;
+}
+
+void pdo_map_decode(const can_message_t* message)
+{
+    pdo_map_t* map;
+    uint64 raw = 0;
+    uint32 i;
+
+    if ((NULL == lock) || (NULL == message) || (message->id > PDO_MAP_COB_ID_MAX))
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    map = maps[message->id];
+    if ((NULL == map) || (message->length < map->length))
+    {
+        os_unlock_mutex(lock);
+        return;
+    }
+
+    /* PDO data is little-endian: one load, then shift and mask per field. */
+    for (i = 0; (i < map->length) && (i < 8u); i += 1)
+    {
+        raw |= (uint64)message->data[i] << (i * 8u);
+    }
+
+    for (i = 0; i < map->field_count; i += 1)
+    {
+        pdo_map_field_t* field = &map->fields[i];
+        uint64 value = (raw >> field->bit_offset) & field->mask;
+
+        if (0 != (value & field->sign_bit))
+        {
+            value |= ~field->mask;
+        }
+
+        field->value = value;
+        field->timestamp_us = message->timestamp_us;
+        field->is_valid = true;
+    }
+
+    map->frames += 1;
+
+    os_unlock_mutex(lock);
+}
+
+status_t pdo_map_get_field(uint8 node_id, uint16 index, uint8 sub_index, pdo_map_field_t* field)
+{
+    status_t status = ITEM_NOT_FOUND;
+    uint32 cob_id;
+
+    if ((NULL == field) || (NULL == lock))
+    {
+        return (NULL == field) ? OS_INVALID_ARGUMENT : ITEM_NOT_FOUND;
+    }
+
+    os_lock_mutex(lock);
+
+    /* The most recently received value wins if an object is mapped twice. */
+    for (cob_id = 0; cob_id <= PDO_MAP_COB_ID_MAX; cob_id += 1)
+    {
+        pdo_map_t* map = maps[cob_id];
+        uint32 i;
+
+        if ((NULL == map) || (node_id != map->node_id))
+        {
+            continue;
+        }
+
+        for (i = 0; i < map->field_count; i += 1)
+        {
+            pdo_map_field_t* candidate = &map->fields[i];
+
+            if ((index != candidate->index) || (sub_index != candidate->sub_index))
+            {
+                continue;
+            }
+
+            if ((ITEM_NOT_FOUND == status) || (candidate->timestamp_us > field->timestamp_us))
+            {
+                os_memcpy(field, candidate, sizeof(pdo_map_field_t));
+                status = ALL_OK;
+            }
+        }
+    }
+
+    os_unlock_mutex(lock);
+    return status;
+}
+
+uint32 pdo_map_get_fields(uint16 cob_id, pdo_map_field_t* fields, uint32 max_count)
+{
+    pdo_map_t* map;
+    uint32 count = 0;
+
+    if ((NULL == lock) || (NULL == fields) || (cob_id > PDO_MAP_COB_ID_MAX))
+    {
+        return 0;
+    }
+
+    os_lock_mutex(lock);
+
+    map = maps[cob_id];
+    if (NULL != map)
+    {
+        count = (map->field_count < max_count) ? map->field_count : max_count;
+        os_memcpy(fields, map->fields, count * sizeof(pdo_map_field_t));
+    }
+
+    os_unlock_mutex(lock);
+    return count;
+}
+
+double pdo_map_to_number(const pdo_map_field_t* field)
+{
+    if (NULL == field)
+    {
+        return 0.0;
+    }
+
+    switch (field->data_type)
+    {
+        case REAL32:
+        case FLOAT_T:
+        {
+            uint32 bits = (uint32)field->value;
+            float number;
+
+            os_memcpy(&number, &bits, sizeof(float));
+            return (double)number;
+        }
+        case REAL64:
+        {
+            double number;
+
+            os_memcpy(&number, &field->value, sizeof(double));
+            return number;
+        }
+        default:
+            if (0 != field->sign_bit)
+            {
+                return (double)(long long)field->value;
+            }
+            return (double)field->value;
+    }
+}
+
+void pdo_map_clear(uint8 node_id)
+{
+    uint32 cob_id;
+
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    for (cob_id = 0; cob_id <= PDO_MAP_COB_ID_MAX; cob_id += 1)
+    {
+        if ((NULL != maps[cob_id]) && ((0 == node_id) || (node_id == maps[cob_id]->node_id)))
+        {
+            free_map(maps[cob_id]);
+            maps[cob_id] = NULL;
+        }
+    }
+
+    os_unlock_mutex(lock);
+}
+
+static bool init(void)
+{
+    if (NULL == lock)
+    {
+        lock = os_create_mutex();
+    }
+
+    return (NULL != lock);
+}
+
+static bool read_value(uint8 node_id, uint16 index, uint8 sub_index, uint32* value)
+{
+    can_message_t sdo_response = {0};
+
+    if (ABORT_TRANSFER == sdo_read(&sdo_response, SILENT, node_id, index, sub_index, NULL))
+    {
+        return false;
+    }
+
+    *value = 0;
+    os_memcpy(value, sdo_response.data, sizeof(uint32));
+
+    return true;
+}
+
+static pdo_map_t* compile(uint8 node_id, uint16 number, bool is_tpdo, uint16 cob_id)
+{
+    uint16 map_index = (uint16)((is_tpdo ? 0x1a00 : 0x1600) + number - 1u);
+    pdo_map_t* map;
+    uint32 count = 0;
+    uint32 bit_offset = 0;
+    uint32 i;
+
+    if ((false == read_value(node_id, map_index, 0x00, &count)) || (0 == (count & 0xff)))
+    {
+        return NULL;
+    }
+
+    count &= 0xff;
+    if (count > PDO_MAP_FIELD_MAX)
+    {
+        count = PDO_MAP_FIELD_MAX;
+    }
+
+    map = os_calloc(1, sizeof(pdo_map_t));
+    if (NULL == map)
+    {
+        return NULL;
+    }
+
+    map->fields = os_calloc(count, sizeof(pdo_map_field_t));
+    if (NULL == map->fields)
+    {
+        os_free(map);
+        return NULL;
+    }
+
+    map->cob_id = cob_id;
+    map->node_id = node_id;
+    map->number = number;
+    map->is_tpdo = is_tpdo;
+
+    for (i = 1; i <= count; i += 1)
+    {
+        pdo_map_field_t* field;
+        uint32 mapping = 0;
+        uint32 bits;
+
+        if (false == read_value(node_id, map_index, (uint8)i, &mapping))
+        {
+            break;
+        }
+
+        bits = mapping & 0xff;
+        if ((0 == bits) || ((bit_offset + bits) > 64))
+        {
+            break;
+        }
+
+        /* Dummy entries (data type indices) only occupy space. */
+        if ((mapping >> 16) >= 0x1000)
+        {
+            const char* name = dict_lookup((uint16)(mapping >> 16), (uint8)((mapping >> 8) & 0xff));
+
+            field = &map->fields[map->field_count];
+            field->index = (uint16)(mapping >> 16);
+            field->sub_index = (uint8)((mapping >> 8) & 0xff);
+            field->bit_offset = (uint8)bit_offset;
+            field->bit_length = (uint8)bits;
+            field->data_type = lookup_data_type(field->index, field->sub_index);
+            field->mask = (bits < 64) ? ((1ULL << bits) - 1u) : ~0ULL;
+            field->sign_bit = is_signed(field->data_type) ? (1ULL << (bits - 1u)) : 0;
+            field->name = os_strdup(name);
+
+            map->field_count += 1;
+        }
+
+        bit_offset += bits;
+    }
+
+    map->length = (uint8)((bit_offset + 7u) / 8u);
+
+    if (0 == map->field_count)
+    {
+        free_map(map);
+        return NULL;
+    }
+
+    return map;
+}
+
+static bool is_signed(data_type_t data_type)
+{
+    switch (data_type)
+    {
+        case INTEGER8:
+        case INTEGER16:
+        case INTEGER24:
+        case INTEGER32:
+        case INTEGER48:
+        case INTEGER56:
+        case INTEGER64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static data_type_t lookup_data_type(uint16 index, uint8 sub_index)
+{
+    object_info_t info;
+
+    os_memset(&info, 0, sizeof(object_info_t));
+
+    if (true == is_codb_loaded())
+    {
+        codb_info_lookup(codb_get_profile(), index, sub_index, &info);
+    }
+
+    if (true == is_ds301_loaded() && false == info.does_exist)
+    {
+        codb_info_lookup(codb_get_ds301_profile(), index, sub_index, &info);
+    }
+
+    if (false == info.does_exist)
+    {
+        return NONE_T;
+    }
+
+    return info.data_type;
+}
+
+static void free_map(pdo_map_t* map)
+{
+    uint32 i;
+
+    if (NULL == map)
+    {
+        return;
+    }
+
+    for (i = 0; i < map->field_count; i += 1)
+    {
+        os_free(map->fields[i].name);
+    }
+
+    os_free(map->fields);
+    os_free(map);
+}
+
+static void print_map(const pdo_map_t* map)
+{
+    uint32 i;
+
+    os_log(LOG_INFO, "%cPDO%u, COB-ID %03Xh, %u byte", map->is_tpdo ? 'T' : 'R', map->number, map->cob_id, map->length);
+
+    for (i = 0; i < map->field_count; i += 1)
+    {
+        const pdo_map_field_t* field = &map->fields[i];
+
+        os_log(LOG_DEFAULT, "  bit %2u, %2u bit: %04Xh sub %02Xh %s", field->bit_offset, field->bit_length, field->index, field->sub_index, field->name);
+    }
+}
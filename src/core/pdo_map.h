@@ -0,0 +1,58 @@
+/** @file pdo_map.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef PDO_MAP_H
+#define PDO_MAP_H
+
+#include "can.h"
+#include "codb.h"
+#include "core.h"
+#include "os.h"
+
+#define PDO_MAP_COB_ID_MAX 0x7ff
+#define PDO_MAP_CHANNEL_MAX 0x200  /* 0x1400 - 0x15ff, 0x1800 - 0x19ff */
+#define PDO_MAP_FIELD_MAX 64
+
+typedef struct pdo_map_field
+{
+    uint16 index;
+    uint8 sub_index;
+    uint8 bit_offset;
+    uint8 bit_length;
+    data_type_t data_type;
+    uint64 mask;
+    uint64 sign_bit;  /* 0 for unsigned types. */
+    char* name;
+    bool is_valid;  /* Received at least once. */
+    uint64 value;  /* Raw, sign-extended for signed types. */
+    uint64 timestamp_us;
+
+} pdo_map_field_t;
+
+typedef struct pdo_map
+{
+    uint16 cob_id;
+    uint8 node_id;
+    uint16 number;  /* 1-based. */
+    bool is_tpdo;  /* Sent by the node, RPDOs are received by it. */
+    uint8 length;  /* Bytes covered by the mapping. */
+    uint32 frames;
+    uint32 field_count;
+    pdo_map_field_t* fields;
+
+} pdo_map_t;
+
+uint32 pdo_map_discover(uint8 node_id, disp_mode_t disp_mode);
+void pdo_map_decode(const can_message_t* message);
+status_t pdo_map_get_field(uint8 node_id, uint16 index, uint8 sub_index, pdo_map_field_t* field);
+uint32 pdo_map_get_fields(uint16 cob_id, pdo_map_field_t* fields, uint32 max_count);
+double pdo_map_to_number(const pdo_map_field_t* field);
+void pdo_map_clear(uint8 node_id);
+
+#endif /* PDO_MAP_H */
@@ -0,0 +1,317 @@
+/** @file scan.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "scan.h"
+#include "can.h"
+#include "core.h"
+#include "heartbeat.h"
+#include "os.h"
+#include "sdo.h"
+#include "table.h"
+
+typedef struct scan_object_id
+{
+    uint16 index;
+    uint8 sub_index;
+
+} scan_object_id_t;
+
+typedef struct scan_job
+{
+    bool is_pending;
+    bool is_sent;
+    uint8 object;
+    uint64 start_time;
+
+} scan_job_t;
+
+static const scan_object_id_t objects[SCAN_OBJECT_COUNT] = {
+    {0x1000, 0x00},
+    {0x1018, 0x01},
+    {0x1018, 0x02},
+    {0x1018, 0x03},
+    {0x1018, 0x04}};
+
+static void start(scan_job_t* job, uint8 object);
+static bool send_pending(scan_job_t* jobs);
+static void handle_response(scan_node_t* nodes, scan_job_t* jobs, const can_message_t* message);
+static void print_nodes(const scan_node_t* nodes);
+
+uint32 scan_network(scan_node_t* nodes, disp_mode_t disp_mode)
+{
+    scan_job_t jobs[SCAN_NODE_MAX + 1];
+    uint32 pending = SCAN_NODE_MAX;
+    uint32 count = 0;
+    uint64 last_sent = os_get_ticks();
+    uint8 node_id;
+
+    if (NULL == nodes)
+    {
+        return 0;
+    }
+
+    os_memset(jobs, 0, sizeof(jobs));
+    os_memset(nodes, 0, (SCAN_NODE_MAX + 1) * sizeof(scan_node_t));
+
+    /* Every Node-ID is probed at once: absent nodes cost one timeout in total. */
+    for (node_id = 1; node_id <= SCAN_NODE_MAX; node_id += 1)
+    {
+        heartbeat_node_t heartbeat;
+
+        nodes[node_id].state = 0xff;
+        if (ALL_OK == heartbeat_get_node(node_id, &heartbeat))
+        {
+            nodes[node_id].is_present = true;
+            nodes[node_id].state = heartbeat.state;
+        }
+
+        start(&jobs[node_id], SCAN_DEVICE_TYPE);
+    }
+
+    while (0 != pending)
+    {
+        can_message_t message = {0};
+        uint64 now;
+
+        if (true == send_pending(jobs))
+        {
+            last_sent = os_get_ticks();
+        }
+
+        if (ALL_OK == can_read(&message))
+        {
+            handle_response(nodes, jobs, &message);
+        }
+
+        now = os_get_ticks();
+        pending = 0;
+
+        for (node_id = 1; node_id <= SCAN_NODE_MAX; node_id += 1)
+        {
+            scan_job_t* job = &jobs[node_id];
+
+            if (false == job->is_pending)
+            {
+                continue;
+            }
+
+            /* Nothing could be sent for a whole timeout: the bus is gone. */
+            if ((false == job->is_sent) && ((now - last_sent) >= SDO_TIMEOUT_IN_NS))
+            {
+                job->is_pending = false;
+                continue;
+            }
+
+            /* Present nodes skip the object, absent ones are done. */
+            if ((true == job->is_sent) && ((now - job->start_time) >= SDO_TIMEOUT_IN_NS))
+            {
+                job->is_pending = false;
+
+                if ((true == nodes[node_id].is_present) && ((job->object + 1u) < SCAN_OBJECT_COUNT))
+                {
+                    start(job, job->object + 1u);
+                }
+            }
+
+            if (true == job->is_pending)
+            {
+                pending += 1;
+            }
+        }
+    }
+
+    for (node_id = 1; node_id <= SCAN_NODE_MAX; node_id += 1)
+    {
+        if (true == nodes[node_id].is_present)
+        {
+            count += 1;
+        }
+    }
+
+    if (SILENT != disp_mode)
+    {
+        print_nodes(nodes);
+    }
+
+    return count;
+}
+
+bool scan_has_value(const scan_node_t* node, scan_object_t object)
+{
+    if ((NULL == node) || (object >= SCAN_OBJECT_COUNT))
+    {
+        return false;
+    }
+
+    return (0 != (node->valid & (1u << object)));
+}
+
+static void start(scan_job_t* job, uint8 object)
+{
+    job->is_pending = true;
+    job->is_sent = false;
+    job->object = object;
+}
+
+static bool send_pending(scan_job_t* jobs)
+{
+    bool is_sent = false;
+    uint8 node_id;
+
+    for (node_id = 1; node_id <= SCAN_NODE_MAX; node_id += 1)
+    {
+        scan_job_t* job = &jobs[node_id];
+        can_message_t msg_out = {0};
+
+        if ((false == job->is_pending) || (true == job->is_sent))
+        {
+            continue;
+        }
+
+        msg_out.id = SDO_REQUEST_BASE_ID + node_id;
+        msg_out.length = 8;
+        msg_out.data[0] = UPLOAD_RESPONSE_SEGMENT_NO_SIZE;
+        msg_out.data[1] = (uint8)(objects[job->object].index & 0x00ff);
+        msg_out.data[2] = (uint8)((objects[job->object].index & 0xff00) >> 8);
+        msg_out.data[3] = objects[job->object].sub_index;
+
+        /* A full transmit queue: the rest goes out on the next pass. */
+        if (0 != can_write(&msg_out, SILENT, NULL))
+        {
+            break;
+        }
+
+        job->is_sent = true;
+        job->start_time = os_get_ticks();
+        is_sent = true;
+    }
+
+    return is_sent;
+}
+
+static void handle_response(scan_node_t* nodes, scan_job_t* jobs, const can_message_t* message)
+{
+    scan_node_t* node;
+    scan_job_t* job;
+    uint8 node_id = (uint8)(message->id & 0x7f);
+    uint16 index;
+    uint8 sub_index;
+
+    if (0 == node_id)
+    {
+        return;
+    }
+
+    node = &nodes[node_id];
+    job = &jobs[node_id];
+
+    /* Boot-up and heartbeat messages reveal nodes without any request. */
+    if ((0x700 == (message->id & 0x780)) && (1 == message->length))
+    {
+        node->state = message->data[0] & 0x7f;
+        node->is_booted = node->is_booted || (0x00 == node->state);
+
+        if ((false == node->is_present) && (false == job->is_pending))
+        {
+            start(job, SCAN_DEVICE_TYPE);
+        }
+        node->is_present = true;
+        return;
+    }
+
+    if (((SDO_RESPONSE_BASE_ID + node_id) != message->id) || (false == job->is_pending) || (false == job->is_sent))
+    {
+        return;
+    }
+
+    index = (uint16)message->data[1] | ((uint16)message->data[2] << 8);
+    sub_index = message->data[3];
+
+    if ((index != objects[job->object].index) || (sub_index != objects[job->object].sub_index))
+    {
+        return;
+    }
+
+    /* Any answer, even an abort, proves the node exists. */
+    node->is_present = true;
+
+    if ((UPLOAD_RESPONSE_SEGMENT_NO_SIZE == (message->data[0] & 0xe0)) && (0 != (message->data[0] & 0x02)))
+    {
+        uint32 value = (uint32)message->data[4] | ((uint32)message->data[5] << 8) | ((uint32)message->data[6] << 16) | ((uint32)message->data[7] << 24);
+
+        if (0 != (message->data[0] & 0x01))
+        {
+            uint32 size = 4u - ((message->data[0] >> 2) & 0x03);
+
+            if (size < 4u)
+            {
+                value &= (1u << (size * 8u)) - 1u;
+            }
+        }
+
+        node->values[job->object] = value;
+        node->valid |= (uint8)(1u << job->object);
+    }
+
+    job->is_pending = false;
+
+    if ((job->object + 1u) < SCAN_OBJECT_COUNT)
+    {
+        start(job, job->object + 1u);
+    }
+}
+
+static void print_nodes(const scan_node_t* nodes)
+{
+    table_t table = {DARK_CYAN, DEFAULT_COLOR, 4, 32, 32};
+    uint8 node_id;
+    bool is_empty = true;
+
+    table_init(&table, 1024);
+    table_print_header(&table);
+    table_print_row("ID", "Vendor-ID / Product code", "Revision / Serial number", &table);
+    table_print_divider(&table);
+
+    for (node_id = 1; node_id <= SCAN_NODE_MAX; node_id += 1)
+    {
+        const scan_node_t* node = &nodes[node_id];
+        char id_str[5] = {0};
+        char product[33] = {0};
+        char revision[33] = {0};
+
+        if (false == node->is_present)
+        {
+            continue;
+        }
+
+        os_snprintf(id_str, sizeof(id_str), "0x%02x", node_id);
+
+        if (true == scan_has_value(node, SCAN_VENDOR_ID))
+        {
+            os_snprintf(product, sizeof(product), "%08Xh / %08Xh", node->values[SCAN_VENDOR_ID], node->values[SCAN_PRODUCT_CODE]);
+            os_snprintf(revision, sizeof(revision), "%08Xh / %08Xh", node->values[SCAN_REVISION], node->values[SCAN_SERIAL]);
+        }
+        else
+        {
+            os_snprintf(product, sizeof(product), "-");
+            os_snprintf(revision, sizeof(revision), "-");
+        }
+
+        table_print_row(id_str, product, revision, &table);
+        is_empty = false;
+    }
+
+    if (true == is_empty)
+    {
+        table_print_row("-", "No nodes found", "-", &table);
+    }
+
+    table_print_footer(&table);
+    table_flush(&table);
+}
@@ -0,0 +1,43 @@
+/** @file scan.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+#define SCAN_NODE_MAX 0x7f
+#define SCAN_OBJECT_COUNT 5
+
+typedef enum
+{
+    SCAN_DEVICE_TYPE = 0,
+    SCAN_VENDOR_ID,
+    SCAN_PRODUCT_CODE,
+    SCAN_REVISION,
+    SCAN_SERIAL
+
+} scan_object_t;
+
+typedef struct scan_node
+{
+    bool is_present;
+    bool is_booted;  /* Boot-up message seen during the scan. */
+    uint8 state;  /* Last heartbeat, 0xff if none was seen. */
+    uint8 valid;  /* One bit per scan_object_t. */
+    uint32 values[SCAN_OBJECT_COUNT];
+
+} scan_node_t;
+
+uint32 scan_network(scan_node_t* nodes, disp_mode_t disp_mode);
+bool scan_has_value(const scan_node_t* node, scan_object_t object);
+
+#endif /* SCAN_H */
@@ -9,19 +9,57 @@
 
 #include "sdo.h"
 #include "can.h"
+#include "codb.h"
 #include "core.h"
 #include "dict.h"
 #include "os.h"
+#include "sdo_cache.h"
+#include "sdo_stats.h"
 
 #define SEGMENT_DATA_SIZE 7u
 #define MAX_SDO_RESPONSE_SIZE 8u
-#define CAN_BASE_ID 0x600
-#define SDO_TIMEOUT_IN_NS 100000000u
+#define SDO_BLOCK_SIZE 0x7f
+#define SDO_BLOCK_MIN_SEGMENTS 8u
+#define SDO_SLOW_RTT_IN_NS 2000000u
+
+typedef struct sdo_job
+{
+    sdo_request_t* request;
+    uint64 begin_time;
+    uint64 start_time;
+    uint32 length;
+    uint8 toggle;
+    bool is_active;
+    bool is_segmented;
+
+} sdo_job_t;
+
+static sdo_node_caps_t node_caps[0x80];
+static sdo_channel_t channels[0x80][SDO_CHANNEL_MAX];
+static uint8 usdo_session_id;
 
 static void print_error(const char* reason, sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, const char* comment, disp_mode_t disp_mode);
 static void print_read_result(uint8 node_id, uint16 index, uint8 sub_index, can_message_t* sdo_response, disp_mode_t disp_mode, sdo_state_t sdo_state, const char* comment);
 static void print_write_result(sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, disp_mode_t disp_mode, const char* comment);
-static int wait_for_response(uint8 node_id, can_message_t* msg_in);
+static int wait_for_response(uint8 node_id, sdo_state_t sdo_state, can_message_t* msg_in);
+static uint32 get_abort_code(can_message_t* msg_in);
+static uint32 get_data_type_size(data_type_t data_type);
+static data_type_t lookup_data_type(uint16 index, uint8 sub_index);
+static sdo_state_t read_block(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment);
+static sdo_state_t transfer_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment);
+static void send_abort(uint32 request_id, uint16 index, uint8 sub_index, uint32 abort_code);
+static uint32 get_request_id(uint8 node_id);
+static uint32 get_response_id(uint8 node_id);
+static bool handle_job_response(uint32 request_id, sdo_job_t* job, can_message_t* msg_in);
+static bool start_job(uint32 request_id, sdo_job_t* job, sdo_request_t* request);
+static void update_block_caps(uint8 node_id, bool is_supported);
+static void set_abort_reason(char* reason, uint8 node_id, sdo_state_t sdo_state, uint32 abort_code);
+static void init_usdo_request(can_message_t* msg_out, uint8 node_id, uint8 cmd, uint8 session_id, uint16 index, uint8 sub_index);
+static uint32 get_usdo_frame_length(uint32 length);
+static uint32 get_usdo_value(can_message_t* msg_in);
+static void send_usdo_abort(uint8 node_id, uint8 session_id, uint16 index, uint8 sub_index, uint32 abort_code);
+static int wait_for_usdo_response(uint8 node_id, sdo_state_t sdo_state, uint8 session_id, can_message_t* msg_in);
+static sdo_state_t write_block(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, const uint8* data, const char* comment);
 
 bool is_printable_string(const char* str, size_t length);
 
@@ -97,6 +135,24 @@ const char* sdo_lookup_abort_code(uint32 abort_code)
 }
 
 sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment)
+{
+    sdo_state_t sdo_state;
+
+    limit_node_id(&node_id);
+
+    if (true == sdo_cache_lookup(node_id, index, sub_index, sdo_response, &sdo_state))
+    {
+        print_read_result(node_id, index, sub_index, sdo_response, disp_mode, sdo_state, comment);
+        return sdo_state;
+    }
+
+    sdo_state = sdo_read_uncached(sdo_response, disp_mode, node_id, index, sub_index, comment);
+    sdo_cache_store(node_id, index, sub_index, sdo_state, sdo_response);
+
+    return sdo_state;
+}
+
+sdo_state_t sdo_read_uncached(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment)
 {
     can_message_t msg_in = {0};
     can_message_t msg_out = {0};
@@ -104,10 +160,11 @@ sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 n
     sdo_state_t sdo_state = IS_READ_EXPEDITED;
     uint32 abort_code = 0;
     uint32 can_status = 0;
+    uint64 start_time = os_get_ticks();
 
     limit_node_id(&node_id);
 
-    msg_out.id = CAN_BASE_ID + node_id;
+    msg_out.id = get_request_id(node_id);
     msg_out.data[0] = UPLOAD_RESPONSE_SEGMENT_NO_SIZE;
     msg_out.data[1] = (uint8)(index & 0x00ff);
     msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
@@ -127,8 +184,9 @@ sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 n
     os_memset(&msg_in, 0, sizeof(msg_in));
     while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
     {
-        if (0 != wait_for_response(node_id, &msg_in))
+        if (0 != wait_for_response(node_id, ABORT_TRANSFER, &msg_in))
         {
+            sdo_stats_add_timeout(node_id, IS_READ_EXPEDITED);
             print_error(reason, IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
             return ABORT_TRANSFER;
         }
@@ -165,11 +223,13 @@ sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 n
             abort_code = (abort_code & 0x00ffffff) | ((uint32)msg_in.data[4] << 24);
             abort_code = os_swap_be_32(abort_code);
 
-            os_snprintf(reason, 300, "0x%08x: %s", abort_code, sdo_lookup_abort_code((abort_code)));
+            set_abort_reason(reason, node_id, IS_READ_EXPEDITED, abort_code);
             print_error(reason, IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
             return ABORT_TRANSFER;
     }
 
+    sdo_stats_add_latency(node_id, sdo_state, os_get_ticks() - start_time);
+
     if (IS_READ_SEGMENTED == sdo_state)
     {
         int n;
@@ -183,7 +243,7 @@ sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 n
         uint64 time_b;
         uint64 delta_time;
 
-        msg_out.id = CAN_BASE_ID + node_id;
+        msg_out.id = get_request_id(node_id);
         msg_out.length = 8;
         msg_out.data[0] = cmd;
 
@@ -197,17 +257,20 @@ sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 n
         for (n = 0; n < expected_msgs; n += 1)
         {
             bool response_received = false;
+            uint64 segment_time = os_get_ticks();
             timeout_time = 0;
-            time_a = os_get_ticks();
+            time_a = segment_time;
 
             while ((false == response_received) && (timeout_time < SDO_TIMEOUT_IN_NS))
             {
                 can_read(&msg_in);
-                if ((0x580 + node_id) == msg_in.id)
+                if (get_response_id(node_id) == msg_in.id)
                 {
                     int can_msg_index = 0;
                     msg_out.data[0] = cmd;
 
+                    sdo_stats_add_latency(node_id, IS_READ_SEGMENTED, os_get_ticks() - segment_time);
+
                     if (0 == (msg_in.data[0] % 2))
                     {
                         if (UPLOAD_SEGMENT_REQUEST_1 == cmd)
@@ -269,6 +332,7 @@ sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 n
 
             if (timeout_time >= SDO_TIMEOUT_IN_NS)
             {
+                sdo_stats_add_timeout(node_id, IS_READ_SEGMENTED);
                 os_snprintf(reason, 300, "SDO timeout: CAN-dongle present?");
                 print_error(reason, IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
                 return ABORT_TRANSFER;
@@ -280,6 +344,7 @@ sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 n
         os_memcpy(&sdo_response->data, &msg_in.data[4], sdo_response->length);
     }
 
+    sdo_stats_add_transfer(node_id, sdo_state, sdo_response->length, os_get_ticks() - start_time);
     print_read_result(node_id, index, sub_index, sdo_response, disp_mode, sdo_state, comment);
     return sdo_state;
 }
@@ -294,6 +359,7 @@ sdo_state_t sdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8
     uint32 can_status;
     uint32 u32_value = 0;
     uint32* u32_data_ptr = (uint32*)data;
+    uint64 start_time = os_get_ticks();
 
     limit_node_id(&node_id);
 
@@ -307,7 +373,7 @@ sdo_state_t sdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8
         return ABORT_TRANSFER;
     }
 
-    msg_out.id = CAN_BASE_ID + node_id;
+    msg_out.id = get_request_id(node_id);
     msg_out.data[1] = (uint8)(index & 0x00ff);
     msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
     msg_out.data[3] = sub_index;
@@ -344,7 +410,7 @@ sdo_state_t sdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8
     os_memset(&msg_in, 0, sizeof(msg_in));
     while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
     {
-        if (0 != wait_for_response(node_id, &msg_in))
+        if (0 != wait_for_response(node_id, IS_WRITE_EXPEDITED, &msg_in))
         {
             print_error(reason, IS_WRITE_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
             return ABORT_TRANSFER;
@@ -365,11 +431,13 @@ sdo_state_t sdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8
             abort_code = (abort_code & 0x00ffffff) | ((uint32)msg_in.data[4] << 24);
             abort_code = os_swap_be_32(abort_code);
 
-            os_snprintf(reason, 300, "0x%08x: %s", abort_code, sdo_lookup_abort_code((abort_code)));
+            set_abort_reason(reason, node_id, IS_WRITE_EXPEDITED, abort_code);
             print_error(reason, IS_WRITE_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
             return ABORT_TRANSFER;
     }
 
+    sdo_stats_add_transfer(node_id, IS_WRITE_EXPEDITED, length, os_get_ticks() - start_time);
+    sdo_cache_update(node_id, index, sub_index, length, data);
     print_write_result(IS_WRITE_EXPEDITED, node_id, index, sub_index, length, data, disp_mode, comment);
 
     return IS_WRITE_EXPEDITED;
@@ -377,21 +445,10 @@ sdo_state_t sdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8
 
 sdo_state_t sdo_write_block(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* filename, const char* comment)
 {
-    can_message_t msg_in = {0};
-    can_message_t msg_out = {0};
-    char reason[300] = {0};
+    sdo_state_t sdo_state;
     void* data = NULL;
-    char* byte_data = NULL;
     FILE* file = NULL;
     long file_size = 0;
-    size_t bytes_sent = 0;
-    uint32 abort_code = 0;
-    uint32 can_status = 0;
-    uint8 block_size = 0;
-    uint8 segment_number = 1;
-    uint8 i;
-    uint8 remaining_bytes;
-    uint8 final_segment_header;
 
     if (NULL == filename)
     {
@@ -431,188 +488,11 @@ sdo_state_t sdo_write_block(can_message_t* sdo_response, disp_mode_t disp_mode,
         return ABORT_TRANSFER;
     }
 
-    limit_node_id(&node_id);
-
-    msg_out.id = CAN_BASE_ID + node_id;
-    msg_out.data[0] = UPLOAD_INIT_BLOCK_NO_CRC_SIZE_IN_DATA;
-    msg_out.data[1] = (uint8)(index & 0x00ff);
-    msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
-    msg_out.data[3] = sub_index;
-    msg_out.data[4] = (uint8)(file_size & 0xff);
-    msg_out.data[5] = (uint8)((file_size >> 8) & 0xff);
-    msg_out.data[6] = (uint8)((file_size >> 16) & 0xff);
-    msg_out.data[7] = (uint8)((file_size >> 24) & 0xff);
-    msg_out.length = 8;
-
-    can_status = can_write(&msg_out, SILENT, NULL);
-    if (0 != can_status)
-    {
-        print_error(can_get_error_message(can_status), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-        os_free(data);
-        fclose(file);
-        return ABORT_TRANSFER;
-    }
-
-    os_memset(&msg_in, 0, sizeof(msg_in));
-    while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
-    {
-        if (0 != wait_for_response(node_id, &msg_in))
-        {
-            print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-            os_free(data);
-            fclose(file);
-            return ABORT_TRANSFER;
-        }
-    }
-
-    switch (msg_in.data[0])
-    {
-        case BLOCK_DOWNLOAD_RESPONSE_NO_CRC:
-        case BLOCK_DOWNLOAD_RESPONSE_CRC:
-            block_size = msg_in.data[4];
-            break;
-        case ABORT_TRANSFER: /* Error. */
-            abort_code = (abort_code & 0xffffff00) | msg_in.data[SEGMENT_DATA_SIZE];
-            abort_code = (abort_code & 0xffff00ff) | ((uint32)msg_in.data[6] << 8);
-            abort_code = (abort_code & 0xff00ffff) | ((uint32)msg_in.data[5] << 16);
-            abort_code = (abort_code & 0x00ffffff) | ((uint32)msg_in.data[4] << 24);
-            abort_code = os_swap_be_32(abort_code);
-
-            os_snprintf(reason, 300, "0x%08x: %s", abort_code, sdo_lookup_abort_code(abort_code));
-            print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-            os_free(data);
-            fclose(file);
-            return ABORT_TRANSFER;
-    }
-
-    byte_data = (char*)data;
-
-    while (bytes_sent < file_size)
-    {
-        msg_out.data[0] = segment_number;
-
-        for (i = 0; i < SEGMENT_DATA_SIZE && (bytes_sent + i) < file_size; ++i)
-        {
-            msg_out.data[i + 1] = byte_data[bytes_sent + i];
-        }
-
-        /* Mark last segment of last block. */
-        if ((bytes_sent + SEGMENT_DATA_SIZE) >= file_size)
-        {
-            msg_out.data[0] |= 0x80;
-        }
-
-        can_status = can_write(&msg_out, SILENT, NULL);
-        if (0 != can_status)
-        {
-            print_error(can_get_error_message(can_status), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-            os_free(data);
-            fclose(file);
-            return ABORT_TRANSFER;
-        }
-
-        bytes_sent += SEGMENT_DATA_SIZE;
-        segment_number += 1;
-
-        if (block_size < segment_number)
-        {
-            msg_in.data[0] = 0x00;
-            msg_in.data[1] = 0x00;
-            msg_in.data[2] = 0x00;
-
-            while ((0xA2 != msg_in.data[0]) || (block_size != msg_in.data[1]))
-            {
-                if (0 != wait_for_response(node_id, &msg_in))
-                {
-                    print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-                    os_free(data);
-                    fclose(file);
-                    return ABORT_TRANSFER;
-                }
-            }
-
-            /* Adjust block_size based on receiver's response. */
-            if (msg_in.data[2] < block_size)
-            {
-                block_size = msg_in.data[2];
-            }
-            segment_number = 1;
-        }
-    }
-
-    /* Handle the final segment. */
-    remaining_bytes = file_size - bytes_sent;
-
-    switch (remaining_bytes)
-    {
-        case 7:
-            final_segment_header = 0xC1;
-            break;
-        case 6:
-            final_segment_header = 0xC5;
-            break;
-        case 5:
-            final_segment_header = 0xC9;
-            break;
-        case 4:
-            final_segment_header = 0xCD;
-            break;
-        case 3:
-            final_segment_header = 0xD1;
-            break;
-        case 2:
-            final_segment_header = 0xD5;
-            break;
-        case 1:
-            final_segment_header = 0xD9;
-            break;
-        default:
-            final_segment_header = 0xDD;
-            break;
-    }
-
-    msg_out.data[0] = final_segment_header;
-
-    for (i = 0; i < SEGMENT_DATA_SIZE; ++i)
-    {
-        if (i < remaining_bytes)
-        {
-            msg_out.data[i + 1] = byte_data[bytes_sent + i];
-        }
-        else
-        {
-            msg_out.data[i + 1] = 0x00;
-        }
-    }
-
-    can_status = can_write(&msg_out, SILENT, NULL);
-    if (0 != can_status)
-    {
-        print_error(can_get_error_message(can_status), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-        os_free(data);
-        fclose(file);
-        return ABORT_TRANSFER;
-    }
-
-    while (1)
-    {
-        if (0 != wait_for_response(node_id, &msg_in))
-        {
-            print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
-            os_free(data);
-            fclose(file);
-            return ABORT_TRANSFER;
-        }
-
-        if (0xA1 == msg_in.data[0])
-        {
-            break;
-        }
-    }
+    sdo_state = write_block(sdo_response, disp_mode, node_id, index, sub_index, (uint32)file_size, (const uint8*)data, comment);
 
     os_free(data);
     fclose(file);
-    return IS_WRITE_BLOCK;
+    return sdo_state;
 }
 
 sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment)
@@ -625,6 +505,7 @@ sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mo
     uint32 abort_code = 0;
     uint32 can_status = 0;
     uint8 cmd = UPLOAD_SEGMENT_CONTINUE_1;
+    uint64 start_time = os_get_ticks();
     int i;
 
     if (length <= 4)
@@ -634,7 +515,7 @@ sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mo
 
     limit_node_id(&node_id);
 
-    msg_out.id = CAN_BASE_ID + node_id;
+    msg_out.id = get_request_id(node_id);
     msg_out.data[0] = DOWNLOAD_INIT_SEGMENT_SIZE_IN_DATA;
     msg_out.data[1] = (uint8)(index & 0x00ff);
     msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
@@ -655,7 +536,7 @@ sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mo
     os_memset(&msg_in, 0, sizeof(msg_in));
     while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
     {
-        if (0 != wait_for_response(node_id, &msg_in))
+        if (0 != wait_for_response(node_id, IS_WRITE_SEGMENTED, &msg_in))
         {
             print_error(reason, IS_WRITE_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
             return ABORT_TRANSFER;
@@ -676,12 +557,12 @@ sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mo
             abort_code = (abort_code & 0x00ffffff) | ((uint32)msg_in.data[4] << 24);
             abort_code = os_swap_be_32(abort_code);
 
-            os_snprintf(reason, 300, "0x%08x: %s", abort_code, sdo_lookup_abort_code(abort_code));
+            set_abort_reason(reason, node_id, IS_WRITE_SEGMENTED, abort_code);
             print_error(reason, IS_WRITE_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
             return ABORT_TRANSFER;
     }
 
-    msg_out.id = CAN_BASE_ID + node_id;
+    msg_out.id = get_request_id(node_id);
     msg_out.length = 8;
     msg_out.data[0] = cmd;
 
@@ -722,7 +603,7 @@ sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mo
             break;
         }
 
-        if (0 == wait_for_response(node_id, &msg_in))
+        if (0 == wait_for_response(node_id, IS_WRITE_SEGMENTED, &msg_in))
         {
             msg_out.data[0] = cmd;
 
@@ -743,333 +624,986 @@ sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mo
         }
     }
 
+    sdo_stats_add_transfer(node_id, IS_WRITE_SEGMENTED, length, os_get_ticks() - start_time);
+    sdo_cache_update(node_id, index, sub_index, length, data);
     print_write_result(IS_WRITE_SEGMENTED, node_id, index, sub_index, length, data, disp_mode, comment);
     return IS_WRITE_SEGMENTED;
 }
 
-bool is_printable_string(const char* str, size_t length)
+sdo_state_t sdo_transfer_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment)
 {
-    size_t i;
-    for (i = 0; i < length; i++)
+    sdo_state_t sdo_state;
+
+    limit_node_id(&node_id);
+
+    if (true == sdo_cache_lookup(node_id, index, sub_index, sdo_response, &sdo_state))
     {
-        if (0 == os_isprint(str[i]))
-        {
-            return false;
-        }
+        print_read_result(node_id, index, sub_index, sdo_response, disp_mode, sdo_state, comment);
+        return sdo_state;
     }
-    return true;
-}
 
-static void print_error(const char* reason, sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, const char* comment, disp_mode_t disp_mode)
-{
-    switch (disp_mode)
-    {
-        case TERM_MODE:
-        {
-            const char* description = dict_lookup(index, sub_index);
+    sdo_state = transfer_read(sdo_response, disp_mode, node_id, index, sub_index, comment);
+    sdo_cache_store(node_id, index, sub_index, sdo_state, sdo_response);
 
-            if (NULL != description)
-            {
-                os_log(LOG_INFO, "%s", description);
-            }
+    return sdo_state;
+}
 
-            switch (sdo_state)
-            {
-                case IS_READ_EXPEDITED:
-                case IS_READ_SEGMENTED:
-                    os_log(LOG_ERROR, "Index %x, Sub-index %x: 0 byte(s) read error: %s", index, sub_index, reason);
-                    break;
-                case IS_WRITE_EXPEDITED:
-                case IS_WRITE_SEGMENTED:
-                    os_log(LOG_ERROR, "Index %x, Sub-index %x: 0 byte(s) write error: %s", index, sub_index, reason);
-                    break;
-                default:
-                    break;
-            }
-            break;
-        }
-        case SCRIPT_MODE:
-        {
-            int i;
-            char buffer[34] = {0};
-            color_t color = DARK_YELLOW;
+sdo_state_t sdo_transfer_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment)
+{
+    sdo_state_t sdo_state;
+    uint8 buffer[sizeof(uint32)] = {0};
 
-            switch (sdo_state)
-            {
-                case IS_READ_EXPEDITED:
-                    os_print(color, "Read ");
-                    os_print(DEFAULT_COLOR, "    0x%02X    0x%04X  0x%02X      -       ", node_id, index, sub_index);
-                    break;
-                case IS_WRITE_EXPEDITED:
-                case IS_WRITE_SEGMENTED:
-                    color = LIGHT_BLUE;
-                    os_print(color, "Write");
-                    os_print(DEFAULT_COLOR, "    0x%02X    0x%04X  0x%02X      -       ", node_id, index, sub_index);
-                    break;
-                default:
-                    break;
-            }
+    limit_node_id(&node_id);
 
-            os_print(LIGHT_RED, "FAIL    ");
+    if (NULL == data)
+    {
+        print_error("NULL data pointer", IS_WRITE_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
 
-            if (NULL == comment)
-            {
-                comment = dict_lookup(index, sub_index);
-            }
+    if (true == node_caps[node_id].is_usdo)
+    {
+        if (0 == length)
+        {
+            length = get_data_type_size(lookup_data_type(index, sub_index));
+            length = (length > 0) ? length : sizeof(uint32);
+        }
+        return usdo_write(sdo_response, disp_mode, node_id, index, sub_index, length, data, comment);
+    }
 
-            if (NULL == comment)
+    switch (sdo_select_write_mode(node_id, index, sub_index, &length))
+    {
+        case IS_WRITE_EXPEDITED:
+            /* sdo_write() always reads a full 32-bit word. */
+            os_memcpy(buffer, data, length);
+            return sdo_write(sdo_response, disp_mode, node_id, index, sub_index, length, (void*)buffer, comment);
+        case IS_WRITE_BLOCK:
+            if (true == node_caps[node_id].is_block_supported)
             {
-                comment = "-";
+                return write_block(sdo_response, disp_mode, node_id, index, sub_index, length, (const uint8*)data, comment);
             }
 
-            os_strlcpy(buffer, comment, 33);
-            for (i = os_strlen(buffer); i < 33; ++i)
+            /* Probe silently, fall back to a segmented download on failure. */
+            sdo_state = write_block(sdo_response, SILENT, node_id, index, sub_index, length, (const uint8*)data, comment);
+            if (IS_WRITE_BLOCK == sdo_state)
             {
-                buffer[i] = ' ';
+                print_write_result(sdo_state, node_id, index, sub_index, length, data, disp_mode, comment);
+                return sdo_state;
             }
-
-            os_print(DARK_MAGENTA, "%s ", buffer);
-            os_print(DEFAULT_COLOR, "%s\n", reason);
-            break;
-        }
+            sdo_stats_add_retry(node_id, IS_WRITE_BLOCK);
+            return sdo_write_segmented(sdo_response, disp_mode, node_id, index, sub_index, length, data, comment);
+        case IS_WRITE_SEGMENTED:
+            return sdo_write_segmented(sdo_response, disp_mode, node_id, index, sub_index, length, data, comment);
         default:
-        case SILENT:
-            break;
+            return ABORT_TRANSFER;
     }
 }
 
-static void print_progress_bar(size_t bytes_sent, size_t length)
+sdo_state_t sdo_select_write_mode(uint8 node_id, uint16 index, uint8 sub_index, uint32* length)
 {
-    static int prev_percentage = -1;
-    int percentage = (int)((bytes_sent * 100) / length);
+    sdo_node_caps_t* caps;
+    uint32 type_size;
+    uint32 segment_count;
+    uint32 min_segments = SDO_BLOCK_MIN_SEGMENTS;
 
-    if (percentage != prev_percentage)
+    if (NULL == length)
     {
-        printf("Progress: %d%%\r", percentage);
-        fflush(stdout);
-        prev_percentage = percentage;
+        return ABORT_TRANSFER;
     }
-}
 
-static void print_read_result(uint8 node_id, uint16 index, uint8 sub_index, can_message_t* sdo_response, disp_mode_t disp_mode, sdo_state_t sdo_state, const char* comment)
-{
-    uint32 u32_value = 0;
-    char str_buffer[5] = {0};
+    limit_node_id(&node_id);
+    caps = &node_caps[node_id];
+    type_size = get_data_type_size(lookup_data_type(index, sub_index));
 
-    if (sdo_response->length >= 4)
+    if (0 == *length)
     {
-        os_memcpy(&u32_value, &sdo_response->data, sizeof(uint32));
-        os_memcpy(&str_buffer, &u32_value, sizeof(uint32));
+        *length = (type_size > 0) ? type_size : sizeof(uint32);
     }
-    else
+
+    if (*length <= sizeof(uint32))
     {
-        os_memcpy(&u32_value, &sdo_response->data, sdo_response->length);
-        os_memcpy(&str_buffer, &u32_value, sdo_response->length);
+        return IS_WRITE_EXPEDITED;
+    }
+    else if (type_size > 0)
+    {
+        /* Fixed-size objects never outweigh the block set-up. */
+        return IS_WRITE_SEGMENTED;
+    }
+    else if ((true == caps->is_block_probed) && (false == caps->is_block_supported))
+    {
+        return IS_WRITE_SEGMENTED;
     }
 
-    if (false == is_printable_string(str_buffer, sizeof(uint32)))
+    /* A segmented download costs one round trip per segment, a block
+     * download about three per block of up to 127 segments.
+     */
+    if (caps->rtt_ns >= SDO_SLOW_RTT_IN_NS)
     {
-        str_buffer[0] = '\0';
+        min_segments = SDO_BLOCK_MIN_SEGMENTS / 2u;
     }
 
-    switch (disp_mode)
+    segment_count = (*length + SEGMENT_DATA_SIZE - 1u) / SEGMENT_DATA_SIZE;
+    if (segment_count >= min_segments)
     {
-        case TERM_MODE:
-        {
-            const char* description = dict_lookup(index, sub_index);
+        return IS_WRITE_BLOCK;
+    }
 
-            if (NULL != description)
-            {
-                os_log(LOG_INFO, "%s", description);
-            }
+    return IS_WRITE_SEGMENTED;
+}
 
-            switch (sdo_state)
+void sdo_get_node_caps(uint8 node_id, sdo_node_caps_t* caps)
+{
+    if (NULL == caps)
+    {
+        return;
+    }
+
+    limit_node_id(&node_id);
+    os_memcpy(caps, &node_caps[node_id], sizeof(sdo_node_caps_t));
+}
+
+void sdo_reset_node_caps(void)
+{
+    os_memset(node_caps, 0, sizeof(node_caps));
+}
+
+void sdo_set_usdo(uint8 node_id, bool is_enabled)
+{
+    limit_node_id(&node_id);
+    node_caps[node_id].is_usdo = is_enabled;
+}
+
+sdo_state_t usdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment)
+{
+    can_message_t msg_in = {0};
+    can_message_t msg_out = {0};
+    char reason[300] = {0};
+    uint32 can_status;
+    uint32 length;
+    uint32 bytes_received = 0;
+    uint8 sequence = 0;
+    uint8 session_id = ++usdo_session_id;
+    uint64 start_time = os_get_ticks();
+
+    limit_node_id(&node_id);
+
+    if (USDO_BROADCAST_ID == node_id)
+    {
+        print_error("USDO broadcast is write-only", IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
+
+    init_usdo_request(&msg_out, node_id, USDO_UPLOAD_EXPEDITED, session_id, index, sub_index);
+    msg_out.length = USDO_HEADER_SIZE;
+
+    can_status = can_write(&msg_out, SILENT, NULL);
+    if (0 != can_status)
+    {
+        print_error(can_get_error_message(can_status), IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
+
+    if (0 != wait_for_usdo_response(node_id, ABORT_TRANSFER, session_id, &msg_in))
+    {
+        sdo_stats_add_timeout(node_id, IS_READ_EXPEDITED);
+        print_error("USDO timeout: CAN FD capable dongle present?", IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
+
+    os_memset(sdo_response, 0, sizeof(can_message_t));
+    sdo_response->id = msg_in.id;
+
+    switch (msg_in.data[1])
+    {
+        case (USDO_UPLOAD_EXPEDITED | USDO_RESPONSE):
+            length = msg_in.data[7];
+            if (length > USDO_EXPEDITED_SIZE)
             {
-                case IS_READ_EXPEDITED:
-                    os_log(LOG_SUCCESS, "Index %x, Sub-index %x: %u byte(s) read: %u (0x%x) %s",
-                           index,
-                           sub_index,
-                           sdo_response->length,
-                           u32_value,
-                           u32_value,
-                           str_buffer);
-                    break;
-                case IS_READ_SEGMENTED:
-                    sdo_response->data[CAN_BUF_SIZE - 1] = '\0';
-                    os_log(LOG_SUCCESS, "Index %x, Sub-index %x: %u byte(s) read: %s",
-                           index,
-                           sub_index,
-                           sdo_response->length,
-                           (char*)sdo_response->data);
-                    break;
-                default:
-                    return;
+                length = USDO_EXPEDITED_SIZE;
             }
-            break;
-        }
-        case SCRIPT_MODE:
-        {
-            int i;
-            char buffer[34] = {0};
 
-            sdo_response->data[CAN_BUF_SIZE - 1] = '\0';
+            os_memcpy(sdo_response->data, &msg_in.data[USDO_HEADER_SIZE], length);
+            sdo_response->length = length;
 
-            if (NULL == comment)
+            sdo_stats_add_latency(node_id, IS_READ_EXPEDITED, os_get_ticks() - start_time);
+
+            /* Anything wider than 32 bit is handed out like a segmented upload. */
+            if (length <= sizeof(uint32))
             {
-                comment = dict_lookup(index, sub_index);
+                sdo_stats_add_transfer(node_id, IS_READ_EXPEDITED, length, os_get_ticks() - start_time);
+                print_read_result(node_id, index, sub_index, sdo_response, disp_mode, IS_READ_EXPEDITED, comment);
+                return IS_READ_EXPEDITED;
             }
+            break;
 
-            if (NULL == comment)
+        case (USDO_UPLOAD_SEGMENTED | USDO_RESPONSE):
+            sdo_stats_add_latency(node_id, IS_READ_SEGMENTED, os_get_ticks() - start_time);
+            length = get_usdo_value(&msg_in);
+            if (length >= CAN_BUF_SIZE)
             {
-                comment = "-";
+                send_usdo_abort(node_id, session_id, index, sub_index, ABORT_OUT_OF_MEMORY);
+                set_abort_reason(reason, node_id, IS_READ_SEGMENTED, ABORT_OUT_OF_MEMORY);
+                print_error(reason, IS_READ_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
+                return ABORT_TRANSFER;
             }
 
-            os_memcpy(buffer, comment, 33);
-            for (i = os_strlen(buffer); i < 33; ++i)
+            while (bytes_received < length)
             {
-                buffer[i] = ' ';
-            }
+                uint32 chunk = length - bytes_received;
 
-            os_print(DARK_YELLOW, "Read     ");
-            os_print(DEFAULT_COLOR, "0x%02X    0x%04X  0x%02X      %03u     ", node_id, index, sub_index, sdo_response->length);
-            os_print(LIGHT_GREEN, "SUCC    ");
-            os_print(DARK_MAGENTA, "%s ", buffer);
+                /* Streamed segments, no request-to-response latency. */
+                if (0 != wait_for_response(node_id, ABORT_TRANSFER, &msg_in))
+                {
+                    sdo_stats_add_timeout(node_id, IS_READ_SEGMENTED);
+                    print_error("USDO timeout", IS_READ_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
+                    return ABORT_TRANSFER;
+                }
 
-            if (IS_READ_EXPEDITED == sdo_state)
-            {
-                switch (sdo_response->length)
+                sequence = (sequence % 0x7f) + 1;
+                if (sequence != (msg_in.data[0] & 0x7f))
                 {
-                    case 4:
-                        os_print(DEFAULT_COLOR, "0x%08X %u (U32) %s", u32_value, u32_value, str_buffer);
-                        break;
-                    case 3:
-                        os_print(DEFAULT_COLOR, "0x%06X %u (U24) %s", u32_value, u32_value, str_buffer);
-                        break;
-                    case 2:
-                        os_print(DEFAULT_COLOR, "0x%04X %u (U16) %s", u32_value, u32_value, str_buffer);
-                        break;
-                    case 1:
-                        os_print(DEFAULT_COLOR, "0x%02X %u (U8) %s", u32_value, u32_value, str_buffer);
-                        break;
+                    send_usdo_abort(node_id, session_id, index, sub_index, ABORT_INVALID_SEQUENCE_NUMBER);
+                    set_abort_reason(reason, node_id, IS_READ_SEGMENTED, ABORT_INVALID_SEQUENCE_NUMBER);
+                    print_error(reason, IS_READ_SEGMENTED, node_id, index, sub_index, comment, disp_mode);
+                    return ABORT_TRANSFER;
+                }
+
+                if (chunk > USDO_SEGMENT_DATA_SIZE)
+                {
+                    chunk = USDO_SEGMENT_DATA_SIZE;
+                }
+
+                os_memcpy(&sdo_response->data[bytes_received], &msg_in.data[1], chunk);
+                bytes_received += chunk;
+
+                if ((0 != (msg_in.data[0] & 0x80)) && (bytes_received < length))
+                {
+                    /* Last segment flagged before the indicated size. */
+                    length = bytes_received;
                 }
             }
-            else /* Read segmented SDO. */
-            {
-                os_print(DEFAULT_COLOR, "%s", (char*)sdo_response->data);
-            }
-            puts("");
+
+            sdo_response->length = length;
             break;
-        }
+
+        case USDO_ABORT:
         default:
-        case SILENT:
-            break;
+        {
+            uint32 abort_code = get_usdo_value(&msg_in);
+
+            set_abort_reason(reason, node_id, IS_READ_EXPEDITED, abort_code);
+            print_error(reason, IS_READ_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
     }
+
+    sdo_stats_add_transfer(node_id, IS_READ_SEGMENTED, sdo_response->length, os_get_ticks() - start_time);
+    print_read_result(node_id, index, sub_index, sdo_response, disp_mode, IS_READ_SEGMENTED, comment);
+    return IS_READ_SEGMENTED;
 }
 
-void print_write_result(sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, disp_mode_t disp_mode, const char* comment)
+sdo_state_t usdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment)
 {
-    uint32 u32_value = 0;
-    uint32* u32_data_ptr = (uint32*)data;
-    char* data_str = (char*)data;
+    can_message_t msg_in = {0};
+    can_message_t msg_out = {0};
+    char reason[300] = {0};
+    const uint8* byte_data = (const uint8*)data;
+    sdo_state_t sdo_state = IS_WRITE_EXPEDITED;
+    uint32 can_status;
+    uint32 bytes_sent = 0;
+    uint8 sequence = 0;
+    uint8 session_id = ++usdo_session_id;
+    uint64 start_time = os_get_ticks();
 
-    if (NULL != u32_data_ptr)
+    limit_node_id(&node_id);
+
+    if (NULL == data)
     {
-        u32_value = *u32_data_ptr;
+        print_error("NULL data pointer", IS_WRITE_EXPEDITED, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
     }
 
-    if (NULL == data_str)
+    if (length <= USDO_EXPEDITED_SIZE)
     {
-        data_str = "";
+        init_usdo_request(&msg_out, node_id, USDO_DOWNLOAD_EXPEDITED, session_id, index, sub_index);
+        msg_out.data[7] = (uint8)length;
+        os_memcpy(&msg_out.data[USDO_HEADER_SIZE], byte_data, length);
+        msg_out.length = get_usdo_frame_length(USDO_HEADER_SIZE + length);
+    }
+    else
+    {
+        sdo_state = IS_WRITE_SEGMENTED;
+        init_usdo_request(&msg_out, node_id, USDO_DOWNLOAD_SEGMENTED, session_id, index, sub_index);
+        msg_out.data[8] = (uint8)(length & 0x000000ff);
+        msg_out.data[9] = (uint8)((length & 0x0000ff00) >> 8);
+        msg_out.data[10] = (uint8)((length & 0x00ff0000) >> 16);
+        msg_out.data[11] = (uint8)((length & 0xff000000) >> 24);
+        msg_out.length = get_usdo_frame_length(USDO_HEADER_SIZE + sizeof(uint32));
     }
 
-    switch (disp_mode)
+    can_status = can_write(&msg_out, SILENT, NULL);
+    if (0 != can_status)
     {
-        case TERM_MODE:
+        print_error(can_get_error_message(can_status), sdo_state, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
+
+    /* Broadcast downloads are unconfirmed, segments follow back-to-back. */
+    if (USDO_BROADCAST_ID != node_id)
+    {
+        if (0 != wait_for_usdo_response(node_id, sdo_state, session_id, &msg_in))
         {
-            const char* description = dict_lookup(index, sub_index);
+            print_error("USDO timeout: CAN FD capable dongle present?", sdo_state, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
+        else if ((msg_out.data[1] | USDO_RESPONSE) != msg_in.data[1])
+        {
+            uint32 abort_code = get_usdo_value(&msg_in);
 
-            if (NULL != description)
-            {
-                os_log(LOG_INFO, "%s", description);
-            }
+            set_abort_reason(reason, node_id, sdo_state, abort_code);
+            print_error(reason, sdo_state, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
+    }
 
-            if (IS_WRITE_EXPEDITED == sdo_state)
+    if (IS_WRITE_SEGMENTED == sdo_state)
+    {
+        while (bytes_sent < length)
+        {
+            uint32 chunk = length - bytes_sent;
+
+            if (chunk > USDO_SEGMENT_DATA_SIZE)
             {
-                char str[5] = {0};
+                chunk = USDO_SEGMENT_DATA_SIZE;
+            }
 
-                switch (length)
-                {
-                    case 1:
-                        str[0] = os_isprint(data_str[0]) ? data_str[0] : '\0';
-                        break;
-                    case 2:
-                        str[0] = os_isprint(data_str[0]) ? data_str[0] : '\0';
-                        str[1] = os_isprint(data_str[1]) ? data_str[1] : '\0';
-                        break;
-                    case 3:
-                        str[0] = os_isprint(data_str[0]) ? data_str[0] : '\0';
-                        str[1] = os_isprint(data_str[1]) ? data_str[1] : '\0';
-                        str[2] = os_isprint(data_str[2]) ? data_str[2] : '\0';
-                        break;
-                    case 4:
-                        str[0] = os_isprint(data_str[0]) ? data_str[0] : '\0';
-                        str[1] = os_isprint(data_str[1]) ? data_str[1] : '\0';
-                        str[2] = os_isprint(data_str[2]) ? data_str[2] : '\0';
-                        str[3] = os_isprint(data_str[3]) ? data_str[3] : '\0';
-                        break;
-                    default:
-                        break;
-                }
+            os_memset(&msg_out, 0, sizeof(msg_out));
+            msg_out.id = get_request_id(node_id);
+            sequence = (sequence % 0x7f) + 1;
+            msg_out.data[0] = sequence;
+            os_memcpy(&msg_out.data[1], &byte_data[bytes_sent], chunk);
+            bytes_sent += chunk;
 
-                os_log(LOG_SUCCESS, "Index %x, Sub-index %x: %u byte(s) written: %u (0x%x) %s",
-                       index,
-                       sub_index,
-                       length,
-                       u32_value,
-                       u32_value,
-                       str);
-            }
-            else if (IS_WRITE_SEGMENTED)
+            if (bytes_sent >= length)
             {
-                data_str[CAN_BUF_SIZE - 1] = '\0';
-
-                os_log(LOG_SUCCESS, "Index %x, Sub-index %x: %u byte(s) written: %s",
-                       index,
-                       sub_index,
-                       os_strlen(data_str),
-                       data_str);
+                msg_out.data[0] |= 0x80; /* Last segment. */
             }
-            else
+            msg_out.length = get_usdo_frame_length(1 + chunk);
+
+            can_status = can_write(&msg_out, SILENT, NULL);
+            if (0 != can_status)
             {
-                return;
+                print_error(can_get_error_message(can_status), sdo_state, node_id, index, sub_index, comment, disp_mode);
+                return ABORT_TRANSFER;
             }
-            break;
         }
-        case SCRIPT_MODE:
-        {
-            int i;
-            char buffer[34] = {0};
 
-            if (NULL == comment)
+        if (USDO_BROADCAST_ID != node_id)
+        {
+            if (0 != wait_for_usdo_response(node_id, sdo_state, session_id, &msg_in))
             {
-                comment = dict_lookup(index, sub_index);
+                print_error("USDO timeout", sdo_state, node_id, index, sub_index, comment, disp_mode);
+                return ABORT_TRANSFER;
             }
-
-            if (NULL == comment)
+            else if ((USDO_DOWNLOAD_SEGMENTED_END | USDO_RESPONSE) != msg_in.data[1])
             {
-                comment = "-";
-            }
+                uint32 abort_code = get_usdo_value(&msg_in);
 
-            os_strlcpy(buffer, comment, 33);
-            for (i = os_strlen(buffer); i < 33; ++i)
-            {
-                buffer[i] = ' ';
+                set_abort_reason(reason, node_id, sdo_state, abort_code);
+                print_error(reason, sdo_state, node_id, index, sub_index, comment, disp_mode);
+                return ABORT_TRANSFER;
             }
+        }
+    }
 
-            os_print(DARK_BLUE, "Write    ");
-            os_print(DEFAULT_COLOR, "0x%02X    0x%04X  0x%02X      %03u     ", node_id, index, sub_index, length);
-            os_print(LIGHT_GREEN, "SUCC    ");
-            os_print(DARK_MAGENTA, "%s ", buffer);
+    if (NULL != sdo_response)
+    {
+        os_memcpy(sdo_response, &msg_in, sizeof(can_message_t));
+    }
+
+    sdo_stats_add_transfer(node_id, sdo_state, length, os_get_ticks() - start_time);
+    sdo_cache_update(node_id, index, sub_index, length, data);
+
+    /* Anything wider than 32 bit is reported like a segmented download. */
+    if (length > sizeof(uint32))
+    {
+        sdo_state = IS_WRITE_SEGMENTED;
+    }
+
+    print_write_result(sdo_state, node_id, index, sub_index, length, data, disp_mode, comment);
+    return sdo_state;
+}
+
+uint8 sdo_discover_channels(uint8 node_id)
+{
+    uint8 channel;
+
+    limit_node_id(&node_id);
+
+    /* 0x1200 is the default channel, additional ones follow at 0x1201 and up. */
+    for (channel = 1; channel < SDO_CHANNEL_MAX; channel += 1)
+    {
+        can_message_t sdo_response = {0};
+        uint32 request_id = 0;
+        uint32 response_id = 0;
+
+        channels[node_id][channel].is_valid = false;
+
+        if (ABORT_TRANSFER == sdo_read(&sdo_response, SILENT, node_id, 0x1200 + channel, 0x01, NULL))
+        {
+            break;
+        }
+        os_memcpy(&request_id, sdo_response.data, sizeof(uint32));
+
+        if (ABORT_TRANSFER == sdo_read(&sdo_response, SILENT, node_id, 0x1200 + channel, 0x02, NULL))
+        {
+            break;
+        }
+        os_memcpy(&response_id, sdo_response.data, sizeof(uint32));
+
+        /* Bit 31 set: channel exists but is not in use. */
+        if ((0 != (request_id & 0x80000000)) || (0 != (response_id & 0x80000000)))
+        {
+            continue;
+        }
+
+        channels[node_id][channel].request_id = (0 != (request_id & 0x20000000)) ? (request_id & 0x1fffffff) : (request_id & 0x7ff);
+        channels[node_id][channel].response_id = (0 != (response_id & 0x20000000)) ? (response_id & 0x1fffffff) : (response_id & 0x7ff);
+        channels[node_id][channel].is_valid = true;
+    }
+
+    for (; channel < SDO_CHANNEL_MAX; channel += 1)
+    {
+        channels[node_id][channel].is_valid = false;
+    }
+
+    return sdo_get_channel_count(node_id);
+}
+
+status_t sdo_set_channel(uint8 node_id, uint8 channel, uint32 request_id, uint32 response_id)
+{
+    if ((channel >= SDO_CHANNEL_MAX) || (request_id > 0x1fffffff) || (response_id > 0x1fffffff))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    limit_node_id(&node_id);
+
+    if ((0 == request_id) && (0 == response_id))
+    {
+        channels[node_id][channel].is_valid = false;
+        return ALL_OK;
+    }
+
+    channels[node_id][channel].request_id = request_id;
+    channels[node_id][channel].response_id = response_id;
+    channels[node_id][channel].is_valid = true;
+
+    return ALL_OK;
+}
+
+status_t sdo_get_channel(uint8 node_id, uint8 channel, sdo_channel_t* sdo_channel)
+{
+    if ((NULL == sdo_channel) || (channel >= SDO_CHANNEL_MAX))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    limit_node_id(&node_id);
+
+    if ((0 == channel) && (false == channels[node_id][0].is_valid))
+    {
+        sdo_channel->request_id = SDO_REQUEST_BASE_ID + node_id;
+        sdo_channel->response_id = SDO_RESPONSE_BASE_ID + node_id;
+        sdo_channel->is_valid = true;
+        return ALL_OK;
+    }
+    else if (false == channels[node_id][channel].is_valid)
+    {
+        return ITEM_NOT_FOUND;
+    }
+
+    os_memcpy(sdo_channel, &channels[node_id][channel], sizeof(sdo_channel_t));
+    return ALL_OK;
+}
+
+uint8 sdo_get_channel_count(uint8 node_id)
+{
+    uint8 channel;
+    uint8 count = 1; /* The default channel is always there. */
+
+    limit_node_id(&node_id);
+
+    for (channel = 1; channel < SDO_CHANNEL_MAX; channel += 1)
+    {
+        if (true == channels[node_id][channel].is_valid)
+        {
+            count += 1;
+        }
+    }
+
+    return count;
+}
+
+uint32 sdo_read_parallel(disp_mode_t disp_mode, uint8 node_id, sdo_request_t* requests, uint32 count)
+{
+    sdo_job_t jobs[SDO_CHANNEL_MAX];
+    sdo_channel_t active[SDO_CHANNEL_MAX];
+    uint8 active_count = 0;
+    uint8 channel;
+    uint32 next = 0;
+    uint32 done = 0;
+    uint32 success = 0;
+    uint32 i;
+
+    if ((NULL == requests) || (0 == count))
+    {
+        return 0;
+    }
+
+    limit_node_id(&node_id);
+    os_memset(jobs, 0, sizeof(jobs));
+
+    for (channel = 0; channel < SDO_CHANNEL_MAX; channel += 1)
+    {
+        if (ALL_OK == sdo_get_channel(node_id, channel, &active[active_count]))
+        {
+            active_count += 1;
+        }
+    }
+
+    for (i = 0; i < count; i += 1)
+    {
+        requests[i].sdo_state = ABORT_TRANSFER;
+        requests[i].abort_code = 0;
+        os_memset(&requests[i].response, 0, sizeof(can_message_t));
+    }
+
+    while (done < count)
+    {
+        can_message_t msg_in = {0};
+        uint64 now;
+
+        /* Keep every channel busy. */
+        for (channel = 0; (channel < active_count) && (next < count); channel += 1)
+        {
+            if (false == jobs[channel].is_active)
+            {
+                if (false == start_job(active[channel].request_id, &jobs[channel], &requests[next]))
+                {
+                    done += 1;
+                }
+                next += 1;
+            }
+        }
+
+        can_read(&msg_in);
+
+        for (channel = 0; channel < active_count; channel += 1)
+        {
+            if ((true == jobs[channel].is_active) && (active[channel].response_id == msg_in.id))
+            {
+                sdo_job_t* job = &jobs[channel];
+                uint64 latency = os_get_ticks() - job->start_time;
+                bool is_done = handle_job_response(active[channel].request_id, job, &msg_in);
+
+                sdo_stats_add_latency(node_id, (true == job->is_segmented) ? IS_READ_SEGMENTED : IS_READ_EXPEDITED, latency);
+
+                if (true == is_done)
+                {
+                    if (ABORT_TRANSFER != job->request->sdo_state)
+                    {
+                        sdo_stats_add_transfer(node_id, job->request->sdo_state, job->request->response.length, os_get_ticks() - job->begin_time);
+                        sdo_cache_store(node_id, job->request->index, job->request->sub_index, job->request->sdo_state, &job->request->response);
+                    }
+                    job->is_active = false;
+                    done += 1;
+                }
+                break;
+            }
+        }
+
+        now = os_get_ticks();
+        for (channel = 0; channel < active_count; channel += 1)
+        {
+            sdo_job_t* job = &jobs[channel];
+
+            if ((true == job->is_active) && ((now - job->start_time) >= SDO_TIMEOUT_IN_NS))
+            {
+                send_abort(active[channel].request_id, job->request->index, job->request->sub_index, ABORT_SDO_PROTOCOL_TIMED_OUT);
+                sdo_stats_add_timeout(node_id, (true == job->is_segmented) ? IS_READ_SEGMENTED : IS_READ_EXPEDITED);
+                job->request->abort_code = ABORT_SDO_PROTOCOL_TIMED_OUT;
+                job->request->sdo_state = ABORT_TRANSFER;
+                job->is_active = false;
+                done += 1;
+            }
+        }
+    }
+
+    for (i = 0; i < count; i += 1)
+    {
+        sdo_request_t* request = &requests[i];
+
+        if (ABORT_TRANSFER == request->sdo_state)
+        {
+            char reason[300] = {0};
+
+            if (ABORT_SDO_PROTOCOL_TIMED_OUT == request->abort_code)
+            {
+                os_snprintf(reason, 300, "SDO timeout: CAN-dongle present?");
+            }
+            else
+            {
+                set_abort_reason(reason, node_id, IS_READ_EXPEDITED, request->abort_code);
+            }
+            print_error(reason, IS_READ_EXPEDITED, node_id, request->index, request->sub_index, NULL, disp_mode);
+        }
+        else
+        {
+            print_read_result(node_id, request->index, request->sub_index, &request->response, disp_mode, request->sdo_state, NULL);
+            success += 1;
+        }
+    }
+
+    return success;
+}
+
+bool is_printable_string(const char* str, size_t length)
+{
+    size_t i;
+    for (i = 0; i < length; i++)
+    {
+        if (0 == os_isprint(str[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void print_error(const char* reason, sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, const char* comment, disp_mode_t disp_mode)
+{
+    switch (disp_mode)
+    {
+        case TERM_MODE:
+        {
+            const char* description = dict_lookup(index, sub_index);
+
+            if (NULL != description)
+            {
+                os_log(LOG_INFO, "%s", description);
+            }
+
+            switch (sdo_state)
+            {
+                case IS_READ_EXPEDITED:
+                case IS_READ_SEGMENTED:
+                case IS_READ_BLOCK:
+                    os_log(LOG_ERROR, "Index %x, Sub-index %x: 0 byte(s) read error: %s", index, sub_index, reason);
+                    break;
+                case IS_WRITE_EXPEDITED:
+                case IS_WRITE_SEGMENTED:
+                case IS_WRITE_BLOCK:
+                    os_log(LOG_ERROR, "Index %x, Sub-index %x: 0 byte(s) write error: %s", index, sub_index, reason);
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+        case SCRIPT_MODE:
+        {
+            int i;
+            char buffer[34] = {0};
+            color_t color = DARK_YELLOW;
+
+            switch (sdo_state)
+            {
+                case IS_READ_EXPEDITED:
+                case IS_READ_SEGMENTED:
+                case IS_READ_BLOCK:
+                    os_print(color, "Read ");
+                    os_print(DEFAULT_COLOR, "    0x%02X    0x%04X  0x%02X      -       ", node_id, index, sub_index);
+                    break;
+                case IS_WRITE_EXPEDITED:
+                case IS_WRITE_SEGMENTED:
+                case IS_WRITE_BLOCK:
+                    color = LIGHT_BLUE;
+                    os_print(color, "Write");
+                    os_print(DEFAULT_COLOR, "    0x%02X    0x%04X  0x%02X      -       ", node_id, index, sub_index);
+                    break;
+                default:
+                    break;
+            }
+
+            os_print(LIGHT_RED, "FAIL    ");
+
+            if (NULL == comment)
+            {
+                comment = dict_lookup(index, sub_index);
+            }
+
+            if (NULL == comment)
+            {
+                comment = "-";
+            }
+
+            os_strlcpy(buffer, comment, 33);
+            for (i = os_strlen(buffer); i < 33; ++i)
+            {
+                buffer[i] = ' ';
+            }
+
+            os_print(DARK_MAGENTA, "%s ", buffer);
+            os_print(DEFAULT_COLOR, "%s\n", reason);
+            break;
+        }
+        default:
+        case SILENT:
+            break;
+    }
+}
+
+static void print_progress_bar(size_t bytes_sent, size_t length)
+{
+    static int prev_percentage = -1;
+    int percentage = (int)((bytes_sent * 100) / length);
+
+    if (percentage != prev_percentage)
+    {
+        printf("Progress: %d%%\r", percentage);
+        fflush(stdout);
+        prev_percentage = percentage;
+    }
+}
+
+static void print_read_result(uint8 node_id, uint16 index, uint8 sub_index, can_message_t* sdo_response, disp_mode_t disp_mode, sdo_state_t sdo_state, const char* comment)
+{
+    uint32 u32_value = 0;
+    char str_buffer[5] = {0};
+
+    if (sdo_response->length >= 4)
+    {
+        os_memcpy(&u32_value, &sdo_response->data, sizeof(uint32));
+        os_memcpy(&str_buffer, &u32_value, sizeof(uint32));
+    }
+    else
+    {
+        os_memcpy(&u32_value, &sdo_response->data, sdo_response->length);
+        os_memcpy(&str_buffer, &u32_value, sdo_response->length);
+    }
+
+    if (false == is_printable_string(str_buffer, sizeof(uint32)))
+    {
+        str_buffer[0] = '\0';
+    }
+
+    switch (disp_mode)
+    {
+        case TERM_MODE:
+        {
+            const char* description = dict_lookup(index, sub_index);
+
+            if (NULL != description)
+            {
+                os_log(LOG_INFO, "%s", description);
+            }
+
+            switch (sdo_state)
+            {
+                case IS_READ_EXPEDITED:
+                    os_log(LOG_SUCCESS, "Index %x, Sub-index %x: %u byte(s) read: %u (0x%x) %s",
+                           index,
+                           sub_index,
+                           sdo_response->length,
+                           u32_value,
+                           u32_value,
+                           str_buffer);
+                    break;
+                case IS_READ_SEGMENTED:
+                case IS_READ_BLOCK:
+                    sdo_response->data[CAN_BUF_SIZE - 1] = '\0';
+                    os_log(LOG_SUCCESS, "Index %x, Sub-index %x: %u byte(s) read: %s",
+                           index,
+                           sub_index,
+                           sdo_response->length,
+                           (char*)sdo_response->data);
+                    break;
+                default:
+                    return;
+            }
+            break;
+        }
+        case SCRIPT_MODE:
+        {
+            int i;
+            char buffer[34] = {0};
+
+            sdo_response->data[CAN_BUF_SIZE - 1] = '\0';
+
+            if (NULL == comment)
+            {
+                comment = dict_lookup(index, sub_index);
+            }
+
+            if (NULL == comment)
+            {
+                comment = "-";
+            }
+
+            os_strlcpy(buffer, comment, 33);
+            for (i = os_strlen(buffer); i < 33; ++i)
+            {
+                buffer[i] = ' ';
+            }
+
+            os_print(DARK_YELLOW, "Read     ");
+            os_print(DEFAULT_COLOR, "0x%02X    0x%04X  0x%02X      %03u     ", node_id, index, sub_index, sdo_response->length);
+            os_print(LIGHT_GREEN, "SUCC    ");
+            os_print(DARK_MAGENTA, "%s ", buffer);
+
+            if (IS_READ_EXPEDITED == sdo_state)
+            {
+                switch (sdo_response->length)
+                {
+                    case 4:
+                        os_print(DEFAULT_COLOR, "0x%08X %u (U32) %s", u32_value, u32_value, str_buffer);
+                        break;
+                    case 3:
+                        os_print(DEFAULT_COLOR, "0x%06X %u (U24) %s", u32_value, u32_value, str_buffer);
+                        break;
+                    case 2:
+                        os_print(DEFAULT_COLOR, "0x%04X %u (U16) %s", u32_value, u32_value, str_buffer);
+                        break;
+                    case 1:
+                        os_print(DEFAULT_COLOR, "0x%02X %u (U8) %s", u32_value, u32_value, str_buffer);
+                        break;
+                }
+            }
+            else /* Read segmented SDO. */
+            {
+                os_print(DEFAULT_COLOR, "%s", (char*)sdo_response->data);
+            }
+            puts("");
+            break;
+        }
+        default:
+        case SILENT:
+            break;
+    }
+}
+
+void print_write_result(sdo_state_t sdo_state, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, disp_mode_t disp_mode, const char* comment)
+{
+    uint32 u32_value = 0;
+    uint32* u32_data_ptr = (uint32*)data;
+    char* data_str = (char*)data;
+
+    if (NULL != u32_data_ptr)
+    {
+        u32_value = *u32_data_ptr;
+    }
+
+    if (NULL == data_str)
+    {
+        data_str = "";
+    }
+
+    switch (disp_mode)
+    {
+        case TERM_MODE:
+        {
+            const char* description = dict_lookup(index, sub_index);
+
+            if (NULL != description)
+            {
+                os_log(LOG_INFO, "%s", description);
+            }
+
+            if (IS_WRITE_EXPEDITED == sdo_state)
+            {
+                char str[5] = {0};
+
+                switch (length)
+                {
+                    case 1:
+                        str[0] = os_isprint(data_str[0]) ? data_str[0] : '\0';
+                        break;
+                    case 2:
+                        str[0] = os_isprint(data_str[0]) ? data_str[0] : '\0';
+                        str[1] = os_isprint(data_str[1]) ? data_str[1] : '\0';
+                        break;
+                    case 3:
+                        str[0] = os_isprint(data_str[0]) ? data_str[0] : '\0';
+                        str[1] = os_isprint(data_str[1]) ? data_str[1] : '\0';
+                        str[2] = os_isprint(data_str[2]) ? data_str[2] : '\0';
+                        break;
+                    case 4:
+                        str[0] = os_isprint(data_str[0]) ? data_str[0] : '\0';
+                        str[1] = os_isprint(data_str[1]) ? data_str[1] : '\0';
+                        str[2] = os_isprint(data_str[2]) ? data_str[2] : '\0';
+                        str[3] = os_isprint(data_str[3]) ? data_str[3] : '\0';
+                        break;
+                    default:
+                        break;
+                }
+
+                os_log(LOG_SUCCESS, "Index %x, Sub-index %x: %u byte(s) written: %u (0x%x) %s",
+                       index,
+                       sub_index,
+                       length,
+                       u32_value,
+                       u32_value,
+                       str);
+            }
+            else if (IS_WRITE_BLOCK == sdo_state)
+            {
+                os_log(LOG_SUCCESS, "Index %x, Sub-index %x: %u byte(s) written (block transfer)",
+                       index,
+                       sub_index,
+                       length);
+            }
+            else if (IS_WRITE_SEGMENTED)
+            {
+                data_str[CAN_BUF_SIZE - 1] = '\0';
+
+                os_log(LOG_SUCCESS, "Index %x, Sub-index %x: %u byte(s) written: %s",
+                       index,
+                       sub_index,
+                       os_strlen(data_str),
+                       data_str);
+            }
+            else
+            {
+                return;
+            }
+            break;
+        }
+        case SCRIPT_MODE:
+        {
+            int i;
+            char buffer[34] = {0};
+
+            if (NULL == comment)
+            {
+                comment = dict_lookup(index, sub_index);
+            }
+
+            if (NULL == comment)
+            {
+                comment = "-";
+            }
+
+            os_strlcpy(buffer, comment, 33);
+            for (i = os_strlen(buffer); i < 33; ++i)
+            {
+                buffer[i] = ' ';
+            }
+
+            os_print(DARK_BLUE, "Write    ");
+            os_print(DEFAULT_COLOR, "0x%02X    0x%04X  0x%02X      %03u     ", node_id, index, sub_index, length);
+            os_print(LIGHT_GREEN, "SUCC    ");
+            os_print(DARK_MAGENTA, "%s ", buffer);
 
             if (IS_WRITE_EXPEDITED == sdo_state)
             {
@@ -1089,57 +1623,816 @@ void print_write_result(sdo_state_t sdo_state, uint8 node_id, uint16 index, uint
                         break;
                 }
             }
+            else if (IS_WRITE_BLOCK == sdo_state)
+            {
+                os_print(DEFAULT_COLOR, "Block transfer");
+            }
             else
             {
-                os_print(DEFAULT_COLOR, "%s", data_str);
+                os_print(DEFAULT_COLOR, "%s", data_str);
+            }
+            puts("");
+
+            break;
+        }
+        case SILENT:
+            break;
+    }
+}
+
+static int wait_for_response(uint8 node_id, sdo_state_t sdo_state, can_message_t* msg_in)
+{
+    uint64 time_a = os_get_ticks();
+    uint64 start_time = time_a;
+    uint64 timeout_time = 0;
+    bool response_received = false;
+
+    while ((false == response_received) && (timeout_time < SDO_TIMEOUT_IN_NS))
+    {
+        uint64 time_b;
+        uint64 delta_time;
+
+        can_read(msg_in);
+        if (get_response_id(node_id) == msg_in->id)
+        {
+            response_received = true;
+            continue;
+        }
+
+        time_b = time_a;
+        time_a = os_get_ticks();
+
+        if (time_a > time_b)
+        {
+            delta_time = time_a - time_b;
+        }
+        else
+        {
+            delta_time = time_b - time_a;
+        }
+        timeout_time += delta_time;
+    }
+
+    /* Callers pass ABORT_TRANSFER if the transfer type is only known
+     * from the response; they record the sample themselves.
+     */
+    if (timeout_time >= SDO_TIMEOUT_IN_NS)
+    {
+        sdo_stats_add_timeout(node_id, sdo_state);
+        return 1;
+    }
+    else
+    {
+        sdo_node_caps_t* caps = &node_caps[node_id & 0x7f];
+        uint64 rtt = os_get_ticks() - start_time;
+
+        sdo_stats_add_latency(node_id, sdo_state, rtt);
+
+        /* Smoothed round-trip time, see RFC 6298. */
+        if (0 == caps->rtt_ns)
+        {
+            caps->rtt_ns = rtt;
+        }
+        else
+        {
+            caps->rtt_ns = ((caps->rtt_ns * 7u) + rtt) / 8u;
+        }
+    }
+
+    return 0;
+}
+
+static uint32 get_abort_code(can_message_t* msg_in)
+{
+    uint32 abort_code = 0;
+
+    abort_code |= (uint32)msg_in->data[4];
+    abort_code |= (uint32)msg_in->data[5] << 8;
+    abort_code |= (uint32)msg_in->data[6] << 16;
+    abort_code |= (uint32)msg_in->data[7] << 24;
+
+    return abort_code;
+}
+
+static uint32 get_data_type_size(data_type_t data_type)
+{
+    switch (data_type)
+    {
+        case BOOLEAN_T:
+        case INTEGER8:
+        case UNSIGNED8:
+            return 1;
+        case INTEGER16:
+        case UNSIGNED16:
+            return 2;
+        case INTEGER24:
+        case UNSIGNED24:
+            return 3;
+        case INTEGER32:
+        case UNSIGNED32:
+        case REAL32:
+        case FLOAT_T:
+            return 4;
+        case INTEGER48:
+        case UNSIGNED48:
+        case TIME_OF_DAY:
+            return 6;
+        case INTEGER56:
+        case UNSIGNED56:
+            return 7;
+        case INTEGER64:
+        case UNSIGNED64:
+        case REAL64:
+            return 8;
+        default:
+        case NONE_T:
+        case VISIBLE_STRING:
+        case OCTET_STRING:
+        case DOMAIN_T:
+            return 0;
+    }
+}
+
+static data_type_t lookup_data_type(uint16 index, uint8 sub_index)
+{
+    object_info_t info;
+
+    os_memset(&info, 0, sizeof(object_info_t));
+
+    if (true == is_codb_loaded())
+    {
+        codb_info_lookup(codb_get_profile(), index, sub_index, &info);
+    }
+
+    if (true == is_ds301_loaded() && false == info.does_exist)
+    {
+        codb_info_lookup(codb_get_ds301_profile(), index, sub_index, &info);
+    }
+
+    if (false == info.does_exist)
+    {
+        return NONE_T;
+    }
+
+    return info.data_type;
+}
+
+static sdo_state_t transfer_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment)
+{
+    sdo_state_t sdo_state;
+
+    if (true == node_caps[node_id].is_usdo)
+    {
+        return usdo_read(sdo_response, disp_mode, node_id, index, sub_index, comment);
+    }
+
+    switch (lookup_data_type(index, sub_index))
+    {
+        case VISIBLE_STRING:
+        case OCTET_STRING:
+        case DOMAIN_T:
+            if (true == node_caps[node_id].is_block_supported)
+            {
+                return read_block(sdo_response, disp_mode, node_id, index, sub_index, comment);
+            }
+            else if (false == node_caps[node_id].is_block_probed)
+            {
+                /* Probe silently, fall back to a regular upload on failure. */
+                sdo_state = read_block(sdo_response, SILENT, node_id, index, sub_index, comment);
+                if (IS_READ_BLOCK == sdo_state)
+                {
+                    print_read_result(node_id, index, sub_index, sdo_response, disp_mode, sdo_state, comment);
+                    return sdo_state;
+                }
+                sdo_stats_add_retry(node_id, IS_READ_BLOCK);
+            }
+            break;
+        default:
+            break;
+    }
+
+    return sdo_read_uncached(sdo_response, disp_mode, node_id, index, sub_index, comment);
+}
+
+static sdo_state_t read_block(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment)
+{
+    can_message_t msg_in = {0};
+    can_message_t msg_out = {0};
+    char reason[300] = {0};
+    uint32 abort_code = 0;
+    uint32 can_status;
+    uint32 object_size;
+    uint32 response_index = 0;
+    uint8 expected_sequence = 1;
+    bool is_last_segment = false;
+    uint64 start_time = os_get_ticks();
+
+    msg_out.id = get_request_id(node_id);
+    msg_out.data[0] = BLOCK_UPLOAD_INIT_NO_CRC;
+    msg_out.data[1] = (uint8)(index & 0x00ff);
+    msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
+    msg_out.data[3] = sub_index;
+    msg_out.data[4] = SDO_BLOCK_SIZE;
+    msg_out.data[5] = 0x00; /* No protocol switch. */
+    msg_out.length = 8;
+
+    can_status = can_write(&msg_out, SILENT, NULL);
+    if (0 != can_status)
+    {
+        print_error(can_get_error_message(can_status), IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
+
+    os_memset(&msg_in, 0, sizeof(msg_in));
+    while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
+    {
+        if (0 != wait_for_response(node_id, IS_READ_BLOCK, &msg_in))
+        {
+            /* A timeout says nothing about block support: probe again next time. */
+            print_error("SDO timeout: CAN-dongle present?", IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
+    }
+
+    switch (msg_in.data[0])
+    {
+        case UPLOAD_INIT_BLOCK_NO_CRC_NO_SIZE:
+        case UPLOAD_INIT_BLOCK_CRC_NO_SIZE:
+            break;
+        case UPLOAD_INIT_BLOCK_NO_CRC_SIZE_IN_DATA:
+        case UPLOAD_INIT_BLOCK_CRC_SIZE_IN_DATA:
+            object_size = (uint32)msg_in.data[4];
+            object_size |= (uint32)msg_in.data[5] << 8;
+            object_size |= (uint32)msg_in.data[6] << 16;
+            object_size |= (uint32)msg_in.data[7] << 24;
+
+            if (object_size >= CAN_BUF_SIZE)
+            {
+                send_abort(get_request_id(node_id), index, sub_index, ABORT_OUT_OF_MEMORY);
+                sdo_stats_add_abort(node_id, IS_READ_BLOCK, ABORT_OUT_OF_MEMORY);
+                print_error("Object too large for block upload", IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+                return ABORT_TRANSFER;
+            }
+            break;
+        default:
+        case ABORT_TRANSFER: /* Error. */
+            abort_code = get_abort_code(&msg_in);
+            if (ABORT_CMD_SPECIFIER_INVALID_UNKNOWN == abort_code)
+            {
+                update_block_caps(node_id, false);
+            }
+
+            set_abort_reason(reason, node_id, IS_READ_BLOCK, abort_code);
+            print_error(reason, IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+    }
+
+    update_block_caps(node_id, true);
+
+    os_memset(&msg_out.data[1], 0, SEGMENT_DATA_SIZE);
+    msg_out.data[0] = BLOCK_UPLOAD_START;
+
+    can_status = can_write(&msg_out, SILENT, NULL);
+    if (0 != can_status)
+    {
+        print_error(can_get_error_message(can_status), IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
+
+    while (false == is_last_segment)
+    {
+        uint8 segment_count = 0;
+        bool is_block_complete = false;
+
+        while (false == is_block_complete)
+        {
+            uint8 sequence;
+
+            /* Streamed segments, no request-to-response latency. */
+            if (0 != wait_for_response(node_id, ABORT_TRANSFER, &msg_in))
+            {
+                sdo_stats_add_timeout(node_id, IS_READ_BLOCK);
+                send_abort(get_request_id(node_id), index, sub_index, ABORT_SDO_PROTOCOL_TIMED_OUT);
+                print_error("SDO timeout: CAN-dongle present?", IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+                return ABORT_TRANSFER;
+            }
+
+            if (ABORT_TRANSFER == msg_in.data[0])
+            {
+                abort_code = get_abort_code(&msg_in);
+                set_abort_reason(reason, node_id, IS_READ_BLOCK, abort_code);
+                print_error(reason, IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+                return ABORT_TRANSFER;
+            }
+
+            sequence = msg_in.data[0] & 0x7f;
+            segment_count += 1;
+
+            /* Out of sequence segments are discarded and requested again
+             * by acknowledging the last one received in order.
+             */
+            if (expected_sequence == sequence)
+            {
+                if ((response_index + SEGMENT_DATA_SIZE) >= CAN_BUF_SIZE)
+                {
+                    send_abort(get_request_id(node_id), index, sub_index, ABORT_OUT_OF_MEMORY);
+                    sdo_stats_add_abort(node_id, IS_READ_BLOCK, ABORT_OUT_OF_MEMORY);
+                    print_error("Object too large for block upload", IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+                    return ABORT_TRANSFER;
+                }
+
+                os_memcpy(&sdo_response->data[response_index], &msg_in.data[1], SEGMENT_DATA_SIZE);
+                response_index += SEGMENT_DATA_SIZE;
+                expected_sequence += 1;
+
+                if (0 != (msg_in.data[0] & 0x80))
+                {
+                    is_last_segment = true;
+                }
+            }
+
+            if ((0 != (msg_in.data[0] & 0x80)) || (segment_count >= SDO_BLOCK_SIZE))
+            {
+                is_block_complete = true;
+            }
+        }
+
+        if ((expected_sequence - 1) < segment_count)
+        {
+            /* The server repeats everything after the acknowledged segment. */
+            sdo_stats_add_retry(node_id, IS_READ_BLOCK);
+        }
+
+        msg_out.data[0] = BLOCK_UPLOAD_ACK;
+        msg_out.data[1] = expected_sequence - 1;
+        msg_out.data[2] = SDO_BLOCK_SIZE;
+
+        can_status = can_write(&msg_out, SILENT, NULL);
+        if (0 != can_status)
+        {
+            print_error(can_get_error_message(can_status), IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
+
+        expected_sequence = 1;
+    }
+
+    /* End block upload: the server tells how many bytes of the last
+     * segment did not contain data.
+     */
+    msg_in.data[0] = 0x00;
+    while (0xc1 != (msg_in.data[0] & 0xe3))
+    {
+        if (0 != wait_for_response(node_id, IS_READ_BLOCK, &msg_in))
+        {
+            send_abort(get_request_id(node_id), index, sub_index, ABORT_SDO_PROTOCOL_TIMED_OUT);
+            print_error("SDO timeout: CAN-dongle present?", IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
+    }
+
+    response_index -= (msg_in.data[0] >> 2) & 0x07;
+    sdo_response->length = response_index;
+    sdo_response->data[response_index] = '\0';
+
+    os_memset(&msg_out.data[1], 0, SEGMENT_DATA_SIZE);
+    msg_out.data[0] = BLOCK_UPLOAD_END_RESPONSE;
+
+    can_status = can_write(&msg_out, SILENT, NULL);
+    if (0 != can_status)
+    {
+        print_error(can_get_error_message(can_status), IS_READ_BLOCK, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
+
+    sdo_stats_add_transfer(node_id, IS_READ_BLOCK, response_index, os_get_ticks() - start_time);
+    print_read_result(node_id, index, sub_index, sdo_response, disp_mode, IS_READ_BLOCK, comment);
+    return IS_READ_BLOCK;
+}
+
+static void send_abort(uint32 request_id, uint16 index, uint8 sub_index, uint32 abort_code)
+{
+    can_message_t msg_out = {0};
+
+    msg_out.id = request_id;
+    msg_out.data[0] = ABORT_TRANSFER;
+    msg_out.data[1] = (uint8)(index & 0x00ff);
+    msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
+    msg_out.data[3] = sub_index;
+    msg_out.data[4] = (uint8)(abort_code & 0x000000ff);
+    msg_out.data[5] = (uint8)((abort_code & 0x0000ff00) >> 8);
+    msg_out.data[6] = (uint8)((abort_code & 0x00ff0000) >> 16);
+    msg_out.data[7] = (uint8)((abort_code & 0xff000000) >> 24);
+    msg_out.length = 8;
+
+    can_write(&msg_out, SILENT, NULL);
+}
+
+static uint32 get_request_id(uint8 node_id)
+{
+    node_id &= 0x7f;
+
+    if (true == channels[node_id][0].is_valid)
+    {
+        return channels[node_id][0].request_id;
+    }
+
+    return SDO_REQUEST_BASE_ID + node_id;
+}
+
+static uint32 get_response_id(uint8 node_id)
+{
+    node_id &= 0x7f;
+
+    if (true == channels[node_id][0].is_valid)
+    {
+        return channels[node_id][0].response_id;
+    }
+
+    return SDO_RESPONSE_BASE_ID + node_id;
+}
+
+static bool start_job(uint32 request_id, sdo_job_t* job, sdo_request_t* request)
+{
+    can_message_t msg_out = {0};
+
+    msg_out.id = request_id;
+    msg_out.data[0] = UPLOAD_RESPONSE_SEGMENT_NO_SIZE;
+    msg_out.data[1] = (uint8)(request->index & 0x00ff);
+    msg_out.data[2] = (uint8)((request->index & 0xff00) >> 8);
+    msg_out.data[3] = request->sub_index;
+    msg_out.length = 8;
+
+    os_memset(job, 0, sizeof(sdo_job_t));
+
+    if (0 != can_write(&msg_out, SILENT, NULL))
+    {
+        request->abort_code = ABORT_GENERAL_ERROR;
+        return false;
+    }
+
+    job->request = request;
+    job->begin_time = os_get_ticks();
+    job->start_time = job->begin_time;
+    job->is_active = true;
+
+    return true;
+}
+
+static bool handle_job_response(uint32 request_id, sdo_job_t* job, can_message_t* msg_in)
+{
+    can_message_t msg_out = {0};
+    sdo_request_t* request = job->request;
+    uint8 cmd = msg_in->data[0];
+
+    if (ABORT_TRANSFER == cmd)
+    {
+        request->abort_code = get_abort_code(msg_in);
+        return true;
+    }
+
+    msg_out.id = request_id;
+    msg_out.length = 8;
+
+    if (false == job->is_segmented)
+    {
+        uint32 length = sizeof(uint32);
+
+        /* Initiate upload response, ignore anything else. */
+        if ((0x40 != (cmd & 0xe0)) ||
+            ((request->index & 0x00ff) != msg_in->data[1]) ||
+            (((request->index & 0xff00) >> 8) != msg_in->data[2]) ||
+            (request->sub_index != msg_in->data[3]))
+        {
+            return false;
+        }
+
+        if (0 != (cmd & 0x02)) /* Expedited. */
+        {
+            if (0 != (cmd & 0x01))
+            {
+                length = sizeof(uint32) - ((cmd >> 2) & 0x03);
             }
-            puts("");
 
-            break;
+            os_memcpy(request->response.data, &msg_in->data[4], length);
+            request->response.length = length;
+            request->sdo_state = IS_READ_EXPEDITED;
+            return true;
         }
-        case SILENT:
-            break;
+
+        job->is_segmented = true;
+        job->toggle = 0x00;
+        job->length = 0;
+    }
+    else
+    {
+        uint32 length = SEGMENT_DATA_SIZE - ((cmd >> 1) & 0x07);
+
+        if ((0x00 != (cmd & 0xe0)) || (job->toggle != (cmd & 0x10)))
+        {
+            send_abort(request_id, request->index, request->sub_index, ABORT_TOGGLE_BIT_NOT_ALTERED);
+            request->abort_code = ABORT_TOGGLE_BIT_NOT_ALTERED;
+            return true;
+        }
+
+        if ((job->length + length) >= CAN_BUF_SIZE)
+        {
+            send_abort(request_id, request->index, request->sub_index, ABORT_OUT_OF_MEMORY);
+            request->abort_code = ABORT_OUT_OF_MEMORY;
+            return true;
+        }
+
+        os_memcpy(&request->response.data[job->length], &msg_in->data[1], length);
+        job->length += length;
+
+        if (0 != (cmd & 0x01)) /* No more segments. */
+        {
+            request->response.data[job->length] = '\0';
+            request->response.length = job->length;
+            request->sdo_state = IS_READ_SEGMENTED;
+            return true;
+        }
+
+        job->toggle ^= 0x10;
     }
+
+    msg_out.data[0] = UPLOAD_SEGMENT_REQUEST_1 | job->toggle;
+
+    if (0 != can_write(&msg_out, SILENT, NULL))
+    {
+        request->abort_code = ABORT_GENERAL_ERROR;
+        return true;
+    }
+
+    job->start_time = os_get_ticks();
+    return false;
 }
 
-static int wait_for_response(uint8 node_id, can_message_t* msg_in)
+static void update_block_caps(uint8 node_id, bool is_supported)
 {
-    uint64 time_a = os_get_ticks();
-    uint64 timeout_time = 0;
-    bool response_received = false;
+    node_caps[node_id & 0x7f].is_block_probed = true;
+    node_caps[node_id & 0x7f].is_block_supported = is_supported;
+}
 
-    while ((false == response_received) && (timeout_time < SDO_TIMEOUT_IN_NS))
+static sdo_state_t write_block(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, const uint8* data, const char* comment)
+{
+    can_message_t msg_in = {0};
+    can_message_t msg_out = {0};
+    char reason[300] = {0};
+    uint32 abort_code = 0;
+    uint32 can_status = 0;
+    uint32 block_offset = 0;
+    uint32 bytes_sent = 0;
+    uint8 block_size = 0;
+    uint8 sequence = 0;
+    uint8 last_segment_size = 0;
+    uint64 start_time = os_get_ticks();
+
+    limit_node_id(&node_id);
+
+    if ((NULL == data) || (0 == length))
     {
-        uint64 time_b;
-        uint64 delta_time;
+        print_error("No data to transfer", IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
 
-        can_read(msg_in);
-        if ((0x580 + node_id) == msg_in->id)
+    msg_out.id = get_request_id(node_id);
+    msg_out.data[0] = UPLOAD_INIT_BLOCK_NO_CRC_SIZE_IN_DATA;
+    msg_out.data[1] = (uint8)(index & 0x00ff);
+    msg_out.data[2] = (uint8)((index & 0xff00) >> 8);
+    msg_out.data[3] = sub_index;
+    msg_out.data[4] = (uint8)(length & 0xff);
+    msg_out.data[5] = (uint8)((length >> 8) & 0xff);
+    msg_out.data[6] = (uint8)((length >> 16) & 0xff);
+    msg_out.data[7] = (uint8)((length >> 24) & 0xff);
+    msg_out.length = 8;
+
+    can_status = can_write(&msg_out, SILENT, NULL);
+    if (0 != can_status)
+    {
+        print_error(can_get_error_message(can_status), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
+
+    os_memset(&msg_in, 0, sizeof(msg_in));
+    while (((index & 0x00ff) != msg_in.data[1]) || (((index & 0xff00) >> 8) != msg_in.data[2]))
+    {
+        if (0 != wait_for_response(node_id, IS_WRITE_BLOCK, &msg_in))
         {
-            response_received = true;
-            continue;
+            print_error("SDO timeout: CAN-dongle present?", IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
         }
+    }
 
-        time_b = time_a;
-        time_a = os_get_ticks();
+    switch (msg_in.data[0])
+    {
+        case BLOCK_DOWNLOAD_RESPONSE_NO_CRC:
+        case BLOCK_DOWNLOAD_RESPONSE_CRC:
+            block_size = msg_in.data[4];
+            break;
+        default:
+        case ABORT_TRANSFER: /* Error. */
+            abort_code = get_abort_code(&msg_in);
+            if (ABORT_CMD_SPECIFIER_INVALID_UNKNOWN == abort_code)
+            {
+                update_block_caps(node_id, false);
+            }
 
-        if (time_a > time_b)
+            set_abort_reason(reason, node_id, IS_WRITE_BLOCK, abort_code);
+            print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+    }
+
+    update_block_caps(node_id, true);
+
+    while (bytes_sent < length)
+    {
+        uint8 i;
+        uint32 segment_size = length - bytes_sent;
+
+        if (segment_size > SEGMENT_DATA_SIZE)
         {
-            delta_time = time_a - time_b;
+            segment_size = SEGMENT_DATA_SIZE;
         }
-        else
+
+        if ((0 == block_size) || (block_size > SDO_BLOCK_SIZE))
         {
-            delta_time = time_b - time_a;
+            send_abort(get_request_id(node_id), index, sub_index, ABORT_INVALID_BLOCK_SIZE);
+            sdo_stats_add_abort(node_id, IS_WRITE_BLOCK, ABORT_INVALID_BLOCK_SIZE);
+            print_error(sdo_lookup_abort_code(ABORT_INVALID_BLOCK_SIZE), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
+
+        sequence += 1;
+        msg_out.data[0] = sequence;
+
+        for (i = 0; i < SEGMENT_DATA_SIZE; ++i)
+        {
+            msg_out.data[i + 1] = (i < segment_size) ? data[bytes_sent + i] : 0x00;
+        }
+
+        bytes_sent += segment_size;
+        last_segment_size = (uint8)segment_size;
+
+        /* Mark last segment of last block. */
+        if (bytes_sent >= length)
+        {
+            msg_out.data[0] |= 0x80;
+        }
+
+        can_status = can_write(&msg_out, SILENT, NULL);
+        if (0 != can_status)
+        {
+            print_error(can_get_error_message(can_status), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
+
+        if ((bytes_sent >= length) || (sequence >= block_size))
+        {
+            msg_in.data[0] = 0x00;
+
+            while (BLOCK_DOWNLOAD_ACK != msg_in.data[0])
+            {
+                if (0 != wait_for_response(node_id, IS_WRITE_BLOCK, &msg_in))
+                {
+                    send_abort(get_request_id(node_id), index, sub_index, ABORT_SDO_PROTOCOL_TIMED_OUT);
+                    print_error("SDO timeout: CAN-dongle present?", IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+                    return ABORT_TRANSFER;
+                }
+
+                if (ABORT_TRANSFER == msg_in.data[0])
+                {
+                    abort_code = get_abort_code(&msg_in);
+                    set_abort_reason(reason, node_id, IS_WRITE_BLOCK, abort_code);
+                    print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+                    return ABORT_TRANSFER;
+                }
+            }
+
+            /* Resume after the last segment the server acknowledged. */
+            if (msg_in.data[1] < sequence)
+            {
+                sdo_stats_add_retry(node_id, IS_WRITE_BLOCK);
+                bytes_sent = block_offset + ((uint32)msg_in.data[1] * SEGMENT_DATA_SIZE);
+            }
+
+            block_offset = bytes_sent;
+            block_size = msg_in.data[2];
+            sequence = 0;
         }
-        timeout_time += delta_time;
     }
 
-    if (timeout_time >= SDO_TIMEOUT_IN_NS)
+    /* End block download, no CRC. */
+    msg_out.data[0] = BLOCK_DOWNLOAD_END_REQUEST | (uint8)((SEGMENT_DATA_SIZE - last_segment_size) << 2);
+    os_memset(&msg_out.data[1], 0, SEGMENT_DATA_SIZE);
+
+    can_status = can_write(&msg_out, SILENT, NULL);
+    if (0 != can_status)
     {
-        char reason[300] = {0};
-        os_snprintf(reason, 300, "SDO timeout: CAN-dongle present?");
-        return 1;
+        print_error(can_get_error_message(can_status), IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+        return ABORT_TRANSFER;
+    }
+
+    msg_in.data[0] = 0x00;
+    while (BLOCK_DOWNLOAD_END_RESPONSE != msg_in.data[0])
+    {
+        if (0 != wait_for_response(node_id, IS_WRITE_BLOCK, &msg_in))
+        {
+            print_error("SDO timeout: CAN-dongle present?", IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
+
+        if (ABORT_TRANSFER == msg_in.data[0])
+        {
+            abort_code = get_abort_code(&msg_in);
+            set_abort_reason(reason, node_id, IS_WRITE_BLOCK, abort_code);
+            print_error(reason, IS_WRITE_BLOCK, node_id, index, sub_index, comment, disp_mode);
+            return ABORT_TRANSFER;
+        }
+    }
+
+    sdo_response->length = length;
+
+    sdo_stats_add_transfer(node_id, IS_WRITE_BLOCK, length, os_get_ticks() - start_time);
+    sdo_cache_update(node_id, index, sub_index, length, data);
+    print_write_result(IS_WRITE_BLOCK, node_id, index, sub_index, length, (void*)data, disp_mode, comment);
+    return IS_WRITE_BLOCK;
+}
+
+static void init_usdo_request(can_message_t* msg_out, uint8 node_id, uint8 cmd, uint8 session_id, uint16 index, uint8 sub_index)
+{
+    os_memset(msg_out, 0, sizeof(can_message_t));
+
+    msg_out->id = get_request_id(node_id);
+    msg_out->data[0] = node_id;
+    msg_out->data[1] = cmd;
+    msg_out->data[2] = session_id;
+    msg_out->data[3] = 0x00; /* Data type, not evaluated. */
+    msg_out->data[4] = (uint8)(index & 0x00ff);
+    msg_out->data[5] = (uint8)((index & 0xff00) >> 8);
+    msg_out->data[6] = sub_index;
+}
+
+static uint32 get_usdo_frame_length(uint32 length)
+{
+    /* Valid CAN FD data lengths beyond the classic 8 bytes. */
+    static const uint8 fd_lengths[] = { 8, 12, 16, 20, 24, 32, 48, 64 };
+    size_t i;
+
+    for (i = 0; i < sizeof(fd_lengths); i++)
+    {
+        if (length <= fd_lengths[i])
+        {
+            return fd_lengths[i];
+        }
     }
 
+    return USDO_FRAME_SIZE;
+}
+
+static uint32 get_usdo_value(can_message_t* msg_in)
+{
+    uint32 value = 0;
+
+    /* Size or abort code, depending on the command. */
+    value |= (uint32)msg_in->data[8];
+    value |= (uint32)msg_in->data[9] << 8;
+    value |= (uint32)msg_in->data[10] << 16;
+    value |= (uint32)msg_in->data[11] << 24;
+
+    return value;
+}
+
+static void send_usdo_abort(uint8 node_id, uint8 session_id, uint16 index, uint8 sub_index, uint32 abort_code)
+{
+    can_message_t msg_out;
+
+    init_usdo_request(&msg_out, node_id, USDO_ABORT, session_id, index, sub_index);
+    msg_out.data[8] = (uint8)(abort_code & 0x000000ff);
+    msg_out.data[9] = (uint8)((abort_code & 0x0000ff00) >> 8);
+    msg_out.data[10] = (uint8)((abort_code & 0x00ff0000) >> 16);
+    msg_out.data[11] = (uint8)((abort_code & 0xff000000) >> 24);
+    msg_out.length = get_usdo_frame_length(USDO_HEADER_SIZE + sizeof(uint32));
+
+    can_write(&msg_out, SILENT, NULL);
+}
+
+static int wait_for_usdo_response(uint8 node_id, sdo_state_t sdo_state, uint8 session_id, can_message_t* msg_in)
+{
+    /* Skip stale responses from earlier, timed out sessions. */
+    do
+    {
+        if (0 != wait_for_response(node_id, sdo_state, msg_in))
+        {
+            return 1;
+        }
+    } while (session_id != msg_in->data[2]);
+
     return 0;
 }
+
+static void set_abort_reason(char* reason, uint8 node_id, sdo_state_t sdo_state, uint32 abort_code)
+{
+    sdo_stats_add_abort(node_id, sdo_state, abort_code);
+    os_snprintf(reason, 300, "0x%08x: %s", abort_code, sdo_lookup_abort_code(abort_code));
+}
@@ -13,6 +13,11 @@
 #include "can.h"
 #include "core.h"
 
+#define SDO_CHANNEL_MAX 0x10
+#define SDO_REQUEST_BASE_ID 0x600
+#define SDO_RESPONSE_BASE_ID 0x580
+#define SDO_TIMEOUT_IN_NS 100000000u
+
 #define DOWNLOAD_RESPONSE_1 0x20
 #define DOWNLOAD_RESPONSE_2 0x30
 #define UPLOAD_SEGMENT_REQUEST_1 0x60
@@ -21,6 +26,19 @@
 #define UPLOAD_SEGMENT_CONTINUE_2 0x10
 #define BLOCK_DOWNLOAD_RESPONSE_NO_CRC 0xa0
 #define BLOCK_DOWNLOAD_RESPONSE_CRC 0xa4
+#define BLOCK_DOWNLOAD_ACK 0xa2
+#define BLOCK_DOWNLOAD_END_REQUEST 0xc1
+#define BLOCK_DOWNLOAD_END_RESPONSE 0xa1
+#define BLOCK_UPLOAD_INIT_NO_CRC 0xa0
+#define BLOCK_UPLOAD_START 0xa3
+#define BLOCK_UPLOAD_ACK 0xa2
+#define BLOCK_UPLOAD_END_RESPONSE 0xa1
+
+#define USDO_FRAME_SIZE 64u
+#define USDO_HEADER_SIZE 8u
+#define USDO_EXPEDITED_SIZE (USDO_FRAME_SIZE - USDO_HEADER_SIZE)
+#define USDO_SEGMENT_DATA_SIZE (USDO_FRAME_SIZE - 1u)
+#define USDO_BROADCAST_ID 0x00
 
 typedef enum
 {
@@ -93,10 +111,63 @@ typedef enum
 
 } sdo_abort_code_t;
 
+typedef enum
+{
+    USDO_DOWNLOAD_EXPEDITED = 0x01,     /* Download, data in the initiate frame */
+    USDO_DOWNLOAD_SEGMENTED = 0x02,     /* Download initiate, size in data */
+    USDO_DOWNLOAD_SEGMENTED_END = 0x03, /* Download confirmation after the last segment */
+    USDO_UPLOAD_EXPEDITED = 0x11,       /* Upload, data in the response frame */
+    USDO_UPLOAD_SEGMENTED = 0x12,       /* Upload response, size in data, segments follow */
+    USDO_ABORT = 0x7f,                  /* Abort, code in bytes 8-11 */
+    USDO_RESPONSE = 0x80                /* Set in every server response */
+
+} usdo_command_t;
+
+typedef struct sdo_node_caps
+{
+    bool is_block_probed;
+    bool is_block_supported;
+    bool is_usdo;
+    uint64 rtt_ns;
+
+} sdo_node_caps_t;
+
+typedef struct sdo_channel
+{
+    uint32 request_id;
+    uint32 response_id;
+    bool is_valid;
+
+} sdo_channel_t;
+
+typedef struct sdo_request
+{
+    uint16 index;
+    uint8 sub_index;
+    sdo_state_t sdo_state;
+    uint32 abort_code;
+    can_message_t response;
+
+} sdo_request_t;
+
 const char* sdo_lookup_abort_code(uint32 abort_code);
 sdo_state_t sdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment);
+sdo_state_t sdo_read_uncached(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment);
 sdo_state_t sdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment);
 sdo_state_t sdo_write_block(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* filename, const char* comment);
 sdo_state_t sdo_write_segmented(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment);
+sdo_state_t sdo_transfer_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment);
+sdo_state_t sdo_transfer_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment);
+sdo_state_t sdo_select_write_mode(uint8 node_id, uint16 index, uint8 sub_index, uint32* length);
+void sdo_get_node_caps(uint8 node_id, sdo_node_caps_t* caps);
+void sdo_reset_node_caps(void);
+void sdo_set_usdo(uint8 node_id, bool is_enabled);
+sdo_state_t usdo_read(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, const char* comment);
+sdo_state_t usdo_write(can_message_t* sdo_response, disp_mode_t disp_mode, uint8 node_id, uint16 index, uint8 sub_index, uint32 length, void* data, const char* comment);
+uint8 sdo_discover_channels(uint8 node_id);
+status_t sdo_set_channel(uint8 node_id, uint8 channel, uint32 request_id, uint32 response_id);
+status_t sdo_get_channel(uint8 node_id, uint8 channel, sdo_channel_t* sdo_channel);
+uint8 sdo_get_channel_count(uint8 node_id);
+uint32 sdo_read_parallel(disp_mode_t disp_mode, uint8 node_id, sdo_request_t* requests, uint32 count);
 
 #endif /* SDO_H */
@@ -0,0 +1,384 @@
+/** @file sdo_cache.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "sdo_cache.h"
+#include "can.h"
+#include "codb.h"
+#include "core.h"
+#include "os.h"
+#include "sdo.h"
+
+typedef struct sdo_cache_node
+{
+    bool is_enabled;
+    uint32 next;
+    uint32 hits;
+    uint32 misses;
+    sdo_cache_entry_t* entries;
+
+} sdo_cache_node_t;
+
+static sdo_cache_node_t cache_nodes[0x80];
+static os_mutex* lock;
+
+static bool init(void);
+static void store(sdo_cache_node_t* node, uint16 index, uint8 sub_index, sdo_state_t sdo_state, const can_message_t* sdo_response);
+static sdo_cache_entry_t* find_entry(sdo_cache_node_t* node, uint16 index, uint8 sub_index);
+static sdo_cache_entry_t* alloc_entry(sdo_cache_node_t* node, uint16 index, uint8 sub_index);
+static bool is_cacheable(uint16 index, uint8 sub_index);
+
+void sdo_cache_enable(uint8 node_id, bool is_enabled)
+{
+    uint8 node;
+
+    if (false == init())
+    {
+        return;
+    }
+
+    limit_node_id(&node_id);
+
+    os_lock_mutex(lock);
+
+    for (node = 0x01; node <= 0x7f; node += 1)
+    {
+        if ((0 != node_id) && (node != node_id))
+        {
+            continue;
+        }
+
+        cache_nodes[node].is_enabled = is_enabled;
+
+        if (false == is_enabled)
+        {
+            os_free(cache_nodes[node].entries);
+            os_memset(&cache_nodes[node], 0, sizeof(sdo_cache_node_t));
+        }
+    }
+
+    os_unlock_mutex(lock);
+}
+
+bool sdo_cache_is_enabled(uint8 node_id)
+{
+    limit_node_id(&node_id);
+    return cache_nodes[node_id].is_enabled;
+}
+
+bool sdo_cache_lookup(uint8 node_id, uint16 index, uint8 sub_index, can_message_t* sdo_response, sdo_state_t* sdo_state)
+{
+    sdo_cache_node_t* node;
+    sdo_cache_entry_t* entry;
+
+    limit_node_id(&node_id);
+    node = &cache_nodes[node_id];
+
+    if ((NULL == lock) || (NULL == sdo_response) || (NULL == sdo_state))
+    {
+        return false;
+    }
+
+    os_lock_mutex(lock);
+
+    if (false == node->is_enabled)
+    {
+        os_unlock_mutex(lock);
+        return false;
+    }
+
+    entry = find_entry(node, index, sub_index);
+    if (NULL == entry)
+    {
+        node->misses += 1;
+        os_unlock_mutex(lock);
+        return false;
+    }
+
+    os_memset(sdo_response->data, 0, sizeof(sdo_response->data));
+    os_memcpy(sdo_response->data, entry->data, entry->length);
+    sdo_response->length = entry->length;
+    *sdo_state = entry->sdo_state;
+
+    node->hits += 1;
+
+    os_unlock_mutex(lock);
+    return true;
+}
+
+void sdo_cache_store(uint8 node_id, uint16 index, uint8 sub_index, sdo_state_t sdo_state, const can_message_t* sdo_response)
+{
+    limit_node_id(&node_id);
+
+    if ((false == sdo_cache_is_enabled(node_id)) || (NULL == sdo_response))
+    {
+        return;
+    }
+
+    switch (sdo_state)
+    {
+        case IS_READ_EXPEDITED:
+        case IS_READ_SEGMENTED:
+        case IS_READ_BLOCK:
+            break;
+        default:
+            return;
+    }
+
+    /* The dictionary lookup stays outside the lock. */
+    if ((sdo_response->length > SDO_CACHE_DATA_SIZE) || (false == is_cacheable(index, sub_index)))
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    /* Disabled meanwhile: the entries may be gone. */
+    if (true == cache_nodes[node_id].is_enabled)
+    {
+        store(&cache_nodes[node_id], index, sub_index, sdo_state, sdo_response);
+    }
+
+    os_unlock_mutex(lock);
+}
+
+void sdo_cache_update(uint8 node_id, uint16 index, uint8 sub_index, uint32 length, const void* data)
+{
+    can_message_t sdo_response = {0};
+    sdo_cache_node_t* node;
+    sdo_cache_entry_t* entry;
+    bool is_stored;
+
+    limit_node_id(&node_id);
+    node = &cache_nodes[node_id];
+
+    if (false == sdo_cache_is_enabled(node_id))
+    {
+        return;
+    }
+
+    is_stored = (NULL != data) && (length <= SDO_CACHE_DATA_SIZE) && (true == is_cacheable(index, sub_index));
+
+    if (true == is_stored)
+    {
+        sdo_response.length = length;
+        os_memcpy(sdo_response.data, data, length);
+    }
+
+    os_lock_mutex(lock);
+
+    /* Never keep a value the device may no longer hold. */
+    entry = find_entry(node, index, sub_index);
+    if (NULL != entry)
+    {
+        entry->is_valid = false;
+    }
+
+    if ((true == is_stored) && (true == node->is_enabled))
+    {
+        store(node, index, sub_index, (length <= sizeof(uint32)) ? IS_READ_EXPEDITED : IS_READ_SEGMENTED, &sdo_response);
+    }
+
+    os_unlock_mutex(lock);
+}
+
+void sdo_cache_invalidate(uint8 node_id)
+{
+    uint8 node;
+
+    /* Nothing was ever cached. */
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    limit_node_id(&node_id);
+
+    os_lock_mutex(lock);
+
+    for (node = 0x01; node <= 0x7f; node += 1)
+    {
+        if ((0 != node_id) && (node != node_id))
+        {
+            continue;
+        }
+
+        if (NULL != cache_nodes[node].entries)
+        {
+            os_memset(cache_nodes[node].entries, 0, SDO_CACHE_SIZE * sizeof(sdo_cache_entry_t));
+        }
+        cache_nodes[node].next = 0;
+    }
+
+    os_unlock_mutex(lock);
+}
+
+void sdo_cache_get_info(uint8 node_id, sdo_cache_info_t* info)
+{
+    sdo_cache_node_t* node;
+    uint32 i;
+
+    if (NULL == info)
+    {
+        return;
+    }
+
+    limit_node_id(&node_id);
+    node = &cache_nodes[node_id];
+
+    os_memset(info, 0, sizeof(sdo_cache_info_t));
+
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    info->is_enabled = node->is_enabled;
+    info->hits = node->hits;
+    info->misses = node->misses;
+
+    for (i = 0; (NULL != node->entries) && (i < SDO_CACHE_SIZE); i += 1)
+    {
+        if (true == node->entries[i].is_valid)
+        {
+            info->entries += 1;
+        }
+    }
+
+    os_unlock_mutex(lock);
+}
+
+void sdo_cache_deinit(void)
+{
+    sdo_cache_enable(0, false);
+}
+
+static bool init(void)
+{
+    if (NULL == lock)
+    {
+        lock = os_create_mutex();
+    }
+
+    return (NULL != lock);
+}
+
+static void store(sdo_cache_node_t* node, uint16 index, uint8 sub_index, sdo_state_t sdo_state, const can_message_t* sdo_response)
+{
+    sdo_cache_entry_t* entry = alloc_entry(node, index, sub_index);
+
+    if (NULL == entry)
+    {
+        return;
+    }
+
+    entry->sdo_state = sdo_state;
+    entry->length = sdo_response->length;
+    os_memcpy(entry->data, sdo_response->data, entry->length);
+}
+
+static sdo_cache_entry_t* find_entry(sdo_cache_node_t* node, uint16 index, uint8 sub_index)
+{
+    uint32 i;
+
+    if (NULL == node->entries)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < SDO_CACHE_SIZE; i += 1)
+    {
+        sdo_cache_entry_t* entry = &node->entries[i];
+
+        if ((true == entry->is_valid) && (index == entry->index) && (sub_index == entry->sub_index))
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static sdo_cache_entry_t* alloc_entry(sdo_cache_node_t* node, uint16 index, uint8 sub_index)
+{
+    sdo_cache_entry_t* entry;
+    uint32 i;
+
+    if (NULL == node->entries)
+    {
+        node->entries = (sdo_cache_entry_t*)os_calloc(SDO_CACHE_SIZE, sizeof(sdo_cache_entry_t));
+        if (NULL == node->entries)
+        {
+            return NULL;
+        }
+    }
+
+    entry = find_entry(node, index, sub_index);
+    if (NULL != entry)
+    {
+        return entry;
+    }
+
+    for (i = 0; i < SDO_CACHE_SIZE; i += 1)
+    {
+        if (false == node->entries[i].is_valid)
+        {
+            entry = &node->entries[i];
+            break;
+        }
+    }
+
+    if (NULL == entry)
+    {
+        /* Full: evict round-robin. */
+        entry = &node->entries[node->next];
+        node->next = (node->next + 1u) % SDO_CACHE_SIZE;
+    }
+
+    os_memset(entry, 0, sizeof(sdo_cache_entry_t));
+    entry->index = index;
+    entry->sub_index = sub_index;
+    entry->is_valid = true;
+
+    return entry;
+}
+
+static bool is_cacheable(uint16 index, uint8 sub_index)
+{
+    object_info_t info;
+
+    os_memset(&info, 0, sizeof(object_info_t));
+
+    if (true == is_codb_loaded())
+    {
+        codb_info_lookup(codb_get_profile(), index, sub_index, &info);
+    }
+
+    if (true == is_ds301_loaded() && false == info.does_exist)
+    {
+        codb_info_lookup(codb_get_ds301_profile(), index, sub_index, &info);
+    }
+
+    if (false == info.does_exist)
+    {
+        return false;
+    }
+
+    switch (info.access_type)
+    {
+        case CONST_T:
+            return true;
+        case RO:
+            /* Mappable RO objects are process data and change at will. */
+            return (false == info.pdo_mapping);
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,49 @@
+/** @file sdo_cache.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef SDO_CACHE_H
+#define SDO_CACHE_H
+
+#include "can.h"
+#include "os.h"
+#include "sdo.h"
+
+#define SDO_CACHE_SIZE 64u
+#define SDO_CACHE_DATA_SIZE 64u
+
+typedef struct sdo_cache_entry
+{
+    uint16 index;
+    uint8 sub_index;
+    bool is_valid;
+    sdo_state_t sdo_state;
+    uint32 length;
+    uint8 data[SDO_CACHE_DATA_SIZE];
+
+} sdo_cache_entry_t;
+
+typedef struct sdo_cache_info
+{
+    bool is_enabled;
+    uint32 entries;
+    uint32 hits;
+    uint32 misses;
+
+} sdo_cache_info_t;
+
+void sdo_cache_enable(uint8 node_id, bool is_enabled);
+bool sdo_cache_is_enabled(uint8 node_id);
+bool sdo_cache_lookup(uint8 node_id, uint16 index, uint8 sub_index, can_message_t* sdo_response, sdo_state_t* sdo_state);
+void sdo_cache_store(uint8 node_id, uint16 index, uint8 sub_index, sdo_state_t sdo_state, const can_message_t* sdo_response);
+void sdo_cache_update(uint8 node_id, uint16 index, uint8 sub_index, uint32 length, const void* data);
+void sdo_cache_invalidate(uint8 node_id);
+void sdo_cache_get_info(uint8 node_id, sdo_cache_info_t* info);
+void sdo_cache_deinit(void);
+
+#endif /* SDO_CACHE_H */
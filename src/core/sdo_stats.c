@@ -0,0 +1,406 @@
+/** @file sdo_stats.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "sdo_stats.h"
+#include "core.h"
+#include "os.h"
+#include "sdo.h"
+#include "table.h"
+#include "test_report.h"
+
+static sdo_stats_t node_stats[0x80][SDO_STATS_TYPE_COUNT];
+
+static sdo_stats_t* get_stats(uint8 node_id, sdo_state_t sdo_state);
+static uint32 get_bucket(uint64 latency_ns);
+static uint64 get_bucket_limit(uint32 bucket);
+static void format_duration(char* buffer, size_t size, uint64 duration_ns);
+static void format_summary(char* buffer, size_t size, const sdo_stats_t* stats);
+
+void sdo_stats_add_latency(uint8 node_id, sdo_state_t sdo_state, uint64 latency_ns)
+{
+    sdo_stats_t* stats = get_stats(node_id, sdo_state);
+
+    if (NULL == stats)
+    {
+        return;
+    }
+
+    stats->histogram[get_bucket(latency_ns)] += 1;
+    stats->sum_ns += latency_ns;
+
+    if ((0 == stats->samples) || (latency_ns < stats->min_ns))
+    {
+        stats->min_ns = latency_ns;
+    }
+    if (latency_ns > stats->max_ns)
+    {
+        stats->max_ns = latency_ns;
+    }
+
+    stats->samples += 1;
+}
+
+void sdo_stats_add_transfer(uint8 node_id, sdo_state_t sdo_state, uint32 length, uint64 duration_ns)
+{
+    sdo_stats_t* stats = get_stats(node_id, sdo_state);
+
+    if (NULL == stats)
+    {
+        return;
+    }
+
+    stats->transfers += 1;
+    stats->bytes += length;
+    stats->duration_ns += duration_ns;
+}
+
+void sdo_stats_add_timeout(uint8 node_id, sdo_state_t sdo_state)
+{
+    sdo_stats_t* stats = get_stats(node_id, sdo_state);
+
+    if (NULL != stats)
+    {
+        stats->timeouts += 1;
+    }
+}
+
+void sdo_stats_add_abort(uint8 node_id, sdo_state_t sdo_state, uint32 abort_code)
+{
+    sdo_stats_t* stats = get_stats(node_id, sdo_state);
+    uint32 i;
+
+    if (NULL == stats)
+    {
+        return;
+    }
+
+    stats->aborts += 1;
+
+    for (i = 0; i < SDO_STATS_ABORT_MAX; i += 1)
+    {
+        sdo_stats_abort_t* entry = &stats->abort_codes[i];
+
+        if ((0 == entry->count) || (abort_code == entry->abort_code))
+        {
+            entry->abort_code = abort_code;
+            entry->count += 1;
+            return;
+        }
+    }
+
+    /* Table full: the total is still counted in aborts. */
+}
+
+void sdo_stats_add_retry(uint8 node_id, sdo_state_t sdo_state)
+{
+    sdo_stats_t* stats = get_stats(node_id, sdo_state);
+
+    if (NULL != stats)
+    {
+        stats->retries += 1;
+    }
+}
+
+status_t sdo_stats_get(uint8 node_id, sdo_state_t sdo_state, sdo_stats_t* stats)
+{
+    sdo_stats_t* source = get_stats(node_id, sdo_state);
+
+    if ((NULL == source) || (NULL == stats))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    os_memcpy(stats, source, sizeof(sdo_stats_t));
+    return ALL_OK;
+}
+
+uint64 sdo_stats_get_percentile(const sdo_stats_t* stats, float percentile)
+{
+    uint64 rank;
+    uint64 count = 0;
+    uint32 bucket;
+
+    if ((NULL == stats) || (0 == stats->samples))
+    {
+        return 0;
+    }
+
+    if (percentile <= 0.f)
+    {
+        return stats->min_ns;
+    }
+    else if (percentile >= 100.f)
+    {
+        return stats->max_ns;
+    }
+
+    rank = (uint64)((percentile / 100.f) * (float)stats->samples);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+
+    for (bucket = 0; bucket < SDO_STATS_BUCKET_COUNT; bucket += 1)
+    {
+        count += stats->histogram[bucket];
+        if (count >= rank)
+        {
+            uint64 limit = get_bucket_limit(bucket);
+
+            /* Never report more than was actually measured. */
+            return (limit < stats->max_ns) ? limit : stats->max_ns;
+        }
+    }
+
+    return stats->max_ns;
+}
+
+uint64 sdo_stats_get_throughput(const sdo_stats_t* stats)
+{
+    if ((NULL == stats) || (0 == stats->duration_ns))
+    {
+        return 0;
+    }
+
+    return (stats->bytes * 1000000000u) / stats->duration_ns;
+}
+
+const char* sdo_stats_get_type_name(sdo_state_t sdo_state)
+{
+    switch (sdo_state)
+    {
+        case IS_READ_EXPEDITED:
+            return "read_expedited";
+        case IS_READ_SEGMENTED:
+            return "read_segmented";
+        case IS_READ_BLOCK:
+            return "read_block";
+        case IS_WRITE_EXPEDITED:
+            return "write_expedited";
+        case IS_WRITE_SEGMENTED:
+            return "write_segmented";
+        case IS_WRITE_BLOCK:
+            return "write_block";
+        default:
+            return "unknown";
+    }
+}
+
+bool sdo_stats_is_empty(const sdo_stats_t* stats)
+{
+    if (NULL == stats)
+    {
+        return true;
+    }
+
+    return (0 == stats->samples) && (0 == stats->transfers) && (0 == stats->timeouts) && (0 == stats->aborts) && (0 == stats->retries);
+}
+
+void sdo_stats_print(uint8 node_id)
+{
+    table_t table = {DARK_CYAN, DEFAULT_COLOR, 4, 15, 72};
+    uint8 first = 0x01;
+    uint8 last = 0x7f;
+    uint8 node;
+    bool is_empty = true;
+
+    if (0 != node_id)
+    {
+        limit_node_id(&node_id);
+        first = node_id;
+        last = node_id;
+    }
+
+    table_init(&table, 1024);
+    table_print_header(&table);
+    table_print_row("ID", "Type", "Latency / Failures / Throughput", &table);
+    table_print_divider(&table);
+
+    for (node = first; node <= last; node += 1)
+    {
+        sdo_state_t sdo_state;
+
+        for (sdo_state = IS_READ_EXPEDITED; sdo_state < SDO_STATS_TYPE_COUNT; sdo_state += 1)
+        {
+            const sdo_stats_t* stats = &node_stats[node][sdo_state];
+            char id_str[5] = {0};
+            char summary[128] = {0};
+
+            if (true == sdo_stats_is_empty(stats))
+            {
+                continue;
+            }
+
+            os_snprintf(id_str, sizeof(id_str), "0x%02x", node);
+            format_summary(summary, sizeof(summary), stats);
+            table_print_row(id_str, sdo_stats_get_type_name(sdo_state), summary, &table);
+            is_empty = false;
+        }
+    }
+
+    if (true == is_empty)
+    {
+        table_print_row("-", "-", "No SDO transfers recorded", &table);
+    }
+
+    table_print_footer(&table);
+    table_flush(&table);
+}
+
+void sdo_stats_export(const char* package)
+{
+    uint8 node;
+
+    if (NULL == package)
+    {
+        package = "SDO";
+    }
+
+    for (node = 0x01; node <= 0x7f; node += 1)
+    {
+        sdo_state_t sdo_state;
+
+        for (sdo_state = IS_READ_EXPEDITED; sdo_state < SDO_STATS_TYPE_COUNT; sdo_state += 1)
+        {
+            const sdo_stats_t* stats = &node_stats[node][sdo_state];
+            test_result_t result = {0};
+            char class_name[16] = {0};
+            char summary[128] = {0};
+            char error_message[64] = {0};
+            char call_stack[1024] = {0};
+            uint32 i;
+
+            if (true == sdo_stats_is_empty(stats))
+            {
+                continue;
+            }
+
+            os_snprintf(class_name, sizeof(class_name), "Node_0x%02X", node);
+            format_summary(summary, sizeof(summary), stats);
+
+            result.has_passed = (0 == stats->timeouts) && (0 == stats->aborts);
+            result.time = (float)stats->duration_ns / 1000000000.f;
+            result.package = package;
+            result.class_name = class_name;
+            result.test_name = sdo_stats_get_type_name(sdo_state);
+            result.system_out = summary;
+
+            if (false == result.has_passed)
+            {
+                os_snprintf(error_message, sizeof(error_message), "%u timeout(s), %u abort(s)", stats->timeouts, stats->aborts);
+
+                for (i = 0; (i < SDO_STATS_ABORT_MAX) && (0 != stats->abort_codes[i].count); i += 1)
+                {
+                    char line[160] = {0};
+
+                    os_snprintf(line, sizeof(line), "%ux 0x%08x: %s\n",
+                                stats->abort_codes[i].count,
+                                stats->abort_codes[i].abort_code,
+                                sdo_lookup_abort_code(stats->abort_codes[i].abort_code));
+                    os_strlcat(call_stack, line, sizeof(call_stack));
+                }
+
+                result.error_type = "SDOTransfer";
+                result.error_message = error_message;
+                result.call_stack = ('\0' != call_stack[0]) ? call_stack : NULL;
+            }
+
+            test_add_result(&result);
+        }
+    }
+}
+
+void sdo_stats_reset(void)
+{
+    os_memset(node_stats, 0, sizeof(node_stats));
+}
+
+static sdo_stats_t* get_stats(uint8 node_id, sdo_state_t sdo_state)
+{
+    if (sdo_state >= SDO_STATS_TYPE_COUNT)
+    {
+        return NULL;
+    }
+
+    return &node_stats[node_id & 0x7f][sdo_state];
+}
+
+static uint32 get_bucket(uint64 latency_ns)
+{
+    uint64 latency_us = latency_ns / 1000u;
+    uint32 magnitude = 0;
+    uint32 bucket;
+
+    if (latency_us < SDO_STATS_SUB_BUCKETS)
+    {
+        return (uint32)latency_us;
+    }
+
+    while ((latency_us >> magnitude) >= (2u * SDO_STATS_SUB_BUCKETS))
+    {
+        magnitude += 1;
+    }
+
+    bucket = ((magnitude + 1u) * SDO_STATS_SUB_BUCKETS) + (uint32)((latency_us >> magnitude) - SDO_STATS_SUB_BUCKETS);
+    if (bucket >= SDO_STATS_BUCKET_COUNT)
+    {
+        bucket = SDO_STATS_BUCKET_COUNT - 1u;
+    }
+
+    return bucket;
+}
+
+static uint64 get_bucket_limit(uint32 bucket)
+{
+    uint32 magnitude;
+    uint64 lower_us;
+
+    if (bucket < SDO_STATS_SUB_BUCKETS)
+    {
+        return ((uint64)bucket + 1u) * 1000u;
+    }
+
+    magnitude = (bucket / SDO_STATS_SUB_BUCKETS) - 1u;
+    lower_us = ((uint64)SDO_STATS_SUB_BUCKETS + (bucket % SDO_STATS_SUB_BUCKETS)) << magnitude;
+
+    return (lower_us + ((uint64)1u << magnitude)) * 1000u;
+}
+
+static void format_duration(char* buffer, size_t size, uint64 duration_ns)
+{
+    if (duration_ns < 1000000u)
+    {
+        os_snprintf(buffer, size, "%uus", (uint32)(duration_ns / 1000u));
+    }
+    else
+    {
+        os_snprintf(buffer, size, "%.1fms", (double)duration_ns / 1000000.0);
+    }
+}
+
+static void format_summary(char* buffer, size_t size, const sdo_stats_t* stats)
+{
+    char p50[16] = {0};
+    char p99[16] = {0};
+    char max[16] = {0};
+
+    format_duration(p50, sizeof(p50), sdo_stats_get_percentile(stats, 50.f));
+    format_duration(p99, sizeof(p99), sdo_stats_get_percentile(stats, 99.f));
+    format_duration(max, sizeof(max), stats->max_ns);
+
+    os_snprintf(buffer, size, "n=%u p50=%s p99=%s max=%s to=%u abort=%u retry=%u %uB/s",
+                stats->transfers,
+                p50,
+                p99,
+                max,
+                stats->timeouts,
+                stats->aborts,
+                stats->retries,
+                (uint32)sdo_stats_get_throughput(stats));
+}
@@ -0,0 +1,63 @@
+/** @file sdo_stats.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef SDO_STATS_H
+#define SDO_STATS_H
+
+#include "os.h"
+#include "sdo.h"
+
+/* Log-linear latency histogram in microseconds: 4 sub-buckets per
+ * power of two, covering 0 us to about 33 s with <= 25% error.
+ */
+#define SDO_STATS_SUB_BUCKETS 4u
+#define SDO_STATS_MAGNITUDES 24u
+#define SDO_STATS_BUCKET_COUNT (SDO_STATS_SUB_BUCKETS * SDO_STATS_MAGNITUDES)
+#define SDO_STATS_ABORT_MAX 8u
+#define SDO_STATS_TYPE_COUNT (IS_WRITE_BLOCK + 1)
+
+typedef struct sdo_stats_abort
+{
+    uint32 abort_code;
+    uint32 count;
+
+} sdo_stats_abort_t;
+
+typedef struct sdo_stats
+{
+    uint32 histogram[SDO_STATS_BUCKET_COUNT];
+    uint32 samples;
+    uint64 min_ns;
+    uint64 max_ns;
+    uint64 sum_ns;
+    uint32 transfers;
+    uint32 timeouts;
+    uint32 aborts;
+    uint32 retries;
+    uint64 bytes;
+    uint64 duration_ns;
+    sdo_stats_abort_t abort_codes[SDO_STATS_ABORT_MAX];
+
+} sdo_stats_t;
+
+void sdo_stats_add_latency(uint8 node_id, sdo_state_t sdo_state, uint64 latency_ns);
+void sdo_stats_add_transfer(uint8 node_id, sdo_state_t sdo_state, uint32 length, uint64 duration_ns);
+void sdo_stats_add_timeout(uint8 node_id, sdo_state_t sdo_state);
+void sdo_stats_add_abort(uint8 node_id, sdo_state_t sdo_state, uint32 abort_code);
+void sdo_stats_add_retry(uint8 node_id, sdo_state_t sdo_state);
+status_t sdo_stats_get(uint8 node_id, sdo_state_t sdo_state, sdo_stats_t* stats);
+uint64 sdo_stats_get_percentile(const sdo_stats_t* stats, float percentile);
+uint64 sdo_stats_get_throughput(const sdo_stats_t* stats);
+const char* sdo_stats_get_type_name(sdo_state_t sdo_state);
+bool sdo_stats_is_empty(const sdo_stats_t* stats);
+void sdo_stats_print(uint8 node_id);
+void sdo_stats_export(const char* package);
+void sdo_stats_reset(void);
+
+#endif /* SDO_STATS_H */
@@ -0,0 +1,1590 @@
+/** @file sim.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "sim.h"
+#include "can.h"
+#include "cJSON.h"
+#include "codb.h"
+#include "core.h"
+#include "eds.h"
+#include "os.h"
+#include "sdo.h"
+#include "vcan.h"
+
+#define SIM_NMT_ID 0x000
+#define SIM_SYNC_ID 0x080
+#define SIM_SDO_RESPONSE_BASE_ID 0x580
+#define SIM_SDO_REQUEST_BASE_ID 0x600
+#define SIM_HEARTBEAT_BASE_ID 0x700
+#define SIM_SEGMENT_DATA_SIZE 7u
+#define SIM_BLOCK_SIZE 0x7f
+#define SIM_NEVER 0xffffffffffffffffULL
+#define SIM_NS_PER_MS 1000000ULL
+
+static sim_node_t nodes[0x80];
+static sim_template_t* templates;
+static sim_info_t info;
+static uint64 next_due = SIM_NEVER;
+static os_mutex* lock;
+static int endpoint = -1;
+static bool is_bus_owner;
+
+static sim_template_t* load_eds_template(const char* file_name);
+static sim_template_t* load_codb_template(void);
+static void add_codb_objects(sim_template_t* template, codb_t* db, uint32 sorted_count);
+static status_t add_object(sim_template_t* template, const sim_object_t* object);
+static void add_default_object(sim_template_t* template, uint16 index, uint8 sub_index, acc_type_t access_type, uint8 size, uint32 value);
+static void sort_template(sim_template_t* template);
+static void free_template(sim_template_t* template);
+static int compare_objects(const void* a, const void* b);
+static uint8 get_eds_type_size(uint16 data_type);
+static uint8 get_codb_type_size(data_type_t data_type);
+static sim_object_t* find_object(sim_node_t* node, uint16 index, uint8 sub_index);
+static sim_object_t* search_objects(sim_object_t* objects, uint32 object_count, uint16 index, uint8 sub_index);
+static uint8* get_object_data(sim_object_t* object);
+static uint32 get_object_value(sim_node_t* node, uint16 index, uint8 sub_index);
+static status_t init_node(sim_node_t* node, uint8 node_id, const sim_template_t* template);
+static void reset_objects(sim_node_t* node, uint16 first_index, uint16 last_index);
+static void free_node(sim_node_t* node);
+static void boot_node(sim_node_t* node, uint64 now);
+static void schedule_node(sim_node_t* node, uint64 now);
+static void update(uint64 now);
+static void handle_frame(const can_message_t* message, uint64 now, void* user);
+static void push_frame(uint32 id, const uint8* data, uint8 length);
+static void handle_nmt(const can_message_t* message, uint64 now);
+static void handle_sync(void);
+static void handle_node_guarding(sim_node_t* node);
+static void handle_sdo(sim_node_t* node, const can_message_t* message, uint64 now);
+static void handle_block_segment(sim_node_t* node, const can_message_t* message);
+static bool check_object(sim_node_t* node, uint16 index, uint8 sub_index, bool is_write, sim_object_t** object);
+static void send_sdo(sim_node_t* node, const uint8 data[8]);
+static void send_sdo_abort(sim_node_t* node, uint16 index, uint8 sub_index, uint32 abort_code);
+static void send_upload_block(sim_node_t* node);
+static void reset_sdo(sim_sdo_t* sdo);
+static bool reserve_buffer(sim_sdo_t* sdo, uint32 size);
+static uint32 write_object(sim_node_t* node, sim_object_t* object, const uint8* data, uint32 length, uint64 now);
+static void send_tpdo(sim_node_t* node, uint8 tpdo);
+
+status_t sim_add_nodes(uint8 first_node_id, uint8 count, const char* file_name)
+{
+    sim_template_t* template;
+    uint32 i;
+
+    if ((0 == first_node_id) || (0 == count) || (((uint32)first_node_id + count - 1u) > 0x7f))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (NULL == file_name)
+    {
+        template = load_codb_template();
+    }
+    else
+    {
+        template = load_eds_template(file_name);
+    }
+
+    if (NULL == template)
+    {
+        return (NULL == file_name) ? ITEM_NOT_FOUND : EDS_PARSE_ERROR;
+    }
+
+    if (NULL == lock)
+    {
+        lock = os_create_mutex();
+        if (NULL == lock)
+        {
+            free_template(template);
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+
+    /* Without a configured virtual bus, open one without delays. */
+    if (false == vcan_is_open())
+    {
+        if (ALL_OK != vcan_init(NULL))
+        {
+            free_template(template);
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+        is_bus_owner = true;
+    }
+
+    if (endpoint < 0)
+    {
+        endpoint = vcan_attach(handle_frame, NULL);
+        if (endpoint < 0)
+        {
+            free_template(template);
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+
+    os_lock_mutex(lock);
+
+    template->next = templates;
+    templates = template;
+
+    for (i = first_node_id; i < ((uint32)first_node_id + count); i += 1)
+    {
+        sim_node_t* node = &nodes[i];
+
+        if (true == node->is_active)
+        {
+            free_node(node);
+        }
+
+        if (ALL_OK != init_node(node, (uint8)i, template))
+        {
+            os_unlock_mutex(lock);
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+
+    /* The boot-up messages are sent on the next bus poll. */
+    next_due = 0;
+
+    os_unlock_mutex(lock);
+    return ALL_OK;
+}
+
+void sim_stop(void)
+{
+    uint32 i;
+
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    /* Detach first: the bus calls into the simulator while polling. */
+    vcan_detach(endpoint);
+    endpoint = -1;
+
+    if (true == is_bus_owner)
+    {
+        vcan_deinit();
+        is_bus_owner = false;
+    }
+
+    os_lock_mutex(lock);
+
+    for (i = 1; i <= 0x7f; i += 1)
+    {
+        free_node(&nodes[i]);
+    }
+
+    while (NULL != templates)
+    {
+        sim_template_t* next = templates->next;
+
+        free_template(templates);
+        templates = next;
+    }
+
+    next_due = SIM_NEVER;
+    os_memset(&info, 0, sizeof(info));
+
+    os_unlock_mutex(lock);
+}
+
+bool sim_is_running(void)
+{
+    return (info.node_count > 0);
+}
+
+void sim_get_info(sim_info_t* sim_info)
+{
+    if (NULL == sim_info)
+    {
+        return;
+    }
+
+    os_memcpy(sim_info, &info, sizeof(sim_info_t));
+}
+
+static sim_template_t* load_eds_template(const char* file_name)
+{
+    sim_template_t* template;
+    eds_t eds = {0};
+    char file_path[512] = {0};
+    FILE_t* file;
+    uint16 i;
+
+    os_strlcpy(file_path, file_name, sizeof(file_path));
+
+    /* Fall back to the eds directory of the data path. */
+    file = os_fopen(file_path, "r");
+    if (NULL == file)
+    {
+        os_snprintf(file_path, sizeof(file_path), "%s/eds/%s", os_find_data_path(), file_name);
+    }
+    else
+    {
+        os_fclose(file);
+    }
+
+    if (ALL_OK != eds_load(file_path, &eds))
+    {
+        return NULL;
+    }
+
+    template = (sim_template_t*)os_calloc(1, sizeof(sim_template_t));
+    if (NULL == template)
+    {
+        eds_free(&eds);
+        return NULL;
+    }
+
+    for (i = 0; i < eds.num_entries; i++)
+    {
+        const eds_entry_t* entry = &eds.entries[i];
+        sim_object_t object = {0};
+        uint8 n;
+
+        /* ARRAY and RECORD headers only describe their sub-indices. */
+        if ((0x08 == entry->ObjectType) || (0x09 == entry->ObjectType))
+        {
+            continue;
+        }
+
+        object.index = entry->Index;
+        object.sub_index = entry->SubIndex;
+        object.access_type = (UNSPECIFIED == entry->AccessType) ? RW : entry->AccessType;
+        object.pdo_mapping = entry->PDOMapping;
+        object.is_node_id_relative = entry->IsNodeIdRelative;
+        object.size = get_eds_type_size(entry->DataType);
+        object.length = object.size;
+
+        for (n = 0; (n < object.size) && (n < sizeof(uint32)); n++)
+        {
+            object.value[n] = (uint8)(entry->DefaultValue >> (n * 8u));
+        }
+
+        /* VISIBLE_STRING: the default is the string itself. */
+        if (0x09 == entry->DataType)
+        {
+            object.length = (uint32)os_strlen(entry->DefaultString);
+            object.data = (uint8*)entry->DefaultString;
+        }
+
+        if (ALL_OK != add_object(template, &object))
+        {
+            free_template(template);
+            eds_free(&eds);
+            return NULL;
+        }
+    }
+
+    eds_free(&eds);
+
+    add_default_object(template, 0x1000, 0x00, RO, 4, 0);
+    add_default_object(template, 0x1017, 0x00, RW, 2, 0);
+    sort_template(template);
+
+    return template;
+}
+
+static sim_template_t* load_codb_template(void)
+{
+    sim_template_t* template;
+
+    if ((false == is_codb_loaded()) && (false == is_ds301_loaded()))
+    {
+        return NULL;
+    }
+
+    template = (sim_template_t*)os_calloc(1, sizeof(sim_template_t));
+    if (NULL == template)
+    {
+        return NULL;
+    }
+
+    if (true == is_codb_loaded())
+    {
+        add_codb_objects(template, codb_get_profile(), 0);
+        sort_template(template);
+    }
+
+    if (true == is_ds301_loaded())
+    {
+        add_codb_objects(template, codb_get_ds301_profile(), template->object_count);
+    }
+
+    add_default_object(template, 0x1000, 0x00, RO, 4, 0);
+    add_default_object(template, 0x1017, 0x00, RW, 2, 0);
+    add_default_object(template, 0x1018, 0x00, RO, 1, 4);
+    add_default_object(template, 0x1018, 0x01, RO, 4, 0);
+    add_default_object(template, 0x1018, 0x02, RO, 4, 0);
+    add_default_object(template, 0x1018, 0x03, RO, 4, 0);
+    add_default_object(template, 0x1018, 0x04, RO, 4, 0);
+    sort_template(template);
+
+    return template;
+}
+
+static void add_codb_objects(sim_template_t* template, codb_t* db, uint32 sorted_count)
+{
+    cJSON* object = NULL;
+
+    if (NULL == db)
+    {
+        return;
+    }
+
+    cJSON_ArrayForEach(object, db)
+    {
+        cJSON* json_index = cJSON_GetObjectItem(object, "index");
+        cJSON* sub_indices = cJSON_GetObjectItem(object, "sub_indices");
+        cJSON* sub_index_item = NULL;
+        uint32 sub_index = 0;
+
+        if ((NULL == json_index) || (NULL == sub_indices))
+        {
+            continue;
+        }
+
+        cJSON_ArrayForEach(sub_index_item, sub_indices)
+        {
+            cJSON* data_type = cJSON_GetObjectItem(sub_index_item, "data_type");
+            cJSON* access_type = cJSON_GetObjectItem(sub_index_item, "access_type");
+            cJSON* mappable = cJSON_GetObjectItem(sub_index_item, "mappable");
+            cJSON* default_value = cJSON_GetObjectItem(sub_index_item, "default_value");
+            sim_object_t sim_object = {0};
+            uint32 value = 0;
+            uint8 n;
+
+            sim_object.index = (uint16)json_index->valueint;
+            sim_object.sub_index = (uint8)sub_index;
+            sim_object.access_type = RW;
+            sub_index += 1;
+
+            if (NULL != data_type)
+            {
+                cJSON* type = cJSON_GetObjectItem(data_type, "type");
+                sim_object.size = (NULL != type) ? get_codb_type_size((data_type_t)type->valueint) : sizeof(uint32);
+            }
+
+            if (NULL != access_type)
+            {
+                cJSON* type = cJSON_GetObjectItem(access_type, "type");
+                if ((NULL != type) && (UNSPECIFIED != type->valueint))
+                {
+                    sim_object.access_type = (acc_type_t)type->valueint;
+                }
+            }
+
+            if (NULL != mappable)
+            {
+                cJSON* mappable_value = cJSON_GetObjectItem(mappable, "value");
+                sim_object.pdo_mapping = (NULL != mappable_value) ? (bool)mappable_value->valueint : false;
+            }
+
+            if (NULL != default_value)
+            {
+                cJSON* default_value_value = cJSON_GetObjectItem(default_value, "value");
+                value = (NULL != default_value_value) ? (uint32)default_value_value->valuedouble : 0;
+            }
+
+            for (n = 0; (n < sim_object.size) && (n < sizeof(uint32)); n++)
+            {
+                sim_object.value[n] = (uint8)(value >> (n * 8u));
+            }
+            sim_object.length = sim_object.size;
+
+            /* The device profile takes precedence over DS301. */
+            if (NULL == search_objects(template->objects, sorted_count, sim_object.index, sim_object.sub_index))
+            {
+                add_object(template, &sim_object);
+            }
+        }
+    }
+}
+
+static status_t add_object(sim_template_t* template, const sim_object_t* object)
+{
+    sim_object_t* objects;
+    sim_object_t* entry;
+
+    objects = (sim_object_t*)os_realloc(template->objects, (template->object_count + 1u) * sizeof(sim_object_t));
+    if (NULL == objects)
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    template->objects = objects;
+    entry = &template->objects[template->object_count];
+    os_memcpy(entry, object, sizeof(sim_object_t));
+    entry->data = NULL;
+
+    if (0 == object->size)
+    {
+        entry->data = (uint8*)os_calloc(object->length + 1u, sizeof(uint8));
+        if (NULL == entry->data)
+        {
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+
+        if ((NULL != object->data) && (object->length > 0))
+        {
+            os_memcpy(entry->data, object->data, object->length);
+        }
+    }
+
+    template->object_count += 1u;
+    return ALL_OK;
+}
+
+static void add_default_object(sim_template_t* template, uint16 index, uint8 sub_index, acc_type_t access_type, uint8 size, uint32 value)
+{
+    sim_object_t object = {0};
+    uint32 i;
+    uint8 n;
+
+    for (i = 0; i < template->object_count; i += 1)
+    {
+        if ((index == template->objects[i].index) && (sub_index == template->objects[i].sub_index))
+        {
+            return;
+        }
+    }
+
+    object.index = index;
+    object.sub_index = sub_index;
+    object.access_type = access_type;
+    object.size = size;
+    object.length = size;
+
+    for (n = 0; (n < size) && (n < sizeof(uint32)); n++)
+    {
+        object.value[n] = (uint8)(value >> (n * 8u));
+    }
+
+    add_object(template, &object);
+}
+
+static void sort_template(sim_template_t* template)
+{
+    if (template->object_count > 1u)
+    {
+        os_qsort(template->objects, template->object_count, sizeof(sim_object_t), compare_objects);
+    }
+}
+
+static void free_template(sim_template_t* template)
+{
+    uint32 i;
+
+    if (NULL == template)
+    {
+        return;
+    }
+
+    for (i = 0; i < template->object_count; i += 1)
+    {
+        os_free(template->objects[i].data);
+    }
+
+    os_free(template->objects);
+    os_free(template);
+}
+
+static int compare_objects(const void* a, const void* b)
+{
+    const sim_object_t* object_a = (const sim_object_t*)a;
+    const sim_object_t* object_b = (const sim_object_t*)b;
+    uint32 key_a = ((uint32)object_a->index << 8) | object_a->sub_index;
+    uint32 key_b = ((uint32)object_b->index << 8) | object_b->sub_index;
+
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+static uint8 get_eds_type_size(uint16 data_type)
+{
+    switch (data_type)
+    {
+        case 0x01: /* BOOLEAN */
+        case 0x02: /* INTEGER8 */
+        case 0x05: /* UNSIGNED8 */
+            return 1;
+        case 0x03: /* INTEGER16 */
+        case 0x06: /* UNSIGNED16 */
+            return 2;
+        case 0x10: /* INTEGER24 */
+        case 0x16: /* UNSIGNED24 */
+            return 3;
+        case 0x04: /* INTEGER32 */
+        case 0x07: /* UNSIGNED32 */
+        case 0x08: /* REAL32 */
+            return 4;
+        case 0x12: /* INTEGER40 */
+        case 0x18: /* UNSIGNED40 */
+            return 5;
+        case 0x0c: /* TIME_OF_DAY */
+        case 0x0d: /* TIME_DIFFERENCE */
+        case 0x13: /* INTEGER48 */
+        case 0x19: /* UNSIGNED48 */
+            return 6;
+        case 0x14: /* INTEGER56 */
+        case 0x1a: /* UNSIGNED56 */
+            return 7;
+        case 0x11: /* REAL64 */
+        case 0x15: /* INTEGER64 */
+        case 0x1b: /* UNSIGNED64 */
+            return 8;
+        case 0x09: /* VISIBLE_STRING */
+        case 0x0a: /* OCTET_STRING */
+        case 0x0b: /* UNICODE_STRING */
+        case 0x0f: /* DOMAIN */
+            return 0;
+        default:
+            return 4;
+    }
+}
+
+static uint8 get_codb_type_size(data_type_t data_type)
+{
+    switch (data_type)
+    {
+        case BOOLEAN_T:
+        case INTEGER8:
+        case UNSIGNED8:
+            return 1;
+        case INTEGER16:
+        case UNSIGNED16:
+            return 2;
+        case INTEGER24:
+        case UNSIGNED24:
+            return 3;
+        case INTEGER48:
+        case UNSIGNED48:
+        case TIME_OF_DAY:
+            return 6;
+        case INTEGER56:
+        case UNSIGNED56:
+            return 7;
+        case INTEGER64:
+        case UNSIGNED64:
+        case REAL64:
+            return 8;
+        case VISIBLE_STRING:
+        case OCTET_STRING:
+        case DOMAIN_T:
+            return 0;
+        default:
+            return 4;
+    }
+}
+
+static sim_object_t* find_object(sim_node_t* node, uint16 index, uint8 sub_index)
+{
+    return search_objects(node->objects, node->object_count, index, sub_index);
+}
+
+static sim_object_t* search_objects(sim_object_t* objects, uint32 object_count, uint16 index, uint8 sub_index)
+{
+    uint32 key = ((uint32)index << 8) | sub_index;
+    uint32 low = 0;
+    uint32 high = object_count;
+
+    while (low < high)
+    {
+        uint32 mid = low + ((high - low) / 2u);
+        sim_object_t* object = &objects[mid];
+        uint32 mid_key = ((uint32)object->index << 8) | object->sub_index;
+
+        if (mid_key == key)
+        {
+            return object;
+        }
+        else if (mid_key < key)
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NULL;
+}
+
+static uint8* get_object_data(sim_object_t* object)
+{
+    return (NULL != object->data) ? object->data : object->value;
+}
+
+static uint32 get_object_value(sim_node_t* node, uint16 index, uint8 sub_index)
+{
+    sim_object_t* object = find_object(node, index, sub_index);
+    uint32 value = 0;
+    uint8 n;
+
+    if ((NULL == object) || (0 == object->size))
+    {
+        return 0;
+    }
+
+    for (n = 0; (n < object->size) && (n < sizeof(uint32)); n++)
+    {
+        value |= (uint32)object->value[n] << (n * 8u);
+    }
+
+    return value;
+}
+
+static status_t init_node(sim_node_t* node, uint8 node_id, const sim_template_t* template)
+{
+    uint32 i;
+
+    os_memset(node, 0, sizeof(sim_node_t));
+
+    node->objects = (sim_object_t*)os_calloc(template->object_count + 1u, sizeof(sim_object_t));
+    if (NULL == node->objects)
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    for (i = 0; i < template->object_count; i += 1)
+    {
+        node->objects[i].index = template->objects[i].index;
+        node->objects[i].sub_index = template->objects[i].sub_index;
+    }
+
+    node->node_id = node_id;
+    node->template = template;
+    node->object_count = template->object_count;
+    node->is_active = true;
+    info.node_count += 1;
+
+    reset_objects(node, 0x0000, 0xffff);
+    return ALL_OK;
+}
+
+static void reset_objects(sim_node_t* node, uint16 first_index, uint16 last_index)
+{
+    uint32 i;
+
+    for (i = 0; i < node->object_count; i += 1)
+    {
+        const sim_object_t* source = &node->template->objects[i];
+        sim_object_t* object = &node->objects[i];
+
+        if ((source->index < first_index) || (source->index > last_index))
+        {
+            continue;
+        }
+
+        os_free(object->data);
+        os_memcpy(object, source, sizeof(sim_object_t));
+        object->data = NULL;
+
+        if (NULL != source->data)
+        {
+            object->data = (uint8*)os_calloc(source->length + 1u, sizeof(uint8));
+            if (NULL != object->data)
+            {
+                os_memcpy(object->data, source->data, source->length);
+            }
+            else
+            {
+                object->length = 0;
+            }
+        }
+
+        if (true == object->is_node_id_relative)
+        {
+            uint32 value = get_object_value(node, object->index, object->sub_index) + node->node_id;
+            uint8 n;
+
+            for (n = 0; (n < object->size) && (n < sizeof(uint32)); n++)
+            {
+                object->value[n] = (uint8)(value >> (n * 8u));
+            }
+        }
+    }
+}
+
+static void free_node(sim_node_t* node)
+{
+    uint32 i;
+
+    if (false == node->is_active)
+    {
+        return;
+    }
+
+    for (i = 0; i < node->object_count; i += 1)
+    {
+        os_free(node->objects[i].data);
+    }
+
+    os_free(node->objects);
+    os_free(node->sdo.buffer);
+    os_memset(node, 0, sizeof(sim_node_t));
+
+    info.node_count -= 1;
+}
+
+static void boot_node(sim_node_t* node, uint64 now)
+{
+    uint8 boot_up = SIM_NMT_BOOT_UP;
+
+    reset_sdo(&node->sdo);
+    push_frame(SIM_HEARTBEAT_BASE_ID + node->node_id, &boot_up, 1);
+
+    node->guard_toggle = 0x00;
+
+    node->nmt_state = SIM_NMT_PRE_OPERATIONAL;
+    schedule_node(node, now);
+}
+
+static void schedule_node(sim_node_t* node, uint64 now)
+{
+    uint8 n;
+
+    node->heartbeat_period = (uint64)get_object_value(node, 0x1017, 0x00) * SIM_NS_PER_MS;
+    node->next_heartbeat = (node->heartbeat_period > 0) ? now + node->heartbeat_period : SIM_NEVER;
+    node->next_due = node->next_heartbeat;
+
+    for (n = 0; n < SIM_TPDO_MAX; n++)
+    {
+        uint32 cob_id = get_object_value(node, 0x1800 + n, 0x01);
+        uint32 type = get_object_value(node, 0x1800 + n, 0x02);
+        uint32 event_timer = get_object_value(node, 0x1800 + n, 0x05);
+
+        node->sync_count[n] = 0;
+        node->tpdo_period[n] = 0;
+        node->next_tpdo[n] = SIM_NEVER;
+
+        if ((NULL == find_object(node, 0x1800 + n, 0x01)) || (0 != (cob_id & 0x80000000)))
+        {
+            continue;
+        }
+
+        if ((type >= 0xfe) && (event_timer > 0))
+        {
+            node->tpdo_period[n] = (uint64)event_timer * SIM_NS_PER_MS;
+            node->next_tpdo[n] = now + node->tpdo_period[n];
+
+            if (node->next_tpdo[n] < node->next_due)
+            {
+                node->next_due = node->next_tpdo[n];
+            }
+        }
+    }
+
+    if (node->next_due < next_due)
+    {
+        next_due = node->next_due;
+    }
+}
+
+static void update(uint64 now)
+{
+    uint32 i;
+
+    if (now < next_due)
+    {
+        return;
+    }
+
+    /* Only walk the nodes when at least one of them is due. */
+    next_due = SIM_NEVER;
+
+    for (i = 1; i <= 0x7f; i += 1)
+    {
+        sim_node_t* node = &nodes[i];
+        uint8 n;
+
+        if ((false == node->is_active) || (SIM_NEVER == node->next_due))
+        {
+            continue;
+        }
+
+        if (SIM_NMT_BOOT_UP == node->nmt_state)
+        {
+            boot_node(node, now);
+        }
+
+        if (node->next_due <= now)
+        {
+            node->next_due = SIM_NEVER;
+
+            if (node->next_heartbeat <= now)
+            {
+                uint8 state = (uint8)node->nmt_state;
+
+                push_frame(SIM_HEARTBEAT_BASE_ID + node->node_id, &state, 1);
+                node->next_heartbeat += node->heartbeat_period;
+                if (node->next_heartbeat <= now)
+                {
+                    node->next_heartbeat = now + node->heartbeat_period;
+                }
+            }
+
+            if (node->next_heartbeat < node->next_due)
+            {
+                node->next_due = node->next_heartbeat;
+            }
+
+            for (n = 0; n < SIM_TPDO_MAX; n++)
+            {
+                if (node->next_tpdo[n] <= now)
+                {
+                    if (SIM_NMT_OPERATIONAL == node->nmt_state)
+                    {
+                        send_tpdo(node, n);
+                    }
+
+                    node->next_tpdo[n] += node->tpdo_period[n];
+                    if (node->next_tpdo[n] <= now)
+                    {
+                        node->next_tpdo[n] = now + node->tpdo_period[n];
+                    }
+                }
+
+                if (node->next_tpdo[n] < node->next_due)
+                {
+                    node->next_due = node->next_tpdo[n];
+                }
+            }
+        }
+
+        if (node->next_due < next_due)
+        {
+            next_due = node->next_due;
+        }
+    }
+}
+
+static void handle_frame(const can_message_t* message, uint64 now, void* user)
+{
+    (void)user;
+
+    os_lock_mutex(lock);
+
+    update(now);
+
+    if (SIM_NEVER != next_due)
+    {
+        os_schedule_wake_up(next_due);
+    }
+
+    if (NULL == message)
+    {
+        os_unlock_mutex(lock);
+        return;
+    }
+
+    info.frames_in += 1;
+
+    if (SIM_NMT_ID == message->id)
+    {
+        handle_nmt(message, now);
+    }
+    else if (SIM_SYNC_ID == message->id)
+    {
+        handle_sync();
+    }
+    else if ((message->id > (SIM_HEARTBEAT_BASE_ID | CAN_REMOTE_FRAME)) && (message->id <= ((SIM_HEARTBEAT_BASE_ID + 0x7f) | CAN_REMOTE_FRAME)))
+    {
+        sim_node_t* node = &nodes[message->id & 0x7f];
+
+        if (true == node->is_active)
+        {
+            handle_node_guarding(node);
+        }
+    }
+    else if ((message->id > SIM_SDO_REQUEST_BASE_ID) && (message->id <= (SIM_SDO_REQUEST_BASE_ID + 0x7f)))
+    {
+        sim_node_t* node = &nodes[message->id - SIM_SDO_REQUEST_BASE_ID];
+
+        if ((true == node->is_active) && (SIM_NMT_STOPPED != node->nmt_state))
+        {
+            handle_sdo(node, message, now);
+        }
+    }
+
+    os_unlock_mutex(lock);
+}
+
+static void push_frame(uint32 id, const uint8* data, uint8 length)
+{
+    can_message_t message = {0};
+
+    message.id = id;
+    message.length = (length > 8) ? 8 : length;
+    os_memcpy(message.data, data, message.length);
+
+    if (ALL_OK == vcan_write(endpoint, &message))
+    {
+        info.frames_out += 1;
+    }
+    else
+    {
+        info.frames_dropped += 1;
+    }
+}
+
+static void handle_nmt(const can_message_t* message, uint64 now)
+{
+    uint8 command = message->data[0];
+    uint8 node_id = message->data[1];
+    uint32 i;
+
+    for (i = 1; i <= 0x7f; i += 1)
+    {
+        sim_node_t* node = &nodes[i];
+
+        if ((false == node->is_active) || ((0 != node_id) && (node_id != i)))
+        {
+            continue;
+        }
+
+        switch (command)
+        {
+            case 0x01:
+                node->nmt_state = SIM_NMT_OPERATIONAL;
+                schedule_node(node, now);
+                break;
+            case 0x02:
+                reset_sdo(&node->sdo);
+                node->nmt_state = SIM_NMT_STOPPED;
+                break;
+            case 0x80:
+                node->nmt_state = SIM_NMT_PRE_OPERATIONAL;
+                break;
+            case 0x81:
+                reset_objects(node, 0x0000, 0xffff);
+                boot_node(node, now);
+                break;
+            case 0x82:
+                reset_objects(node, 0x1000, 0x1fff);
+                boot_node(node, now);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void handle_sync(void)
+{
+    uint32 i;
+
+    for (i = 1; i <= 0x7f; i += 1)
+    {
+        sim_node_t* node = &nodes[i];
+        uint8 n;
+
+        if ((false == node->is_active) || (SIM_NMT_OPERATIONAL != node->nmt_state))
+        {
+            continue;
+        }
+
+        for (n = 0; n < SIM_TPDO_MAX; n++)
+        {
+            uint32 type = get_object_value(node, 0x1800 + n, 0x02);
+
+            if ((NULL == find_object(node, 0x1800 + n, 0x01)) || (type < 1) || (type > 240))
+            {
+                continue;
+            }
+
+            node->sync_count[n] += 1;
+            if (node->sync_count[n] >= type)
+            {
+                node->sync_count[n] = 0;
+                send_tpdo(node, n);
+            }
+        }
+    }
+}
+
+static void handle_node_guarding(sim_node_t* node)
+{
+    uint8 response = (uint8)node->nmt_state | node->guard_toggle;
+
+    push_frame(SIM_HEARTBEAT_BASE_ID + node->node_id, &response, 1);
+    node->guard_toggle ^= 0x80;
+}
+
+static void handle_sdo(sim_node_t* node, const can_message_t* message, uint64 now)
+{
+    const uint8* request = message->data;
+    uint16 index = (uint16)request[1] | ((uint16)request[2] << 8);
+    uint8 sub_index = request[3];
+    sim_sdo_t* sdo = &node->sdo;
+    sim_object_t* object = NULL;
+    uint8 response[8] = {0};
+    uint32 abort_code;
+
+    /* Block download segments carry no command specifier, sequence
+     * number 0 is never used and marks an abort. */
+    if ((SIM_SDO_DOWNLOAD_BLOCK == sdo->state) && (0x80 != request[0]))
+    {
+        handle_block_segment(node, message);
+        return;
+    }
+
+    if (0x80 == request[0])
+    {
+        reset_sdo(sdo);
+        return;
+    }
+
+    switch (request[0] >> 5)
+    {
+        case 1: /* Download initiate. */
+        {
+            reset_sdo(sdo);
+            if (false == check_object(node, index, sub_index, true, &object))
+            {
+                return;
+            }
+
+            if (0 != (request[0] & 0x02))
+            {
+                uint32 length = (0 != (request[0] & 0x01)) ? (4u - ((request[0] >> 2) & 0x03)) : 4u;
+
+                abort_code = write_object(node, object, &request[4], length, now);
+                if (0 != abort_code)
+                {
+                    send_sdo_abort(node, index, sub_index, abort_code);
+                    return;
+                }
+            }
+            else
+            {
+                uint32 size = 0;
+
+                if (0 != (request[0] & 0x01))
+                {
+                    size = (uint32)request[4] | ((uint32)request[5] << 8) | ((uint32)request[6] << 16) | ((uint32)request[7] << 24);
+                }
+
+                if ((size > SIM_MAX_OBJECT_SIZE) || (false == reserve_buffer(sdo, size)))
+                {
+                    send_sdo_abort(node, index, sub_index, ABORT_OUT_OF_MEMORY);
+                    return;
+                }
+
+                sdo->state = SIM_SDO_DOWNLOAD_SEGMENTED;
+                sdo->object = object;
+                sdo->size = size;
+            }
+
+            response[0] = 0x60;
+            os_memcpy(&response[1], &request[1], 3);
+            send_sdo(node, response);
+            break;
+        }
+        case 0: /* Download segment. */
+        {
+            uint8 toggle = (request[0] >> 4) & 0x01;
+            uint32 count = SIM_SEGMENT_DATA_SIZE - ((request[0] >> 1) & 0x07);
+
+            if (SIM_SDO_DOWNLOAD_SEGMENTED != sdo->state)
+            {
+                send_sdo_abort(node, index, sub_index, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+                return;
+            }
+
+            object = sdo->object;
+            if (toggle != sdo->toggle)
+            {
+                send_sdo_abort(node, object->index, object->sub_index, ABORT_TOGGLE_BIT_NOT_ALTERED);
+                reset_sdo(sdo);
+                return;
+            }
+
+            if (((sdo->offset + count) > SIM_MAX_OBJECT_SIZE) || (false == reserve_buffer(sdo, sdo->offset + count)))
+            {
+                send_sdo_abort(node, object->index, object->sub_index, ABORT_OUT_OF_MEMORY);
+                reset_sdo(sdo);
+                return;
+            }
+
+            os_memcpy(&sdo->buffer[sdo->offset], &request[1], count);
+            sdo->offset += count;
+            sdo->toggle ^= 0x01;
+
+            if (0 != (request[0] & 0x01))
+            {
+                uint32 length = ((sdo->size > 0) && (sdo->size < sdo->offset)) ? sdo->size : sdo->offset;
+
+                abort_code = write_object(node, object, sdo->buffer, length, now);
+                if (0 != abort_code)
+                {
+                    send_sdo_abort(node, object->index, object->sub_index, abort_code);
+                    reset_sdo(sdo);
+                    return;
+                }
+
+                reset_sdo(sdo);
+            }
+
+            response[0] = 0x20 | (uint8)(toggle << 4);
+            send_sdo(node, response);
+            break;
+        }
+        case 2: /* Upload initiate. */
+        {
+            reset_sdo(sdo);
+            if (false == check_object(node, index, sub_index, false, &object))
+            {
+                return;
+            }
+
+            os_memcpy(&response[1], &request[1], 3);
+
+            if ((object->length > 0) && (object->length <= sizeof(uint32)))
+            {
+                response[0] = 0x43 | (uint8)((sizeof(uint32) - object->length) << 2);
+                os_memcpy(&response[4], get_object_data(object), object->length);
+            }
+            else
+            {
+                response[0] = 0x41;
+                response[4] = (uint8)(object->length & 0xff);
+                response[5] = (uint8)((object->length >> 8) & 0xff);
+                response[6] = (uint8)((object->length >> 16) & 0xff);
+                response[7] = (uint8)((object->length >> 24) & 0xff);
+
+                sdo->state = SIM_SDO_UPLOAD_SEGMENTED;
+                sdo->object = object;
+            }
+
+            send_sdo(node, response);
+            break;
+        }
+        case 3: /* Upload segment. */
+        {
+            uint8 toggle = (request[0] >> 4) & 0x01;
+            uint32 count;
+
+            if (SIM_SDO_UPLOAD_SEGMENTED != sdo->state)
+            {
+                send_sdo_abort(node, index, sub_index, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+                return;
+            }
+
+            object = sdo->object;
+            if (toggle != sdo->toggle)
+            {
+                send_sdo_abort(node, object->index, object->sub_index, ABORT_TOGGLE_BIT_NOT_ALTERED);
+                reset_sdo(sdo);
+                return;
+            }
+
+            count = object->length - sdo->offset;
+            if (count > SIM_SEGMENT_DATA_SIZE)
+            {
+                count = SIM_SEGMENT_DATA_SIZE;
+            }
+
+            response[0] = (uint8)(toggle << 4) | (uint8)((SIM_SEGMENT_DATA_SIZE - count) << 1);
+            os_memcpy(&response[1], get_object_data(object) + sdo->offset, count);
+
+            sdo->offset += count;
+            sdo->toggle ^= 0x01;
+
+            if (sdo->offset >= object->length)
+            {
+                response[0] |= 0x01;
+                reset_sdo(sdo);
+            }
+
+            send_sdo(node, response);
+            break;
+        }
+        case 5: /* Block upload. */
+        {
+            switch (request[0] & 0x03)
+            {
+                case 0x00: /* Initiate. */
+                    reset_sdo(sdo);
+                    if (false == check_object(node, index, sub_index, false, &object))
+                    {
+                        return;
+                    }
+
+                    if ((0 == request[4]) || (request[4] > SIM_BLOCK_SIZE))
+                    {
+                        send_sdo_abort(node, index, sub_index, ABORT_INVALID_BLOCK_SIZE);
+                        return;
+                    }
+
+                    sdo->state = SIM_SDO_UPLOAD_BLOCK;
+                    sdo->object = object;
+                    sdo->block_size = request[4];
+
+                    response[0] = 0xc2;
+                    os_memcpy(&response[1], &request[1], 3);
+                    response[4] = (uint8)(object->length & 0xff);
+                    response[5] = (uint8)((object->length >> 8) & 0xff);
+                    response[6] = (uint8)((object->length >> 16) & 0xff);
+                    response[7] = (uint8)((object->length >> 24) & 0xff);
+                    send_sdo(node, response);
+                    break;
+                case 0x03: /* Start. */
+                    if (SIM_SDO_UPLOAD_BLOCK != sdo->state)
+                    {
+                        send_sdo_abort(node, index, sub_index, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+                        return;
+                    }
+                    send_upload_block(node);
+                    break;
+                case 0x02: /* Acknowledge. */
+                {
+                    uint32 length;
+
+                    if (SIM_SDO_UPLOAD_BLOCK != sdo->state)
+                    {
+                        send_sdo_abort(node, index, sub_index, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+                        return;
+                    }
+
+                    object = sdo->object;
+                    length = object->length;
+
+                    /* Repeat everything after the acknowledged segment. */
+                    sdo->offset = sdo->block_offset + ((uint32)request[1] * SIM_SEGMENT_DATA_SIZE);
+                    if ((0 != request[2]) && (request[2] <= SIM_BLOCK_SIZE))
+                    {
+                        sdo->block_size = request[2];
+                    }
+
+                    if (sdo->offset >= length)
+                    {
+                        uint8 unused = (uint8)((SIM_SEGMENT_DATA_SIZE - (length % SIM_SEGMENT_DATA_SIZE)) % SIM_SEGMENT_DATA_SIZE);
+
+                        if (0 == length)
+                        {
+                            unused = SIM_SEGMENT_DATA_SIZE;
+                        }
+
+                        sdo->state = SIM_SDO_UPLOAD_BLOCK_END;
+                        response[0] = 0xc1 | (uint8)(unused << 2);
+                        send_sdo(node, response);
+                    }
+                    else
+                    {
+                        send_upload_block(node);
+                    }
+                    break;
+                }
+                case 0x01: /* End. */
+                default:
+                    reset_sdo(sdo);
+                    break;
+            }
+            break;
+        }
+        case 6: /* Block download. */
+        {
+            if ((SIM_SDO_DOWNLOAD_BLOCK_END == sdo->state) && (0x01 == (request[0] & 0x01)))
+            {
+                uint32 unused = (request[0] >> 2) & 0x07;
+                uint32 length = (sdo->offset > unused) ? sdo->offset - unused : 0;
+
+                object = sdo->object;
+                abort_code = write_object(node, object, sdo->buffer, length, now);
+                reset_sdo(sdo);
+
+                if (0 != abort_code)
+                {
+                    send_sdo_abort(node, object->index, object->sub_index, abort_code);
+                    return;
+                }
+
+                response[0] = 0xa1;
+                send_sdo(node, response);
+            }
+            else if (0x00 == (request[0] & 0x01))
+            {
+                uint32 size = 0;
+
+                reset_sdo(sdo);
+                if (false == check_object(node, index, sub_index, true, &object))
+                {
+                    return;
+                }
+
+                if (0 != (request[0] & 0x02))
+                {
+                    size = (uint32)request[4] | ((uint32)request[5] << 8) | ((uint32)request[6] << 16) | ((uint32)request[7] << 24);
+                }
+
+                if ((size > SIM_MAX_OBJECT_SIZE) || (false == reserve_buffer(sdo, size)))
+                {
+                    send_sdo_abort(node, index, sub_index, ABORT_OUT_OF_MEMORY);
+                    return;
+                }
+
+                sdo->state = SIM_SDO_DOWNLOAD_BLOCK;
+                sdo->object = object;
+                sdo->size = size;
+                sdo->block_size = SIM_BLOCK_SIZE;
+
+                response[0] = 0xa0; /* No CRC. */
+                os_memcpy(&response[1], &request[1], 3);
+                response[4] = sdo->block_size;
+                send_sdo(node, response);
+            }
+            else
+            {
+                send_sdo_abort(node, index, sub_index, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+                reset_sdo(sdo);
+            }
+            break;
+        }
+        default:
+            send_sdo_abort(node, index, sub_index, ABORT_CMD_SPECIFIER_INVALID_UNKNOWN);
+            reset_sdo(sdo);
+            break;
+    }
+}
+
+static void handle_block_segment(sim_node_t* node, const can_message_t* message)
+{
+    sim_sdo_t* sdo = &node->sdo;
+    uint8 sequence = message->data[0] & 0x7f;
+    bool is_last = (0 != (message->data[0] & 0x80));
+
+    if (sequence == (sdo->sequence + 1u))
+    {
+        if (((sdo->offset + SIM_SEGMENT_DATA_SIZE) > SIM_MAX_OBJECT_SIZE) || (false == reserve_buffer(sdo, sdo->offset + SIM_SEGMENT_DATA_SIZE)))
+        {
+            send_sdo_abort(node, sdo->object->index, sdo->object->sub_index, ABORT_OUT_OF_MEMORY);
+            reset_sdo(sdo);
+            return;
+        }
+
+        os_memcpy(&sdo->buffer[sdo->offset], &message->data[1], SIM_SEGMENT_DATA_SIZE);
+        sdo->offset += SIM_SEGMENT_DATA_SIZE;
+        sdo->sequence += 1;
+    }
+    else
+    {
+        /* Lost segment: everything up to the end of the block is ignored. */
+        is_last = false;
+    }
+
+    if ((true == is_last) || (sequence >= sdo->block_size))
+    {
+        uint8 response[8] = {0};
+
+        response[0] = 0xa2;
+        response[1] = sdo->sequence;
+        response[2] = sdo->block_size;
+        send_sdo(node, response);
+
+        sdo->sequence = 0;
+        if (true == is_last)
+        {
+            sdo->state = SIM_SDO_DOWNLOAD_BLOCK_END;
+        }
+    }
+}
+
+static bool check_object(sim_node_t* node, uint16 index, uint8 sub_index, bool is_write, sim_object_t** object)
+{
+    *object = find_object(node, index, sub_index);
+
+    if (NULL == *object)
+    {
+        bool has_index = (NULL != find_object(node, index, 0x00));
+
+        send_sdo_abort(node, index, sub_index, has_index ? ABORT_SUB_INDEX_DOES_NOT_EXIST : ABORT_OBJECT_DOES_NOT_EXIST);
+        return false;
+    }
+
+    if ((true == is_write) && ((RO == (*object)->access_type) || (CONST_T == (*object)->access_type)))
+    {
+        send_sdo_abort(node, index, sub_index, ABORT_ATTEMPT_TO_WRITE_READ_ONLY);
+        return false;
+    }
+
+    if ((false == is_write) && (WO == (*object)->access_type))
+    {
+        send_sdo_abort(node, index, sub_index, ABORT_ATTEMPT_TO_READ_WRITE_ONLY);
+        return false;
+    }
+
+    return true;
+}
+
+static void send_sdo(sim_node_t* node, const uint8 data[8])
+{
+    push_frame(SIM_SDO_RESPONSE_BASE_ID + node->node_id, data, 8);
+}
+
+static void send_sdo_abort(sim_node_t* node, uint16 index, uint8 sub_index, uint32 abort_code)
+{
+    uint8 response[8] = {0};
+
+    response[0] = 0x80;
+    response[1] = (uint8)(index & 0x00ff);
+    response[2] = (uint8)((index & 0xff00) >> 8);
+    response[3] = sub_index;
+    response[4] = (uint8)(abort_code & 0x000000ff);
+    response[5] = (uint8)((abort_code & 0x0000ff00) >> 8);
+    response[6] = (uint8)((abort_code & 0x00ff0000) >> 16);
+    response[7] = (uint8)((abort_code & 0xff000000) >> 24);
+
+    send_sdo(node, response);
+}
+
+static void send_upload_block(sim_node_t* node)
+{
+    sim_sdo_t* sdo = &node->sdo;
+    sim_object_t* object = sdo->object;
+    uint8 sequence;
+
+    sdo->block_offset = sdo->offset;
+
+    for (sequence = 1; sequence <= sdo->block_size; sequence++)
+    {
+        uint8 segment[8] = {0};
+        uint32 count = object->length - sdo->offset;
+
+        if (count > SIM_SEGMENT_DATA_SIZE)
+        {
+            count = SIM_SEGMENT_DATA_SIZE;
+        }
+
+        segment[0] = sequence;
+        os_memcpy(&segment[1], get_object_data(object) + sdo->offset, count);
+        sdo->offset += count;
+
+        if (sdo->offset >= object->length)
+        {
+            segment[0] |= 0x80;
+            push_frame(SIM_SDO_RESPONSE_BASE_ID + node->node_id, segment, 8);
+            break;
+        }
+
+        push_frame(SIM_SDO_RESPONSE_BASE_ID + node->node_id, segment, 8);
+    }
+}
+
+static void reset_sdo(sim_sdo_t* sdo)
+{
+    uint8* buffer = sdo->buffer;
+
+    /* Keep the buffer for the next transfer. */
+    os_memset(sdo, 0, sizeof(sim_sdo_t));
+    sdo->buffer = buffer;
+}
+
+static bool reserve_buffer(sim_sdo_t* sdo, uint32 size)
+{
+    uint8* buffer;
+
+    buffer = (uint8*)os_realloc(sdo->buffer, (size_t)size + SIM_SEGMENT_DATA_SIZE);
+    if (NULL == buffer)
+    {
+        return false;
+    }
+
+    sdo->buffer = buffer;
+    return true;
+}
+
+static uint32 write_object(sim_node_t* node, sim_object_t* object, const uint8* data, uint32 length, uint64 now)
+{
+    if (object->size > 0)
+    {
+        uint32 i;
+
+        for (i = object->size; i < length; i += 1)
+        {
+            if (0 != data[i])
+            {
+                return ABORT_DATA_TYPE_LENGTH_TOO_HIGH;
+            }
+        }
+
+        os_memset(object->value, 0, sizeof(object->value));
+        os_memcpy(object->value, data, (length < object->size) ? length : object->size);
+        object->length = object->size;
+    }
+    else
+    {
+        uint8* buffer;
+
+        if (length > SIM_MAX_OBJECT_SIZE)
+        {
+            return ABORT_OUT_OF_MEMORY;
+        }
+
+        buffer = (uint8*)os_realloc(object->data, (size_t)length + 1u);
+        if (NULL == buffer)
+        {
+            return ABORT_OUT_OF_MEMORY;
+        }
+
+        os_memcpy(buffer, data, length);
+        buffer[length] = '\0';
+        object->data = buffer;
+        object->length = length;
+    }
+
+    /* Heartbeat and TPDO parameters take effect immediately. */
+    if ((0x1017 == object->index) || ((object->index >= 0x1800) && (object->index < (0x1800 + SIM_TPDO_MAX))))
+    {
+        schedule_node(node, now);
+    }
+
+    return 0;
+}
+
+static void send_tpdo(sim_node_t* node, uint8 tpdo)
+{
+    uint8 data[8] = {0};
+    uint32 cob_id = get_object_value(node, 0x1800 + tpdo, 0x01);
+    uint32 count = get_object_value(node, 0x1a00 + tpdo, 0x00);
+    uint32 bit_offset = 0;
+    uint32 i;
+
+    if (count > 8)
+    {
+        count = 8;
+    }
+
+    for (i = 1; i <= count; i += 1)
+    {
+        uint32 mapping = get_object_value(node, 0x1a00 + tpdo, (uint8)i);
+        sim_object_t* object = find_object(node, (uint16)(mapping >> 16), (uint8)((mapping >> 8) & 0xff));
+        uint32 bits = mapping & 0xff;
+        uint32 bit;
+
+        if ((bit_offset + bits) > 64)
+        {
+            break;
+        }
+
+        for (bit = 0; (NULL != object) && (bit < bits) && (bit < (object->length * 8u)); bit += 1)
+        {
+            uint8* source = get_object_data(object);
+
+            if (0 != (source[bit / 8u] & (1u << (bit % 8u))))
+            {
+                data[(bit_offset + bit) / 8u] |= (uint8)(1u << ((bit_offset + bit) % 8u));
+            }
+        }
+
+        bit_offset += bits;
+    }
+
+    push_frame(cob_id & 0x7ff, data, (uint8)((bit_offset + 7u) / 8u));
+}
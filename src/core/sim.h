@@ -0,0 +1,111 @@
+/** @file sim.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef SIM_H
+#define SIM_H
+
+#include "can.h"
+#include "codb.h"
+#include "core.h"
+#include "os.h"
+
+#define SIM_TPDO_MAX 4u
+#define SIM_MAX_OBJECT_SIZE 0x10000u
+
+typedef enum
+{
+    SIM_NMT_BOOT_UP = 0x00,
+    SIM_NMT_STOPPED = 0x04,
+    SIM_NMT_OPERATIONAL = 0x05,
+    SIM_NMT_PRE_OPERATIONAL = 0x7f
+
+} sim_nmt_state_t;
+
+typedef enum
+{
+    SIM_SDO_IDLE = 0,
+    SIM_SDO_UPLOAD_SEGMENTED,
+    SIM_SDO_DOWNLOAD_SEGMENTED,
+    SIM_SDO_UPLOAD_BLOCK,
+    SIM_SDO_UPLOAD_BLOCK_END,
+    SIM_SDO_DOWNLOAD_BLOCK,
+    SIM_SDO_DOWNLOAD_BLOCK_END
+
+} sim_sdo_state_t;
+
+typedef struct sim_object
+{
+    uint16 index;
+    uint8 sub_index;
+    acc_type_t access_type;
+    bool pdo_mapping;
+    bool is_node_id_relative;
+    uint8 size;   /* Fixed size in bytes, 0 for strings and domains. */
+    uint32 length;
+    uint8 value[8];
+    uint8* data;  /* Strings and domains. */
+
+} sim_object_t;
+
+typedef struct sim_template
+{
+    uint32 object_count;
+    sim_object_t* objects;
+    struct sim_template* next;
+
+} sim_template_t;
+
+typedef struct sim_sdo
+{
+    sim_sdo_state_t state;
+    sim_object_t* object;
+    uint8 toggle;
+    uint8 block_size;
+    uint8 sequence;
+    uint32 offset;
+    uint32 block_offset;
+    uint32 size;
+    uint8* buffer;
+
+} sim_sdo_t;
+
+typedef struct sim_node
+{
+    bool is_active;
+    uint8 node_id;
+    sim_nmt_state_t nmt_state;
+    const sim_template_t* template;
+    uint32 object_count;
+    sim_object_t* objects;
+    sim_sdo_t sdo;
+    uint64 heartbeat_period;
+    uint64 next_heartbeat;
+    uint8 guard_toggle;  /* Toggle bit of the next node guarding response. */
+    uint64 tpdo_period[SIM_TPDO_MAX];
+    uint64 next_tpdo[SIM_TPDO_MAX];
+    uint8 sync_count[SIM_TPDO_MAX];
+    uint64 next_due;
+
+} sim_node_t;
+
+typedef struct sim_info
+{
+    uint32 node_count;
+    uint32 frames_in;
+    uint32 frames_out;
+    uint32 frames_dropped;
+
+} sim_info_t;
+
+status_t sim_add_nodes(uint8 first_node_id, uint8 count, const char* file_name);
+void sim_stop(void);
+bool sim_is_running(void);
+void sim_get_info(sim_info_t* info);
+
+#endif /* SIM_H */
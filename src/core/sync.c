@@ -0,0 +1,405 @@
+/** @file sync.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "sync.h"
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+static os_mutex* lock;
+static bool is_running;
+static uint16 sync_cob_id;
+static uint8 sync_overflow;
+static uint8 sync_counter;
+static uint64 period_ns;
+static uint64 deadline_ns;
+static uint32 sequence;  /* SYNCs sent since the start. */
+static uint32 generation;
+static os_timer_id sync_timer;
+static sync_rpdo_t rpdos[SYNC_RPDO_MAX];
+static sync_stats_t producer_stats;
+static sync_stats_t node_stats[0x80];
+static uint32 node_sequence[0x80];
+static uint64 node_timestamp_us[0x80];
+
+static bool init(void);
+static int sync_thread(void* thread_generation);
+static uint64 sync_timer_callback(void* param, os_timer_id id, uint64 interval);
+static void produce(uint64 now);
+static void add_jitter(sync_stats_t* stats, uint64 jitter);
+static void stop(void);
+
+status_t sync_start(uint32 period_us, uint8 counter_overflow, uint16 cob_id)
+{
+    uint64 now;
+
+    if ((period_us < SYNC_PERIOD_MIN_US) || (1 == counter_overflow) || (counter_overflow > SYNC_COUNTER_MAX) || (cob_id > 0x7ff))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (false == init())
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    os_lock_mutex(lock);
+
+    stop();
+
+    now = os_get_ticks();
+
+    sync_cob_id = (0 == cob_id) ? SYNC_DEFAULT_COB_ID : cob_id;
+    sync_overflow = counter_overflow;
+    sync_counter = 1;
+    period_ns = (uint64)period_us * 1000u;
+    deadline_ns = now + period_ns;
+    sequence = 0;
+
+    os_memset(&producer_stats, 0, sizeof(producer_stats));
+    os_memset(node_stats, 0, sizeof(node_stats));
+    os_memset(node_sequence, 0, sizeof(node_sequence));
+
+    generation += 1;
+    is_running = true;
+
+    /* A sleeping thread never wakes on a virtual clock, so use a timer. */
+    if (true == os_is_virtual_time())
+    {
+        sync_timer = os_add_timer(period_ns, sync_timer_callback, NULL);
+    }
+    else
+    {
+        os_thread* thread = os_create_thread(sync_thread, "SYNC thread", (void*)(size_t)generation);
+
+        if (NULL == thread)
+        {
+            is_running = false;
+            os_unlock_mutex(lock);
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+        os_detach_thread(thread);
+    }
+
+    os_unlock_mutex(lock);
+    return ALL_OK;
+}
+
+void sync_stop(void)
+{
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+    stop();
+    os_unlock_mutex(lock);
+}
+
+bool sync_is_running(void)
+{
+    return is_running;
+}
+
+status_t sync_add_rpdo(uint16 can_id, uint8 length, uint64 data)
+{
+    sync_rpdo_t* rpdo = NULL;
+    int offset = 0;
+    int i;
+
+    if ((0 == can_id) || (can_id > 0x7ff))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (false == init())
+    {
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    if (length > 8)
+    {
+        length = 8;
+    }
+
+    os_lock_mutex(lock);
+
+    for (i = 0; i < SYNC_RPDO_MAX; i += 1)
+    {
+        if ((true == rpdos[i].is_active) && (can_id == rpdos[i].message.id))
+        {
+            rpdo = &rpdos[i];
+            break;
+        }
+        if ((NULL == rpdo) && (false == rpdos[i].is_active))
+        {
+            rpdo = &rpdos[i];
+        }
+    }
+
+    if (NULL == rpdo)
+    {
+        os_unlock_mutex(lock);
+        return OS_MEMORY_ALLOCATION_ERROR;
+    }
+
+    os_memset(&rpdo->message, 0, sizeof(can_message_t));
+    rpdo->message.id = can_id;
+    rpdo->message.length = length;
+
+    for (i = (length - 1); i >= 0; i -= 1)
+    {
+        rpdo->message.data[i] = ((data >> offset) & 0xFF);
+        offset += 8;
+    }
+
+    rpdo->is_active = true;
+
+    os_unlock_mutex(lock);
+    return ALL_OK;
+}
+
+status_t sync_del_rpdo(uint16 can_id)
+{
+    status_t status = ITEM_NOT_FOUND;
+    int i;
+
+    if (NULL == lock)
+    {
+        return status;
+    }
+
+    os_lock_mutex(lock);
+
+    for (i = 0; i < SYNC_RPDO_MAX; i += 1)
+    {
+        if ((true == rpdos[i].is_active) && (can_id == rpdos[i].message.id))
+        {
+            rpdos[i].is_active = false;
+            status = ALL_OK;
+        }
+    }
+
+    os_unlock_mutex(lock);
+    return status;
+}
+
+void sync_on_receive(const can_message_t* message)
+{
+    uint32 function_code;
+    uint8 node_id;
+
+    if ((false == is_running) || (NULL == message))
+    {
+        return;
+    }
+
+    function_code = message->id & 0x780;
+    node_id = (uint8)(message->id & 0x7f);
+
+    if ((message->id > 0x7ff) || (0 == node_id))
+    {
+        return;
+    }
+
+    /* TPDO1 - TPDO4 of a node; RPDOs share the range in between. */
+    switch (function_code)
+    {
+        case 0x180:
+        case 0x280:
+        case 0x380:
+        case 0x480:
+            break;
+        default:
+            return;
+    }
+
+    os_lock_mutex(lock);
+
+    /* Only the first TPDO of each node after a SYNC counts. */
+    if ((0 != sequence) && (sequence != node_sequence[node_id]))
+    {
+        if (0 != node_sequence[node_id])
+        {
+            uint32 cycles = sequence - node_sequence[node_id];
+            uint64 interval = (message->timestamp_us - node_timestamp_us[node_id]) * 1000u;
+            uint64 expected = cycles * period_ns;
+
+            add_jitter(&node_stats[node_id], (interval > expected) ? (interval - expected) : (expected - interval));
+            node_stats[node_id].missed += cycles - 1u;
+        }
+
+        node_sequence[node_id] = sequence;
+        node_timestamp_us[node_id] = message->timestamp_us;
+    }
+
+    os_unlock_mutex(lock);
+}
+
+status_t sync_get_stats(uint8 node_id, sync_stats_t* stats)
+{
+    if ((NULL == stats) || (node_id > 0x7f))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (NULL == lock)
+    {
+        os_memset(stats, 0, sizeof(sync_stats_t));
+        return ALL_OK;
+    }
+
+    os_lock_mutex(lock);
+
+    if (0 == node_id)
+    {
+        os_memcpy(stats, &producer_stats, sizeof(sync_stats_t));
+    }
+    else
+    {
+        os_memcpy(stats, &node_stats[node_id], sizeof(sync_stats_t));
+    }
+
+    os_unlock_mutex(lock);
+    return ALL_OK;
+}
+
+void sync_reset_stats(void)
+{
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+    os_memset(&producer_stats, 0, sizeof(producer_stats));
+    os_memset(node_stats, 0, sizeof(node_stats));
+    os_memset(node_sequence, 0, sizeof(node_sequence));
+    os_unlock_mutex(lock);
+}
+
+static bool init(void)
+{
+    if (NULL == lock)
+    {
+        lock = os_create_mutex();
+    }
+
+    return (NULL != lock);
+}
+
+static int sync_thread(void* thread_generation)
+{
+    while (true)
+    {
+        uint64 deadline;
+
+        os_lock_mutex(lock);
+        if ((uint32)(size_t)thread_generation != generation)
+        {
+            os_unlock_mutex(lock);
+            break;
+        }
+        deadline = deadline_ns;
+        os_unlock_mutex(lock);
+
+        os_delay_until(deadline);
+
+        os_lock_mutex(lock);
+        if ((uint32)(size_t)thread_generation != generation)
+        {
+            os_unlock_mutex(lock);
+            break;
+        }
+        produce(os_get_ticks());
+        os_unlock_mutex(lock);
+    }
+
+    return 0;
+}
+
+static uint64 sync_timer_callback(void* param, os_timer_id id, uint64 interval)
+{
+    (void)param;
+    (void)id;
+
+    os_lock_mutex(lock);
+    produce(os_get_ticks());
+    os_unlock_mutex(lock);
+
+    return interval;
+}
+
+static void produce(uint64 now)
+{
+    can_message_t message = {0};
+    int i;
+
+    message.id = sync_cob_id;
+
+    if (0 != sync_overflow)
+    {
+        message.length = 1;
+        message.data[0] = sync_counter;
+
+        sync_counter = (sync_counter >= sync_overflow) ? 1 : (sync_counter + 1);
+    }
+
+    can_write(&message, SILENT, NULL);
+    sequence += 1;
+
+    /* Synchronous RPDOs go out right behind the SYNC. */
+    for (i = 0; i < SYNC_RPDO_MAX; i += 1)
+    {
+        if (true == rpdos[i].is_active)
+        {
+            can_write(&rpdos[i].message, SILENT, NULL);
+        }
+    }
+
+    add_jitter(&producer_stats, (now > deadline_ns) ? (now - deadline_ns) : 0);
+
+    /* Stay on the original period grid; a late SYNC counts as missed. */
+    deadline_ns += period_ns;
+    if (deadline_ns <= now)
+    {
+        uint64 missed = ((now - deadline_ns) / period_ns) + 1u;
+
+        producer_stats.missed += (uint32)missed;
+        deadline_ns += missed * period_ns;
+    }
+}
+
+static void add_jitter(sync_stats_t* stats, uint64 jitter)
+{
+    if ((0 == stats->count) || (jitter < stats->jitter_min_ns))
+    {
+        stats->jitter_min_ns = jitter;
+    }
+    if (jitter > stats->jitter_max_ns)
+    {
+        stats->jitter_max_ns = jitter;
+    }
+    stats->jitter_sum_ns += jitter;
+    stats->count += 1;
+}
+
+static void stop(void)
+{
+    /* The thread ends before its next SYNC. */
+    generation += 1;
+    is_running = false;
+
+    if (0 != sync_timer)
+    {
+        os_remove_timer(sync_timer);
+        sync_timer = 0;
+    }
+}
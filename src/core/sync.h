@@ -0,0 +1,48 @@
+/** @file sync.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef SYNC_H
+#define SYNC_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+#define SYNC_DEFAULT_COB_ID 0x080
+#define SYNC_COUNTER_MAX 240
+#define SYNC_PERIOD_MIN_US 100
+#define SYNC_RPDO_MAX 64
+
+typedef struct sync_stats
+{
+    uint32 count;
+    uint32 missed;  /* SYNC: deadlines skipped, nodes: cycles without response. */
+    uint64 jitter_min_ns;
+    uint64 jitter_max_ns;
+    uint64 jitter_sum_ns;
+
+} sync_stats_t;
+
+typedef struct sync_rpdo
+{
+    bool is_active;
+    can_message_t message;
+
+} sync_rpdo_t;
+
+status_t sync_start(uint32 period_us, uint8 counter_overflow, uint16 cob_id);
+void sync_stop(void);
+bool sync_is_running(void);
+status_t sync_add_rpdo(uint16 can_id, uint8 length, uint64 data);
+status_t sync_del_rpdo(uint16 can_id);
+void sync_on_receive(const can_message_t* message);
+status_t sync_get_stats(uint8 node_id, sync_stats_t* stats);
+void sync_reset_stats(void);
+
+#endif /* SYNC_H */
@@ -80,6 +80,10 @@ void test_add_result(test_result_t* result)
             {
                 results[num_results - 1]->call_stack = os_strdup(result->call_stack);
             }
+            if (result->system_out)
+            {
+                results[num_results - 1]->system_out = os_strdup(result->system_out);
+            }
         }
     }
 }
@@ -113,6 +117,10 @@ void test_clear_results(void)
         {
             os_free((void*)results[i]->call_stack);
         }
+        if (results[i]->system_out)
+        {
+            os_free((void*)results[i]->system_out);
+        }
         os_free(results[i]);
     }
     os_free(results);
@@ -233,6 +241,11 @@ status_t test_generate_report(const char* file_name)
                     os_fprintf(file, "                %s\n", results[i]->call_stack);
                     os_fprintf(file, "            </failure>\n");
                 }
+
+                if (NULL != results[i]->system_out)
+                {
+                    os_fprintf(file, "            <system-out>%s</system-out>\n", results[i]->system_out);
+                }
                 os_fprintf(file, "        </testcase>\n");
             }
             os_fprintf(file, "    </testsuite>\n");
@@ -24,6 +24,7 @@ typedef struct
     const char* error_type;
     const char* error_message;
     const char* call_stack;
+    const char* system_out;
 
 } test_result_t;
 
@@ -0,0 +1,546 @@
+/** @file vcan.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "vcan.h"
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+typedef struct vcan_frame
+{
+    uint32 id;
+    uint8 length;
+    uint8 data[VCAN_DATA_SIZE];
+    int sender;
+    uint64 deliver_ns;
+
+} vcan_frame_t;
+
+typedef struct vcan_endpoint
+{
+    bool is_attached;
+    vcan_handler_t handler;
+    void* user;
+    vcan_frame_t* queue;
+    uint32 head;
+    uint32 tail;
+
+} vcan_endpoint_t;
+
+static bool is_open;
+static bool is_polling;
+static uint64 poll_now;
+static vcan_config_t bus_config;
+static vcan_info_t info;
+static vcan_endpoint_t endpoints[VCAN_MAX_ENDPOINTS];
+static vcan_frame_t* pending;
+static uint32 pending_head;
+static uint32 pending_tail;
+static uint64 bus_free_ns;
+static uint64 last_deliver_ns;
+static uint32 random_state;
+static os_mutex* lock;
+
+static void poll(uint64 now);
+static void deliver(const vcan_frame_t* frame, uint64 now);
+static void to_message(const vcan_frame_t* frame, can_message_t* message);
+static uint32 get_frame_bits(uint32 id, uint32 length);
+static uint32 get_random(void);
+static status_t parse_option(vcan_config_t* config, const char* key, const char* value);
+
+status_t vcan_init(const vcan_config_t* config)
+{
+    vcan_config_t default_config = {0};
+
+    if (NULL == config)
+    {
+        config = &default_config;
+    }
+
+    if ((config->load >= 100) || (config->drop_rate < 0.f) || (config->drop_rate > 100.f))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (NULL == lock)
+    {
+        lock = os_create_mutex();
+        if (NULL == lock)
+        {
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+
+    os_lock_mutex(lock);
+
+    /* Re-initialising only changes the bus parameters. */
+    if (false == is_open)
+    {
+        pending = (vcan_frame_t*)os_calloc(VCAN_QUEUE_SIZE, sizeof(vcan_frame_t));
+        if (NULL == pending)
+        {
+            os_unlock_mutex(lock);
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+
+        endpoints[VCAN_HOST].queue = (vcan_frame_t*)os_calloc(VCAN_QUEUE_SIZE, sizeof(vcan_frame_t));
+        if (NULL == endpoints[VCAN_HOST].queue)
+        {
+            os_free(pending);
+            pending = NULL;
+            os_unlock_mutex(lock);
+            return OS_MEMORY_ALLOCATION_ERROR;
+        }
+
+        endpoints[VCAN_HOST].is_attached = true;
+        pending_head = 0;
+        pending_tail = 0;
+        bus_free_ns = 0;
+        last_deliver_ns = 0;
+        os_memset(&info, 0, sizeof(info));
+        info.endpoints = 1;
+        is_open = true;
+    }
+
+    os_memcpy(&bus_config, config, sizeof(vcan_config_t));
+    random_state = (0 != config->seed) ? config->seed : 1u;
+
+    os_unlock_mutex(lock);
+    return ALL_OK;
+}
+
+status_t vcan_init_from_string(const char* options)
+{
+    vcan_config_t config = {0};
+    char buffer[256] = {0};
+    char* save_ptr = NULL;
+    char* token;
+
+    if (NULL != options)
+    {
+        os_strlcpy(buffer, options, sizeof(buffer));
+    }
+
+    token = os_strtokr_r(buffer, ",;", &save_ptr);
+    while (NULL != token)
+    {
+        char* value = os_strchr(token, '=');
+
+        if (NULL == value)
+        {
+            return OS_INVALID_ARGUMENT;
+        }
+
+        *value = '\0';
+        value += 1;
+
+        if (ALL_OK != parse_option(&config, token, value))
+        {
+            return OS_INVALID_ARGUMENT;
+        }
+
+        token = os_strtokr_r(NULL, ",;", &save_ptr);
+    }
+
+    return vcan_init(&config);
+}
+
+void vcan_deinit(void)
+{
+    int i;
+
+    if (NULL == lock)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    for (i = 0; i < VCAN_MAX_ENDPOINTS; i++)
+    {
+        os_free(endpoints[i].queue);
+    }
+
+    os_memset(endpoints, 0, sizeof(endpoints));
+    os_free(pending);
+    pending = NULL;
+    is_open = false;
+
+    os_unlock_mutex(lock);
+}
+
+bool vcan_is_open(void)
+{
+    return is_open;
+}
+
+void vcan_get_config(vcan_config_t* config)
+{
+    if (NULL != config)
+    {
+        os_memcpy(config, &bus_config, sizeof(vcan_config_t));
+    }
+}
+
+status_t vcan_set_bit_rate(uint32 bit_rate)
+{
+    vcan_config_t config;
+
+    vcan_get_config(&config);
+    config.bit_rate = bit_rate;
+
+    return vcan_init(&config);
+}
+
+int vcan_attach(vcan_handler_t handler, void* user)
+{
+    int i;
+
+    if (false == is_open)
+    {
+        return -1;
+    }
+
+    os_lock_mutex(lock);
+
+    for (i = VCAN_HOST + 1; i < VCAN_MAX_ENDPOINTS; i++)
+    {
+        vcan_endpoint_t* endpoint = &endpoints[i];
+
+        if (true == endpoint->is_attached)
+        {
+            continue;
+        }
+
+        /* Endpoints without handler are read with vcan_read(). */
+        if (NULL == handler)
+        {
+            endpoint->queue = (vcan_frame_t*)os_calloc(VCAN_QUEUE_SIZE, sizeof(vcan_frame_t));
+            if (NULL == endpoint->queue)
+            {
+                break;
+            }
+        }
+
+        endpoint->is_attached = true;
+        endpoint->handler = handler;
+        endpoint->user = user;
+        endpoint->head = 0;
+        endpoint->tail = 0;
+        info.endpoints += 1;
+
+        os_unlock_mutex(lock);
+        return i;
+    }
+
+    os_unlock_mutex(lock);
+    return -1;
+}
+
+void vcan_detach(int endpoint)
+{
+    if ((endpoint <= VCAN_HOST) || (endpoint >= VCAN_MAX_ENDPOINTS) || (NULL == lock))
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    if (true == endpoints[endpoint].is_attached)
+    {
+        os_free(endpoints[endpoint].queue);
+        os_memset(&endpoints[endpoint], 0, sizeof(vcan_endpoint_t));
+        info.endpoints -= 1;
+    }
+
+    os_unlock_mutex(lock);
+}
+
+status_t vcan_write(int endpoint, const can_message_t* message)
+{
+    vcan_frame_t* frame;
+    uint64 now;
+    uint64 tx_ns = 0;
+    uint64 start_ns;
+    uint32 next_tail;
+
+    if ((NULL == message) || (endpoint < VCAN_HOST) || (endpoint >= VCAN_MAX_ENDPOINTS) || (message->length > VCAN_DATA_SIZE))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    if (false == is_open)
+    {
+        return CAN_WRITE_ERROR;
+    }
+
+    /* SDL mutexes are recursive: handlers may write while being polled. */
+    os_lock_mutex(lock);
+
+    if (true == is_polling)
+    {
+        now = poll_now;
+    }
+    else
+    {
+        now = os_get_ticks();
+        poll(now);
+    }
+
+    next_tail = (pending_tail + 1u) % VCAN_QUEUE_SIZE;
+    if (next_tail == pending_head)
+    {
+        info.frames_overrun += 1;
+        os_unlock_mutex(lock);
+        return CAN_WRITE_ERROR;
+    }
+
+    if (bus_config.bit_rate > 0)
+    {
+        tx_ns = ((uint64)get_frame_bits(message->id, message->length) * 1000000000u) / bus_config.bit_rate;
+
+        /* Background traffic wins arbitration for its share of the bus. */
+        tx_ns = (tx_ns * 100u) / (100u - bus_config.load);
+    }
+
+    start_ns = (now > bus_free_ns) ? now : bus_free_ns;
+    bus_free_ns = start_ns + tx_ns;
+    info.bus_time_ns += tx_ns;
+    info.frames_sent += 1;
+
+    if ((bus_config.drop_rate > 0.f) && ((float)(get_random() % 1000000u) < (bus_config.drop_rate * 10000.f)))
+    {
+        info.frames_dropped += 1;
+        os_unlock_mutex(lock);
+        return ALL_OK;
+    }
+
+    frame = &pending[pending_tail];
+    frame->id = message->id;
+    frame->length = (uint8)message->length;
+    frame->sender = endpoint;
+    os_memcpy(frame->data, message->data, message->length);
+
+    frame->deliver_ns = bus_free_ns + ((uint64)bus_config.latency_us * 1000u);
+    if (bus_config.jitter_us > 0)
+    {
+        frame->deliver_ns += (uint64)(get_random() % (bus_config.jitter_us + 1u)) * 1000u;
+    }
+
+    /* CAN never reorders frames, jitter only delays. */
+    if (frame->deliver_ns < last_deliver_ns)
+    {
+        frame->deliver_ns = last_deliver_ns;
+    }
+    last_deliver_ns = frame->deliver_ns;
+    os_schedule_wake_up(frame->deliver_ns);
+
+    pending_tail = next_tail;
+
+    os_unlock_mutex(lock);
+    return ALL_OK;
+}
+
+status_t vcan_read(int endpoint, can_message_t* message)
+{
+    vcan_endpoint_t* target;
+    vcan_frame_t* frame;
+
+    if ((NULL == message) || (endpoint < VCAN_HOST) || (endpoint >= VCAN_MAX_ENDPOINTS))
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    os_memset(message, 0, sizeof(*message));
+
+    if (false == is_open)
+    {
+        return CAN_READ_ERROR;
+    }
+
+    os_lock_mutex(lock);
+
+    poll(os_get_ticks());
+
+    target = &endpoints[endpoint];
+    if ((NULL == target->queue) || (target->head == target->tail))
+    {
+        os_unlock_mutex(lock);
+        return CAN_READ_ERROR;
+    }
+
+    frame = &target->queue[target->head];
+    target->head = (target->head + 1u) % VCAN_QUEUE_SIZE;
+    to_message(frame, message);
+
+    os_unlock_mutex(lock);
+    return ALL_OK;
+}
+
+void vcan_get_info(vcan_info_t* vcan_info)
+{
+    if (NULL != vcan_info)
+    {
+        os_memcpy(vcan_info, &info, sizeof(vcan_info_t));
+    }
+}
+
+static void poll(uint64 now)
+{
+    int i;
+
+    if (true == is_polling)
+    {
+        return;
+    }
+
+    is_polling = true;
+    poll_now = now;
+
+    for (i = VCAN_HOST + 1; i < VCAN_MAX_ENDPOINTS; i++)
+    {
+        if ((true == endpoints[i].is_attached) && (NULL != endpoints[i].handler))
+        {
+            endpoints[i].handler(NULL, now, endpoints[i].user);
+        }
+    }
+
+    /* Responses sent by handlers without latency are delivered in the
+     * same poll.
+     */
+    while ((pending_head != pending_tail) && (pending[pending_head].deliver_ns <= now))
+    {
+        /* Copy first: handlers may append to the pending queue. */
+        vcan_frame_t frame = pending[pending_head];
+
+        pending_head = (pending_head + 1u) % VCAN_QUEUE_SIZE;
+        deliver(&frame, now);
+    }
+
+    if (pending_head != pending_tail)
+    {
+        os_schedule_wake_up(pending[pending_head].deliver_ns);
+    }
+
+    is_polling = false;
+}
+
+static void deliver(const vcan_frame_t* frame, uint64 now)
+{
+    can_message_t message;
+    int i;
+
+    info.frames_delivered += 1;
+
+    for (i = 0; i < VCAN_MAX_ENDPOINTS; i++)
+    {
+        vcan_endpoint_t* endpoint = &endpoints[i];
+
+        if ((false == endpoint->is_attached) || (i == frame->sender))
+        {
+            continue;
+        }
+
+        if (NULL != endpoint->handler)
+        {
+            to_message(frame, &message);
+            endpoint->handler(&message, now, endpoint->user);
+        }
+        else
+        {
+            uint32 next_tail = (endpoint->tail + 1u) % VCAN_QUEUE_SIZE;
+
+            if (next_tail == endpoint->head)
+            {
+                info.frames_overrun += 1;
+                continue;
+            }
+
+            os_memcpy(&endpoint->queue[endpoint->tail], frame, sizeof(vcan_frame_t));
+            endpoint->tail = next_tail;
+        }
+    }
+}
+
+static void to_message(const vcan_frame_t* frame, can_message_t* message)
+{
+    os_memset(message, 0, sizeof(*message));
+    message->id = frame->id;
+    message->length = frame->length;
+    message->timestamp_us = frame->deliver_ns / 1000u;
+    os_memcpy(message->data, frame->data, frame->length);
+}
+
+static uint32 get_frame_bits(uint32 id, uint32 length)
+{
+    /* Worst-case bit stuffing over SOF, arbitration, control, data and
+     * CRC, plus the unstuffed CRC delimiter, ACK, EOF and IFS.
+     */
+    uint32 stuffed;
+
+    /* Remote frames carry no data field. */
+    if (0 != (id & CAN_REMOTE_FRAME))
+    {
+        length = 0;
+    }
+
+    stuffed = (((id & ~CAN_REMOTE_FRAME) > 0x7ff) ? 54u : 34u) + (8u * length);
+
+    return stuffed + ((stuffed - 1u) / 4u) + 13u;
+}
+
+static uint32 get_random(void)
+{
+    /* xorshift32: the same seed gives the same drops and jitter. */
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+
+    return random_state;
+}
+
+static status_t parse_option(vcan_config_t* config, const char* key, const char* value)
+{
+    if (0 == os_strcmp(key, "latency"))
+    {
+        config->latency_us = (uint32)os_strtoul(value, NULL, 0);
+    }
+    else if (0 == os_strcmp(key, "jitter"))
+    {
+        config->jitter_us = (uint32)os_strtoul(value, NULL, 0);
+    }
+    else if (0 == os_strcmp(key, "drop"))
+    {
+        config->drop_rate = (float)os_atof(value);
+    }
+    else if (0 == os_strcmp(key, "bitrate"))
+    {
+        config->bit_rate = (uint32)os_strtoul(value, NULL, 0);
+    }
+    else if (0 == os_strcmp(key, "load"))
+    {
+        uint32 load = (uint32)os_strtoul(value, NULL, 0);
+
+        if (load >= 100)
+        {
+            return OS_INVALID_ARGUMENT;
+        }
+        config->load = (uint8)load;
+    }
+    else if (0 == os_strcmp(key, "seed"))
+    {
+        config->seed = (uint32)os_strtoul(value, NULL, 0);
+    }
+    else
+    {
+        return OS_INVALID_ARGUMENT;
+    }
+
+    return ALL_OK;
+}
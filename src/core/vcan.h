@@ -0,0 +1,62 @@
+/** @file vcan.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef VCAN_H
+#define VCAN_H
+
+#include "can.h"
+#include "core.h"
+#include "os.h"
+
+#define VCAN_INTERFACE "virtual"
+#define VCAN_MAX_ENDPOINTS 8
+#define VCAN_QUEUE_SIZE 4096u
+#define VCAN_DATA_SIZE 64
+#define VCAN_HOST 0
+
+/* Called for every frame delivered to the endpoint, and with NULL on
+ * every bus poll so the endpoint can run its timers.
+ */
+typedef void (*vcan_handler_t)(const can_message_t* message, uint64 now, void* user);
+
+typedef struct vcan_config
+{
+    uint32 latency_us;
+    uint32 jitter_us;
+    float drop_rate;  /* Percent. */
+    uint32 bit_rate;  /* 0 = unlimited. */
+    uint8 load;       /* Background load in percent. */
+    uint32 seed;
+
+} vcan_config_t;
+
+typedef struct vcan_info
+{
+    uint32 endpoints;
+    uint32 frames_sent;
+    uint32 frames_delivered;
+    uint32 frames_dropped;
+    uint32 frames_overrun;
+    uint64 bus_time_ns;
+
+} vcan_info_t;
+
+status_t vcan_init(const vcan_config_t* config);
+status_t vcan_init_from_string(const char* options);
+void vcan_deinit(void);
+bool vcan_is_open(void);
+void vcan_get_config(vcan_config_t* config);
+status_t vcan_set_bit_rate(uint32 bit_rate);
+int vcan_attach(vcan_handler_t handler, void* user);
+void vcan_detach(int endpoint);
+status_t vcan_write(int endpoint, const can_message_t* message);
+status_t vcan_read(int endpoint, can_message_t* message);
+void vcan_get_info(vcan_info_t* info);
+
+#endif /* VCAN_H */
@@ -16,6 +16,7 @@
 #include "os.h"
 #include "scripts.h"
 #include "tachometer.h"
+#include "vcan.h"
 #include "window.h"
 
 core_t* core = NULL;
@@ -94,6 +95,9 @@ int main(int argc, char* argv[])
                 os_printf("                      Can't be combined with other options\n\n");
                 os_printf("    -s SCRIPT         Run script (.lua can be ommited)\n");
                 os_printf("    -i INTERFACE      Set CAN interface\n");
+                os_printf("                        virtual[:OPTIONS] = in-process bus\n");
+                os_printf("                        OPTIONS: latency=US,jitter=US,drop=PERCENT,\n");
+                os_printf("                                 bitrate=BPS,load=PERCENT,seed=N\n");
                 os_printf("    -b BAUD           Set baud rate\n");
                 os_printf("                        1 = 1 MBit/s\n");
                 os_printf("                        2 = 800 kBit/s\n");
@@ -110,6 +114,18 @@ int main(int argc, char* argv[])
         }
     }
 
+    /* -i virtual[:OPTIONS] replaces the CAN interface by the virtual bus. */
+    if (0 == os_strncmp(can_interface, VCAN_INTERFACE, os_strlen(VCAN_INTERFACE)))
+    {
+        const char* options = os_strchr(can_interface, ':');
+
+        if (ALL_OK != vcan_init_from_string((NULL != options) ? options + 1 : NULL))
+        {
+            os_printf("Invalid virtual bus options.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
     if (core_init(&core, is_plain_mode) != ALL_OK)
     {
         os_log(LOG_ERROR, "Failed to initialize core.");
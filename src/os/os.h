@@ -17,6 +17,7 @@
 #endif
 
 #define PROMPT_BUFFER_SIZE 1024
+#define OS_VIRTUAL_TIMER_ID 0x80000000u
 
 typedef enum color
 {
@@ -62,6 +63,9 @@ typedef enum status
     EDS_OBJECT_NOT_AVAILABLE,
     EDS_PARSE_ERROR,
     ITEM_NOT_FOUND,
+    LSS_NO_RESPONSE,
+    LSS_REJECTED,
+    NMT_NOT_CONFIRMED,
     NMT_UNKNOWN_COMMAND,
     NOTHING_TO_DO,
     OS_CONSOLE_INIT_ERROR,
@@ -179,6 +183,10 @@ size_t os_strlcpy(char* dst, const char* src, size_t dstsize);
 #error os_printf() not defined
 #endif
 
+#ifndef os_qsort
+#error os_qsort() not defined
+#endif
+
 #ifndef os_readdir
 #error os_readdir() not defined
 #endif
@@ -279,6 +287,42 @@ size_t os_strlcpy(char* dst, const char* src, size_t dstsize);
 #error os_vsnprintf() not defined
 #endif
 
+#ifndef os_atomic_int
+#error os_atomic_int not defined
+#endif
+
+#ifndef os_atomic_add
+#error os_atomic_add() not defined
+#endif
+
+#ifndef os_atomic_get
+#error os_atomic_get() not defined
+#endif
+
+#ifndef os_atomic_set
+#error os_atomic_set() not defined
+#endif
+
+#ifndef os_mutex
+#error os_mutex not defined
+#endif
+
+#ifndef os_create_mutex
+#error os_create_mutex() not defined
+#endif
+
+#ifndef os_destroy_mutex
+#error os_destroy_mutex() not defined
+#endif
+
+#ifndef os_lock_mutex
+#error os_lock_mutex() not defined
+#endif
+
+#ifndef os_unlock_mutex
+#error os_unlock_mutex() not defined
+#endif
+
 #ifndef os_thread
 #error os_thread not defined
 #endif
@@ -384,25 +428,34 @@ size_t os_strlcpy(char* dst, const char* src, size_t dstsize);
 #endif
 
 os_timer_id os_add_timer(uint64 interval, os_timer_cb callback, void* param);
+os_timer_id os_add_virtual_timer(uint64 interval, os_timer_cb callback, void* param);
+void os_advance_time(uint64 delta_ns);
 status_t os_console_init(bool is_plain_mode);
 void os_console_hide(void);
 void os_console_show(void);
 os_thread* os_create_thread(os_thread_func fn, const char* name, void* data);
 void os_delay(uint32 delay_in_ms);
+void os_delay_until(uint64 ticks);
 void os_detach_thread(os_thread* thread);
 char* os_fix_path(char* path);
 const char* os_find_data_path(void);
 const char* os_get_error(void);
 status_t os_get_prompt(char prompt[PROMPT_BUFFER_SIZE]);
 uint64 os_get_ticks(void);
+uint64 os_get_virtual_ticks(void);
 const char* os_get_user_directory(void);
+void os_idle(void);
 status_t os_init(void);
+bool os_is_virtual_time(void);
 bool os_key_is_hit(void);
 void os_key_send(uint16 key);
 void os_log(const log_level_t level, const char* format, ...);
 void os_print(const color_t color, const char* format, ...);
 void os_print_prompt(void);
 bool os_remove_timer(os_timer_id id);
+bool os_remove_virtual_timer(os_timer_id id);
+void os_schedule_wake_up(uint64 ticks);
+void os_set_virtual_time(bool enable);
 uint64 os_swap_64(uint64 n);
 uint32 os_swap_be_32(uint32 n);
 void os_quit(void);
@@ -29,6 +29,11 @@ static void reset_terminal_mode(struct termios* orig_termios);
 
 os_timer_id os_add_timer(uint64 interval, os_timer_cb callback, void* param)
 {
+    if (true == os_is_virtual_time())
+    {
+        return os_add_virtual_timer(interval, callback, param);
+    }
+
     return SDL_AddTimerNS(interval, callback, param);
 }
 
@@ -55,9 +60,34 @@ os_thread* os_create_thread(os_thread_func fn, const char* name, void* data)
 
 void os_delay(uint32 delay_in_ms)
 {
+    if (true == os_is_virtual_time())
+    {
+        os_advance_time((uint64)delay_in_ms * 1000000u);
+        return;
+    }
+
     SDL_Delay(delay_in_ms);
 }
 
+void os_delay_until(uint64 ticks)
+{
+    uint64 now = os_get_ticks();
+
+    if (ticks <= now)
+    {
+        return;
+    }
+
+    if (true == os_is_virtual_time())
+    {
+        os_advance_time(ticks - now);
+        return;
+    }
+
+    /* Sleeps most of the time and spins for the last bit. */
+    SDL_DelayPrecise(ticks - now);
+}
+
 void os_detach_thread(os_thread* thread)
 {
     SDL_DetachThread(thread);
@@ -92,6 +122,11 @@ const char* os_get_error(void)
 
 uint64 os_get_ticks(void)
 {
+    if (true == os_is_virtual_time())
+    {
+        return os_get_virtual_ticks();
+    }
+
     return SDL_GetTicksNS();
 }
 
@@ -306,6 +341,11 @@ void os_print(const color_t color, const char* format, ...)
 
 bool os_remove_timer(os_timer_id id)
 {
+    if (0 != (id & OS_VIRTUAL_TIMER_ID))
+    {
+        return os_remove_virtual_timer(id);
+    }
+
     return SDL_RemoveTimer(id);
 }
 
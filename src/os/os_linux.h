@@ -45,6 +45,7 @@
 #define os_memset SDL_memset
 #define os_opendir opendir
 #define os_printf printf
+#define os_qsort SDL_qsort
 #define os_readdir readdir
 #define os_realloc SDL_realloc
 #define os_rewind rewind
@@ -71,6 +72,15 @@
 #define os_va_start va_start
 #define os_vsnprintf SDL_vsnprintf
 
+#define os_atomic_int SDL_AtomicInt
+#define os_atomic_add SDL_AddAtomicInt
+#define os_atomic_get SDL_GetAtomicInt
+#define os_atomic_set SDL_SetAtomicInt
+#define os_mutex SDL_Mutex
+#define os_create_mutex SDL_CreateMutex
+#define os_destroy_mutex SDL_DestroyMutex
+#define os_lock_mutex SDL_LockMutex
+#define os_unlock_mutex SDL_UnlockMutex
 #define os_thread SDL_Thread
 #define os_thread_func SDL_ThreadFunction
 #define os_timer_cb SDL_NSTimerCallback
@@ -0,0 +1,298 @@
+/** @file os_time.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include "os.h"
+
+#define VIRTUAL_TIMER_MAX 64
+#define IDLE_STEP_IN_NS 1000000u
+
+typedef struct virtual_timer
+{
+    os_timer_id id;
+    uint64 interval;
+    uint64 due;
+    os_timer_cb callback;
+    void* param;
+    bool is_firing;
+
+} virtual_timer_t;
+
+static bool is_virtual;
+static uint64 virtual_ticks;
+static uint64 wake_up_ticks;
+static uint32 next_timer_id;
+static virtual_timer_t timers[VIRTUAL_TIMER_MAX];
+
+/* Any thread may advance the clock: os_delay() runs on the monitor and
+ * timer threads too. The lock guards the table and the tick counter,
+ * but is never held while a callback runs, as callbacks take other
+ * locks that are held while reading the clock.
+ */
+static os_mutex* lock;
+
+static void advance_to(uint64 target);
+static virtual_timer_t* get_next_timer(uint64 until);
+
+void os_advance_time(uint64 delta_ns)
+{
+    uint64 target;
+
+    if (false == is_virtual)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+    target = virtual_ticks + delta_ns;
+    os_unlock_mutex(lock);
+
+    advance_to(target);
+}
+
+os_timer_id os_add_virtual_timer(uint64 interval, os_timer_cb callback, void* param)
+{
+    int i;
+
+    if ((0 == interval) || (NULL == callback) || (NULL == lock))
+    {
+        return 0;
+    }
+
+    os_lock_mutex(lock);
+
+    for (i = 0; i < VIRTUAL_TIMER_MAX; i++)
+    {
+        if (0 == timers[i].id)
+        {
+            next_timer_id = (next_timer_id + 1u) & ~OS_VIRTUAL_TIMER_ID;
+            if (0 == next_timer_id)
+            {
+                next_timer_id = 1u;
+            }
+
+            timers[i].id = OS_VIRTUAL_TIMER_ID | next_timer_id;
+            timers[i].interval = interval;
+            timers[i].due = virtual_ticks + interval;
+            timers[i].callback = callback;
+            timers[i].param = param;
+            timers[i].is_firing = false;
+
+            os_unlock_mutex(lock);
+            return timers[i].id;
+        }
+    }
+
+    os_unlock_mutex(lock);
+    return 0;
+}
+
+uint64 os_get_virtual_ticks(void)
+{
+    uint64 ticks;
+
+    if (NULL == lock)
+    {
+        return virtual_ticks;
+    }
+
+    os_lock_mutex(lock);
+    ticks = virtual_ticks;
+    os_unlock_mutex(lock);
+
+    return ticks;
+}
+
+void os_idle(void)
+{
+    uint64 target;
+    virtual_timer_t* timer;
+
+    if (false == is_virtual)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    /* Nobody has anything to do: skip ahead to the next event. */
+    target = virtual_ticks + IDLE_STEP_IN_NS;
+
+    if ((0 != wake_up_ticks) && (wake_up_ticks < target))
+    {
+        target = wake_up_ticks;
+    }
+
+    timer = get_next_timer(target);
+    if (NULL != timer)
+    {
+        target = timer->due;
+    }
+
+    os_unlock_mutex(lock);
+
+    advance_to(target);
+}
+
+bool os_is_virtual_time(void)
+{
+    return is_virtual;
+}
+
+bool os_remove_virtual_timer(os_timer_id id)
+{
+    int i;
+
+    if ((0 == id) || (NULL == lock))
+    {
+        return false;
+    }
+
+    os_lock_mutex(lock);
+
+    for (i = 0; i < VIRTUAL_TIMER_MAX; i++)
+    {
+        if (id == timers[i].id)
+        {
+            os_memset(&timers[i], 0, sizeof(virtual_timer_t));
+            os_unlock_mutex(lock);
+            return true;
+        }
+    }
+
+    os_unlock_mutex(lock);
+    return false;
+}
+
+void os_schedule_wake_up(uint64 ticks)
+{
+    if (false == is_virtual)
+    {
+        return;
+    }
+
+    os_lock_mutex(lock);
+
+    if ((ticks > virtual_ticks) && ((0 == wake_up_ticks) || (ticks < wake_up_ticks)))
+    {
+        wake_up_ticks = ticks;
+    }
+
+    os_unlock_mutex(lock);
+}
+
+void os_set_virtual_time(bool enable)
+{
+    if (enable == is_virtual)
+    {
+        return;
+    }
+
+    if (NULL == lock)
+    {
+        lock = os_create_mutex();
+        if (NULL == lock)
+        {
+            return;
+        }
+    }
+
+    os_lock_mutex(lock);
+
+    if (true == enable)
+    {
+        /* Continue from wall time so earlier timestamps stay valid. */
+        virtual_ticks = os_get_ticks();
+    }
+
+    wake_up_ticks = 0;
+    os_memset(timers, 0, sizeof(timers));
+    is_virtual = enable;
+
+    os_unlock_mutex(lock);
+}
+
+static void advance_to(uint64 target)
+{
+    virtual_timer_t* timer;
+
+    os_lock_mutex(lock);
+
+    /* Fire all timers due on the way, in order. A timer another thread
+     * is firing is skipped, so no callback runs twice at once.
+     */
+    while (NULL != (timer = get_next_timer(target)))
+    {
+        os_timer_id id = timer->id;
+        os_timer_cb callback = timer->callback;
+        void* param = timer->param;
+        uint64 interval = timer->interval;
+
+        if (timer->due > virtual_ticks)
+        {
+            virtual_ticks = timer->due;
+        }
+
+        timer->is_firing = true;
+        os_unlock_mutex(lock);
+
+        interval = callback(param, id, interval);
+
+        os_lock_mutex(lock);
+
+        /* The callback may have removed its own timer. */
+        if (id != timer->id)
+        {
+            continue;
+        }
+
+        timer->is_firing = false;
+
+        if (0 == interval)
+        {
+            os_memset(timer, 0, sizeof(virtual_timer_t));
+        }
+        else
+        {
+            timer->interval = interval;
+            timer->due += interval;
+        }
+    }
+
+    /* Another thread may have gone further already. */
+    if (target > virtual_ticks)
+    {
+        virtual_ticks = target;
+    }
+
+    if (wake_up_ticks <= virtual_ticks)
+    {
+        wake_up_ticks = 0;
+    }
+
+    os_unlock_mutex(lock);
+}
+
+static virtual_timer_t* get_next_timer(uint64 until)
+{
+    virtual_timer_t* next = NULL;
+    int i;
+
+    for (i = 0; i < VIRTUAL_TIMER_MAX; i++)
+    {
+        if ((0 != timers[i].id) && (false == timers[i].is_firing) && (timers[i].due <= until))
+        {
+            if ((NULL == next) || (timers[i].due < next->due))
+            {
+                next = &timers[i];
+            }
+        }
+    }
+
+    return next;
+}
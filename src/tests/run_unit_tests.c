@@ -24,8 +24,10 @@
 #include "test_pdo.h"
 #include "test_scripts.h"
 #include "test_sdo.h"
+#include "test_sim.h"
 #include "test_table.h"
 #include "test_test_report.h"
+#include "test_vcan.h"
 
 core_t* core = NULL;
 
@@ -130,7 +132,13 @@ int main(void)
             cmocka_unit_test(test_python_970_inspect),
             cmocka_unit_test(test_python_980_thread),
             cmocka_unit_test(test_python_990_extras),
+            cmocka_unit_test(test_nmt_confirmed),
+            cmocka_unit_test(test_nmt_emcy),
+            cmocka_unit_test(test_nmt_heartbeat),
+            cmocka_unit_test(test_nmt_lss),
+            cmocka_unit_test(test_nmt_node_guarding),
             cmocka_unit_test(test_nmt_print_help),
+            cmocka_unit_test(test_nmt_scan),
             cmocka_unit_test(test_nmt_send_command_invalid),
             cmocka_unit_test(test_os_atof),
             cmocka_unit_test(test_os_atoi),
@@ -191,8 +199,27 @@ int main(void)
             cmocka_unit_test(test_os_key_is_hit),
             cmocka_unit_test(test_os_clear_window),
             cmocka_unit_test(test_os_add_remove_timer),
+            cmocka_unit_test(test_os_virtual_time),
             cmocka_unit_test(test_os_create_detach_thread),
             cmocka_unit_test(test_sdo_lookup_abort_code),
+            cmocka_unit_test(test_sdo_select_write_mode),
+            cmocka_unit_test(test_sdo_transfer_write_block_fallback),
+            cmocka_unit_test(test_sdo_set_channel),
+            cmocka_unit_test(test_sdo_set_usdo),
+            cmocka_unit_test(test_sdo_stats_latency),
+            cmocka_unit_test(test_sdo_stats_failures),
+            cmocka_unit_test(test_sdo_cache),
+            cmocka_unit_test(test_sim_add_nodes_invalid),
+            cmocka_unit_test(test_sim_eds_sections),
+            cmocka_unit_test(test_sim_sdo_server),
+            cmocka_unit_test(test_sim_nmt),
+            cmocka_unit_test(test_vcan_endpoints),
+            cmocka_unit_test(test_vcan_options),
+            cmocka_unit_test(test_vcan_bit_rate),
+            cmocka_unit_test(test_vcan_latency),
+            cmocka_unit_test(test_vcan_drop),
+            cmocka_unit_test(test_vcan_sdo_read),
+            cmocka_unit_test(test_vcan_virtual_time),
             cmocka_unit_test(test_uint8),
             cmocka_unit_test(test_uint16),
             cmocka_unit_test(test_uint32),
@@ -202,6 +229,11 @@ int main(void)
             cmocka_unit_test(test_can_is_can_initialised),
             cmocka_unit_test(test_pdo_is_id_valid),
             cmocka_unit_test(test_pdo_print_help),
+            cmocka_unit_test(test_pdo_slots),
+            cmocka_unit_test(test_pdo_timer_wheel),
+            cmocka_unit_test(test_pdo_update),
+            cmocka_unit_test(test_pdo_map),
+            cmocka_unit_test(test_pdo_sync),
             cmocka_unit_test(test_table_init),
             cmocka_unit_test(test_table_lifecycle),
             cmocka_unit_test(test_dict_lookup_unknown),
@@ -209,9 +241,17 @@ int main(void)
             cmocka_unit_test(test_codb_loaded_state),
             cmocka_unit_test(test_dbc_unloaded_guards),
             cmocka_unit_test(test_dbc_load_invalid_path),
+            cmocka_unit_test(test_dbc_load_grammar),
             cmocka_unit_test(test_dbc_lifecycle),
             cmocka_unit_test(test_dbc_decode_no_match),
+            cmocka_unit_test(test_dbc_decode_lookup),
+            cmocka_unit_test(test_dbc_decode_j1939),
+            cmocka_unit_test(test_dbc_decode_signals),
+            cmocka_unit_test(test_dbc_decode_values),
+            cmocka_unit_test(test_dbc_decode_multiplexed),
+            cmocka_unit_test(test_dbc_encode),
             cmocka_unit_test(test_dbc_find_id_invalid_args),
+            cmocka_unit_test(test_dbc_find_names),
             cmocka_unit_test(test_report_init),
             cmocka_unit_test(test_report_clear),
             cmocka_unit_test(test_report_add_and_generate),
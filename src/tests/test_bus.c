@@ -0,0 +1,54 @@
+/** @file test_bus.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cmocka.h"
+#include "heartbeat.h"
+#include "os.h"
+#include "sim.h"
+#include "test_bus.h"
+#include "vcan.h"
+
+/* Virtual bus on virtual time with an empty heartbeat table and,
+ * unless count is 0, simulated nodes from first_node_id on.
+ */
+status_t test_bus_setup(uint8 first_node_id, uint8 count)
+{
+    status_t status = ALL_OK;
+
+    os_set_virtual_time(true);
+    assert_int_equal(vcan_init(NULL), ALL_OK);
+
+    heartbeat_reset();
+    heartbeat_update(NULL);
+
+    if (0 != count)
+    {
+        status = sim_add_nodes(first_node_id, count, "eds/DS301_profile.eds");
+        if (ALL_OK != status)
+        {
+            test_bus_teardown();
+        }
+    }
+
+    return status;
+}
+
+void test_bus_teardown(void)
+{
+    heartbeat_close();
+    heartbeat_reset();
+    sim_stop();
+    vcan_deinit();
+    os_set_virtual_time(false);
+}
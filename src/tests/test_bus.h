@@ -0,0 +1,18 @@
+/** @file test_bus.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef TEST_BUS_H
+#define TEST_BUS_H
+
+#include "os.h"
+
+status_t test_bus_setup(uint8 first_node_id, uint8 count);
+void test_bus_teardown(void);
+
+#endif /* TEST_BUS_H */
@@ -44,6 +44,34 @@ static const char* minimal_dbc =
 	" SG_ EngineLoad  :  8|8@1+ (1,0) [0|250] \"%\" Vector__XXX\n"
 	"\n";
 
+/* Byte order, sign and IEEE float signals of a single message. */
+static const char* signals_dbc =
+	"BO_ 200 SignalMessage: 8 Vector__XXX\n"
+	" SG_ Temperature : 0|8@1- (1,-10) [-138|117] \"degC\" Vector__XXX\n"
+	" SG_ Speed : 15|16@0+ (0.5,0) [0|32767.5] \"km/h\" Vector__XXX\n"
+	" SG_ Length : 27|12@0+ (1,0) [0|4095] \"Byte\" Vector__XXX\n"
+	" SG_ Ratio : 32|32@1- (1,0) [0|0] \"\" Vector__XXX\n"
+	"\n"
+	"SIG_VALTYPE_ 200 Ratio : 1;\n";
+
+/* Multiplexing, value tables and attributes, with CRLF line endings. */
+static const char* grammar_dbc =
+	"VERSION \"\"\r\n"
+	"\r\n"
+	"BO_ 2566849022 MuxMessage: 8 Vector__XXX\r\n"
+	" SG_ Selector M : 0|8@1+ (1,0) [0|255] \"\" Vector__XXX\r\n"
+	" SG_ Pressure m1 : 8|16@1+ (0.1,0) [0|6553.5] \"kPa\" Receiver1,Receiver2\r\n"
+	" SG_ Mode m2 : 8|2@1+ (1,0) [0|3] \"\" Vector__XXX\r\n"
+	"\r\n"
+	"BO_ 300 Plain: 2 Vector__XXX\r\n"
+	" SG_ Counter : 0|4@1+ (1,0) [0|15] \"\" Vector__XXX\r\n"
+	"\r\n"
+	"BA_DEF_ BO_  \"GenMsgCycleTime\" INT 0 65535;\r\n"
+	"BA_ \"GenMsgCycleTime\" BO_ 2566849022 100;\r\n"
+	"VAL_ 2566849022 Mode 3 \"NotAvailable\" 2 \"Error\" 1 \"On\" 0 \"Off\" ;\r\n"
+	"VAL_ 300 Counter 1000 \"Sparse\" 0 \"Zero\" ;\r\n"
+	"VAL_ EnvVar 0 \"Ignored\" ;\r\n";
+
 static const char* dbc_temp_path = "tests/temp_test.dbc";
 
 /* ------------------------------------------------------------------ */
@@ -169,3 +197,392 @@ void test_dbc_find_id_invalid_args(void** state)
 
 	dbc_unload();
 }
+
+void test_dbc_decode_lookup(void** state)
+{
+	FILE_t* f;
+	status_t status;
+	const char* result;
+	int i;
+
+	(void)state;
+
+	f = os_fopen(dbc_temp_path, "w");
+	assert_non_null(f);
+	os_fprintf(f, "%s", minimal_dbc);
+
+	/* Enough extended messages for the hash table to see collisions.
+	 * Bit 31 marks an extended ID in the DBC. */
+	for (i = 0; i < 500; i++)
+	{
+		os_fprintf(f, "BO_ %u Pgn%d: 8 Vector__XXX\n", 0x80000000u | 0x18000000u | ((uint32)i << 8) | 0x00u, i);
+		os_fprintf(f, " SG_ Value%d : 0|8@1+ (1,0) [0|255] \"\" Vector__XXX\n", i);
+	}
+	os_fprintf(f, "BA_ \"ProtocolType\" \"J1939\";\n");
+	os_fclose(f);
+
+	status = dbc_load((char*)dbc_temp_path);
+	assert_true(status == ALL_OK);
+
+	/* 11-bit ID. */
+	result = dbc_decode(100, 0, NULL);
+	assert_non_null(os_strstr(result, "TestMessage"));
+
+	/* 29-bit ID, exact match. */
+	result = dbc_decode(0x18012300, 0, NULL);
+	assert_non_null(os_strstr(result, "Pgn291 "));
+
+	/* Same PGN from another source address. */
+	result = dbc_decode(0x180123FE, 0, NULL);
+	assert_non_null(os_strstr(result, "Pgn291 "));
+
+	/* Unknown PGN. */
+	assert_string_equal(dbc_decode(0x1CFFFF00, 0, NULL), "");
+	assert_string_equal(dbc_decode(0x7FF, 0, NULL), "");
+
+	dbc_unload();
+}
+
+void test_dbc_decode_j1939(void** state)
+{
+	FILE_t* f;
+	status_t status;
+
+	(void)state;
+
+	/* No ProtocolType: only the message marked J1939PG matches by PGN. */
+	f = os_fopen(dbc_temp_path, "w");
+	assert_non_null(f);
+	os_fprintf(f, "%s", minimal_dbc);
+	os_fprintf(f, "BO_ %u Plain: 8 Vector__XXX\n", 0x80000000u | 0x18AB0000u);
+	os_fprintf(f, " SG_ PlainValue : 0|8@1+ (1,0) [0|255] \"\" Vector__XXX\n");
+	os_fprintf(f, "BO_ %u Engine: 8 Vector__XXX\n", 0x80000000u | 0x0CF00400u);
+	os_fprintf(f, " SG_ EngineValue : 0|8@1+ (1,0) [0|255] \"\" Vector__XXX\n");
+	os_fprintf(f, "BA_ \"VFrameFormat\" BO_ %u 3;\n", 0x80000000u | 0x0CF00400u);
+	os_fclose(f);
+
+	status = dbc_load((char*)dbc_temp_path);
+	assert_true(status == ALL_OK);
+
+	assert_non_null(os_strstr(dbc_decode(0x18AB0000, 0, NULL), "Plain "));
+	assert_string_equal(dbc_decode(0x18AB0001, 0, NULL), "");
+
+	assert_non_null(os_strstr(dbc_decode(0x0CF004FE, 0, NULL), "Engine "));
+
+	dbc_unload();
+}
+
+void test_dbc_decode_signals(void** state)
+{
+	FILE_t* f;
+	status_t status;
+	uint8 frame[8] = {0xFE, 0x12, 0x34, 0x0A, 0x00, 0x00, 0xC0, 0x3F};
+	uint64 data = 0;
+	int i;
+
+	(void)state;
+
+	f = os_fopen(dbc_temp_path, "w");
+	assert_non_null(f);
+	os_fprintf(f, "%s", signals_dbc);
+	os_fclose(f);
+
+	status = dbc_load((char*)dbc_temp_path);
+	assert_true(status == ALL_OK);
+
+	/* Byte 0 is the least significant byte, as returned by can_read(). */
+	for (i = 7; i >= 0; i--)
+	{
+		data = (data << 8) | frame[i];
+	}
+
+	/* Intel, signed: FEh = -2. */
+	assert_non_null(os_strstr(dbc_decode(200, data, "Temperature"), ": -12.000000 degC"));
+
+	/* Motorola: MSB at bit 15, bytes 1 and 2. */
+	assert_non_null(os_strstr(dbc_decode(200, data, "Speed"), ": 2330.000000 km/h"));
+
+	/* Motorola, not byte-aligned: low nibble of byte 3, then byte 4. */
+	assert_non_null(os_strstr(dbc_decode(200, data, "Length"), ": 2560.000000 Byte"));
+
+	/* IEEE 754 single precision: 3FC00000h = 1.5. */
+	assert_non_null(os_strstr(dbc_decode(200, data, "Ratio"), ": 1.500000"));
+
+	dbc_unload();
+}
+
+void test_dbc_decode_values(void** state)
+{
+	FILE_t* f;
+	signal_value_t values[DBC_VALUES_MAX];
+	uint64 data = 0x3FC000000A3412FEULL;
+	int count = -1;
+
+	(void)state;
+
+	/* Not loaded. */
+	assert_true(dbc_decode_values(200, data, NULL, values, DBC_VALUES_MAX, &count) == ITEM_NOT_FOUND);
+	assert_int_equal(count, 0);
+
+	f = os_fopen(dbc_temp_path, "w");
+	assert_non_null(f);
+	os_fprintf(f, "%s", signals_dbc);
+	os_fclose(f);
+
+	assert_true(dbc_load((char*)dbc_temp_path) == ALL_OK);
+
+	assert_true(dbc_decode_values(200, data, NULL, NULL, DBC_VALUES_MAX, &count) == OS_INVALID_ARGUMENT);
+	assert_true(dbc_decode_values(0x123, data, NULL, values, DBC_VALUES_MAX, &count) == ITEM_NOT_FOUND);
+
+	assert_true(dbc_decode_values(200, data, NULL, values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 4);
+	assert_string_equal(values[0].signal->name, "Temperature");
+	assert_int_equal(values[0].raw, 0xFE);
+	assert_true(values[0].value == -12.0);
+	assert_int_equal(values[1].raw, 0x1234);
+	assert_true(values[1].value == 2330.0);
+
+	/* Capacity is respected. */
+	assert_true(dbc_decode_values(200, data, NULL, values, 2, &count) == ALL_OK);
+	assert_int_equal(count, 2);
+
+	/* Filters are compiled on first use and reused afterwards. */
+	assert_true(dbc_decode_values(200, data, "Speed", values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 1);
+	assert_string_equal(values[0].signal->name, "Speed");
+	assert_true(dbc_decode_values(200, data, "Speed", values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 1);
+	assert_true(dbc_decode_values(200, data, "NoSuchSignal", values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 0);
+
+	dbc_unload();
+}
+
+void test_dbc_load_grammar(void** state)
+{
+	FILE_t* f;
+	const message_t* msg;
+
+	(void)state;
+
+	f = os_fopen(dbc_temp_path, "wb");
+	assert_non_null(f);
+	os_fprintf(f, "%s", grammar_dbc);
+	os_fclose(f);
+
+	assert_true(dbc_load((char*)dbc_temp_path) == ALL_OK);
+
+	msg = dbc_get_message(0x18FF01FE);
+	assert_non_null(msg);
+	assert_string_equal(msg->name, "MuxMessage");
+	assert_true(msg->is_extended);
+	assert_int_equal(msg->dlc, 8);
+	assert_int_equal(msg->cycle_time_ms, 100);
+	assert_int_equal(msg->signal_count, 3);
+
+	assert_int_equal(msg->signals[0].mux, MUX_SWITCH);
+	assert_int_equal(msg->signals[1].mux, MUX_VALUE);
+	assert_int_equal(msg->signals[1].mux_value, 1);
+	assert_string_equal(msg->signals[1].unit, "kPa");
+	assert_string_equal(msg->signals[1].receiver, "Receiver1,Receiver2");
+	assert_int_equal(msg->signals[2].mux_value, 2);
+
+	assert_int_equal(msg->signals[2].value_description_count, 4);
+	assert_int_equal(msg->signals[2].value_descriptions[1].value, 2);
+	assert_string_equal(msg->signals[2].value_descriptions[1].description, "Error");
+	assert_int_equal(msg->signals[0].value_description_count, 0);
+
+	msg = dbc_get_message(300);
+	assert_non_null(msg);
+	assert_false(msg->is_extended);
+	assert_int_equal(msg->cycle_time_ms, 0);
+	assert_int_equal(msg->signal_count, 1);
+	assert_string_equal(msg->signals[0].name, "Counter");
+	assert_string_equal(msg->signals[0].unit, "");
+
+	dbc_unload();
+	assert_null(dbc_get_message(300));
+}
+
+void test_dbc_decode_multiplexed(void** state)
+{
+	FILE_t* f;
+	signal_value_t values[DBC_VALUES_MAX];
+	int count = 0;
+
+	(void)state;
+
+	f = os_fopen(dbc_temp_path, "wb");
+	assert_non_null(f);
+	os_fprintf(f, "%s", grammar_dbc);
+	os_fclose(f);
+
+	assert_true(dbc_load((char*)dbc_temp_path) == ALL_OK);
+
+	/* Selector 1: the switch and Pressure. */
+	assert_true(dbc_decode_values(0x18FF01FE, 0x0000000000030201ULL, NULL, values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 2);
+	assert_string_equal(values[0].signal->name, "Selector");
+	assert_string_equal(values[1].signal->name, "Pressure");
+	assert_int_equal(values[1].raw, 0x0302);
+	assert_null(values[1].description);
+
+	/* Selector 2: the switch and Mode, with its value table. */
+	assert_true(dbc_decode_values(0x18FF01FE, 0x0000000000000202ULL, NULL, values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 2);
+	assert_string_equal(values[1].signal->name, "Mode");
+	assert_string_equal(values[1].description, "Error");
+	assert_non_null(os_strstr(dbc_decode(0x18FF01FE, 0x0000000000000202ULL, NULL), "(Error)"));
+	assert_null(os_strstr(dbc_decode(0x18FF01FE, 0x0000000000000202ULL, NULL), "Pressure"));
+
+	/* Selector without a group: only the switch. */
+	assert_true(dbc_decode_values(0x18FF01FE, 0x0000000000000007ULL, NULL, values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 1);
+
+	/* Sparse value table. */
+	assert_true(dbc_decode_values(300, 0, NULL, values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 1);
+	assert_string_equal(values[0].description, "Zero");
+	assert_true(dbc_decode_values(300, 1, NULL, values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_null(values[0].description);
+
+	dbc_unload();
+}
+
+void test_dbc_encode(void** state)
+{
+	FILE_t* f;
+	signal_value_t values[DBC_VALUES_MAX];
+	const message_t* msg;
+	uint64 data = 0x3FC000000A3412FEULL;
+	uint64 encoded = 0;
+	uint8 length = 0;
+	int count = 0;
+
+	(void)state;
+
+	f = os_fopen(dbc_temp_path, "w");
+	assert_non_null(f);
+	os_fprintf(f, "%s", signals_dbc);
+	os_fclose(f);
+
+	assert_true(dbc_load((char*)dbc_temp_path) == ALL_OK);
+
+	/* Intel, Motorola, signed and float signals round-trip. */
+	assert_true(dbc_decode_values(200, data, NULL, values, DBC_VALUES_MAX, &count) == ALL_OK);
+	assert_true(dbc_encode(200, values, count, &encoded, &length) == ALL_OK);
+	assert_true(encoded == data);
+	assert_int_equal(length, 8);
+
+	/* Clamped to [min|max], then to what fits into the signal. */
+	msg = dbc_get_message(200);
+	assert_non_null(msg);
+	values[0].signal = &msg->signals[0];
+	values[0].value = 500.0;
+	values[1].signal = &msg->signals[1];
+	values[1].value = -5.0;
+	assert_true(dbc_encode(200, values, 2, &encoded, &length) == ALL_OK);
+	assert_true(encoded == 0x7FULL);
+
+	values[0].value = -11.6;
+	assert_true(dbc_encode(200, values, 1, &encoded, &length) == ALL_OK);
+	assert_true(encoded == 0xFEULL);
+
+	/* Unknown message, no output. */
+	assert_true(dbc_encode(0x123, values, 1, &encoded, &length) == ITEM_NOT_FOUND);
+	assert_true(dbc_encode(200, values, 1, NULL, &length) == OS_INVALID_ARGUMENT);
+
+	dbc_unload();
+
+	f = os_fopen(dbc_temp_path, "wb");
+	assert_non_null(f);
+	os_fprintf(f, "%s", grammar_dbc);
+	os_fclose(f);
+
+	assert_true(dbc_load((char*)dbc_temp_path) == ALL_OK);
+
+	/* Only the group the switch selects is placed. */
+	msg = dbc_get_message(0x18FF01FE);
+	assert_non_null(msg);
+	values[0].signal = &msg->signals[1];
+	values[0].value = 77.0;
+	values[1].signal = &msg->signals[2];
+	values[1].value = 2.0;
+	values[2].signal = &msg->signals[0];
+	values[2].value = 2.0;
+	assert_true(dbc_encode(0x18FF01FE, values, 3, &encoded, &length) == ALL_OK);
+	assert_true(encoded == 0x0202ULL);
+
+	values[2].value = 1.0;
+	assert_true(dbc_encode(0x18FF01FE, values, 3, &encoded, &length) == ALL_OK);
+	assert_true(encoded == 0x030201ULL);
+
+	/* Signals of another message are rejected, missing ones are 0. */
+	assert_true(dbc_encode(300, values, 1, &encoded, &length) == OS_INVALID_ARGUMENT);
+	assert_true(dbc_encode(300, NULL, 0, &encoded, &length) == ALL_OK);
+	assert_true(encoded == 0);
+	assert_int_equal(length, 2);
+
+	dbc_unload();
+}
+
+void test_dbc_find_names(void** state)
+{
+	FILE_t* f;
+	name_match_t matches[DBC_MATCHES_MAX];
+	uint32 id = 0;
+	int count = -1;
+
+	(void)state;
+
+	/* Not loaded. */
+	assert_true(dbc_find_names("Mode", false, matches, DBC_MATCHES_MAX, &count) == ITEM_NOT_FOUND);
+	assert_int_equal(count, 0);
+
+	f = os_fopen(dbc_temp_path, "wb");
+	assert_non_null(f);
+	os_fprintf(f, "%s", grammar_dbc);
+	os_fclose(f);
+
+	assert_true(dbc_load((char*)dbc_temp_path) == ALL_OK);
+
+	assert_true(dbc_find_names(NULL, false, matches, DBC_MATCHES_MAX, &count) == OS_INVALID_ARGUMENT);
+
+	/* Substring: messages first, then shorter names, then file order. */
+	assert_true(dbc_find_names("E", false, matches, DBC_MATCHES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 5);
+	assert_string_equal(matches[0].message->name, "MuxMessage");
+	assert_null(matches[0].signal);
+	assert_string_equal(matches[1].signal->name, "Mode");
+	assert_string_equal(matches[2].signal->name, "Counter");
+	assert_string_equal(matches[2].message->name, "Plain");
+	assert_string_equal(matches[3].signal->name, "Selector");
+	assert_string_equal(matches[4].signal->name, "Pressure");
+	assert_int_equal(matches[4].match, MATCH_SUBSTRING);
+
+	/* The best matches are kept when there are more than fit. */
+	assert_true(dbc_find_names("e", false, matches, 2, &count) == ALL_OK);
+	assert_int_equal(count, 2);
+	assert_string_equal(matches[1].signal->name, "Mode");
+
+	/* Exact before prefix, each name once. */
+	assert_true(dbc_find_names("mode", false, matches, DBC_MATCHES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 1);
+	assert_int_equal(matches[0].match, MATCH_EXACT);
+	assert_true(dbc_find_names("m", true, matches, DBC_MATCHES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 2);
+	assert_string_equal(matches[0].message->name, "MuxMessage");
+	assert_int_equal(matches[0].match, MATCH_PREFIX);
+	assert_string_equal(matches[1].signal->name, "Mode");
+	assert_true(dbc_find_names("ssure", true, matches, DBC_MATCHES_MAX, &count) == ALL_OK);
+	assert_int_equal(count, 0);
+
+	/* Message names only. */
+	assert_true(dbc_find_id_by_name(&id, "PLAIN") == ALL_OK);
+	assert_int_equal(id, 300);
+	assert_true(dbc_find_id_by_name(&id, "message") == ALL_OK);
+	assert_int_equal(id, 0x18FF01FE);
+	assert_true(dbc_find_id_by_name(&id, "ode") == ITEM_NOT_FOUND);
+
+	dbc_unload();
+}
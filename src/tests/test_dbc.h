@@ -12,8 +12,16 @@
 
 void test_dbc_unloaded_guards(void** state);
 void test_dbc_load_invalid_path(void** state);
+void test_dbc_load_grammar(void** state);
 void test_dbc_lifecycle(void** state);
 void test_dbc_decode_no_match(void** state);
+void test_dbc_decode_lookup(void** state);
+void test_dbc_decode_j1939(void** state);
+void test_dbc_decode_signals(void** state);
+void test_dbc_decode_values(void** state);
+void test_dbc_decode_multiplexed(void** state);
+void test_dbc_encode(void** state);
 void test_dbc_find_id_invalid_args(void** state);
+void test_dbc_find_names(void** state);
 
 #endif /* TEST_DBC_H */
@@ -13,9 +13,251 @@
 #include <stdint.h>
 
 #include "cmocka.h"
+#include "emcy.h"
+#include "heartbeat.h"
+#include "lss.h"
 #include "nmt.h"
 #include "os.h"
+#include "scan.h"
+#include "sdo.h"
+#include "sim.h"
+#include "test_bus.h"
 #include "test_nmt.h"
+#include "vcan.h"
+
+#define TEST_NMT_NODE_ID 0x23
+#define TEST_NMT_PERIOD_MS 10
+#define TEST_NMT_SCAN_FIRST_ID 0x40
+#define TEST_NMT_SCAN_COUNT 3
+#define TEST_NMT_EMCY_BURST 40
+#define TEST_NMT_LSS_SLAVES 3
+#define TEST_NMT_LSS_FIRST_ID 0x50
+
+typedef struct test_lss_slave
+{
+    uint32 identity[4];
+    uint8 node_id;
+    uint8 pending_node_id;
+    uint8 mode;
+    uint8 sub;
+
+} test_lss_slave_t;
+
+static uint32 timeout_callbacks;
+static uint32 emcy_triggers;
+static int lss_endpoint;
+static test_lss_slave_t lss_slaves[TEST_NMT_LSS_SLAVES];
+
+static void on_heartbeat_event(const heartbeat_entry_t* entry, void* user);
+static void on_emcy_trigger(const emcy_record_t* entry, void* user);
+static void send_emcy(int endpoint, uint8 node_id, uint16 code, uint8 error_register);
+static void run_bus(uint32 duration_ms);
+static void on_lss_frame(const can_message_t* message, uint64 now, void* user);
+static void send_lss_response(uint8 command, uint8 value);
+
+void test_nmt_scan(void** state)
+{
+    scan_node_t nodes[SCAN_NODE_MAX + 1];
+    uint64 start_time;
+    uint32 i;
+
+    (void)state;
+
+    assert_int_equal(test_bus_setup(TEST_NMT_SCAN_FIRST_ID, TEST_NMT_SCAN_COUNT), ALL_OK);
+
+    /* All 127 Node-IDs in one timeout instead of one timeout each. */
+    start_time = os_get_ticks();
+    assert_int_equal(scan_network(nodes, SILENT), TEST_NMT_SCAN_COUNT);
+    assert_true((os_get_ticks() - start_time) < (2 * SDO_TIMEOUT_IN_NS));
+
+    for (i = 0; i < TEST_NMT_SCAN_COUNT; i++)
+    {
+        const scan_node_t* node = &nodes[TEST_NMT_SCAN_FIRST_ID + i];
+
+        assert_true(node->is_present);
+        assert_true(scan_has_value(node, SCAN_DEVICE_TYPE));
+        assert_true(scan_has_value(node, SCAN_VENDOR_ID));
+        assert_true(scan_has_value(node, SCAN_SERIAL));
+    }
+
+    assert_false(nodes[TEST_NMT_SCAN_FIRST_ID - 1].is_present);
+    assert_false(nodes[TEST_NMT_SCAN_FIRST_ID + TEST_NMT_SCAN_COUNT].is_present);
+
+    test_bus_teardown();
+}
+
+void test_nmt_lss(void** state)
+{
+    lss_assignment_t assignments[TEST_NMT_LSS_SLAVES];
+    lss_identity_t identity;
+    uint64 start_time;
+    uint32 i;
+
+    (void)state;
+
+    test_bus_setup(0, 0);
+    os_memset(lss_slaves, 0, sizeof(lss_slaves));
+
+    /* Two fresh devices of one product and one that is configured
+     * already, on the first Node-ID and without heartbeat.
+     */
+    for (i = 0; i < TEST_NMT_LSS_SLAVES; i++)
+    {
+        lss_slaves[i].identity[0] = 0x000000a5;
+        lss_slaves[i].identity[1] = 0x12345678;
+        lss_slaves[i].identity[2] = 0x00010002;
+        lss_slaves[i].identity[3] = 0x8000f00du + (i * 0x1111u);
+        lss_slaves[i].node_id = 0xff;
+        lss_slaves[i].pending_node_id = 0xff;
+    }
+    lss_slaves[2].node_id = TEST_NMT_LSS_FIRST_ID;
+
+    lss_endpoint = vcan_attach(on_lss_frame, NULL);
+    assert_true(lss_endpoint > VCAN_HOST);
+
+    start_time = os_get_ticks();
+    assert_int_equal(lss_assign_node_ids(TEST_NMT_LSS_FIRST_ID, true, assignments, TEST_NMT_LSS_SLAVES, SILENT), 2);
+
+    /* 132 steps per device, each at most one Fastscan timeout, and one
+     * SDO timeout to make sure its Node-ID is free.
+     */
+    assert_true((os_get_ticks() - start_time) < (2u * ((140u * LSS_FASTSCAN_TIMEOUT_US * 1000u) + SDO_TIMEOUT_IN_NS)));
+
+    for (i = 0; i < 2; i++)
+    {
+        test_lss_slave_t* slave = (assignments[i].identity.serial == lss_slaves[0].identity[3]) ? &lss_slaves[0] : &lss_slaves[1];
+
+        assert_int_equal(assignments[i].node_id, TEST_NMT_LSS_FIRST_ID + 1 + i);
+        assert_int_equal(assignments[i].identity.vendor_id, slave->identity[0]);
+        assert_int_equal(assignments[i].identity.product_code, slave->identity[1]);
+        assert_int_equal(assignments[i].identity.revision, slave->identity[2]);
+        assert_int_equal(assignments[i].identity.serial, slave->identity[3]);
+        assert_int_equal(slave->node_id, assignments[i].node_id);
+        assert_int_equal(slave->mode, LSS_MODE_WAITING);
+    }
+    assert_true(assignments[0].identity.serial != assignments[1].identity.serial);
+    assert_int_equal(lss_slaves[2].node_id, TEST_NMT_LSS_FIRST_ID);
+
+    /* Nobody is left unconfigured. */
+    assert_int_equal(lss_fastscan(&identity, 0), ITEM_NOT_FOUND);
+
+    vcan_detach(lss_endpoint);
+    test_bus_teardown();
+}
+
+void test_nmt_emcy(void** state)
+{
+    emcy_record_t entries[EMCY_HISTORY_MAX];
+    emcy_record_t entry;
+    emcy_node_t node;
+    can_message_t sync = {0};
+    int endpoint;
+    uint32 i;
+
+    (void)state;
+
+    test_bus_setup(0, 0);
+
+    emcy_clear(0);
+    emcy_update(NULL);
+    emcy_set_trigger(0x8100, 0xff00, on_emcy_trigger, NULL);
+    emcy_triggers = 0;
+
+    endpoint = vcan_attach(NULL, NULL);
+    assert_true(endpoint > VCAN_HOST);
+
+    assert_int_equal(emcy_get_node(TEST_NMT_NODE_ID, &node), ITEM_NOT_FOUND);
+
+    /* The SYNC shares the function code but is no EMCY. */
+    sync.id = 0x080;
+    assert_int_equal(vcan_write(endpoint, &sync), ALL_OK);
+
+    for (i = 0; i < 5; i++)
+    {
+        send_emcy(endpoint, TEST_NMT_NODE_ID, 0x3210, 0x05);
+        run_bus(300);
+    }
+
+    /* A burst within one window: counted and kept, not just printed. */
+    for (i = 0; i < TEST_NMT_EMCY_BURST; i++)
+    {
+        send_emcy(endpoint, TEST_NMT_NODE_ID, (i == (TEST_NMT_EMCY_BURST - 1)) ? 0x8130 : 0x8110, 0x11);
+    }
+    run_bus(10);
+
+    assert_int_equal(emcy_get_node(TEST_NMT_NODE_ID, &node), ALL_OK);
+    assert_int_equal(node.count, 5 + TEST_NMT_EMCY_BURST);
+    assert_int_equal(node.last_code, 0x8130);
+    assert_int_equal(node.error_register, 0x11);
+    assert_int_equal(node.peak_per_s, TEST_NMT_EMCY_BURST + 1);
+    assert_true(node.last_us > node.first_us);
+    assert_true(emcy_get_rate(&node) > 0.0);
+    assert_int_equal(emcy_triggers, TEST_NMT_EMCY_BURST);
+
+    assert_int_equal(emcy_get_history(TEST_NMT_NODE_ID, entries, EMCY_HISTORY_MAX), EMCY_HISTORY_MAX);
+    assert_int_equal(entries[0].code, 0x8110);
+    assert_int_equal(entries[EMCY_HISTORY_MAX - 1].code, 0x8130);
+    assert_int_equal(entries[EMCY_HISTORY_MAX - 1].node_id, TEST_NMT_NODE_ID);
+    assert_int_equal(entries[EMCY_HISTORY_MAX - 1].data[0], TEST_NMT_NODE_ID);
+    assert_int_equal(entries[EMCY_HISTORY_MAX - 1].data[4], 0x55);
+
+    assert_int_equal(emcy_get_node(TEST_NMT_NODE_ID + 1, &node), ITEM_NOT_FOUND);
+
+    /* Scripts wait for a specific error instead of polling. */
+    send_emcy(endpoint, TEST_NMT_NODE_ID + 1, 0x5530, 0x01);
+    assert_int_equal(emcy_wait(0, 0x5500, 0xff00, 100, &entry), ALL_OK);
+    assert_int_equal(entry.node_id, TEST_NMT_NODE_ID + 1);
+    assert_int_equal(entry.code, 0x5530);
+    assert_int_equal(emcy_wait(TEST_NMT_NODE_ID, 0x5530, 0xffff, 20, &entry), ITEM_NOT_FOUND);
+
+    emcy_clear(TEST_NMT_NODE_ID);
+    assert_int_equal(emcy_get_node(TEST_NMT_NODE_ID, &node), ITEM_NOT_FOUND);
+    assert_int_equal(emcy_get_node(TEST_NMT_NODE_ID + 1, &node), ALL_OK);
+
+    emcy_close();
+    emcy_clear(0);
+    vcan_detach(endpoint);
+    test_bus_teardown();
+}
+
+void test_nmt_confirmed(void** state)
+{
+    can_message_t message = {0};
+    nmt_transition_t transitions[NMT_NODE_MAX + 1];
+    uint32 value;
+
+    (void)state;
+
+    assert_int_equal(test_bus_setup(TEST_NMT_NODE_ID, 2), ALL_OK);
+
+    /* Without a heartbeat producer nothing can be confirmed. */
+    assert_int_equal(nmt_send_command_confirmed(TEST_NMT_NODE_ID, NMT_OPERATIONAL, 50, transitions, SILENT, NULL), NMT_NOT_CONFIRMED);
+    assert_true(transitions[TEST_NMT_NODE_ID].is_expected);
+    assert_false(transitions[TEST_NMT_NODE_ID].is_confirmed);
+
+    value = TEST_NMT_PERIOD_MS;
+    assert_int_equal(sdo_write(&message, SILENT, TEST_NMT_NODE_ID, 0x1017, 0x00, 2, &value, NULL), IS_WRITE_EXPEDITED);
+    assert_int_equal(sdo_write(&message, SILENT, TEST_NMT_NODE_ID + 1, 0x1017, 0x00, 2, &value, NULL), IS_WRITE_EXPEDITED);
+
+    run_bus(TEST_NMT_PERIOD_MS * 3);
+
+    assert_int_equal(nmt_send_command_confirmed(TEST_NMT_NODE_ID, NMT_PRE_OPERATIONAL, 100, transitions, SILENT, NULL), ALL_OK);
+    assert_true(transitions[TEST_NMT_NODE_ID].is_confirmed);
+    assert_true(transitions[TEST_NMT_NODE_ID].latency_us <= (TEST_NMT_PERIOD_MS * 1000));
+    assert_false(transitions[TEST_NMT_NODE_ID + 1].is_expected);
+
+    /* A broadcast waits for both nodes. */
+    assert_int_equal(nmt_send_command_confirmed(0x00, NMT_STOP, 100, transitions, SILENT, NULL), ALL_OK);
+    assert_true(transitions[TEST_NMT_NODE_ID].is_confirmed);
+    assert_true(transitions[TEST_NMT_NODE_ID + 1].is_confirmed);
+
+    /* A reset is confirmed by the boot-up message. */
+    assert_int_equal(nmt_send_command_confirmed(0x00, NMT_RESET_COMM, 100, transitions, SILENT, NULL), ALL_OK);
+    assert_true(transitions[TEST_NMT_NODE_ID].is_confirmed);
+    assert_true(transitions[TEST_NMT_NODE_ID + 1].is_confirmed);
+
+    test_bus_teardown();
+}
 
 void test_nmt_print_help(void** state)
 {
@@ -30,3 +272,296 @@ void test_nmt_send_command_invalid(void** state)
 
     assert_true(nmt_send_command(0x01, (nmt_command_t)0xFF, SILENT, NULL) == NMT_UNKNOWN_COMMAND);
 }
+
+void test_nmt_heartbeat(void** state)
+{
+    can_message_t message = {0};
+    heartbeat_entry_t entries[HEARTBEAT_EVENT_MAX];
+    heartbeat_node_t node;
+    uint32 value;
+    uint32 count;
+    uint32 i;
+    bool is_operational = false;
+    bool is_timeout = false;
+
+    (void)state;
+
+    assert_int_equal(test_bus_setup(TEST_NMT_NODE_ID, 1), ALL_OK);
+
+    heartbeat_set_callback(on_heartbeat_event, NULL);
+    timeout_callbacks = 0;
+
+    assert_int_equal(heartbeat_get_node(0, &node), OS_INVALID_ARGUMENT);
+
+    value = TEST_NMT_PERIOD_MS;
+    assert_int_equal(sdo_write(&message, SILENT, TEST_NMT_NODE_ID, 0x1017, 0x00, 2, &value, NULL), IS_WRITE_EXPEDITED);
+    assert_int_equal(nmt_send_command(TEST_NMT_NODE_ID, NMT_OPERATIONAL, SILENT, NULL), ALL_OK);
+
+    run_bus(TEST_NMT_PERIOD_MS * 10);
+
+    assert_int_equal(heartbeat_get_node(TEST_NMT_NODE_ID, &node), ALL_OK);
+    assert_int_equal(node.state, 0x05);
+    assert_int_equal(node.period_us, TEST_NMT_PERIOD_MS * 1000);
+    assert_true(node.frames >= 9);
+    assert_false(node.is_timed_out);
+
+    /* Silence the node: the table times out at twice the period. */
+    value = 0;
+    assert_int_equal(sdo_write(&message, SILENT, TEST_NMT_NODE_ID, 0x1017, 0x00, 2, &value, NULL), IS_WRITE_EXPEDITED);
+
+    run_bus(TEST_NMT_PERIOD_MS * 5);
+
+    assert_int_equal(heartbeat_get_node(TEST_NMT_NODE_ID, &node), ALL_OK);
+    assert_true(node.is_timed_out);
+    assert_int_equal(node.timeouts, 1);
+    assert_int_equal(timeout_callbacks, 1);
+
+    count = heartbeat_get_events(entries, HEARTBEAT_EVENT_MAX);
+    for (i = 0; i < count; i++)
+    {
+        assert_int_equal(entries[i].node_id, TEST_NMT_NODE_ID);
+
+        if ((HEARTBEAT_STATE_CHANGED == entries[i].event) && (0x05 == entries[i].state))
+        {
+            is_operational = true;
+        }
+        else if (HEARTBEAT_TIMEOUT == entries[i].event)
+        {
+            is_timeout = true;
+        }
+    }
+    assert_true(is_operational);
+    assert_true(is_timeout);
+    assert_int_equal(heartbeat_get_events(entries, HEARTBEAT_EVENT_MAX), 0);
+
+    /* A configured consumer time replaces the measured period. */
+    assert_int_equal(heartbeat_set_timeout(TEST_NMT_NODE_ID, 100), ALL_OK);
+    value = TEST_NMT_PERIOD_MS * 8;
+    assert_int_equal(sdo_write(&message, SILENT, TEST_NMT_NODE_ID, 0x1017, 0x00, 2, &value, NULL), IS_WRITE_EXPEDITED);
+
+    run_bus(TEST_NMT_PERIOD_MS * 50);
+
+    assert_int_equal(heartbeat_get_node(TEST_NMT_NODE_ID, &node), ALL_OK);
+    assert_false(node.is_timed_out);
+    assert_int_equal(node.timeouts, 1);
+
+    heartbeat_set_timeout(TEST_NMT_NODE_ID, 0);
+    test_bus_teardown();
+}
+
+void test_nmt_node_guarding(void** state)
+{
+    can_message_t message = {0};
+    heartbeat_node_t node;
+    uint8 toggle;
+
+    (void)state;
+
+    assert_int_equal(test_bus_setup(TEST_NMT_NODE_ID, 1), ALL_OK);
+
+    heartbeat_set_callback(on_heartbeat_event, NULL);
+    timeout_callbacks = 0;
+
+    assert_int_equal(heartbeat_set_guarding(0, TEST_NMT_PERIOD_MS, 3), OS_INVALID_ARGUMENT);
+    assert_int_equal(heartbeat_set_guarding(TEST_NMT_NODE_ID, TEST_NMT_PERIOD_MS, 0), OS_INVALID_ARGUMENT);
+    assert_int_equal(heartbeat_set_guarding(TEST_NMT_NODE_ID, TEST_NMT_PERIOD_MS, 3), ALL_OK);
+
+    /* The node has no heartbeat producer, every frame is a response. */
+    run_bus(TEST_NMT_PERIOD_MS * 10);
+
+    assert_int_equal(heartbeat_get_node(TEST_NMT_NODE_ID, &node), ALL_OK);
+    assert_int_equal(node.state, 0x7f);
+    assert_true(node.frames >= 9);
+    assert_int_equal(node.toggle_errors, 0);
+    assert_false(node.is_timed_out);
+
+    /* No responses: the node times out after its life time. */
+    sim_stop();
+    run_bus(TEST_NMT_PERIOD_MS * 5);
+
+    assert_int_equal(heartbeat_get_node(TEST_NMT_NODE_ID, &node), ALL_OK);
+    assert_true(node.is_timed_out);
+    assert_int_equal(node.timeouts, 1);
+    assert_int_equal(timeout_callbacks, 1);
+
+    /* A repeated toggle bit is not a valid response. */
+    toggle = node.toggle;
+    message.id = 0x700 + TEST_NMT_NODE_ID;
+    message.length = 1;
+    message.data[0] = 0x7f | (toggle ^ 0x80);
+    assert_int_equal(vcan_write(VCAN_HOST, &message), ALL_OK);
+    run_bus(1);
+
+    assert_int_equal(heartbeat_get_node(TEST_NMT_NODE_ID, &node), ALL_OK);
+    assert_true(node.is_timed_out);
+    assert_int_equal(node.toggle_errors, 1);
+
+    message.data[0] = 0x7f | toggle;
+    assert_int_equal(vcan_write(VCAN_HOST, &message), ALL_OK);
+    run_bus(1);
+
+    assert_int_equal(heartbeat_get_node(TEST_NMT_NODE_ID, &node), ALL_OK);
+    assert_false(node.is_timed_out);
+    assert_int_equal(node.toggle_errors, 1);
+
+    heartbeat_set_guarding(TEST_NMT_NODE_ID, 0, 0);
+    test_bus_teardown();
+}
+
+static void on_heartbeat_event(const heartbeat_entry_t* entry, void* user)
+{
+    (void)user;
+
+    if (HEARTBEAT_TIMEOUT == entry->event)
+    {
+        timeout_callbacks += 1;
+    }
+}
+
+static void on_emcy_trigger(const emcy_record_t* entry, void* user)
+{
+    (void)entry;
+    (void)user;
+
+    emcy_triggers += 1;
+}
+
+static void send_emcy(int endpoint, uint8 node_id, uint16 code, uint8 error_register)
+{
+    can_message_t message = {0};
+
+    message.id = 0x080 + node_id;
+    message.length = 8;
+    message.data[0] = (uint8)(code & 0xff);
+    message.data[1] = (uint8)(code >> 8);
+    message.data[2] = error_register;
+    message.data[3] = node_id;
+    message.data[4] = 0x22;
+    message.data[5] = 0x33;
+    message.data[6] = 0x44;
+    message.data[7] = 0x55;
+
+    assert_int_equal(vcan_write(endpoint, &message), ALL_OK);
+}
+
+static void on_lss_frame(const can_message_t* message, uint64 now, void* user)
+{
+    uint32 id_number;
+    uint32 i;
+
+    (void)now;
+    (void)user;
+
+    if (NULL == message)
+    {
+        return;
+    }
+
+    /* Configured slaves answer a read of the device type. */
+    for (i = 0; i < TEST_NMT_LSS_SLAVES; i++)
+    {
+        if ((0xff != lss_slaves[i].node_id) && ((0x600u + lss_slaves[i].node_id) == message->id))
+        {
+            can_message_t response = {0};
+
+            response.id = 0x580u + lss_slaves[i].node_id;
+            response.length = 8;
+            response.data[0] = 0x43;
+            response.data[1] = message->data[1];
+            response.data[2] = message->data[2];
+            response.data[3] = message->data[3];
+
+            vcan_write(lss_endpoint, &response);
+            return;
+        }
+    }
+
+    if ((LSS_MASTER_ID != message->id) || (8 != message->length))
+    {
+        return;
+    }
+
+    id_number = (uint32)message->data[1] | ((uint32)message->data[2] << 8) | ((uint32)message->data[3] << 16) | ((uint32)message->data[4] << 24);
+
+    for (i = 0; i < TEST_NMT_LSS_SLAVES; i++)
+    {
+        test_lss_slave_t* slave = &lss_slaves[i];
+
+        switch (message->data[0])
+        {
+            case LSS_SWITCH_MODE_GLOBAL:
+                slave->mode = message->data[1];
+                if ((LSS_MODE_WAITING == slave->mode) && (0xff == slave->node_id))
+                {
+                    slave->node_id = slave->pending_node_id;
+                }
+                break;
+            case LSS_FASTSCAN:
+            {
+                uint8 bit_checked = message->data[5];
+
+                if ((LSS_MODE_WAITING != slave->mode) || (0xff != slave->node_id))
+                {
+                    break;
+                }
+
+                if (0x80 == bit_checked)
+                {
+                    slave->sub = 0;
+                    send_lss_response(LSS_IDENTIFY_SLAVE, 0);
+                }
+                else if ((message->data[6] == slave->sub) && (0 == ((slave->identity[slave->sub] ^ id_number) >> bit_checked)))
+                {
+                    send_lss_response(LSS_IDENTIFY_SLAVE, 0);
+
+                    if ((0 == bit_checked) && (3 == slave->sub) && (0 == message->data[7]))
+                    {
+                        slave->mode = LSS_MODE_CONFIGURATION;
+                    }
+                    slave->sub = message->data[7];
+                }
+                break;
+            }
+            case LSS_CONFIGURE_NODE_ID:
+            case LSS_STORE_CONFIGURATION:
+                if (LSS_MODE_CONFIGURATION == slave->mode)
+                {
+                    if (LSS_CONFIGURE_NODE_ID == message->data[0])
+                    {
+                        slave->pending_node_id = message->data[1];
+                    }
+                    send_lss_response(message->data[0], 0);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void send_lss_response(uint8 command, uint8 value)
+{
+    can_message_t message = {0};
+
+    message.id = LSS_SLAVE_ID;
+    message.length = 8;
+    message.data[0] = command;
+    message.data[1] = value;
+
+    vcan_write(lss_endpoint, &message);
+}
+
+static void run_bus(uint32 duration_ms)
+{
+    can_message_t message;
+    uint32 i;
+
+    for (i = 0; i < duration_ms; i++)
+    {
+        os_delay(1);
+        while (ALL_OK == vcan_read(VCAN_HOST, &message))
+        {
+            /* Only keep the bus moving. */
+        }
+    }
+}
@@ -10,7 +10,13 @@
 #ifndef TEST_NMT_H
 #define TEST_NMT_H
 
+void test_nmt_confirmed(void** state);
+void test_nmt_emcy(void** state);
+void test_nmt_heartbeat(void** state);
+void test_nmt_lss(void** state);
+void test_nmt_node_guarding(void** state);
 void test_nmt_print_help(void** state);
+void test_nmt_scan(void** state);
 void test_nmt_send_command_invalid(void** state);
 
 #endif /* TEST_NMT_H */
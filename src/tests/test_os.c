@@ -922,6 +922,55 @@ void test_os_add_remove_timer(void** state)
     assert_false(os_remove_timer(id));
 }
 
+static uint64 timer_periodic_cb(void* userdata, os_timer_id id, uint64 interval)
+{
+    int* count = (int*)userdata;
+    (void)id;
+    *count += 1;
+    return interval;
+}
+
+void test_os_virtual_time(void** state)
+{
+    os_timer_id id;
+    uint64 start;
+    int count = 0;
+
+    (void)state;
+
+    os_set_virtual_time(true);
+    assert_true(os_is_virtual_time());
+
+    /* Delays advance the clock instantly and exactly. */
+    start = os_get_ticks();
+    os_delay(1000);
+    assert_true(os_get_ticks() == start + 1000000000ULL);
+
+    /* Timers fire on virtual time. */
+    id = os_add_timer(10000000ULL, timer_periodic_cb, &count);
+    assert_true(0 != (id & OS_VIRTUAL_TIMER_ID));
+    os_delay(100);
+    assert_int_equal(count, 10);
+    assert_true(os_remove_timer(id));
+    os_delay(100);
+    assert_int_equal(count, 10);
+
+    /* Idle skips ahead to the next scheduled event. */
+    start = os_get_ticks();
+    os_schedule_wake_up(start + 250000ULL);
+    os_idle();
+    assert_true(os_get_ticks() == start + 250000ULL);
+
+    id = os_add_timer(500000ULL, timer_periodic_cb, &count);
+    os_idle();
+    assert_int_equal(count, 11);
+    assert_true(os_get_ticks() == start + 750000ULL);
+    assert_true(os_remove_timer(id));
+
+    os_set_virtual_time(false);
+    assert_false(os_is_virtual_time());
+}
+
 static int noop_thread_fn(void* data)
 {
     (void)data;
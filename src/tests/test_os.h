@@ -74,6 +74,7 @@ void test_os_print_prompt(void** state);
 void test_os_key_is_hit(void** state);
 void test_os_clear_window(void** state);
 void test_os_add_remove_timer(void** state);
+void test_os_virtual_time(void** state);
 void test_os_create_detach_thread(void** state);
 
 #endif /* TEST_OS_H */
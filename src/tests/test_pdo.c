@@ -13,14 +13,24 @@
 #include <stdint.h>
 
 #include "cmocka.h"
+#include "os.h"
 #include "pdo.h"
+#include "pdo_map.h"
+#include "sdo.h"
+#include "sync.h"
+#include "test_bus.h"
 #include "test_pdo.h"
+#include "vcan.h"
+
+#define TEST_PDO_COUNT 200
+#define TEST_PDO_PERIOD_MS 10
+#define TEST_PDO_NODE_ID 0x22
 
 void test_pdo_print_help(void** state)
 {
-    (void)state;
+	(void)state;
 
-    assert_true(pdo_print_help() == ALL_OK);
+	assert_true(pdo_print_help() == ALL_OK);
 }
 
 void test_pdo_is_id_valid(void** state)
@@ -65,3 +75,341 @@ void test_pdo_is_id_valid(void** state)
 	assert_false(pdo_is_id_valid(0x080));
 	assert_false(pdo_is_id_valid(0x17f));
 }
+
+void test_pdo_slots(void** state)
+{
+	pdo_stats_t stats;
+	uint16 can_id;
+	uint16 last_id = 0;
+	uint32 count = 0;
+
+	(void)state;
+
+	os_set_virtual_time(true);
+
+	assert_false(pdo_add(0x181, 0, 8, 0, SILENT));
+	assert_true(pdo_add(0x181, 100, 8, 0x1122334455667788, SILENT));
+	assert_true(pdo_add(0x181, 50, 2, 0x1122, SILENT));
+	assert_int_equal(pdo_get_stats(0x181, &stats), ALL_OK);
+
+	assert_true(pdo_del(0x181, SILENT));
+	assert_int_equal(pdo_get_stats(0x181, &stats), ITEM_NOT_FOUND);
+	assert_int_equal(pdo_get_stats(0, &stats), ALL_OK);
+	assert_int_equal(stats.sent, 0);
+
+	for (can_id = 0; (can_id <= PDO_ID_MAX) && (count < PDO_MAX); can_id++)
+	{
+		if (true == pdo_is_id_valid(can_id))
+		{
+			assert_true(pdo_add(can_id, 100, 8, can_id, SILENT));
+			last_id = can_id;
+			count += 1;
+		}
+	}
+	assert_int_equal(count, PDO_MAX);
+
+	/* Replacing a PDO doesn't take a second slot. */
+	assert_true(pdo_add(last_id, 50, 2, 0x1122, SILENT));
+
+	while ((can_id <= PDO_ID_MAX) && (false == pdo_is_id_valid(can_id)))
+	{
+		can_id++;
+	}
+	assert_true(can_id <= PDO_ID_MAX);
+	assert_false(pdo_add(can_id, 100, 8, 0, SILENT));
+	assert_int_equal(pdo_get_stats(can_id, &stats), ITEM_NOT_FOUND);
+
+	pdo_del_all();
+	assert_true(pdo_add(can_id, 100, 8, 0, SILENT));
+
+	pdo_del_all();
+	os_set_virtual_time(false);
+}
+
+void test_pdo_timer_wheel(void** state)
+{
+	can_message_t message;
+	pdo_stats_t stats;
+	uint32 per_tick[TEST_PDO_PERIOD_MS * 100] = {0};
+	uint32 received = 0;
+	uint32 max_per_tick = 0;
+	uint64 start_us;
+	uint16 can_id;
+	int endpoint;
+	int i;
+
+	(void)state;
+
+	test_bus_setup(0, 0);
+	endpoint = vcan_attach(NULL, NULL);
+
+	start_us = os_get_ticks() / 1000u;
+
+	for (i = 0; i < TEST_PDO_COUNT; i++)
+	{
+		can_id = (uint16)((i < 0x7f) ? (0x181 + i) : (0x281 + i - 0x7f));
+		assert_true(pdo_add(can_id, TEST_PDO_PERIOD_MS, 2, (uint64)i, SILENT));
+	}
+
+	/* One second of transmissions, 100 per PDO. */
+	for (i = 0; i < 100; i++)
+	{
+		os_delay(TEST_PDO_PERIOD_MS);
+
+		while (ALL_OK == vcan_read(endpoint, &message))
+		{
+			uint64 tick = (message.timestamp_us - start_us) / 1000u;
+
+			if (tick < (sizeof(per_tick) / sizeof(per_tick[0])))
+			{
+				per_tick[tick] += 1;
+			}
+			received += 1;
+		}
+	}
+
+	assert_int_equal(pdo_get_stats(0, &stats), ALL_OK);
+	assert_int_equal(stats.sent, received);
+	assert_int_equal(stats.missed, 0);
+	assert_true(received >= (TEST_PDO_COUNT * 99));
+	assert_true(stats.jitter_max_ns <= PDO_TICK_IN_NS);
+
+	/* PDOs with the same event time are spread over the period. */
+	for (i = 0; i < (int)(sizeof(per_tick) / sizeof(per_tick[0])); i++)
+	{
+		if (per_tick[i] > max_per_tick)
+		{
+			max_per_tick = per_tick[i];
+		}
+	}
+	assert_true(max_per_tick <= (TEST_PDO_COUNT / TEST_PDO_PERIOD_MS));
+
+	assert_int_equal(pdo_get_stats(0x181, &stats), ALL_OK);
+	assert_true(stats.sent >= 99);
+
+	pdo_del_all();
+	vcan_read(endpoint, &message);
+	assert_int_equal(pdo_get_stats(0, &stats), ALL_OK);
+	assert_int_equal(stats.sent, 0);
+
+	vcan_detach(endpoint);
+	test_bus_teardown();
+}
+
+void test_pdo_update(void** state)
+{
+	can_message_t message;
+	uint64 last_us = 0;
+	uint32 received = 0;
+	uint32 updated = 0;
+	int endpoint;
+	int i;
+
+	(void)state;
+
+	test_bus_setup(0, 0);
+	endpoint = vcan_attach(NULL, NULL);
+
+	assert_false(pdo_update(0x181, 0x0102, SILENT));
+	assert_true(pdo_add(0x181, TEST_PDO_PERIOD_MS, 2, 0x0102, SILENT));
+
+	for (i = 0; i < 20; i++)
+	{
+		/* Change the payload between every transmission. */
+		assert_true(pdo_update(0x181, (uint64)i, SILENT));
+		os_delay(TEST_PDO_PERIOD_MS);
+
+		while (ALL_OK == vcan_read(endpoint, &message))
+		{
+			assert_int_equal(message.id, 0x181);
+			assert_int_equal(message.length, 2);
+
+			/* The schedule is not touched by the updates. */
+			if (0 != last_us)
+			{
+				assert_int_equal(message.timestamp_us - last_us, TEST_PDO_PERIOD_MS * 1000u);
+			}
+			last_us = message.timestamp_us;
+
+			if ((uint8)i == message.data[1])
+			{
+				updated += 1;
+			}
+			received += 1;
+		}
+	}
+
+	assert_true(received >= 19);
+	assert_int_equal(updated, received);
+
+	pdo_del_all();
+	assert_false(pdo_update(0x181, 0, SILENT));
+
+	vcan_detach(endpoint);
+	test_bus_teardown();
+}
+
+void test_pdo_map(void** state)
+{
+	can_message_t message = {0};
+	pdo_map_field_t fields[PDO_MAP_FIELD_MAX];
+	pdo_map_field_t field;
+	uint32 value;
+	uint32 received = 0;
+	int i;
+
+	(void)state;
+
+	assert_int_equal(test_bus_setup(TEST_PDO_NODE_ID, 1), ALL_OK);
+
+	/* TPDO1: error register and heartbeat time, sent every 10 ms. */
+	value = 0x4321;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1017, 0x00, 2, &value, NULL), IS_WRITE_EXPEDITED);
+	value = 0;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1a00, 0x00, 1, &value, NULL), IS_WRITE_EXPEDITED);
+	value = 0x10010008;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1a00, 0x01, 4, &value, NULL), IS_WRITE_EXPEDITED);
+	value = 0x10170010;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1a00, 0x02, 4, &value, NULL), IS_WRITE_EXPEDITED);
+	value = 2;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1a00, 0x00, 1, &value, NULL), IS_WRITE_EXPEDITED);
+	value = 0x180 + TEST_PDO_NODE_ID;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1800, 0x01, 4, &value, NULL), IS_WRITE_EXPEDITED);
+	value = TEST_PDO_PERIOD_MS;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1800, 0x05, 2, &value, NULL), IS_WRITE_EXPEDITED);
+
+	assert_int_equal(pdo_map_discover(TEST_PDO_NODE_ID, SILENT), 1);
+	assert_int_equal(pdo_map_get_fields(0x180 + TEST_PDO_NODE_ID, fields, PDO_MAP_FIELD_MAX), 2);
+	assert_int_equal(fields[0].index, 0x1001);
+	assert_int_equal(fields[0].bit_length, 8);
+	assert_int_equal(fields[1].index, 0x1017);
+	assert_int_equal(fields[1].bit_offset, 8);
+	assert_false(fields[1].is_valid);
+
+	/* Start the node and decode what it sends. */
+	message.id = 0x000;
+	message.length = 2;
+	message.data[0] = 0x01;
+	message.data[1] = TEST_PDO_NODE_ID;
+	can_write(&message, SILENT, NULL);
+
+	for (i = 0; (i < 1000) && (received < 3); i++)
+	{
+		if ((ALL_OK == can_read(&message)) && ((0x180 + TEST_PDO_NODE_ID) == message.id))
+		{
+			received += 1;
+		}
+	}
+	assert_int_equal(received, 3);
+
+	assert_int_equal(pdo_map_get_field(TEST_PDO_NODE_ID, 0x1017, 0x00, &field), ALL_OK);
+	assert_true(field.is_valid);
+	assert_int_equal(field.value, 0x4321);
+	assert_int_equal(pdo_map_get_field(TEST_PDO_NODE_ID, 0x1018, 0x01, &field), ITEM_NOT_FOUND);
+
+	pdo_map_clear(TEST_PDO_NODE_ID);
+	assert_int_equal(pdo_map_get_fields(0x180 + TEST_PDO_NODE_ID, fields, PDO_MAP_FIELD_MAX), 0);
+
+	test_bus_teardown();
+}
+
+void test_pdo_sync(void** state)
+{
+	can_message_t message = {0};
+	sync_stats_t stats;
+	uint32 value;
+	uint32 responses = 0;
+	uint32 syncs = 0;
+	uint8 counter = 0;
+	bool expect_rpdo = false;
+	int endpoint;
+	int i;
+
+	(void)state;
+
+	assert_int_equal(test_bus_setup(TEST_PDO_NODE_ID, 1), ALL_OK);
+
+	/* TPDO1: error register, sent on every SYNC. */
+	value = 0;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1a00, 0x00, 1, &value, NULL), IS_WRITE_EXPEDITED);
+	value = 0x10010008;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1a00, 0x01, 4, &value, NULL), IS_WRITE_EXPEDITED);
+	value = 1;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1a00, 0x00, 1, &value, NULL), IS_WRITE_EXPEDITED);
+	value = 0x180 + TEST_PDO_NODE_ID;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1800, 0x01, 4, &value, NULL), IS_WRITE_EXPEDITED);
+	value = 1;
+	assert_int_equal(sdo_write(&message, SILENT, TEST_PDO_NODE_ID, 0x1800, 0x02, 1, &value, NULL), IS_WRITE_EXPEDITED);
+
+	message.id = 0x000;
+	message.length = 2;
+	message.data[0] = 0x01;
+	message.data[1] = TEST_PDO_NODE_ID;
+	can_write(&message, SILENT, NULL);
+
+	endpoint = vcan_attach(NULL, NULL);
+
+	assert_int_equal(sync_start(SYNC_PERIOD_MIN_US - 1, 0, 0), OS_INVALID_ARGUMENT);
+	assert_int_equal(sync_start(1000, 1, 0), OS_INVALID_ARGUMENT);
+	assert_int_equal(sync_start(1000, SYNC_COUNTER_MAX + 1, 0), OS_INVALID_ARGUMENT);
+
+	assert_int_equal(sync_add_rpdo(0x200 + TEST_PDO_NODE_ID, 2, 0x1234), ALL_OK);
+	assert_int_equal(sync_start(1000, 4, 0), ALL_OK);
+	assert_true(sync_is_running());
+
+	for (i = 0; (i < 10000) && (responses < 10); i++)
+	{
+		if ((ALL_OK == can_read(&message)) && ((0x180 + TEST_PDO_NODE_ID) == message.id))
+		{
+			responses += 1;
+		}
+	}
+	assert_int_equal(responses, 10);
+
+	sync_stop();
+	assert_false(sync_is_running());
+
+	/* Every SYNC carries the next counter value and is followed by the RPDO. */
+	while (ALL_OK == vcan_read(endpoint, &message))
+	{
+		if (SYNC_DEFAULT_COB_ID == message.id)
+		{
+			assert_false(expect_rpdo);
+			assert_int_equal(message.length, 1);
+			assert_int_equal(message.data[0], (counter % 4) + 1);
+
+			counter = message.data[0];
+			expect_rpdo = true;
+			syncs += 1;
+		}
+		else if ((0x200 + TEST_PDO_NODE_ID) == message.id)
+		{
+			assert_true(expect_rpdo);
+			assert_int_equal(message.data[0], 0x12);
+			assert_int_equal(message.data[1], 0x34);
+
+			expect_rpdo = false;
+		}
+	}
+	assert_true(syncs >= 10);
+
+	assert_int_equal(sync_get_stats(0, &stats), ALL_OK);
+	assert_int_equal(stats.count, syncs);
+	assert_int_equal(stats.missed, 0);
+	assert_int_equal(stats.jitter_max_ns, 0);
+
+	/* The first response only sets the reference. */
+	assert_int_equal(sync_get_stats(TEST_PDO_NODE_ID, &stats), ALL_OK);
+	assert_int_equal(stats.count, 9);
+	assert_int_equal(stats.missed, 0);
+	assert_int_equal(stats.jitter_max_ns, 0);
+
+	os_delay(10);
+	assert_int_not_equal(vcan_read(endpoint, &message), ALL_OK);
+
+	assert_int_equal(sync_del_rpdo(0x200 + TEST_PDO_NODE_ID), ALL_OK);
+	assert_int_equal(sync_del_rpdo(0x200 + TEST_PDO_NODE_ID), ITEM_NOT_FOUND);
+
+	vcan_detach(endpoint);
+	test_bus_teardown();
+}
@@ -11,6 +11,11 @@
 #define TEST_PDO_H
 
 void test_pdo_is_id_valid(void** state);
+void test_pdo_map(void** state);
 void test_pdo_print_help(void** state);
+void test_pdo_slots(void** state);
+void test_pdo_sync(void** state);
+void test_pdo_timer_wheel(void** state);
+void test_pdo_update(void** state);
 
 #endif /* TEST_PDO_H */
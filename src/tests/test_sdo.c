@@ -14,6 +14,8 @@
 
 #include "cmocka.h"
 #include "sdo.h"
+#include "sdo_cache.h"
+#include "sdo_stats.h"
 #include "test_sdo.h"
 
 void test_sdo_lookup_abort_code(void** state)
@@ -53,3 +55,217 @@ void test_sdo_lookup_abort_code(void** state)
     assert_string_equal(sdo_lookup_abort_code(ABORT_NO_DATA_AVAILABLE), "No data available");
     assert_string_equal(sdo_lookup_abort_code(0x12345678), "Unknown abort code");
 }
+
+void test_sdo_select_write_mode(void** state)
+{
+    uint32 length;
+    sdo_node_caps_t caps;
+
+    (void)state;
+
+    sdo_reset_node_caps();
+
+    length = 0;
+    assert_int_equal(sdo_select_write_mode(0x01, 0x2000, 0x00, &length), IS_WRITE_EXPEDITED);
+    assert_int_equal(length, 4);
+
+    length = 2;
+    assert_int_equal(sdo_select_write_mode(0x01, 0x2000, 0x00, &length), IS_WRITE_EXPEDITED);
+    assert_int_equal(length, 2);
+
+    length = 20;
+    assert_int_equal(sdo_select_write_mode(0x01, 0x2000, 0x00, &length), IS_WRITE_SEGMENTED);
+
+    length = 1024;
+    assert_int_equal(sdo_select_write_mode(0x01, 0x2000, 0x00, &length), IS_WRITE_BLOCK);
+
+    assert_int_equal(sdo_select_write_mode(0x01, 0x2000, 0x00, NULL), ABORT_TRANSFER);
+
+    sdo_get_node_caps(0x01, &caps);
+    assert_false(caps.is_block_probed);
+    assert_false(caps.is_block_supported);
+}
+
+void test_sdo_transfer_write_block_fallback(void** state)
+{
+    can_message_t sdo_response = {0};
+    uint8 data[64] = {0};
+    uint32 length = sizeof(data);
+    sdo_node_caps_t caps;
+
+    (void)state;
+
+    sdo_reset_node_caps();
+
+    /* No device answers: a timed-out probe leaves the node unprobed, so
+     * block transfer is tried again on the next download.
+     */
+    assert_int_equal(sdo_transfer_write(&sdo_response, SILENT, 0x02, 0x2000, 0x00, sizeof(data), data, NULL), ABORT_TRANSFER);
+
+    sdo_get_node_caps(0x02, &caps);
+    assert_false(caps.is_block_probed);
+    assert_false(caps.is_block_supported);
+    assert_int_equal(sdo_select_write_mode(0x02, 0x2000, 0x00, &length), IS_WRITE_BLOCK);
+
+    sdo_reset_node_caps();
+}
+
+void test_sdo_set_channel(void** state)
+{
+    sdo_channel_t sdo_channel;
+
+    (void)state;
+
+    assert_int_equal(sdo_get_channel(0x03, 0, &sdo_channel), ALL_OK);
+    assert_int_equal(sdo_channel.request_id, 0x603);
+    assert_int_equal(sdo_channel.response_id, 0x583);
+    assert_int_equal(sdo_get_channel(0x03, 1, &sdo_channel), ITEM_NOT_FOUND);
+    assert_int_equal(sdo_get_channel_count(0x03), 1);
+
+    assert_int_equal(sdo_set_channel(0x03, 1, 0x640, 0x5c0), ALL_OK);
+    assert_int_equal(sdo_set_channel(0x03, 2, 0x641, 0x5c1), ALL_OK);
+    assert_int_equal(sdo_get_channel_count(0x03), 3);
+    assert_int_equal(sdo_get_channel(0x03, 2, &sdo_channel), ALL_OK);
+    assert_int_equal(sdo_channel.request_id, 0x641);
+    assert_int_equal(sdo_channel.response_id, 0x5c1);
+
+    assert_int_equal(sdo_set_channel(0x03, SDO_CHANNEL_MAX, 0x642, 0x5c2), OS_INVALID_ARGUMENT);
+    assert_int_equal(sdo_set_channel(0x03, 3, 0x20000000, 0x5c2), OS_INVALID_ARGUMENT);
+    assert_int_equal(sdo_get_channel(0x03, 0, NULL), OS_INVALID_ARGUMENT);
+
+    assert_int_equal(sdo_set_channel(0x03, 1, 0, 0), ALL_OK);
+    assert_int_equal(sdo_set_channel(0x03, 2, 0, 0), ALL_OK);
+    assert_int_equal(sdo_get_channel_count(0x03), 1);
+}
+
+void test_sdo_set_usdo(void** state)
+{
+    can_message_t sdo_response = {0};
+    uint8 data[100] = {0};
+    sdo_node_caps_t caps;
+
+    (void)state;
+
+    sdo_reset_node_caps();
+
+    sdo_set_usdo(0x00, true);
+    sdo_set_usdo(0x04, true);
+    sdo_get_node_caps(0x04, &caps);
+    assert_true(caps.is_usdo);
+
+    /* Broadcast downloads are unconfirmed, uploads are rejected. */
+    assert_int_equal(sdo_transfer_write(&sdo_response, SILENT, USDO_BROADCAST_ID, 0x2000, 0x00, sizeof(data), data, NULL), IS_WRITE_SEGMENTED);
+    assert_int_equal(sdo_transfer_read(&sdo_response, SILENT, USDO_BROADCAST_ID, 0x2000, 0x00, NULL), ABORT_TRANSFER);
+
+    /* No device answers. */
+    assert_int_equal(sdo_transfer_write(&sdo_response, SILENT, 0x04, 0x2000, 0x00, sizeof(data), data, NULL), ABORT_TRANSFER);
+
+    sdo_set_usdo(0x04, false);
+    sdo_get_node_caps(0x04, &caps);
+    assert_false(caps.is_usdo);
+
+    sdo_reset_node_caps();
+}
+
+void test_sdo_stats_latency(void** state)
+{
+    sdo_stats_t stats;
+    uint32 i;
+
+    (void)state;
+
+    sdo_stats_reset();
+
+    for (i = 0; i < 99; i += 1)
+    {
+        sdo_stats_add_latency(0x05, IS_READ_EXPEDITED, 1000000u); /* 1 ms */
+    }
+    sdo_stats_add_latency(0x05, IS_READ_EXPEDITED, 50000000u); /* 50 ms */
+    sdo_stats_add_transfer(0x05, IS_READ_EXPEDITED, 4000, 1000000000u);
+
+    assert_int_equal(sdo_stats_get(0x05, IS_READ_EXPEDITED, &stats), ALL_OK);
+    assert_int_equal(stats.samples, 100);
+    assert_int_equal(stats.min_ns, 1000000u);
+    assert_int_equal(stats.max_ns, 50000000u);
+
+    /* Bucket resolution is 25%. */
+    assert_in_range(sdo_stats_get_percentile(&stats, 50.f), 1000000u, 1250000u);
+    assert_in_range(sdo_stats_get_percentile(&stats, 99.f), 1000000u, 1250000u);
+    assert_int_equal(sdo_stats_get_percentile(&stats, 100.f), 50000000u);
+    assert_int_equal(sdo_stats_get_throughput(&stats), 4000);
+
+    assert_int_equal(sdo_stats_get(0x05, ABORT_TRANSFER, &stats), OS_INVALID_ARGUMENT);
+
+    sdo_stats_reset();
+    assert_int_equal(sdo_stats_get(0x05, IS_READ_EXPEDITED, &stats), ALL_OK);
+    assert_true(sdo_stats_is_empty(&stats));
+}
+
+void test_sdo_stats_failures(void** state)
+{
+    can_message_t sdo_response = {0};
+    uint32 data = 0x1234;
+    sdo_stats_t stats;
+
+    (void)state;
+
+    sdo_stats_reset();
+
+    /* No device answers. */
+    assert_int_equal(sdo_write(&sdo_response, SILENT, 0x06, 0x2000, 0x00, sizeof(data), &data, NULL), ABORT_TRANSFER);
+
+    sdo_stats_add_abort(0x06, IS_WRITE_EXPEDITED, ABORT_OBJECT_DOES_NOT_EXIST);
+    sdo_stats_add_abort(0x06, IS_WRITE_EXPEDITED, ABORT_OBJECT_DOES_NOT_EXIST);
+    sdo_stats_add_retry(0x06, IS_WRITE_EXPEDITED);
+
+    assert_int_equal(sdo_stats_get(0x06, IS_WRITE_EXPEDITED, &stats), ALL_OK);
+    assert_int_equal(stats.timeouts, 1);
+    assert_int_equal(stats.transfers, 0);
+    assert_int_equal(stats.aborts, 2);
+    assert_int_equal(stats.retries, 1);
+    assert_int_equal(stats.abort_codes[0].abort_code, ABORT_OBJECT_DOES_NOT_EXIST);
+    assert_int_equal(stats.abort_codes[0].count, 2);
+    assert_int_equal(stats.abort_codes[1].count, 0);
+
+    sdo_stats_reset();
+}
+
+void test_sdo_cache(void** state)
+{
+    can_message_t sdo_response = {0};
+    sdo_cache_info_t info;
+    sdo_state_t sdo_state;
+    uint32 data = 0x12345678;
+
+    (void)state;
+
+    sdo_response.length = sizeof(data);
+    os_memcpy(sdo_response.data, &data, sizeof(data));
+
+    /* Disabled by default. */
+    assert_false(sdo_cache_is_enabled(0x07));
+    sdo_cache_store(0x07, 0x1000, 0x00, IS_READ_EXPEDITED, &sdo_response);
+    assert_false(sdo_cache_lookup(0x07, 0x1000, 0x00, &sdo_response, &sdo_state));
+
+    sdo_cache_enable(0x07, true);
+    assert_true(sdo_cache_is_enabled(0x07));
+    assert_false(sdo_cache_is_enabled(0x08));
+
+    /* Without an object dictionary the access type is unknown: never cached. */
+    sdo_cache_store(0x07, 0x1000, 0x00, IS_READ_EXPEDITED, &sdo_response);
+    sdo_cache_update(0x07, 0x1000, 0x00, sizeof(data), &data);
+    assert_false(sdo_cache_lookup(0x07, 0x1000, 0x00, &sdo_response, &sdo_state));
+
+    /* Failed transfers are never cached. */
+    sdo_cache_store(0x07, 0x1000, 0x00, ABORT_TRANSFER, &sdo_response);
+
+    sdo_cache_get_info(0x07, &info);
+    assert_true(info.is_enabled);
+    assert_int_equal(info.entries, 0);
+    assert_int_equal(info.hits, 0);
+    assert_int_equal(info.misses, 1);
+
+    sdo_cache_invalidate(0);
+    sdo_cache_enable(0, false);
+    assert_false(sdo_cache_is_enabled(0x07));
+}
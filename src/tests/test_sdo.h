@@ -11,5 +11,12 @@
 #define TEST_SDO_H
 
 void test_sdo_lookup_abort_code(void** state);
+void test_sdo_select_write_mode(void** state);
+void test_sdo_transfer_write_block_fallback(void** state);
+void test_sdo_set_channel(void** state);
+void test_sdo_set_usdo(void** state);
+void test_sdo_stats_latency(void** state);
+void test_sdo_stats_failures(void** state);
+void test_sdo_cache(void** state);
 
 #endif /* TEST_SDO_H */
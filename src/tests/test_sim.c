@@ -0,0 +1,175 @@
+/** @file test_sim.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cmocka.h"
+#include "eds.h"
+#include "os.h"
+#include "sdo.h"
+#include "sim.h"
+#include "test_sim.h"
+#include "vcan.h"
+
+#define TEST_SIM_EDS "eds/DS301_profile.eds"
+#define TEST_SIM_NODE_ID 0x10
+
+static void send_request(uint32 id, uint8 d0, uint8 d1, uint8 d2, uint8 d3, uint32 value)
+{
+    can_message_t message = {0};
+
+    message.id = id;
+    message.length = 8;
+    message.data[0] = d0;
+    message.data[1] = d1;
+    message.data[2] = d2;
+    message.data[3] = d3;
+    message.data[4] = (uint8)(value & 0xff);
+    message.data[5] = (uint8)((value >> 8) & 0xff);
+    message.data[6] = (uint8)((value >> 16) & 0xff);
+    message.data[7] = (uint8)((value >> 24) & 0xff);
+
+    vcan_write(VCAN_HOST, &message);
+}
+
+static uint32 get_value(const can_message_t* message)
+{
+    return (uint32)message->data[4] | ((uint32)message->data[5] << 8) | ((uint32)message->data[6] << 16) | ((uint32)message->data[7] << 24);
+}
+
+void test_sim_add_nodes_invalid(void** state)
+{
+    (void)state;
+
+    assert_int_equal(sim_add_nodes(0x00, 1, TEST_SIM_EDS), OS_INVALID_ARGUMENT);
+    assert_int_equal(sim_add_nodes(0x7f, 2, TEST_SIM_EDS), OS_INVALID_ARGUMENT);
+    assert_int_equal(sim_add_nodes(0x01, 1, "does_not_exist.eds"), EDS_PARSE_ERROR);
+    assert_false(sim_is_running());
+}
+
+void test_sim_eds_sections(void** state)
+{
+    eds_t eds = {0};
+    uint32 var_count = 0;
+    uint32 sub_count = 0;
+    uint16 i;
+
+    (void)state;
+
+    assert_int_equal(eds_load(TEST_SIM_EDS, &eds), ALL_OK);
+
+    /* The simulator serves plain VAR objects, the conformance test
+     * only checks [XXXXsubY] sections.
+     */
+    for (i = 0; i < eds.num_entries; i++)
+    {
+        const eds_entry_t* entry = &eds.entries[i];
+
+        if ((0x1000 == entry->Index) && (0x00 == entry->SubIndex))
+        {
+            assert_false(entry->IsSubSection);
+            assert_int_equal(entry->ObjectType, 0x07);
+            var_count += 1;
+        }
+        else if (0x1018 == entry->Index)
+        {
+            /* [1018] and [1018sub0] share one entry. */
+            assert_true(entry->IsSubSection);
+            assert_int_equal(entry->ObjectType, 0x07);
+            sub_count += 1;
+        }
+    }
+
+    assert_int_equal(var_count, 1);
+    assert_int_equal(sub_count, 5);
+
+    eds_free(&eds);
+}
+
+void test_sim_sdo_server(void** state)
+{
+    can_message_t message = {0};
+    uint32 request_id = 0x600 + TEST_SIM_NODE_ID;
+
+    (void)state;
+
+    assert_int_equal(sim_add_nodes(TEST_SIM_NODE_ID, 1, TEST_SIM_EDS), ALL_OK);
+
+    assert_true(sim_is_running());
+
+    /* Boot-up. */
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(message.id, 0x700 + TEST_SIM_NODE_ID);
+    assert_int_equal(message.data[0], 0x00);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), CAN_READ_ERROR);
+
+    /* Expedited upload of a $NODEID relative default. */
+    send_request(request_id, 0x40, 0x00, 0x18, 0x01, 0);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(message.id, 0x580 + TEST_SIM_NODE_ID);
+    assert_int_equal(message.data[0], 0x43);
+    assert_int_equal(get_value(&message), 0xc0000180 + TEST_SIM_NODE_ID);
+
+    /* Expedited download and read-back. */
+    send_request(request_id, 0x2b, 0x17, 0x10, 0x00, 500);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(message.data[0], 0x60);
+
+    send_request(request_id, 0x40, 0x17, 0x10, 0x00, 0);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(message.data[0], 0x4b);
+    assert_int_equal(get_value(&message), 500);
+
+    /* Read-only and missing objects abort. */
+    send_request(request_id, 0x23, 0x00, 0x10, 0x00, 0);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(message.data[0], 0x80);
+    assert_int_equal(get_value(&message), ABORT_ATTEMPT_TO_WRITE_READ_ONLY);
+
+    send_request(request_id, 0x40, 0x34, 0x12, 0x00, 0);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(message.data[0], 0x80);
+    assert_int_equal(get_value(&message), ABORT_OBJECT_DOES_NOT_EXIST);
+
+    sim_stop();
+    assert_false(sim_is_running());
+}
+
+void test_sim_nmt(void** state)
+{
+    can_message_t message = {0};
+
+    (void)state;
+
+    assert_int_equal(sim_add_nodes(TEST_SIM_NODE_ID, 2, TEST_SIM_EDS), ALL_OK);
+
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+
+    /* Stopped nodes do not answer SDO requests. */
+    send_request(0x000, 0x02, TEST_SIM_NODE_ID, 0x00, 0x00, 0);
+    send_request(0x600 + TEST_SIM_NODE_ID, 0x40, 0x00, 0x10, 0x00, 0);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), CAN_READ_ERROR);
+
+    /* Reset communication on all nodes. */
+    send_request(0x000, 0x82, 0x00, 0x00, 0x00, 0);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(message.id, 0x700 + TEST_SIM_NODE_ID);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(message.id, 0x700 + TEST_SIM_NODE_ID + 1);
+
+    send_request(0x600 + TEST_SIM_NODE_ID, 0x40, 0x00, 0x10, 0x00, 0);
+    assert_int_equal(vcan_read(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(message.data[0], 0x43);
+
+    sim_stop();
+}
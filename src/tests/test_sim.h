@@ -0,0 +1,18 @@
+/** @file test_sim.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef TEST_SIM_H
+#define TEST_SIM_H
+
+void test_sim_add_nodes_invalid(void** state);
+void test_sim_eds_sections(void** state);
+void test_sim_sdo_server(void** state);
+void test_sim_nmt(void** state);
+
+#endif /* TEST_SIM_H */
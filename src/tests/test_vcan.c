@@ -0,0 +1,248 @@
+/** @file test_vcan.c
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cmocka.h"
+#include "os.h"
+#include "sdo.h"
+#include "sim.h"
+#include "test_vcan.h"
+#include "vcan.h"
+
+static can_message_t get_message(uint32 id, uint32 length)
+{
+    can_message_t message = {0};
+    uint32 i;
+
+    message.id = id;
+    message.length = length;
+
+    for (i = 0; i < length; i++)
+    {
+        message.data[i] = (uint8)i;
+    }
+
+    return message;
+}
+
+void test_vcan_endpoints(void** state)
+{
+    can_message_t message = get_message(0x123, 8);
+    can_message_t received;
+    vcan_info_t info;
+    int endpoint;
+
+    (void)state;
+
+    assert_false(vcan_is_open());
+    assert_int_equal(vcan_write(VCAN_HOST, &message), CAN_WRITE_ERROR);
+    assert_int_equal(vcan_init(NULL), ALL_OK);
+    assert_true(vcan_is_open());
+
+    endpoint = vcan_attach(NULL, NULL);
+    assert_true(endpoint > VCAN_HOST);
+
+    /* Frames reach every endpoint but the sender. */
+    assert_int_equal(vcan_write(VCAN_HOST, &message), ALL_OK);
+    assert_int_equal(vcan_read(VCAN_HOST, &received), CAN_READ_ERROR);
+    assert_int_equal(vcan_read(endpoint, &received), ALL_OK);
+    assert_int_equal(received.id, 0x123);
+    assert_int_equal(received.length, 8);
+    assert_memory_equal(received.data, message.data, 8);
+
+    message.id = 0x321;
+    assert_int_equal(vcan_write(endpoint, &message), ALL_OK);
+    assert_int_equal(vcan_read(VCAN_HOST, &received), ALL_OK);
+    assert_int_equal(received.id, 0x321);
+
+    vcan_get_info(&info);
+    assert_int_equal(info.endpoints, 2);
+    assert_int_equal(info.frames_sent, 2);
+    assert_int_equal(info.frames_delivered, 2);
+
+    vcan_detach(endpoint);
+    vcan_deinit();
+    assert_false(vcan_is_open());
+}
+
+void test_vcan_options(void** state)
+{
+    vcan_config_t config;
+
+    (void)state;
+
+    assert_int_equal(vcan_init_from_string("latency=250,jitter=50,drop=0.5,bitrate=500000,load=30,seed=7"), ALL_OK);
+    vcan_get_config(&config);
+    assert_int_equal(config.latency_us, 250);
+    assert_int_equal(config.jitter_us, 50);
+    assert_true(config.drop_rate > 0.49f && config.drop_rate < 0.51f);
+    assert_int_equal(config.bit_rate, 500000);
+    assert_int_equal(config.load, 30);
+    assert_int_equal(config.seed, 7);
+    vcan_deinit();
+
+    assert_int_equal(vcan_init_from_string("load=100"), OS_INVALID_ARGUMENT);
+    assert_int_equal(vcan_init_from_string("speed=1"), OS_INVALID_ARGUMENT);
+    assert_int_equal(vcan_init_from_string("latency"), OS_INVALID_ARGUMENT);
+    assert_false(vcan_is_open());
+}
+
+void test_vcan_bit_rate(void** state)
+{
+    vcan_config_t config = {0};
+    can_message_t message = get_message(0x181, 8);
+    vcan_info_t info;
+
+    (void)state;
+
+    /* 8 data bytes, base frame: 135 bits worst case, 2 us per bit. */
+    config.bit_rate = 500000;
+    assert_int_equal(vcan_init(&config), ALL_OK);
+    assert_int_equal(vcan_write(VCAN_HOST, &message), ALL_OK);
+    vcan_get_info(&info);
+    assert_int_equal(info.bus_time_ns, 270000);
+    vcan_deinit();
+
+    /* Half of the bus is taken by background traffic. */
+    config.load = 50;
+    assert_int_equal(vcan_init(&config), ALL_OK);
+    assert_int_equal(vcan_write(VCAN_HOST, &message), ALL_OK);
+    vcan_get_info(&info);
+    assert_int_equal(info.bus_time_ns, 540000);
+    vcan_deinit();
+}
+
+void test_vcan_latency(void** state)
+{
+    vcan_config_t config = {0};
+    can_message_t message = get_message(0x201, 2);
+    can_message_t received;
+    uint64 last_timestamp = 0;
+    int endpoint;
+    int i;
+
+    (void)state;
+
+    config.latency_us = 20000;
+    config.jitter_us = 5000;
+    config.seed = 42;
+    assert_int_equal(vcan_init(&config), ALL_OK);
+    endpoint = vcan_attach(NULL, NULL);
+
+    for (i = 0; i < 10; i++)
+    {
+        message.data[0] = (uint8)i;
+        assert_int_equal(vcan_write(VCAN_HOST, &message), ALL_OK);
+    }
+
+    assert_int_equal(vcan_read(endpoint, &received), CAN_READ_ERROR);
+    os_delay(40);
+
+    /* Jitter never reorders frames. */
+    for (i = 0; i < 10; i++)
+    {
+        assert_int_equal(vcan_read(endpoint, &received), ALL_OK);
+        assert_int_equal(received.data[0], i);
+        assert_true(received.timestamp_us >= last_timestamp);
+        last_timestamp = received.timestamp_us;
+    }
+
+    vcan_detach(endpoint);
+    vcan_deinit();
+}
+
+void test_vcan_drop(void** state)
+{
+    vcan_config_t config = {0};
+    can_message_t message = get_message(0x301, 1);
+    can_message_t received;
+    vcan_info_t info;
+    int endpoint;
+    int i;
+
+    (void)state;
+
+    config.drop_rate = 100.f;
+    assert_int_equal(vcan_init(&config), ALL_OK);
+    endpoint = vcan_attach(NULL, NULL);
+
+    for (i = 0; i < 100; i++)
+    {
+        assert_int_equal(vcan_write(VCAN_HOST, &message), ALL_OK);
+    }
+
+    assert_int_equal(vcan_read(endpoint, &received), CAN_READ_ERROR);
+    vcan_get_info(&info);
+    assert_int_equal(info.frames_sent, 100);
+    assert_int_equal(info.frames_dropped, 100);
+
+    vcan_detach(endpoint);
+    vcan_deinit();
+}
+
+void test_vcan_sdo_read(void** state)
+{
+    vcan_config_t config = {0};
+    can_message_t sdo_response = {0};
+    uint32 heartbeat_time = 250;
+
+    (void)state;
+
+    /* sdo.c end-to-end against a simulated node on a 500 kBit/s bus. */
+    config.latency_us = 100;
+    config.bit_rate = 500000;
+    assert_int_equal(vcan_init(&config), ALL_OK);
+
+    assert_int_equal(sim_add_nodes(0x20, 1, "eds/DS301_profile.eds"), ALL_OK);
+
+    assert_int_equal(sdo_read(&sdo_response, SILENT, 0x20, 0x1800, 0x01, NULL), IS_READ_EXPEDITED);
+    assert_int_equal(*(uint32*)sdo_response.data, 0xc00001a0);
+
+    assert_int_equal(sdo_write(&sdo_response, SILENT, 0x20, 0x1017, 0x00, 2, &heartbeat_time, NULL), IS_WRITE_EXPEDITED);
+    os_memset(&sdo_response, 0, sizeof(sdo_response));
+    assert_int_equal(sdo_read(&sdo_response, SILENT, 0x20, 0x1017, 0x00, NULL), IS_READ_EXPEDITED);
+    assert_int_equal(*(uint16*)sdo_response.data, 250);
+
+    sim_stop();
+    vcan_deinit();
+}
+
+void test_vcan_virtual_time(void** state)
+{
+    vcan_config_t config = {0};
+    can_message_t sdo_response = {0};
+    uint64 start;
+
+    (void)state;
+
+    /* 30 ms latency each way: slow in wall time, instant on virtual time. */
+    os_set_virtual_time(true);
+    config.latency_us = 30000;
+    assert_int_equal(vcan_init(&config), ALL_OK);
+
+    assert_int_equal(sim_add_nodes(0x21, 1, "eds/DS301_profile.eds"), ALL_OK);
+
+    start = os_get_ticks();
+    assert_int_equal(sdo_read(&sdo_response, SILENT, 0x21, 0x1800, 0x01, NULL), IS_READ_EXPEDITED);
+    assert_int_equal(*(uint32*)sdo_response.data, 0xc00001a1);
+    assert_true(os_get_ticks() - start >= 60000000ULL);
+
+    /* A missing node times out after the SDO timeout. */
+    start = os_get_ticks();
+    assert_int_equal(sdo_read(&sdo_response, SILENT, 0x22, 0x1000, 0x00, NULL), ABORT_TRANSFER);
+    assert_true(os_get_ticks() - start >= 100000000ULL);
+
+    sim_stop();
+    vcan_deinit();
+    os_set_virtual_time(false);
+}
@@ -0,0 +1,21 @@
+/** @file test_vcan.h
+ *
+ *  A versatile software tool to analyse and configure CANopen devices.
+ *
+ *  Copyright (c) 2022-2026, Michael Fitzmayer. All rights reserved.
+ *  SPDX-License-Identifier: MIT
+ *
+ **/
+
+#ifndef TEST_VCAN_H
+#define TEST_VCAN_H
+
+void test_vcan_endpoints(void** state);
+void test_vcan_options(void** state);
+void test_vcan_bit_rate(void** state);
+void test_vcan_latency(void** state);
+void test_vcan_drop(void** state);
+void test_vcan_sdo_read(void** state);
+void test_vcan_virtual_time(void** state);
+
+#endif /* TEST_VCAN_H */
@@ -8,10 +8,12 @@
  **/
 
 #include "can.h"
+#include "emcy.h"
+#include "heartbeat.h"
 #include "os.h"
-
-#include "can.h"
-#include "os.h"
+#include "pdo_map.h"
+#include "sync.h"
+#include "vcan.h"
 
 uint32 __wrap_can_read(can_message_t* message, disp_mode_t disp_mode, const char* comment)
 {
@@ -24,6 +26,21 @@ uint32 __wrap_can_read(can_message_t* message, disp_mode_t disp_mode, const char
     {
         status = 1;
     }
+    else if (true == vcan_is_open())
+    {
+        status = vcan_read(VCAN_HOST, message);
+        if (ALL_OK != status)
+        {
+            os_idle();
+        }
+        else
+        {
+            heartbeat_on_read(message);
+            emcy_on_read(message);
+            pdo_map_decode(message);
+            sync_on_receive(message);
+        }
+    }
 
     return status;
 }
@@ -39,6 +56,10 @@ uint32 __wrap_can_write(can_message_t* message, disp_mode_t disp_mode, const cha
     {
         status = 1;
     }
+    else if (true == vcan_is_open())
+    {
+        status = vcan_write(VCAN_HOST, message);
+    }
 
     return status;
 }